@@ -0,0 +1,699 @@
+/**
+ * @file mqtt_bench.c
+ *
+ * @brief DATALOGGER Broker Benchmark - End-to-end latency and sustained throughput for N devices
+ *
+ * @details Every simulated device is its own MQTT client publishing periodic
+ *          readings to an edge broker (round-robin over -e) or, without -e,
+ *          straight to the central broker. One subscriber on the central
+ *          broker receives them through the bridges. Publishers and the
+ *          subscriber share this process, so latency is measured on a single
+ *          monotonic clock.
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <getopt.h>
+#include <mosquitto.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+#define BENCH_DATA_TOPIC "datalogger/%s/stm32/periodic/data" // Per device, like the gateway
+#define BENCH_DATA_FILTER "datalogger/+/stm32/periodic/data"
+#define BENCH_EDGES_MAX 16
+#define BENCH_SITE_MAX 32
+#define BENCH_TOPIC_MAX 128
+#define BENCH_PAYLOAD_MAX 192
+#define BENCH_CONNECT_TIMEOUT_S 30 // Clients and bridges up
+#define BENCH_DRAIN_TIMEOUT_S 10   // Wait for messages still in flight
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Edge broker (-e host:port:site)
+ */
+typedef struct
+{
+    char host[64];
+    int port;
+    char site[BENCH_SITE_MAX];
+} bench_edge_t;
+
+/**
+ * @brief Benchmark configuration (command line)
+ */
+typedef struct
+{
+    const char *host;
+    int port;
+    const char *user;
+    const char *password;
+    bench_edge_t edges[BENCH_EDGES_MAX];
+    int edge_count;
+    uint32_t devices;
+    double rate;      // Messages/s per device
+    int duration;     // Seconds of publishing
+    int warmup;       // Seconds excluded from the sustained rate
+    int qos;
+    const char *label;
+    const char *csv_path;
+} bench_config_t;
+
+/**
+ * @brief Simulated device
+ */
+typedef struct
+{
+    struct mosquitto *mosq;
+    atomic_bool connected;
+    char topic[BENCH_TOPIC_MAX]; // Data topic under the device's client id
+} bench_device_t;
+
+/**
+ * @brief Receive side (written by the subscriber thread only)
+ */
+typedef struct
+{
+    uint8_t *seen;         // One bit per planned message
+    uint32_t *latency_us;  // First receipt of each message
+    int64_t *last_n;       // Per device, detects reordering
+    uint64_t unique;
+    uint64_t duplicates;
+    uint64_t reordered;
+    uint64_t invalid;
+    uint64_t in_window;    // Received between warmup and end of publishing
+} bench_recv_t;
+
+/* PRIVATE VARIABLES ---------------------------------------------------------*/
+
+static bench_config_t g_config = {
+    .host = "localhost",
+    .port = 1883,
+    .devices = 10,
+    .rate = 1.0,
+    .duration = 30,
+    .warmup = 5,
+    .qos = 1,
+    .label = "-",
+};
+
+static bench_device_t *g_devices;
+static bench_recv_t g_recv;
+static uint64_t g_planned;         // Messages scheduled (n devices x duration x rate)
+static uint64_t g_t0_us;           // Publishing start
+static atomic_uint_fast64_t g_received; // Unique messages, polled by the main thread
+static atomic_uint g_bridges_up;   // Bit per edge whose sites/<site>/bridge/state is 1
+static atomic_int g_subacks;       // Subscriptions acknowledged
+static volatile sig_atomic_t g_running = 1;
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+static uint64_t bench_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void bench_sleep_until_us(uint64_t t_us)
+{
+    struct timespec ts = {
+        .tv_sec = (time_t)(t_us / 1000000ull),
+        .tv_nsec = (long)(t_us % 1000000ull) * 1000,
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR && g_running)
+    {
+    }
+}
+
+static void bench_on_signal(int sig)
+{
+    (void)sig;
+    g_running = 0;
+}
+
+/**
+ * @brief Parse host:port:site
+ */
+static bool bench_parse_edge(const char *arg, bench_edge_t *edge)
+{
+    const char *c1 = strchr(arg, ':');
+    const char *c2 = c1 ? strchr(c1 + 1, ':') : NULL;
+
+    if (c2 == NULL || c1 == arg || (size_t)(c1 - arg) >= sizeof(edge->host) ||
+        strlen(c2 + 1) == 0 || strlen(c2 + 1) >= sizeof(edge->site))
+    {
+        return false;
+    }
+
+    memcpy(edge->host, arg, (size_t)(c1 - arg));
+    edge->host[c1 - arg] = '\0';
+    edge->port = atoi(c1 + 1);
+    strcpy(edge->site, c2 + 1);
+    return edge->port > 0;
+}
+
+/**
+ * @brief Read an unsigned field ("name":123) from the payload
+ */
+static bool bench_json_u64(const char *json, const char *key, uint64_t *value)
+{
+    const char *p = strstr(json, key);
+    char *end;
+
+    if (p == NULL)
+    {
+        return false;
+    }
+    *value = strtoull(p + strlen(key), &end, 10);
+    return end != p + strlen(key);
+}
+
+/* Publisher callbacks ---------------------------------------------------------*/
+
+static void bench_on_device_connect(struct mosquitto *mosq, void *obj, int rc)
+{
+    (void)mosq;
+    bench_device_t *device = obj;
+
+    if (rc != 0)
+    {
+        fprintf(stderr, "[BENCH] Device connect refused: %s\n", mosquitto_connack_string(rc));
+        return;
+    }
+    atomic_store(&device->connected, true);
+}
+
+static void bench_on_device_disconnect(struct mosquitto *mosq, void *obj, int rc)
+{
+    (void)mosq;
+    (void)rc;
+    bench_device_t *device = obj;
+    atomic_store(&device->connected, false);
+}
+
+/* Subscriber callbacks --------------------------------------------------------*/
+
+static void bench_on_sub_connect(struct mosquitto *mosq, void *obj, int rc)
+{
+    (void)obj;
+    char topic[BENCH_TOPIC_MAX];
+
+    if (rc != 0)
+    {
+        fprintf(stderr, "[BENCH] Subscriber connect refused: %s\n", mosquitto_connack_string(rc));
+        return;
+    }
+
+    if (g_config.edge_count > 0)
+    {
+        snprintf(topic, sizeof(topic), "sites/+/%s", BENCH_DATA_FILTER);
+        mosquitto_subscribe(mosq, NULL, "sites/+/bridge/state", 1);
+    }
+    else
+    {
+        snprintf(topic, sizeof(topic), "%s", BENCH_DATA_FILTER);
+    }
+    mosquitto_subscribe(mosq, NULL, topic, g_config.qos);
+}
+
+static void bench_on_sub_subscribe(struct mosquitto *mosq, void *obj, int mid, int qos_count,
+                                   const int *granted_qos)
+{
+    (void)mosq;
+    (void)obj;
+    (void)mid;
+    (void)qos_count;
+    (void)granted_qos;
+    atomic_fetch_add(&g_subacks, 1);
+}
+
+static void bench_on_sub_message(struct mosquitto *mosq, void *obj, const struct mosquitto_message *msg)
+{
+    (void)mosq;
+    (void)obj;
+    char json[BENCH_PAYLOAD_MAX];
+    uint64_t now_us = bench_now_us();
+    uint64_t dev, n, sent_us;
+    size_t len;
+
+    // Bridge notifications: retained "1"/"0" on sites/<site>/bridge/state
+    len = strlen(msg->topic);
+    if (len > 13 && strcmp(msg->topic + len - 13, "/bridge/state") == 0)
+    {
+        for (int i = 0; i < g_config.edge_count; i++)
+        {
+            size_t site_len = strlen(g_config.edges[i].site);
+            if (len == 6 + site_len + 13 && strncmp(msg->topic + 6, g_config.edges[i].site, site_len) == 0)
+            {
+                if (msg->payloadlen == 1 && ((const char *)msg->payload)[0] == '1')
+                {
+                    atomic_fetch_or(&g_bridges_up, 1u << i);
+                }
+                else
+                {
+                    atomic_fetch_and(&g_bridges_up, ~(1u << i));
+                }
+            }
+        }
+        return;
+    }
+
+    len = (size_t)msg->payloadlen < sizeof(json) - 1 ? (size_t)msg->payloadlen : sizeof(json) - 1;
+    memcpy(json, msg->payload, len);
+    json[len] = '\0';
+
+    if (!bench_json_u64(json, "\"dev\":", &dev) || !bench_json_u64(json, "\"n\":", &n) ||
+        !bench_json_u64(json, "\"sent_us\":", &sent_us) || dev >= g_config.devices)
+    {
+        g_recv.invalid++;
+        return;
+    }
+
+    uint64_t k = n * g_config.devices + dev;
+    if (k >= g_planned)
+    {
+        g_recv.invalid++;
+        return;
+    }
+    if (g_recv.seen[k / 8] & (1u << (k % 8)))
+    {
+        g_recv.duplicates++;
+        return;
+    }
+    g_recv.seen[k / 8] |= (uint8_t)(1u << (k % 8));
+
+    if ((int64_t)n < g_recv.last_n[dev])
+    {
+        g_recv.reordered++;
+    }
+    else
+    {
+        g_recv.last_n[dev] = (int64_t)n;
+    }
+
+    uint64_t lat = now_us > sent_us ? now_us - sent_us : 0;
+    g_recv.latency_us[g_recv.unique++] = lat > UINT32_MAX ? UINT32_MAX : (uint32_t)lat;
+
+    uint64_t since_us = now_us - g_t0_us;
+    if (since_us >= (uint64_t)g_config.warmup * 1000000ull &&
+        since_us < (uint64_t)g_config.duration * 1000000ull)
+    {
+        g_recv.in_window++;
+    }
+    atomic_store(&g_received, g_recv.unique);
+}
+
+/* Run -------------------------------------------------------------------------*/
+
+/**
+ * @brief Create a client with the common options
+ */
+static struct mosquitto *bench_client_new(const char *id, void *obj)
+{
+    struct mosquitto *mosq = mosquitto_new(id, true, obj);
+
+    if (mosq == NULL)
+    {
+        return NULL;
+    }
+    if (g_config.user)
+    {
+        mosquitto_username_pw_set(mosq, g_config.user, g_config.password);
+    }
+    mosquitto_reconnect_delay_set(mosq, 1, 10, true);
+    return mosq;
+}
+
+/**
+ * @brief Connect in the background (own network thread, retries until up)
+ */
+static bool bench_client_start(struct mosquitto *mosq, const char *host, int port)
+{
+    if (mosquitto_connect_async(mosq, host, port, 60) != MOSQ_ERR_SUCCESS)
+    {
+        fprintf(stderr, "[BENCH] Cannot reach %s:%d, retrying\n", host, port);
+    }
+    return mosquitto_loop_start(mosq) == MOSQ_ERR_SUCCESS;
+}
+
+/**
+ * @brief Wait until cond() holds or the timeout expires
+ */
+static bool bench_wait(bool (*cond)(void), int timeout_s)
+{
+    uint64_t deadline_us = bench_now_us() + (uint64_t)timeout_s * 1000000ull;
+
+    while (g_running && !cond())
+    {
+        if (bench_now_us() > deadline_us)
+        {
+            return false;
+        }
+        usleep(50000);
+    }
+    return g_running;
+}
+
+static bool bench_all_connected(void)
+{
+    for (uint32_t i = 0; i < g_config.devices; i++)
+    {
+        if (!atomic_load(&g_devices[i].connected))
+        {
+            return false;
+        }
+    }
+    // Data topic, plus the bridge notifications when bridged
+    return atomic_load(&g_subacks) >= (g_config.edge_count > 0 ? 2 : 1) &&
+           atomic_load(&g_bridges_up) == (1u << g_config.edge_count) - 1;
+}
+
+static bool bench_all_received(void)
+{
+    return atomic_load(&g_received) >= g_planned;
+}
+
+static int bench_cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double bench_percentile_ms(const uint32_t *sorted, uint64_t count, double p)
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+    uint64_t i = (uint64_t)(p * (double)(count - 1) + 0.5);
+    return sorted[i] / 1000.0;
+}
+
+/**
+ * @brief Print the summary and append the CSV line
+ */
+static void bench_report(uint64_t sent, uint64_t pub_errors, uint64_t late, double publish_s)
+{
+    uint64_t received = g_recv.unique;
+    double window_s = g_config.duration - g_config.warmup;
+    double offered = g_config.devices * g_config.rate;
+    double sustained = window_s > 0 ? g_recv.in_window / window_s : 0.0;
+    uint64_t lost = sent - received;
+
+    qsort(g_recv.latency_us, received, sizeof(uint32_t), bench_cmp_u32);
+    double p50 = bench_percentile_ms(g_recv.latency_us, received, 0.50);
+    double p90 = bench_percentile_ms(g_recv.latency_us, received, 0.90);
+    double p99 = bench_percentile_ms(g_recv.latency_us, received, 0.99);
+    double max = received ? g_recv.latency_us[received - 1] / 1000.0 : 0.0;
+
+    printf("[BENCH] %s: %u devices x %.2f msg/s, QoS %d, %s\n", g_config.label, g_config.devices,
+           g_config.rate, g_config.qos, g_config.edge_count ? "bridged" : "direct");
+    printf("  sent %llu in %.1f s (%llu late, %llu publish errors)\n", (unsigned long long)sent,
+           publish_s, (unsigned long long)late, (unsigned long long)pub_errors);
+    printf("  received %llu, lost %llu, duplicates %llu, reordered %llu, invalid %llu\n",
+           (unsigned long long)received, (unsigned long long)lost,
+           (unsigned long long)g_recv.duplicates, (unsigned long long)g_recv.reordered,
+           (unsigned long long)g_recv.invalid);
+    printf("  throughput offered %.1f msg/s, sustained %.1f msg/s\n", offered, sustained);
+    printf("  latency ms p50 %.2f, p90 %.2f, p99 %.2f, max %.2f\n", p50, p90, p99, max);
+
+    if (g_config.csv_path == NULL)
+    {
+        return;
+    }
+
+    FILE *f = fopen(g_config.csv_path, "a");
+    if (f == NULL)
+    {
+        perror(g_config.csv_path);
+        return;
+    }
+    if (ftell(f) == 0)
+    {
+        fprintf(f, "label,topology,devices,rate,qos,sent,received,lost,duplicates,reordered,"
+                   "publish_errors,late,offered_mps,sustained_mps,p50_ms,p90_ms,p99_ms,max_ms\n");
+    }
+    fprintf(f, "%s,%s,%u,%.2f,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%.1f,%.1f,%.2f,%.2f,%.2f,%.2f\n",
+            g_config.label, g_config.edge_count ? "bridged" : "direct", g_config.devices,
+            g_config.rate, g_config.qos, (unsigned long long)sent, (unsigned long long)received,
+            (unsigned long long)lost, (unsigned long long)g_recv.duplicates,
+            (unsigned long long)g_recv.reordered, (unsigned long long)pub_errors,
+            (unsigned long long)late, offered, sustained, p50, p90, p99, max);
+    fclose(f);
+}
+
+/**
+ * @brief Connect everything, publish on schedule, drain and report
+ *
+ * @return Exit code
+ */
+static int bench_run(void)
+{
+    struct mosquitto *sub;
+    char id[64];
+    char payload[BENCH_PAYLOAD_MAX];
+    uint64_t sent = 0, pub_errors = 0, late = 0;
+    int rc = 0;
+
+    g_planned = (uint64_t)(g_config.devices * g_config.rate * g_config.duration);
+    g_devices = calloc(g_config.devices, sizeof(*g_devices));
+    g_recv.seen = calloc(g_planned / 8 + 1, 1);
+    g_recv.latency_us = calloc(g_planned + 1, sizeof(uint32_t));
+    g_recv.last_n = malloc(g_config.devices * sizeof(int64_t));
+    if (!g_devices || !g_recv.seen || !g_recv.latency_us || !g_recv.last_n)
+    {
+        fprintf(stderr, "[BENCH] Out of memory (%llu messages planned)\n", (unsigned long long)g_planned);
+        return 1;
+    }
+    for (uint32_t i = 0; i < g_config.devices; i++)
+    {
+        g_recv.last_n[i] = -1;
+    }
+
+    mosquitto_lib_init();
+
+    sub = bench_client_new("bench_central_sub", NULL);
+    if (sub == NULL)
+    {
+        fprintf(stderr, "[BENCH] Cannot create subscriber\n");
+        return 1;
+    }
+    mosquitto_connect_callback_set(sub, bench_on_sub_connect);
+    mosquitto_subscribe_callback_set(sub, bench_on_sub_subscribe);
+    mosquitto_message_callback_set(sub, bench_on_sub_message);
+    if (!bench_client_start(sub, g_config.host, g_config.port))
+    {
+        fprintf(stderr, "[BENCH] Cannot start subscriber\n");
+        return 1;
+    }
+
+    // Devices publish the ESP32 data topic on their edge broker (or central)
+    for (uint32_t i = 0; i < g_config.devices; i++)
+    {
+        const char *host = g_config.host;
+        int port = g_config.port;
+
+        if (g_config.edge_count > 0)
+        {
+            const bench_edge_t *edge = &g_config.edges[i % (uint32_t)g_config.edge_count];
+            host = edge->host;
+            port = edge->port;
+        }
+
+        snprintf(id, sizeof(id), "bench_dev_%u", i);
+        snprintf(g_devices[i].topic, sizeof(g_devices[i].topic), BENCH_DATA_TOPIC, id);
+        g_devices[i].mosq = bench_client_new(id, &g_devices[i]);
+        if (g_devices[i].mosq == NULL)
+        {
+            fprintf(stderr, "[BENCH] Cannot create device %u\n", i);
+            rc = 1;
+            goto out;
+        }
+        mosquitto_connect_callback_set(g_devices[i].mosq, bench_on_device_connect);
+        mosquitto_disconnect_callback_set(g_devices[i].mosq, bench_on_device_disconnect);
+        if (!bench_client_start(g_devices[i].mosq, host, port))
+        {
+            fprintf(stderr, "[BENCH] Cannot start device %u\n", i);
+            rc = 1;
+            goto out;
+        }
+    }
+
+    if (!bench_wait(bench_all_connected, BENCH_CONNECT_TIMEOUT_S))
+    {
+        fprintf(stderr, "[BENCH] Timeout: devices, subscriber or bridges not connected\n");
+        rc = 1;
+        goto out;
+    }
+
+    // Evenly spaced schedule over all devices: message k is device k % n
+    double interval_us = 1e6 / (g_config.devices * g_config.rate);
+    time_t ts = time(NULL);
+    g_t0_us = bench_now_us() + 100000;
+
+    for (uint64_t k = 0; k < g_planned && g_running; k++)
+    {
+        uint64_t due_us = g_t0_us + (uint64_t)(k * interval_us);
+        uint64_t now_us = bench_now_us();
+        uint32_t dev = (uint32_t)(k % g_config.devices);
+        uint64_t n = k / g_config.devices;
+
+        if (now_us < due_us)
+        {
+            bench_sleep_until_us(due_us);
+        }
+        else if (now_us - due_us > 1000)
+        {
+            late++;
+        }
+
+        // Same shape as the ESP32 periodic payload, plus the benchmark fields
+        int len = snprintf(payload, sizeof(payload),
+                           "{\"mode\":\"PERIODIC\",\"timestamp\":%lld,\"temperature\":%.2f,"
+                           "\"humidity\":%.2f,\"dev\":%u,\"n\":%llu,\"sent_us\":%llu}",
+                           (long long)(ts + (time_t)(n / g_config.rate)), 25.0 + (k % 100) / 100.0,
+                           60.0 + (k % 50) / 10.0, dev, (unsigned long long)n,
+                           (unsigned long long)bench_now_us());
+
+        if (mosquitto_publish(g_devices[dev].mosq, NULL, g_devices[dev].topic, len, payload,
+                              g_config.qos, false) == MOSQ_ERR_SUCCESS)
+        {
+            sent++;
+        }
+        else
+        {
+            pub_errors++;
+        }
+    }
+    double publish_s = (bench_now_us() - g_t0_us) / 1e6;
+
+    bench_wait(bench_all_received, BENCH_DRAIN_TIMEOUT_S);
+
+out:
+    mosquitto_disconnect(sub);
+    mosquitto_loop_stop(sub, false);
+    for (uint32_t i = 0; i < g_config.devices; i++)
+    {
+        if (g_devices[i].mosq)
+        {
+            mosquitto_disconnect(g_devices[i].mosq);
+            mosquitto_loop_stop(g_devices[i].mosq, false);
+            mosquitto_destroy(g_devices[i].mosq);
+        }
+    }
+
+    if (rc == 0)
+    {
+        bench_report(sent, pub_errors, late, publish_s);
+    }
+
+    mosquitto_destroy(sub);
+    mosquitto_lib_cleanup();
+    return rc;
+}
+
+/**
+ * @brief Print usage
+ *
+ * @param prog Program name
+ */
+static void bench_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -h host       Central broker host (localhost)\n"
+            "  -p port       Central broker port (1883)\n"
+            "  -e h:p:site   Edge broker bridged as sites/<site>/, repeatable;\n"
+            "                none = devices publish to the central broker\n"
+            "  -u user       Username on all brokers (password from MQTT_PASSWORD)\n"
+            "  -n devices    Simulated devices, one client each (10)\n"
+            "  -r rate       Messages/s per device (1)\n"
+            "  -d seconds    Publishing time (30)\n"
+            "  -w seconds    Warmup excluded from the sustained rate (5)\n"
+            "  -q qos        Publish and subscribe QoS (1)\n"
+            "  -l label      Run label, e.g. the broker profile (-)\n"
+            "  -c file       Append the results as CSV\n",
+            prog);
+}
+
+/* MAIN ----------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "h:p:e:u:n:r:d:w:q:l:c:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'h':
+            g_config.host = optarg;
+            break;
+        case 'p':
+            g_config.port = atoi(optarg);
+            break;
+        case 'e':
+            if (g_config.edge_count == BENCH_EDGES_MAX ||
+                !bench_parse_edge(optarg, &g_config.edges[g_config.edge_count]))
+            {
+                fprintf(stderr, "Bad edge '%s' (host:port:site, at most %d)\n", optarg, BENCH_EDGES_MAX);
+                return 2;
+            }
+            g_config.edge_count++;
+            break;
+        case 'u':
+            g_config.user = optarg;
+            break;
+        case 'n':
+            g_config.devices = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            g_config.rate = atof(optarg);
+            break;
+        case 'd':
+            g_config.duration = atoi(optarg);
+            break;
+        case 'w':
+            g_config.warmup = atoi(optarg);
+            break;
+        case 'q':
+            g_config.qos = atoi(optarg);
+            break;
+        case 'l':
+            g_config.label = optarg;
+            break;
+        case 'c':
+            g_config.csv_path = optarg;
+            break;
+        default:
+            bench_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (g_config.devices == 0 || g_config.rate <= 0 || g_config.duration <= 0 ||
+        g_config.warmup < 0 || g_config.warmup >= g_config.duration || g_config.qos < 0 ||
+        g_config.qos > 2)
+    {
+        bench_usage(argv[0]);
+        return 2;
+    }
+    // Keep the password off the command line (visible in ps)
+    g_config.password = getenv("MQTT_PASSWORD");
+
+    signal(SIGINT, bench_on_signal);
+    signal(SIGTERM, bench_on_signal);
+
+    return bench_run();
+}
@@ -0,0 +1,104 @@
+#!/bin/sh
+# DATALOGGER broker benchmark: every profile in profiles/ x direct/bridged x DEVICES
+#
+# Starts the central broker and two edge brokers (../cluster configs) as local
+# containers on a private Docker network, swaps conf.d/limits.conf for each
+# profile and runs mqtt_bench. Results are appended to results/<run>.csv,
+# broker CPU/memory samples to results/<run>-stats.txt.
+#
+# Environment (defaults):
+#   DEVICES="10 100 500"  Device counts
+#   RATE=1                Messages/s per device
+#   DURATION=60           Seconds of publishing per run
+#   WARMUP=10             Seconds excluded from the sustained rate
+#   QOS=1                 Publish/subscribe QoS
+#   PROFILES=profiles/*.conf
+#   IMAGE=eclipse-mosquitto:2
+
+set -eu
+
+cd "$(dirname "$0")"
+
+DEVICES=${DEVICES:-"10 100 500"}
+RATE=${RATE:-1}
+DURATION=${DURATION:-60}
+WARMUP=${WARMUP:-10}
+QOS=${QOS:-1}
+PROFILES=${PROFILES:-$(ls profiles/*.conf)}
+IMAGE=${IMAGE:-eclipse-mosquitto:2}
+
+NET=dl-bench
+BENCH_USER=bench
+PASS=bench-$$
+RUN=$(date +%Y%m%d_%H%M%S)
+OUT=$(pwd)/results
+WORK=$(mktemp -d)
+BROKERS="dl-bench-central dl-bench-edge-site1 dl-bench-edge-site2"
+
+cleanup() {
+    docker rm -f $BROKERS >/dev/null 2>&1 || true
+    docker network rm $NET >/dev/null 2>&1 || true
+    rm -rf "$WORK"
+}
+trap cleanup EXIT INT TERM
+
+mkdir -p "$OUT" "$WORK/auth" "$WORK/conf.d"
+
+docker build -q -t datalogger-bench . >/dev/null
+docker network create $NET >/dev/null 2>&1 || true
+
+# Benchmark account on all brokers, same configs as the shipped topology
+docker run --rm -v "$WORK/auth:/work" "$IMAGE" \
+    sh -c "mosquitto_passwd -b -c /work/passwd.txt $BENCH_USER $PASS && chmod 644 /work/passwd.txt"
+cp ../cluster/central.conf "$WORK/"
+for site in site1 site2; do
+    sed -e "s/^remote_username .*/remote_username $BENCH_USER/" \
+        -e "s/^remote_password .*/remote_password $PASS/" \
+        "../cluster/edge-$site.conf" > "$WORK/edge-$site.conf"
+done
+
+start_broker() { # name alias config
+    docker run -d --name "$1" --network $NET --network-alias "$2" \
+        -v "$WORK/$3:/mosquitto/config/mosquitto.conf:ro" \
+        -v "$WORK/conf.d:/mosquitto/config/conf.d:ro" \
+        -v "$WORK/auth:/mosquitto/config/auth:ro" \
+        "$IMAGE" >/dev/null
+}
+
+bench() { # label devices [edge...]
+    label=$1
+    devices=$2
+    shift 2
+    topology=direct
+    [ $# -gt 0 ] && topology=bridged
+
+    docker run --rm --network $NET -e MQTT_PASSWORD=$PASS -v "$OUT:/out" datalogger-bench \
+        -h central -u $BENCH_USER -n "$devices" -r "$RATE" -d "$DURATION" -w "$WARMUP" -q "$QOS" \
+        -l "$label" -c "/out/$RUN.csv" "$@" &
+    pid=$!
+
+    # Broker load half way through the run
+    sleep $((DURATION / 2))
+    echo "== $label, $devices devices, $topology" >> "$OUT/$RUN-stats.txt"
+    docker stats --no-stream --format '{{.Name}} cpu {{.CPUPerc}} mem {{.MemUsage}}' $BROKERS \
+        >> "$OUT/$RUN-stats.txt"
+
+    wait $pid
+}
+
+for profile in $PROFILES; do
+    label=$(basename "$profile" .conf)
+    cp "$profile" "$WORK/conf.d/limits.conf"
+
+    docker rm -f $BROKERS >/dev/null 2>&1 || true
+    start_broker dl-bench-central central central.conf
+    start_broker dl-bench-edge-site1 edge-site1 edge-site1.conf
+    start_broker dl-bench-edge-site2 edge-site2 edge-site2.conf
+
+    for n in $DEVICES; do
+        bench "$label" "$n"
+        bench "$label" "$n" -e edge-site1:1883:site1 -e edge-site2:1883:site2
+    done
+done
+
+echo "Results: $OUT/$RUN.csv"
@@ -0,0 +1,977 @@
+/**
+ * @file ingest.c
+ *
+ * @brief DATALOGGER Ingest Service - MQTT subscriber writing sensor data to the local store
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include "ts_recent.h"
+#include "ts_store.h"
+#include <getopt.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if INGEST_MQTT
+#include <mosquitto.h>
+#endif
+
+/* DEFINES -------------------------------------------------------------------*/
+
+#define INGEST_TOPIC_DEFAULT "datalogger/+/stm32/+/data"
+#define INGEST_TOPIC_LEGACY "datalogger/stm32/+/data" // Also subscribed when no -t is given
+#define INGEST_TOPICS_MAX 8              // -t options
+#define INGEST_DEVICE_DEFAULT "ESP32_01" // Topics without a device level (datalogger/stm32/...)
+#define INGEST_TZ_OFFSET_DEFAULT 25200   // Device RTC runs on local time (UTC+7)
+#define INGEST_FLUSH_MS 1000             // Max time a sample waits in RAM
+#define INGEST_STATS_S 60                // Stats log interval
+#define INGEST_PAYLOAD_MAX 512           // Longest accepted payload
+#define INGEST_LINE_MAX 1024             // Longest --stdin line
+#define INGEST_RECENT_TOPIC "history"  // Retained <namespace>/history/latest and /recent
+#define INGEST_RECENT_MS 1000            // Min time between two /recent snapshots of a device
+#define INGEST_DEVICES_MAX 1024          // Devices with a recent window
+#define INGEST_DEVICE_SLOTS (INGEST_DEVICES_MAX * 2) // Hash slots (power of two)
+#define INGEST_NAMESPACE_MAX 128         // Longest topic prefix up to the device level
+#define INGEST_BACKLOG_SEEN 16384        // Backlog records remembered per generation (two generations)
+#define INGEST_BACKLOG_SLOTS (INGEST_BACKLOG_SEEN * 2) // Hash slots per generation (power of two)
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Service configuration (command line)
+ */
+typedef struct
+{
+    const char *host;
+    int port;
+    const char *user;
+    const char *password;
+    const char *client_id;
+    const char *topics[INGEST_TOPICS_MAX];
+    int topic_count;
+    const char *device;
+    const char *data_dir;
+    long tz_offset;
+    int qos;
+    bool sync;
+    bool from_stdin;
+    int stats_interval;
+    uint32_t recent_points;
+} ingest_config_t;
+
+/**
+ * @brief Ingest counters
+ */
+typedef struct
+{
+    uint64_t messages; // Messages received
+    uint64_t stored;   // Samples appended to the store
+    uint64_t rejected;   // Unknown topic, bad payload or store error
+    uint64_t duplicates; // Backlog records already stored (same device, seq and timestamp)
+} ingest_stats_t;
+
+/**
+ * @brief Backlog record already stored
+ */
+typedef struct
+{
+    uint32_t device;   // Device id hash
+    uint32_t seq;      // SD record sequence number
+    int64_t timestamp; // Device timestamp
+    bool used;
+} ingest_backlog_entry_t;
+
+/**
+ * @brief One generation of remembered backlog records
+ */
+typedef struct
+{
+    ingest_backlog_entry_t slots[INGEST_BACKLOG_SLOTS];
+    uint32_t count;
+} ingest_backlog_gen_t;
+
+/**
+ * @brief Recent window of one device (broker mode)
+ */
+typedef struct
+{
+    char id[TS_STORE_DEVICE_MAX];
+    uint32_t hash;
+    char topic[INGEST_NAMESPACE_MAX + TS_STORE_DEVICE_MAX + sizeof("/" INGEST_RECENT_TOPIC "/latest")];
+    size_t topic_len;          // Length of "<namespace>/history/" in topic
+    ts_recent_t recent;
+    uint64_t last_snapshot_ms; // Last /recent publish
+} ingest_device_t;
+
+/* PRIVATE VARIABLES ---------------------------------------------------------*/
+
+static ingest_config_t g_config = {
+    .host = "localhost",
+    .port = 1883,
+    .client_id = "datalogger_ingest",
+    .device = INGEST_DEVICE_DEFAULT,
+    .data_dir = "./data",
+    .tz_offset = INGEST_TZ_OFFSET_DEFAULT,
+    .qos = 1,
+    .stats_interval = INGEST_STATS_S,
+    .recent_points = TS_RECENT_POINTS_DEFAULT,
+};
+
+static ts_store_t g_store; // Large (pending blocks), keep off the stack
+static ingest_stats_t g_stats;
+static ingest_device_t g_devices[INGEST_DEVICES_MAX]; // Broker mode only (recent_points > 0)
+static uint16_t g_device_slots[INGEST_DEVICE_SLOTS];   // Index + 1 into g_devices, 0 = free
+static uint32_t g_device_count;
+static ingest_backlog_gen_t g_backlog[2]; // Current and previous generation
+static uint32_t g_backlog_current;
+static bool g_recent_enabled;
+static volatile sig_atomic_t g_running = 1;
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+/**
+ * @brief Monotonic time in milliseconds
+ *
+ * @return Milliseconds
+ */
+static uint64_t ingest_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Signal handler: stop the main loop (pending samples are flushed)
+ *
+ * @param sig Signal number
+ */
+static void ingest_on_signal(int sig)
+{
+    (void)sig;
+    g_running = 0;
+}
+
+/**
+ * @brief Find the closing quote of a JSON string
+ *
+ * @param p First character after the opening quote
+ *
+ * @return Closing quote, NULL if the string is not terminated
+ */
+static const char *ingest_json_string_end(const char *p)
+{
+    for (; *p != '\0'; p++)
+    {
+        if (*p == '\\' && p[1] != '\0')
+        {
+            p++;
+        }
+        else if (*p == '"')
+        {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Find the value of a field in a flat JSON object
+ *
+ * @param json NUL-terminated payload
+ * @param key Field name (without quotes)
+ *
+ * @return First character of the value, NULL if the field is missing
+ *
+ * @note The gateway payload is flat ({"mode":...,"timestamp":...}), so a key
+ *       scan is enough and much cheaper than a full parser. Only keys are
+ *       matched, never text inside string values.
+ */
+static const char *ingest_json_value(const char *json, const char *key)
+{
+    size_t key_len = strlen(key);
+    const char *p = json;
+
+    while ((p = strchr(p, '"')) != NULL)
+    {
+        p++;
+        const char *close = ingest_json_string_end(p);
+        if (close == NULL)
+        {
+            return NULL;
+        }
+
+        const char *after = close + 1;
+        while (*after == ' ' || *after == '\t')
+        {
+            after++;
+        }
+
+        if (*after == ':')
+        {
+            // A key: match it, else step over to its value
+            after++;
+            while (*after == ' ' || *after == '\t')
+            {
+                after++;
+            }
+            if ((size_t)(close - p) == key_len && strncmp(p, key, key_len) == 0)
+            {
+                return after;
+            }
+            if (*after == '"')
+            {
+                after = ingest_json_string_end(after + 1);
+                if (after == NULL)
+                {
+                    return NULL;
+                }
+                after++;
+            }
+        }
+        p = after;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Find a numeric field in a flat JSON object
+ *
+ * @param json NUL-terminated payload
+ * @param key Field name (without quotes)
+ * @param value Output value
+ *
+ * @return true if the field exists and holds a number
+ */
+static bool ingest_json_number(const char *json, const char *key, double *value)
+{
+    const char *p = ingest_json_value(json, key);
+    if (p == NULL)
+    {
+        return false;
+    }
+
+    char *end;
+    *value = strtod(p, &end);
+    return end != p && isfinite(*value);
+}
+
+/**
+ * @brief Check if a string field of a flat JSON object has a given value
+ *
+ * @param json NUL-terminated payload
+ * @param key Field name (without quotes)
+ * @param expected Expected value (without quotes)
+ *
+ * @return true if the field exists and is exactly that string
+ */
+static bool ingest_json_string_is(const char *json, const char *key, const char *expected)
+{
+    const char *p = ingest_json_value(json, key);
+    size_t len = strlen(expected);
+
+    return p != NULL && *p == '"' && strncmp(p + 1, expected, len) == 0 && p[1 + len] == '"';
+}
+
+/**
+ * @brief Length of the topic level ending at end
+ *
+ * @param topic Topic string
+ * @param end One past the last character of the level
+ * @param start Output start of the level
+ *
+ * @return Level length, 0 if end is the start of the topic
+ */
+static size_t ingest_topic_level(const char *topic, const char *end, const char **start)
+{
+    const char *p = end;
+    while (p > topic && p[-1] != '/')
+    {
+        p--;
+    }
+    *start = p;
+    return (size_t)(end - p);
+}
+
+/**
+ * @brief Split a data topic (<namespace>/<device>/stm32/<mode>/data)
+ *
+ * @param topic Topic string
+ * @param json NUL-terminated payload (mode of backlog records)
+ * @param flags Output mode flags
+ * @param device Output device id (TS_STORE_DEVICE_MAX bytes)
+ * @param ns_len Output length of the topic before "stm32/"
+ * @param named Output true if that prefix ends with the device level
+ *
+ * @return true for single, periodic, archive and backlog data
+ *
+ * @note The device is the level before "stm32". Topics without one
+ *       (datalogger/stm32/...) are stored under the -d device. Backlog
+ *       records (SD buffer replay after an outage) keep the mode they were
+ *       taken in, which only the payload carries, and get the backlog flag.
+ */
+static bool ingest_topic_parse(const char *topic, const char *json, uint8_t *flags, char *device, size_t *ns_len,
+                               bool *named)
+{
+    const char *level;
+    const char *end = strrchr(topic, '/');
+    if (end == NULL || strcmp(end, "/data") != 0)
+    {
+        return false;
+    }
+
+    size_t len = ingest_topic_level(topic, end, &level);
+    if (len == 6 && strncmp(level, "single", len) == 0)
+        *flags = TS_STORE_MODE_SINGLE;
+    else if (len == 8 && strncmp(level, "periodic", len) == 0)
+        *flags = TS_STORE_MODE_PERIODIC;
+    else if (len == 7 && strncmp(level, "archive", len) == 0)
+        *flags = TS_STORE_MODE_ARCHIVE;
+    else if (len == 7 && strncmp(level, "backlog", len) == 0)
+        *flags = TS_STORE_FLAG_BACKLOG |
+                 (ingest_json_string_is(json, "mode", "SINGLE") ? TS_STORE_MODE_SINGLE : TS_STORE_MODE_PERIODIC);
+    else
+        return false;
+
+    if (level == topic || ingest_topic_level(topic, level - 1, &level) != 5 || strncmp(level, "stm32", 5) != 0)
+    {
+        return false;
+    }
+
+    *ns_len = (size_t)(level - topic);
+    len = level > topic ? ingest_topic_level(topic, level - 1, &level) : 0;
+    *named = len > 0 && !(len == 10 && strncmp(level, "datalogger", len) == 0);
+    if (!*named)
+    {
+        snprintf(device, TS_STORE_DEVICE_MAX, "%s", g_config.device);
+    }
+    else if (len < TS_STORE_DEVICE_MAX)
+    {
+        memcpy(device, level, len);
+        device[len] = '\0';
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Find or create the recent window of a device
+ *
+ * @param device Device id (valid store id)
+ * @param topic Data topic it arrived on
+ * @param ns_len Topic length before "stm32/"
+ * @param named true if the topic has a device level
+ *
+ * @return Device entry, NULL if the table is full or the window cannot load
+ *
+ * @note Open addressing on the device hash, so a message costs one hash and
+ *       usually one compare however many devices share the broker. A new
+ *       device loads its window from the store once.
+ */
+static ingest_device_t *ingest_get_device(const char *device, const char *topic, size_t ns_len, bool named)
+{
+    uint32_t hash = TSStore_DeviceHash(device);
+    uint32_t slot = hash & (INGEST_DEVICE_SLOTS - 1);
+
+    while (g_device_slots[slot])
+    {
+        ingest_device_t *d = &g_devices[g_device_slots[slot] - 1];
+        if (d->hash == hash && strcmp(d->id, device) == 0)
+        {
+            return d;
+        }
+        slot = (slot + 1) & (INGEST_DEVICE_SLOTS - 1);
+    }
+
+    if (g_device_count == INGEST_DEVICES_MAX || ns_len > INGEST_NAMESPACE_MAX)
+    {
+        return NULL;
+    }
+
+    ingest_device_t *d = &g_devices[g_device_count];
+    memset(d, 0, sizeof(*d));
+    strcpy(d->id, device);
+    d->hash = hash;
+
+    // Publish next to the data: datalogger/<device>/history/ (device added for the legacy layout)
+    d->topic_len = (size_t)snprintf(d->topic, sizeof(d->topic), "%.*s%s%s" INGEST_RECENT_TOPIC "/",
+                                    (int)ns_len, topic, named ? "" : device, named ? "" : "/");
+
+    if (!TSRecent_Init(&d->recent, g_config.recent_points) ||
+        !TSRecent_Load(&d->recent, g_config.data_dir, device))
+    {
+        TSRecent_Free(&d->recent);
+        return NULL;
+    }
+
+    g_device_slots[slot] = (uint16_t)(++g_device_count);
+    return d;
+}
+
+/**
+ * @brief Find a backlog record in one generation
+ *
+ * @param gen Generation
+ * @param key Record
+ * @param slot Start slot
+ *
+ * @return Matching entry, or the free slot where it would go
+ */
+static ingest_backlog_entry_t *ingest_backlog_find(ingest_backlog_gen_t *gen, const ingest_backlog_entry_t *key,
+                                                   uint32_t slot)
+{
+    while (gen->slots[slot].used)
+    {
+        const ingest_backlog_entry_t *e = &gen->slots[slot];
+        if (e->device == key->device && e->seq == key->seq && e->timestamp == key->timestamp)
+        {
+            break;
+        }
+        slot = (slot + 1) & (INGEST_BACKLOG_SLOTS - 1);
+    }
+    return &gen->slots[slot];
+}
+
+/**
+ * @brief Remember a backlog record
+ *
+ * @param device Device id
+ * @param seq SD record sequence number
+ * @param timestamp Device timestamp
+ *
+ * @return true if the record was already stored since startup
+ *
+ * @note A record can arrive twice: QoS 1 redelivery, or a replay the logger
+ *       starts over after a reset. Repeats come within minutes, so two
+ *       generations of INGEST_BACKLOG_SEEN records (the latest 16k to 32k
+ *       records, fixed memory) are enough. When the current one is full, the
+ *       previous one is dropped and reused.
+ */
+static bool ingest_backlog_seen(const char *device, uint32_t seq, int64_t timestamp)
+{
+    ingest_backlog_entry_t key = {
+        .device = TSStore_DeviceHash(device),
+        .seq = seq,
+        .timestamp = timestamp,
+        .used = true,
+    };
+    uint32_t slot = (((key.device ^ seq) * 0x9E3779B1u) >> 17) & (INGEST_BACKLOG_SLOTS - 1);
+
+    ingest_backlog_gen_t *current = &g_backlog[g_backlog_current];
+    ingest_backlog_entry_t *e = ingest_backlog_find(current, &key, slot);
+    if (e->used || ingest_backlog_find(&g_backlog[g_backlog_current ^ 1], &key, slot)->used)
+    {
+        return true;
+    }
+
+    if (current->count == INGEST_BACKLOG_SEEN)
+    {
+        g_backlog_current ^= 1;
+        current = &g_backlog[g_backlog_current];
+        memset(current, 0, sizeof(*current));
+        e = ingest_backlog_find(current, &key, slot);
+    }
+    *e = key;
+    current->count++;
+    return false;
+}
+
+/**
+ * @brief Decode one data message and append it to the store
+ *
+ * @param topic Topic string
+ * @param payload Payload bytes (not NUL-terminated)
+ * @param len Payload length
+ */
+static void ingest_handle(const char *topic, const void *payload, size_t len)
+{
+    char json[INGEST_PAYLOAD_MAX + 1];
+    char device[TS_STORE_DEVICE_MAX];
+    size_t ns_len;
+    bool named;
+    ts_sample_t sample = {0};
+    double timestamp, temperature, humidity, seq;
+
+    g_stats.messages++;
+
+    if (len > INGEST_PAYLOAD_MAX)
+    {
+        g_stats.rejected++;
+        return;
+    }
+    memcpy(json, payload, len);
+    json[len] = '\0';
+
+    if (!ingest_topic_parse(topic, json, &sample.flags, device, &ns_len, &named) ||
+        !ingest_json_number(json, "timestamp", &timestamp) ||
+        !ingest_json_number(json, "temperature", &temperature) ||
+        !ingest_json_number(json, "humidity", &humidity))
+    {
+        g_stats.rejected++;
+        return;
+    }
+
+    // Backlog lines carry the SD record number, which only repeats when the same record is replayed again
+    if ((sample.flags & TS_STORE_FLAG_BACKLOG) && ingest_json_number(json, "seq", &seq) && seq >= 0.0 &&
+        seq <= UINT32_MAX && ingest_backlog_seen(device, (uint32_t)seq, (int64_t)timestamp))
+    {
+        g_stats.duplicates++;
+        return;
+    }
+
+    // Same failure rules as the dashboard: 0/0 = sensor failure, timestamp 0 = RTC failure
+    if (temperature == 0.0 && humidity == 0.0)
+    {
+        sample.flags |= TS_STORE_FLAG_SENSOR_FAIL;
+    }
+    if (timestamp <= 0.0)
+    {
+        sample.flags |= TS_STORE_FLAG_RTC_FAIL;
+        sample.time = (int64_t)time(NULL);
+    }
+    else
+    {
+        sample.time = (int64_t)timestamp - g_config.tz_offset;
+    }
+
+    sample.temperature = (int32_t)lround(temperature * 100.0);
+    sample.humidity = (int32_t)lround(humidity * 100.0);
+
+    if (TSStore_Append(&g_store, device, &sample))
+    {
+        g_stats.stored++;
+        if (g_recent_enabled)
+        {
+            ingest_device_t *d = ingest_get_device(device, topic, ns_len, named);
+            if (d)
+            {
+                TSRecent_Add(&d->recent, &sample);
+            }
+        }
+    }
+    else
+    {
+        g_stats.rejected++;
+    }
+}
+
+/**
+ * @brief Log counters and rates since the previous call
+ *
+ * @param elapsed_ms Time since the previous call
+ */
+static void ingest_log_stats(uint64_t elapsed_ms)
+{
+    static ingest_stats_t last;
+    ts_store_stats_t store;
+
+    TSStore_GetStats(&g_store, &store);
+    double rate = elapsed_ms ? (double)(g_stats.messages - last.messages) * 1000.0 / elapsed_ms : 0.0;
+
+    printf("[INGEST] msgs %llu (%.0f/s) | stored %llu | rejected %llu | duplicates %llu | blocks %llu | "
+           "bytes %llu | write errors %llu\n",
+           (unsigned long long)g_stats.messages, rate, (unsigned long long)g_stats.stored,
+           (unsigned long long)g_stats.rejected, (unsigned long long)g_stats.duplicates,
+           (unsigned long long)store.blocks,
+           (unsigned long long)store.bytes, (unsigned long long)store.write_errors);
+    fflush(stdout);
+    last = g_stats;
+}
+
+/**
+ * @brief Offline mode: read "topic payload" lines (mosquitto_sub -v output)
+ *
+ * @return Exit code
+ */
+static int ingest_run_stdin(void)
+{
+    char line[INGEST_LINE_MAX];
+    uint64_t start_ms = ingest_now_ms();
+
+    while (g_running && fgets(line, sizeof(line), stdin) != NULL)
+    {
+        char *space = strchr(line, ' ');
+        if (space == NULL)
+        {
+            g_stats.messages++;
+            g_stats.rejected++;
+            continue;
+        }
+        *space = '\0';
+
+        char *payload = space + 1;
+        size_t len = strcspn(payload, "\r\n");
+        ingest_handle(line, payload, len);
+    }
+
+    TSStore_Flush(&g_store);
+    ingest_log_stats(ingest_now_ms() - start_ms);
+    return 0;
+}
+
+#if INGEST_MQTT
+/**
+ * @brief Connection callback: (re)subscribe
+ */
+static void ingest_on_connect(struct mosquitto *mosq, void *obj, int rc)
+{
+    (void)obj;
+    if (rc != 0)
+    {
+        fprintf(stderr, "[MQTT] Connect refused: %s\n", mosquitto_connack_string(rc));
+        return;
+    }
+
+    for (int i = 0; i < g_config.topic_count; i++)
+    {
+        printf("[MQTT] Connected to %s:%d, subscribing to %s (QoS %d)\n",
+               g_config.host, g_config.port, g_config.topics[i], g_config.qos);
+        mosquitto_subscribe(mosq, NULL, g_config.topics[i], g_config.qos);
+    }
+    fflush(stdout);
+
+    // Refresh the retained messages (the broker may have lost them)
+    for (uint32_t i = 0; i < g_device_count; i++)
+    {
+        ts_recent_t *recent = &g_devices[i].recent;
+        recent->latest_dirty = recent->has_latest;
+        recent->samples_dirty = recent->count > 0;
+    }
+}
+
+/**
+ * @brief Message callback
+ */
+static void ingest_on_message(struct mosquitto *mosq, void *obj, const struct mosquitto_message *msg)
+{
+    (void)mosq;
+    (void)obj;
+    ingest_handle(msg->topic, msg->payload, (size_t)msg->payloadlen);
+}
+
+/**
+ * @brief Publish the retained latest reading and recent snapshot of one device when changed
+ *
+ * @param mosq Client
+ * @param d Device
+ * @param now_ms Monotonic time
+ * @param snapshot Encoding buffer (TS_RECENT_SNAPSHOT_SIZE(recent_points) bytes)
+ *
+ * @note Dashboards get both on subscribe and can draw a chart before any
+ *       new reading arrives. The snapshot is rate limited per device; a flag
+ *       is only cleared once the publish was accepted.
+ */
+static void ingest_publish_device(struct mosquitto *mosq, ingest_device_t *d, uint64_t now_ms, uint8_t *snapshot)
+{
+    char latest[TS_RECENT_LATEST_MAX];
+    ts_recent_t *recent = &d->recent;
+
+    if (recent->latest_dirty)
+    {
+        size_t len = TSRecent_FormatLatest(recent, g_config.tz_offset, latest, sizeof(latest));
+        strcpy(d->topic + d->topic_len, "latest");
+        if (len == 0 || mosquitto_publish(mosq, NULL, d->topic, (int)len, latest, 1, true) == MOSQ_ERR_SUCCESS)
+        {
+            recent->latest_dirty = false;
+        }
+    }
+
+    if (recent->samples_dirty && now_ms - d->last_snapshot_ms >= INGEST_RECENT_MS)
+    {
+        size_t len = TSRecent_Encode(recent, snapshot, TS_RECENT_SNAPSHOT_SIZE(recent->capacity));
+        strcpy(d->topic + d->topic_len, "recent");
+        if (mosquitto_publish(mosq, NULL, d->topic, (int)len, snapshot, 1, true) == MOSQ_ERR_SUCCESS)
+        {
+            recent->samples_dirty = false;
+            d->last_snapshot_ms = now_ms;
+        }
+    }
+}
+
+/**
+ * @brief Publish what changed for every device
+ *
+ * @param mosq Client
+ * @param now_ms Monotonic time
+ */
+static void ingest_publish_recent(struct mosquitto *mosq, uint64_t now_ms)
+{
+    static uint8_t *snapshot;
+
+    if (snapshot == NULL)
+    {
+        snapshot = malloc(TS_RECENT_SNAPSHOT_SIZE(g_config.recent_points));
+        if (snapshot == NULL)
+        {
+            return;
+        }
+    }
+
+    for (uint32_t i = 0; i < g_device_count; i++)
+    {
+        ingest_publish_device(mosq, &g_devices[i], now_ms, snapshot);
+    }
+}
+
+/**
+ * @brief Broker mode: subscribe and store until SIGINT/SIGTERM
+ *
+ * @return Exit code
+ */
+static int ingest_run_mqtt(void)
+{
+    struct mosquitto *mosq;
+    uint64_t last_flush_ms, last_stats_ms;
+
+    mosquitto_lib_init();
+
+    // Persistent session: QoS 1 messages are queued by the broker while the service restarts
+    mosq = mosquitto_new(g_config.client_id, false, NULL);
+    if (mosq == NULL)
+    {
+        fprintf(stderr, "[MQTT] Cannot create client\n");
+        return 1;
+    }
+
+    if (g_config.user)
+    {
+        mosquitto_username_pw_set(mosq, g_config.user, g_config.password);
+    }
+    mosquitto_connect_callback_set(mosq, ingest_on_connect);
+    mosquitto_message_callback_set(mosq, ingest_on_message);
+    mosquitto_reconnect_delay_set(mosq, 1, 30, true);
+
+    if (mosquitto_connect(mosq, g_config.host, g_config.port, 60) != MOSQ_ERR_SUCCESS)
+    {
+        fprintf(stderr, "[MQTT] Cannot reach %s:%d, retrying\n", g_config.host, g_config.port);
+    }
+
+    last_flush_ms = last_stats_ms = ingest_now_ms();
+
+    // Single thread: network, decoding and block writes share one core
+    while (g_running)
+    {
+        int rc = mosquitto_loop(mosq, 100, 1);
+        if (rc != MOSQ_ERR_SUCCESS && g_running)
+        {
+            sleep(1);
+            mosquitto_reconnect(mosq);
+        }
+
+        uint64_t now_ms = ingest_now_ms();
+        if (g_recent_enabled)
+        {
+            ingest_publish_recent(mosq, now_ms);
+        }
+        if (now_ms - last_flush_ms >= INGEST_FLUSH_MS)
+        {
+            TSStore_Flush(&g_store);
+            last_flush_ms = now_ms;
+        }
+        if (g_config.stats_interval > 0 && now_ms - last_stats_ms >= (uint64_t)g_config.stats_interval * 1000)
+        {
+            ingest_log_stats(now_ms - last_stats_ms);
+            last_stats_ms = now_ms;
+        }
+    }
+
+    mosquitto_disconnect(mosq);
+    mosquitto_destroy(mosq);
+    mosquitto_lib_cleanup();
+    return 0;
+}
+#endif
+
+/**
+ * @brief Print a segment as CSV (offline inspection)
+ *
+ * @param path Segment file
+ *
+ * @return Exit code
+ */
+static int ingest_dump(const char *path)
+{
+    static ts_sample_t samples[TS_STORE_BLOCK_MAX];
+    static const char *modes[] = {"single", "periodic", "archive", "?"};
+    ts_segment_reader_t reader;
+
+    if (!TSStore_ReaderOpen(&reader, path))
+    {
+        fprintf(stderr, "%s: not a segment file\n", path);
+        return 1;
+    }
+
+    printf("time,temperature,humidity,mode,backlog,sensor_fail,rtc_fail\n");
+    while (TSStore_ReaderNext(&reader))
+    {
+        if (!TSStore_ReaderDecode(&reader, samples))
+        {
+            fprintf(stderr, "%s: corrupt block\n", path);
+            break;
+        }
+        for (uint16_t i = 0; i < reader.header.count; i++)
+        {
+            const ts_sample_t *s = &samples[i];
+            printf("%lld,%.2f,%.2f,%s,%d,%d,%d\n", (long long)s->time,
+                   s->temperature / 100.0, s->humidity / 100.0,
+                   modes[s->flags & TS_STORE_MODE_MASK],
+                   (s->flags & TS_STORE_FLAG_BACKLOG) != 0,
+                   (s->flags & TS_STORE_FLAG_SENSOR_FAIL) != 0,
+                   (s->flags & TS_STORE_FLAG_RTC_FAIL) != 0);
+        }
+    }
+
+    TSStore_ReaderClose(&reader);
+    return 0;
+}
+
+/**
+ * @brief Print usage
+ *
+ * @param prog Program name
+ */
+static void ingest_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "       %s dump <segment.seg>\n"
+            "  -h host       Broker host (localhost)\n"
+            "  -p port       Broker port (1883)\n"
+            "  -u user       Username (password from MQTT_PASSWORD)\n"
+            "  -i id         Client id, persistent session (datalogger_ingest)\n"
+            "  -t topic      Subscription, repeatable (" INGEST_TOPIC_DEFAULT "\n"
+            "                and " INGEST_TOPIC_LEGACY ")\n"
+            "  -q qos        Subscription QoS (1)\n"
+            "  -d device     Store device for topics without a device level (" INGEST_DEVICE_DEFAULT ")\n"
+            "  -D dir        Data directory (./data)\n"
+            "  -z seconds    Device RTC offset from UTC (25200)\n"
+            "  -s seconds    Stats interval, 0 = off (60)\n"
+            "  -H points     Periodic points in the retained <device>/" INGEST_RECENT_TOPIC "/recent\n"
+            "                snapshot, 0 = no latest/recent topics (500)\n"
+            "  -S            fsync() every block\n"
+            "  -             Read \"topic payload\" lines from stdin instead of a broker\n",
+            prog, prog);
+}
+
+/* MAIN ----------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    int opt;
+
+    if (argc == 3 && strcmp(argv[1], "dump") == 0)
+    {
+        return ingest_dump(argv[2]);
+    }
+
+    while ((opt = getopt(argc, argv, "h:p:u:i:t:q:d:D:z:s:H:S")) != -1)
+    {
+        switch (opt)
+        {
+        case 'h':
+            g_config.host = optarg;
+            break;
+        case 'p':
+            g_config.port = atoi(optarg);
+            break;
+        case 'u':
+            g_config.user = optarg;
+            break;
+        case 'i':
+            g_config.client_id = optarg;
+            break;
+        case 't':
+            if (g_config.topic_count == INGEST_TOPICS_MAX)
+            {
+                fprintf(stderr, "Too many -t options (max %d)\n", INGEST_TOPICS_MAX);
+                return 2;
+            }
+            g_config.topics[g_config.topic_count++] = optarg;
+            break;
+        case 'q':
+            g_config.qos = atoi(optarg);
+            break;
+        case 'd':
+            g_config.device = optarg;
+            break;
+        case 'D':
+            g_config.data_dir = optarg;
+            break;
+        case 'z':
+            g_config.tz_offset = atol(optarg);
+            break;
+        case 's':
+            g_config.stats_interval = atoi(optarg);
+            break;
+        case 'H':
+            g_config.recent_points = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'S':
+            g_config.sync = true;
+            break;
+        default:
+            ingest_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (optind < argc && strcmp(argv[optind], "-") == 0)
+    {
+        g_config.from_stdin = true;
+    }
+    // Gateways on older firmware publish without a device level (stored as -d)
+    if (g_config.topic_count == 0)
+    {
+        g_config.topics[g_config.topic_count++] = INGEST_TOPIC_DEFAULT;
+        g_config.topics[g_config.topic_count++] = INGEST_TOPIC_LEGACY;
+    }
+    // Keep the password off the command line (visible in ps)
+    g_config.password = getenv("MQTT_PASSWORD");
+
+    if (!TSStore_Open(&g_store, g_config.data_dir, g_config.sync))
+    {
+        fprintf(stderr, "Cannot open store in %s\n", g_config.data_dir);
+        return 1;
+    }
+
+    signal(SIGINT, ingest_on_signal);
+    signal(SIGTERM, ingest_on_signal);
+
+    int rc;
+    if (g_config.from_stdin)
+    {
+        rc = ingest_run_stdin();
+    }
+    else
+    {
+#if INGEST_MQTT
+        if (g_config.recent_points > TS_RECENT_POINTS_MAX)
+        {
+            fprintf(stderr, "Recent window too large (-H 0..%d)\n", TS_RECENT_POINTS_MAX);
+            TSStore_Close(&g_store);
+            return 2;
+        }
+        // Windows are loaded from the store on each device's first message
+        g_recent_enabled = g_config.recent_points > 0;
+        rc = ingest_run_mqtt();
+        for (uint32_t i = 0; i < g_device_count; i++)
+        {
+            TSRecent_Free(&g_devices[i].recent);
+        }
+#else
+        fprintf(stderr, "Built without libmosquitto, use '-' to read from stdin\n");
+        rc = 2;
+#endif
+    }
+
+    TSStore_Close(&g_store);
+    return rc;
+}
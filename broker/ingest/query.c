@@ -0,0 +1,737 @@
+/**
+ * @file query.c
+ *
+ * @brief DATALOGGER Query Service - Read-only HTTP API over the local time-series store
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include "ts_query.h"
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <errno.h>
+#include <getopt.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+#define QUERY_PORT_DEFAULT 8090
+#define QUERY_BIND_DEFAULT "127.0.0.1"
+#define QUERY_DEVICE_DEFAULT "ESP32_01" // Same default as the ingest service
+#define QUERY_REQUEST_MAX 8192          // Request line and headers
+#define QUERY_PARAM_MAX 128             // Decoded key or value
+#define QUERY_TIMEOUT_S 5               // Receive timeout per client
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Service configuration (command line)
+ */
+typedef struct
+{
+    const char *bind;
+    int port;
+    const char *device;
+    const char *data_dir;
+} query_config_t;
+
+/**
+ * @brief Growable response buffer
+ */
+typedef struct
+{
+    char *data;
+    size_t len;
+    size_t cap;
+    bool failed; // Out of memory
+} query_buf_t;
+
+/* PRIVATE VARIABLES ---------------------------------------------------------*/
+
+static query_config_t g_config = {
+    .bind = QUERY_BIND_DEFAULT,
+    .port = QUERY_PORT_DEFAULT,
+    .device = QUERY_DEVICE_DEFAULT,
+    .data_dir = "./data",
+};
+
+static const char *const g_modes[] = {"single", "periodic", "archive"};
+static const char *const g_sorts[] = {"time-desc", "time-asc", "temp-desc",
+                                      "temp-asc", "humi-desc", "humi-asc"};
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+/**
+ * @brief Monotonic time in microseconds
+ *
+ * @return Microseconds
+ */
+static uint64_t query_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Append formatted text to a buffer
+ *
+ * @param b Buffer
+ * @param fmt printf() format
+ */
+static void query_printf(query_buf_t *b, const char *fmt, ...)
+{
+    va_list args;
+
+    for (;;)
+    {
+        if (b->failed)
+        {
+            return;
+        }
+
+        va_start(args, fmt);
+        int n = vsnprintf(b->data ? b->data + b->len : NULL, b->cap - b->len, fmt, args);
+        va_end(args);
+
+        if (n < 0)
+        {
+            b->failed = true;
+            return;
+        }
+        if ((size_t)n < b->cap - b->len)
+        {
+            b->len += (size_t)n;
+            return;
+        }
+
+        size_t cap = b->cap ? b->cap * 2 : 4096;
+        while (cap - b->len <= (size_t)n)
+        {
+            cap *= 2;
+        }
+        char *data = realloc(b->data, cap);
+        if (data == NULL)
+        {
+            b->failed = true;
+            return;
+        }
+        b->data = data;
+        b->cap = cap;
+    }
+}
+
+/**
+ * @brief Decode a URL-encoded component
+ *
+ * @param out Output buffer (QUERY_PARAM_MAX bytes)
+ * @param in Input
+ * @param len Input length
+ *
+ * @return false if the result does not fit or an escape is invalid
+ */
+static bool query_url_decode(char *out, const char *in, size_t len)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        char c = in[i];
+        if (c == '+')
+        {
+            c = ' ';
+        }
+        else if (c == '%')
+        {
+            unsigned int v;
+            if (i + 2 >= len || !isxdigit((unsigned char)in[i + 1]) ||
+                !isxdigit((unsigned char)in[i + 2]) || sscanf(in + i + 1, "%2x", &v) != 1)
+            {
+                return false;
+            }
+            c = (char)v;
+            i += 2;
+        }
+
+        if (n + 1 >= QUERY_PARAM_MAX)
+        {
+            return false;
+        }
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    return true;
+}
+
+/**
+ * @brief Parse a whole decimal integer
+ *
+ * @param text Text
+ * @param value Output value
+ *
+ * @return true if the text is a number without trailing characters
+ */
+static bool query_parse_int(const char *text, int64_t *value)
+{
+    char *end;
+
+    errno = 0;
+    long long v = strtoll(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0')
+    {
+        return false;
+    }
+    *value = v;
+    return true;
+}
+
+/**
+ * @brief Parse a bound in degrees/percent into 0.01 fixed point
+ *
+ * @param text Text
+ * @param upper true for a maximum (rounded down), false for a minimum (rounded up)
+ * @param value Output value
+ *
+ * @return true if the text is a number within range
+ *
+ * @note Rounding inward keeps the bound exact: temp_min=25.305 must not
+ *       match 25.30. Values that are already 0.01 steps (25.3 * 100 =
+ *       2529.9999...) are snapped first.
+ */
+static bool query_parse_fixed(const char *text, bool upper, int32_t *value)
+{
+    char *end;
+    double x = strtod(text, &end) * 100.0;
+
+    if (end == text || *end != '\0' || !isfinite(x) || fabs(x) > 2e9)
+    {
+        return false;
+    }
+
+    double r = round(x);
+    *value = (int32_t)(fabs(x - r) < 1e-6 ? r : (upper ? floor(x) : ceil(x)));
+    return true;
+}
+
+/**
+ * @brief Find a name in a table
+ *
+ * @param name Name
+ * @param table Names
+ * @param count Table size
+ *
+ * @return Index, -1 if not found
+ */
+static int query_lookup(const char *name, const char *const *table, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(name, table[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Parse a query string into a query
+ *
+ * @param qs Query string (without '?'), may be NULL
+ * @param query Output query
+ * @param error Output error message
+ *
+ * @return true if every known parameter is valid (unknown ones are ignored,
+ *         e.g. cache busters)
+ */
+static bool query_parse(const char *qs, ts_query_t *query, const char **error)
+{
+    char key[QUERY_PARAM_MAX], value[QUERY_PARAM_MAX];
+    int64_t n;
+
+    TSQuery_Init(query, g_config.device);
+
+    while (qs && *qs)
+    {
+        const char *amp = strchr(qs, '&');
+        size_t len = amp ? (size_t)(amp - qs) : strlen(qs);
+        const char *eq = memchr(qs, '=', len);
+
+        if (eq == NULL || !query_url_decode(key, qs, (size_t)(eq - qs)) ||
+            !query_url_decode(value, eq + 1, len - (size_t)(eq - qs) - 1))
+        {
+            *error = "malformed query string";
+            return false;
+        }
+        qs = amp ? amp + 1 : NULL;
+
+        if (strcmp(key, "device") == 0)
+        {
+            // Directory name: same character set the store accepts
+            if (!value[0] || strlen(value) >= sizeof(query->device) ||
+                value[strspn(value, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_-")])
+            {
+                *error = "invalid device";
+                return false;
+            }
+            strcpy(query->device, value);
+        }
+        else if (strcmp(key, "from") == 0 || strcmp(key, "to") == 0)
+        {
+            if (!query_parse_int(value, &n))
+            {
+                *error = "from/to must be Unix seconds";
+                return false;
+            }
+            *(key[0] == 'f' ? &query->from : &query->to) = n;
+        }
+        else if (strcmp(key, "mode") == 0)
+        {
+            if (value[0] && (query->mode = query_lookup(value, g_modes, 3)) < 0)
+            {
+                *error = "mode must be single, periodic or archive";
+                return false;
+            }
+        }
+        else if (strcmp(key, "status") == 0)
+        {
+            if (strcmp(value, "success") == 0)
+                query->status = TS_QUERY_STATUS_SUCCESS;
+            else if (strcmp(value, "error") == 0)
+                query->status = TS_QUERY_STATUS_ERROR;
+            else if (value[0])
+            {
+                *error = "status must be success or error";
+                return false;
+            }
+        }
+        else if (strcmp(key, "temp_min") == 0 || strcmp(key, "temp_max") == 0 ||
+                 strcmp(key, "humi_min") == 0 || strcmp(key, "humi_max") == 0)
+        {
+            bool upper = strcmp(key + 5, "max") == 0;
+            int32_t *bound = key[0] == 't' ? (upper ? &query->temp_max : &query->temp_min)
+                                           : (upper ? &query->humi_max : &query->humi_min);
+            if (value[0] && !query_parse_fixed(value, upper, bound))
+            {
+                *error = "invalid temperature/humidity bound";
+                return false;
+            }
+        }
+        else if (strcmp(key, "sort") == 0)
+        {
+            int sort = query_lookup(value, g_sorts, 6);
+            if (sort < 0)
+            {
+                *error = "sort must be (time|temp|humi)-(asc|desc)";
+                return false;
+            }
+            query->sort = (ts_query_sort_t)sort;
+        }
+        else if (strcmp(key, "limit") == 0 || strcmp(key, "offset") == 0 ||
+                 strcmp(key, "points") == 0)
+        {
+            if (!query_parse_int(value, &n) || n < 0 || n > UINT32_MAX)
+            {
+                *error = "limit/offset/points must be positive integers";
+                return false;
+            }
+            if (key[0] == 'l')
+                query->limit = (uint32_t)n;
+            else if (key[0] == 'o')
+                query->offset = (uint32_t)n;
+            else
+                query->points = (uint32_t)n;
+        }
+    }
+
+    if (query->from > query->to)
+    {
+        *error = "from is after to";
+        return false;
+    }
+    if (query->limit > TS_QUERY_LIMIT_MAX ||
+        (uint64_t)query->offset + query->limit > TS_QUERY_WINDOW_MAX)
+    {
+        *error = "limit above 100000 or offset + limit above 1000000";
+        return false;
+    }
+    if (query->points > TS_QUERY_POINTS_MAX)
+    {
+        *error = "points above 10000";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Append min/avg/max of a summary as JSON fields
+ *
+ * @param b Buffer
+ * @param s Summary
+ */
+static void query_put_aggregates(query_buf_t *b, const ts_query_summary_t *s)
+{
+    if (s->valid == 0)
+    {
+        query_printf(b, "\"temp_min\":null,\"temp_avg\":null,\"temp_max\":null,"
+                        "\"humi_min\":null,\"humi_avg\":null,\"humi_max\":null");
+        return;
+    }
+    query_printf(b, "\"temp_min\":%.2f,\"temp_avg\":%.2f,\"temp_max\":%.2f,"
+                    "\"humi_min\":%.2f,\"humi_avg\":%.2f,\"humi_max\":%.2f",
+                 s->temp_min / 100.0, (double)s->temp_sum / s->valid / 100.0, s->temp_max / 100.0,
+                 s->humi_min / 100.0, (double)s->humi_sum / s->valid / 100.0, s->humi_max / 100.0);
+}
+
+/**
+ * @brief Run a query and render it as JSON
+ *
+ * @param qs Query string (may be NULL)
+ * @param b Response body
+ *
+ * @return HTTP status code
+ */
+static int query_readings(const char *qs, query_buf_t *b)
+{
+    ts_query_t query;
+    ts_query_result_t result;
+    const char *error = NULL;
+
+    if (!query_parse(qs, &query, &error))
+    {
+        query_printf(b, "{\"error\":\"%s\"}", error);
+        return 400;
+    }
+
+    uint64_t start = query_now_us();
+    if (!TSQuery_Run(g_config.data_dir, &query, &result))
+    {
+        query_printf(b, "{\"error\":\"query failed\"}");
+        return 500;
+    }
+    uint64_t elapsed = query_now_us() - start;
+
+    const ts_query_summary_t *s = &result.summary;
+    query_printf(b, "{\"device\":\"%s\",\"total\":%llu,\"valid\":%llu,", query.device,
+                 (unsigned long long)s->count, (unsigned long long)s->valid);
+    if (s->count > 0)
+    {
+        query_printf(b, "\"time_min\":%lld,\"time_max\":%lld,",
+                     (long long)s->time_min, (long long)s->time_max);
+    }
+    query_put_aggregates(b, s);
+
+    if (query.points > 0)
+    {
+        // Empty buckets are left out (gaps in the chart)
+        query_printf(b, ",\"bucket_seconds\":%lld,\"points\":[", (long long)result.bucket_seconds);
+        bool first = true;
+        for (uint32_t i = 0; i < result.bucket_count; i++)
+        {
+            const ts_query_summary_t *p = &result.buckets[i];
+            if (p->count == 0)
+            {
+                continue;
+            }
+            query_printf(b, "%s{\"time\":%lld,\"count\":%llu,", first ? "" : ",",
+                         (long long)(result.bucket_start + (int64_t)i * result.bucket_seconds),
+                         (unsigned long long)p->count);
+            query_put_aggregates(b, p);
+            query_printf(b, "}");
+            first = false;
+        }
+        query_printf(b, "]");
+    }
+    else
+    {
+        query_printf(b, ",\"offset\":%u,\"limit\":%u,\"rows\":[", query.offset, query.limit);
+        for (uint32_t i = 0; i < result.row_count; i++)
+        {
+            const ts_sample_t *r = &result.rows[i];
+            const char *err = (r->flags & TS_STORE_FLAG_SENSOR_FAIL) ? "\"sensor_fail\""
+                              : (r->flags & TS_STORE_FLAG_RTC_FAIL)  ? "\"rtc_fail\""
+                                                                     : "null";
+            int mode = r->flags & TS_STORE_MODE_MASK;
+            query_printf(b,
+                         "%s{\"time\":%lld,\"temp\":%.2f,\"humi\":%.2f,\"mode\":\"%s\","
+                         "\"backlog\":%s,\"status\":\"%s\",\"error\":%s}",
+                         i ? "," : "", (long long)r->time, r->temperature / 100.0,
+                         r->humidity / 100.0, mode < 3 ? g_modes[mode] : "single",
+                         (r->flags & TS_STORE_FLAG_BACKLOG) ? "true" : "false",
+                         (r->flags & TS_STORE_FLAG_SENSOR_FAIL) ? "error" : "success", err);
+        }
+        query_printf(b, "]");
+    }
+
+    query_printf(b,
+                 ",\"scan\":{\"segments\":%u,\"blocks\":%llu,\"skipped\":%llu,"
+                 "\"summarized\":%llu,\"decoded\":%llu,\"elapsed_us\":%llu}}",
+                 result.segments, (unsigned long long)result.blocks,
+                 (unsigned long long)result.blocks_skipped,
+                 (unsigned long long)result.blocks_summarized,
+                 (unsigned long long)result.blocks_decoded, (unsigned long long)elapsed);
+
+    TSQuery_Free(&result);
+    return 200;
+}
+
+/**
+ * @brief Write a whole buffer to a socket
+ *
+ * @param fd Socket
+ * @param data Data
+ * @param len Length
+ */
+static void query_write_all(int fd, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+        if (n <= 0)
+        {
+            return;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+/**
+ * @brief Send a response and close the connection
+ *
+ * @param fd Client socket
+ * @param status HTTP status code
+ * @param body Response body (JSON), may be empty
+ */
+static void query_respond(int fd, int status, const query_buf_t *body)
+{
+    const char *reason = status == 200   ? "OK"
+                         : status == 204 ? "No Content"
+                         : status == 400 ? "Bad Request"
+                         : status == 404 ? "Not Found"
+                         : status == 405 ? "Method Not Allowed"
+                                         : "Internal Server Error";
+    char head[512];
+
+    // The dashboard is opened from another origin (file:// or a static host)
+    int n = snprintf(head, sizeof(head),
+                     "HTTP/1.1 %d %s\r\n"
+                     "Content-Type: application/json\r\n"
+                     "Content-Length: %zu\r\n"
+                     "Access-Control-Allow-Origin: *\r\n"
+                     "Access-Control-Allow-Methods: GET, OPTIONS\r\n"
+                     "Cache-Control: no-store\r\n"
+                     "Connection: close\r\n\r\n",
+                     status, reason, body->len);
+    query_write_all(fd, head, (size_t)n);
+    query_write_all(fd, body->data, body->len);
+}
+
+/**
+ * @brief Serve one client request
+ *
+ * @param fd Client socket
+ */
+static void query_serve_client(int fd)
+{
+    char request[QUERY_REQUEST_MAX];
+    size_t len = 0;
+    query_buf_t body = {0};
+    int status;
+
+    struct timeval tv = {.tv_sec = QUERY_TIMEOUT_S};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    // Only the request line is used, read until the end of the headers
+    while (len < sizeof(request) - 1)
+    {
+        ssize_t n = read(fd, request + len, sizeof(request) - 1 - len);
+        if (n <= 0)
+        {
+            return;
+        }
+        len += (size_t)n;
+        request[len] = '\0';
+        if (strstr(request, "\r\n\r\n"))
+        {
+            break;
+        }
+    }
+
+    char *method = request;
+    char *target = strchr(request, ' ');
+    char *version = target ? strchr(target + 1, ' ') : NULL;
+    if (version == NULL)
+    {
+        return;
+    }
+    *target++ = '\0';
+    *version = '\0';
+
+    char *qs = strchr(target, '?');
+    if (qs)
+    {
+        *qs++ = '\0';
+    }
+
+    uint64_t start = query_now_us();
+    if (strcmp(method, "OPTIONS") == 0)
+    {
+        status = 204;
+    }
+    else if (strcmp(method, "GET") != 0)
+    {
+        status = 405;
+    }
+    else if (strcmp(target, "/api/readings") == 0)
+    {
+        status = query_readings(qs, &body);
+    }
+    else if (strcmp(target, "/health") == 0)
+    {
+        query_printf(&body, "{\"status\":\"ok\"}");
+        status = 200;
+    }
+    else
+    {
+        query_printf(&body, "{\"error\":\"not found\"}");
+        status = 404;
+    }
+
+    if (body.failed)
+    {
+        body.len = 0;
+        status = 500;
+    }
+    query_respond(fd, status, &body);
+
+    printf("[QUERY] %s %s%s%s %d %zu bytes %.1f ms\n", method, target, qs ? "?" : "", qs ? qs : "",
+           status, body.len, (query_now_us() - start) / 1000.0);
+    fflush(stdout);
+    free(body.data);
+}
+
+/**
+ * @brief Accept and serve clients one at a time
+ *
+ * @return Exit code
+ */
+static int query_serve(void)
+{
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons((uint16_t)g_config.port)};
+    int one = 1;
+
+    if (inet_pton(AF_INET, g_config.bind, &addr.sin_addr) != 1)
+    {
+        fprintf(stderr, "Invalid bind address %s\n", g_config.bind);
+        return 2;
+    }
+
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0 || setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+        bind(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(sock, 16) != 0)
+    {
+        fprintf(stderr, "Cannot listen on %s:%d: %s\n", g_config.bind, g_config.port, strerror(errno));
+        return 1;
+    }
+
+    printf("[QUERY] Serving %s on http://%s:%d/api/readings\n", g_config.data_dir, g_config.bind,
+           g_config.port);
+    fflush(stdout);
+
+    for (;;)
+    {
+        int client = accept(sock, NULL, NULL);
+        if (client < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            fprintf(stderr, "accept: %s\n", strerror(errno));
+            break;
+        }
+        query_serve_client(client);
+        close(client);
+    }
+
+    close(sock);
+    return 1;
+}
+
+/**
+ * @brief Print usage
+ *
+ * @param prog Program name
+ */
+static void query_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "       %s [options] -q 'from=...&to=...'   Run one query, print JSON\n"
+            "  -b address    Bind address (" QUERY_BIND_DEFAULT ")\n"
+            "  -p port       HTTP port (8090)\n"
+            "  -d device     Default device id (" QUERY_DEVICE_DEFAULT ")\n"
+            "  -D dir        Data directory (./data)\n"
+            "  -q query      Run one query string and exit\n",
+            prog, prog);
+}
+
+/* MAIN ----------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    const char *once = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:p:d:D:q:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'b':
+            g_config.bind = optarg;
+            break;
+        case 'p':
+            g_config.port = atoi(optarg);
+            break;
+        case 'd':
+            g_config.device = optarg;
+            break;
+        case 'D':
+            g_config.data_dir = optarg;
+            break;
+        case 'q':
+            once = optarg;
+            break;
+        default:
+            query_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (once)
+    {
+        query_buf_t body = {0};
+        int status = query_readings(once, &body);
+        if (body.len)
+        {
+            fwrite(body.data, 1, body.len, stdout);
+        }
+        putchar('\n');
+        free(body.data);
+        return status == 200 ? 0 : 1;
+    }
+
+    // A client closing early must not kill the service
+    signal(SIGPIPE, SIG_IGN);
+    return query_serve();
+}
@@ -0,0 +1,76 @@
+#!/bin/sh
+# DATALOGGER ingest regression test (make test, or make MQTT=0 test)
+#
+# Replays capture.txt (mosquitto_sub -v format) plus one generated day of
+# periodic readings through datalogger_ingest in stdin mode. Prints the
+# stats line, every segment as CSV and a set of datalogger_query results,
+# then compares the output with expected.txt. Timings (rate, elapsed_us)
+# are masked.
+#
+#   UPDATE=1 sh test/run.sh   Rewrite expected.txt after an intended change
+
+set -eu
+
+export LC_ALL=C
+
+cd "$(dirname "$0")"
+
+OUT=out
+INGEST=../datalogger_ingest
+QUERY=../datalogger_query
+
+rm -rf "$OUT"
+mkdir -p "$OUT"
+
+# Device SYN: 2880 readings 30 s apart on 2025-10-17 (three full blocks), so queries skip and summarize blocks
+awk 'BEGIN {
+    for (i = 0; i < 2880; i++)
+        printf "datalogger/SYN/stm32/periodic/data {\"mode\":\"PERIODIC\",\"timestamp\":%d,\"temperature\":%d.%02d,\"humidity\":%d.%d}\n",
+               1760684400 + i * 30, 20 + int(i / 288), (i * 7) % 100, 50 + i % 20, i % 10
+}' > "$OUT/generated.txt"
+
+{
+    cat capture.txt "$OUT/generated.txt" | "$INGEST" -D "$OUT/history" - | sed 's| ([0-9]*/s)||'
+
+    for seg in $(cd "$OUT/history" && ls */*.seg); do
+        echo "== dump $seg"
+        if [ "${seg%%/*}" = SYN ]; then
+            "$INGEST" dump "$OUT/history/$seg" | sed -n '1,4p;$p'
+        else
+            "$INGEST" dump "$OUT/history/$seg"
+        fi
+    done
+
+    while IFS= read -r q; do
+        echo "== query $q"
+        "$QUERY" -D "$OUT/history" -q "$q" | sed 's/"elapsed_us":[0-9]*/"elapsed_us":0/' || true
+    done <<QUERIES
+device=GW1
+device=GW1&from=1760662800&to=1760662815
+device=GW1&mode=single&sort=time-asc
+device=GW1&mode=archive
+device=GW1&status=error
+device=GW1&status=success&temp_min=24.1&temp_max=25.2&sort=temp-asc
+device=GW1&sort=humi-desc&limit=3&offset=2
+device=GW1&from=1760660000&to=1760662819&points=4
+device=ESP32_01
+device=GW2
+device=SYN&from=1760686200&to=1760686500&sort=time-asc
+device=SYN&sort=time-asc&limit=2&offset=1500
+device=SYN&temp_min=29.9&sort=temp-desc&limit=3
+device=SYN&humi_max=50.0&limit=2
+device=SYN&mode=single
+device=SYN&points=6
+device=SYN&mode=bogus
+QUERIES
+} > "$OUT/actual.txt"
+
+if [ "${UPDATE:-0}" = 1 ]; then
+    cp "$OUT/actual.txt" expected.txt
+    echo "expected.txt updated"
+elif diff -u expected.txt "$OUT/actual.txt"; then
+    echo "PASS"
+else
+    echo "FAIL: output differs from expected.txt"
+    exit 1
+fi
@@ -0,0 +1,692 @@
+/**
+ * @file ts_query.c
+ *
+ * @brief Time-Series Query Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include "ts_query.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Row candidate (seq = scan position, last tie-breaker)
+ */
+typedef struct
+{
+    ts_sample_t sample;
+    uint64_t seq;
+} ts_query_row_t;
+
+/**
+ * @brief How much of a block matches the query, from its summary
+ */
+typedef enum
+{
+    TS_BLOCK_NONE = 0, // No sample can match
+    TS_BLOCK_SOME,     // Must be decoded
+    TS_BLOCK_ALL       // Every sample matches
+} ts_block_match_t;
+
+/**
+ * @brief Scan state
+ */
+typedef struct
+{
+    const ts_query_t *query;
+    ts_query_result_t *result;
+    ts_query_row_t *heap; // Best offset + limit rows so far, worst at the root
+    uint32_t heap_len;
+    uint32_t heap_cap;
+    uint64_t seq;
+} ts_query_scan_t;
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+/**
+ * @brief Days since epoch of a Unix time (floor)
+ *
+ * @param time Unix time in seconds
+ *
+ * @return Day number
+ */
+static int64_t ts_query_day(int64_t time)
+{
+    int64_t day = time / TS_STORE_DAY_SECONDS;
+    return (time % TS_STORE_DAY_SECONDS < 0) ? day - 1 : day;
+}
+
+/**
+ * @brief Days since epoch of a civil date (proleptic Gregorian)
+ *
+ * @param y Year
+ * @param m Month (1-12)
+ * @param d Day (1-31)
+ *
+ * @return Day number
+ */
+static int64_t ts_query_days_from_civil(int64_t y, int m, int d)
+{
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief qsort() comparator for day numbers
+ */
+static int ts_query_cmp_day(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief List the day segments of a device within a day range
+ *
+ * @param root Data directory
+ * @param device Device id
+ * @param first First day
+ * @param last Last day
+ * @param days Output array of TS_QUERY_SEGMENTS_MAX entries, sorted
+ *
+ * @return Number of segments (the directory is listed once instead of
+ *         probing every day of a multi-year range)
+ */
+static uint32_t ts_query_list_days(const char *root, const char *device,
+                                   int64_t first, int64_t last, int64_t *days)
+{
+    char path[TS_STORE_PATH_MAX];
+    uint32_t n = 0;
+    struct dirent *entry;
+
+    if (snprintf(path, sizeof(path), "%s/%s", root, device) >= (int)sizeof(path))
+    {
+        return 0;
+    }
+
+    DIR *dir = opendir(path);
+    if (dir == NULL)
+    {
+        return 0;
+    }
+
+    while ((entry = readdir(dir)) != NULL && n < TS_QUERY_SEGMENTS_MAX)
+    {
+        int y, m, d;
+        char tail[8];
+
+        // YYYY-MM-DD.seg (compaction leftovers end in .tmp)
+        if (strlen(entry->d_name) != 14 ||
+            sscanf(entry->d_name, "%4d-%2d-%2d%7s", &y, &m, &d, tail) != 4 ||
+            strcmp(tail, ".seg") != 0 || m < 1 || m > 12 || d < 1 || d > 31)
+        {
+            continue;
+        }
+
+        int64_t day = ts_query_days_from_civil(y, m, d);
+        if (day >= first && day <= last)
+        {
+            days[n++] = day;
+        }
+    }
+    closedir(dir);
+
+    qsort(days, n, sizeof(*days), ts_query_cmp_day);
+    return n;
+}
+
+/**
+ * @brief Reset a summary to empty
+ *
+ * @param s Summary
+ */
+static void ts_query_summary_init(ts_query_summary_t *s)
+{
+    memset(s, 0, sizeof(*s));
+    s->time_min = INT64_MAX;
+    s->time_max = INT64_MIN;
+    s->temp_min = s->humi_min = INT32_MAX;
+    s->temp_max = s->humi_max = INT32_MIN;
+}
+
+/**
+ * @brief Add one sample to a summary
+ *
+ * @param s Summary
+ * @param sample Sample
+ */
+static void ts_query_summary_add(ts_query_summary_t *s, const ts_sample_t *sample)
+{
+    s->count++;
+    if (sample->time < s->time_min)
+        s->time_min = sample->time;
+    if (sample->time > s->time_max)
+        s->time_max = sample->time;
+
+    if (sample->flags & TS_STORE_FLAG_SENSOR_FAIL)
+    {
+        return;
+    }
+    s->valid++;
+    s->temp_sum += sample->temperature;
+    s->humi_sum += sample->humidity;
+    if (sample->temperature < s->temp_min)
+        s->temp_min = sample->temperature;
+    if (sample->temperature > s->temp_max)
+        s->temp_max = sample->temperature;
+    if (sample->humidity < s->humi_min)
+        s->humi_min = sample->humidity;
+    if (sample->humidity > s->humi_max)
+        s->humi_max = sample->humidity;
+}
+
+/**
+ * @brief Add a whole block to a summary without decoding it
+ *
+ * @param s Summary
+ * @param h Block header
+ */
+static void ts_query_summary_add_block(ts_query_summary_t *s, const ts_block_header_t *h)
+{
+    s->count += h->count;
+    if (h->time_min < s->time_min)
+        s->time_min = h->time_min;
+    if (h->time_max > s->time_max)
+        s->time_max = h->time_max;
+
+    if (h->valid == 0)
+    {
+        return;
+    }
+    s->valid += h->valid;
+    s->temp_sum += h->temp_sum;
+    s->humi_sum += h->humi_sum;
+    if (h->temp_min < s->temp_min)
+        s->temp_min = h->temp_min;
+    if (h->temp_max > s->temp_max)
+        s->temp_max = h->temp_max;
+    if (h->humi_min < s->humi_min)
+        s->humi_min = h->humi_min;
+    if (h->humi_max > s->humi_max)
+        s->humi_max = h->humi_max;
+}
+
+/**
+ * @brief Check one sample against the query
+ *
+ * @param q Query
+ * @param s Sample
+ *
+ * @return true if it matches
+ */
+static bool ts_query_match(const ts_query_t *q, const ts_sample_t *s)
+{
+    bool fail = (s->flags & TS_STORE_FLAG_SENSOR_FAIL) != 0;
+
+    if (s->time < q->from || s->time > q->to)
+        return false;
+    if (q->mode != TS_QUERY_MODE_ANY && (s->flags & TS_STORE_MODE_MASK) != q->mode)
+        return false;
+    if ((q->status == TS_QUERY_STATUS_SUCCESS && fail) ||
+        (q->status == TS_QUERY_STATUS_ERROR && !fail))
+        return false;
+    if (s->temperature < q->temp_min || s->temperature > q->temp_max)
+        return false;
+    if (s->humidity < q->humi_min || s->humidity > q->humi_max)
+        return false;
+    return true;
+}
+
+/**
+ * @brief Decide from a block summary how much of it matches
+ *
+ * @param q Query
+ * @param h Block header
+ *
+ * @return TS_BLOCK_NONE, TS_BLOCK_SOME or TS_BLOCK_ALL
+ *
+ * @details Valid samples lie within the summary min/max. Failed samples
+ *          (count - valid) hold 0/0, so they are checked as that one value.
+ *          The mode is not summarized: a mode filter never yields ALL.
+ */
+static ts_block_match_t ts_query_block_match(const ts_query_t *q, const ts_block_header_t *h)
+{
+    uint16_t failed = h->count - h->valid;
+
+    if (h->time_max < q->from || h->time_min > q->to)
+    {
+        return TS_BLOCK_NONE;
+    }
+
+    bool valid_none = h->valid == 0 || q->status == TS_QUERY_STATUS_ERROR ||
+                      h->temp_max < q->temp_min || h->temp_min > q->temp_max ||
+                      h->humi_max < q->humi_min || h->humi_min > q->humi_max;
+    bool valid_all = h->valid == 0 ||
+                     (q->status != TS_QUERY_STATUS_ERROR &&
+                      h->temp_min >= q->temp_min && h->temp_max <= q->temp_max &&
+                      h->humi_min >= q->humi_min && h->humi_max <= q->humi_max);
+
+    bool zero_in = q->temp_min <= 0 && q->temp_max >= 0 && q->humi_min <= 0 && q->humi_max >= 0;
+    bool failed_none = failed == 0 || q->status == TS_QUERY_STATUS_SUCCESS || !zero_in;
+    bool failed_all = failed == 0 || (q->status != TS_QUERY_STATUS_SUCCESS && zero_in);
+
+    if (valid_none && failed_none)
+    {
+        return TS_BLOCK_NONE;
+    }
+
+    if (valid_all && failed_all && q->mode == TS_QUERY_MODE_ANY &&
+        h->time_min >= q->from && h->time_max <= q->to)
+    {
+        return TS_BLOCK_ALL;
+    }
+    return TS_BLOCK_SOME;
+}
+
+/**
+ * @brief Sort key of a sample
+ *
+ * @param sort Row order
+ * @param s Sample
+ *
+ * @return Key value
+ */
+static int64_t ts_query_key(ts_query_sort_t sort, const ts_sample_t *s)
+{
+    switch (sort)
+    {
+    case TS_QUERY_SORT_TEMP_DESC:
+    case TS_QUERY_SORT_TEMP_ASC:
+        return s->temperature;
+    case TS_QUERY_SORT_HUMI_DESC:
+    case TS_QUERY_SORT_HUMI_ASC:
+        return s->humidity;
+    default:
+        return s->time;
+    }
+}
+
+/**
+ * @brief Check whether a row comes before another in the requested order
+ *
+ * @param sort Row order
+ * @param a First row
+ * @param b Second row
+ *
+ * @return true if a ranks before b (ties: time, then scan position, same direction)
+ */
+static bool ts_query_before(ts_query_sort_t sort, const ts_query_row_t *a, const ts_query_row_t *b)
+{
+    bool desc = (sort == TS_QUERY_SORT_TIME_DESC || sort == TS_QUERY_SORT_TEMP_DESC ||
+                 sort == TS_QUERY_SORT_HUMI_DESC);
+    int64_t ka = ts_query_key(sort, &a->sample);
+    int64_t kb = ts_query_key(sort, &b->sample);
+
+    if (ka != kb)
+        return desc ? ka > kb : ka < kb;
+    if (a->sample.time != b->sample.time)
+        return desc ? a->sample.time > b->sample.time : a->sample.time < b->sample.time;
+    return desc ? a->seq > b->seq : a->seq < b->seq;
+}
+
+/**
+ * @brief Restore the heap below a node (worst row at the root)
+ *
+ * @param scan Scan state
+ * @param i Node index
+ * @param len Heap length
+ */
+static void ts_query_sift_down(ts_query_scan_t *scan, uint32_t i, uint32_t len)
+{
+    ts_query_sort_t sort = scan->query->sort;
+    ts_query_row_t *heap = scan->heap;
+
+    for (;;)
+    {
+        uint32_t c = 2 * i + 1;
+        if (c >= len)
+        {
+            break;
+        }
+        if (c + 1 < len && ts_query_before(sort, &heap[c], &heap[c + 1]))
+        {
+            c++; // The worse child
+        }
+        if (!ts_query_before(sort, &heap[i], &heap[c]))
+        {
+            break;
+        }
+        ts_query_row_t tmp = heap[i];
+        heap[i] = heap[c];
+        heap[c] = tmp;
+        i = c;
+    }
+}
+
+/**
+ * @brief Offer a matching sample to the page window
+ *
+ * @param scan Scan state
+ * @param sample Sample
+ */
+static void ts_query_offer(ts_query_scan_t *scan, const ts_sample_t *sample)
+{
+    ts_query_sort_t sort = scan->query->sort;
+    ts_query_row_t row = {.sample = *sample, .seq = scan->seq};
+    ts_query_row_t *heap = scan->heap;
+
+    if (scan->heap_len < scan->heap_cap)
+    {
+        uint32_t i = scan->heap_len++;
+        while (i > 0)
+        {
+            uint32_t parent = (i - 1) / 2;
+            if (!ts_query_before(sort, &heap[parent], &row))
+            {
+                break;
+            }
+            heap[i] = heap[parent];
+            i = parent;
+        }
+        heap[i] = row;
+    }
+    else if (scan->heap_cap > 0 && ts_query_before(sort, &row, &heap[0]))
+    {
+        heap[0] = row;
+        ts_query_sift_down(scan, 0, scan->heap_len);
+    }
+}
+
+/**
+ * @brief Check whether a fully matching block can place a row in the window
+ *
+ * @param scan Scan state
+ * @param h Block header
+ *
+ * @return false if even its best sample ranks after the current worst row
+ */
+static bool ts_query_block_may_rank(const ts_query_scan_t *scan, const ts_block_header_t *h)
+{
+    if (scan->heap_cap == 0)
+    {
+        return false;
+    }
+    if (scan->heap_len < scan->heap_cap)
+    {
+        return true;
+    }
+
+    const ts_sample_t *worst = &scan->heap[0].sample;
+    bool failed = h->count > h->valid;
+    int64_t best;
+
+    switch (scan->query->sort)
+    {
+    case TS_QUERY_SORT_TIME_DESC:
+        return h->time_max >= worst->time;
+    case TS_QUERY_SORT_TIME_ASC:
+        return h->time_min <= worst->time;
+    case TS_QUERY_SORT_TEMP_DESC:
+        best = h->valid ? h->temp_max : INT32_MIN;
+        return (failed && best < 0 ? 0 : best) >= worst->temperature;
+    case TS_QUERY_SORT_TEMP_ASC:
+        best = h->valid ? h->temp_min : INT32_MAX;
+        return (failed && best > 0 ? 0 : best) <= worst->temperature;
+    case TS_QUERY_SORT_HUMI_DESC:
+        best = h->valid ? h->humi_max : INT32_MIN;
+        return (failed && best < 0 ? 0 : best) >= worst->humidity;
+    case TS_QUERY_SORT_HUMI_ASC:
+        best = h->valid ? h->humi_min : INT32_MAX;
+        return (failed && best > 0 ? 0 : best) <= worst->humidity;
+    }
+    return true;
+}
+
+/**
+ * @brief Bucket index of a time
+ *
+ * @param r Result (bucket layout)
+ * @param time Unix time within the bucket range
+ *
+ * @return Bucket index
+ */
+static uint32_t ts_query_bucket(const ts_query_result_t *r, int64_t time)
+{
+    return (uint32_t)((time - r->bucket_start) / r->bucket_seconds);
+}
+
+/**
+ * @brief Scan one segment
+ *
+ * @param scan Scan state
+ * @param reader Open segment reader
+ * @param samples Decoding buffer (TS_STORE_BLOCK_MAX entries)
+ */
+static void ts_query_scan_segment(ts_query_scan_t *scan, ts_segment_reader_t *reader, ts_sample_t *samples)
+{
+    const ts_query_t *q = scan->query;
+    ts_query_result_t *r = scan->result;
+
+    while (TSStore_ReaderNext(reader))
+    {
+        const ts_block_header_t *h = &reader->header;
+        ts_block_match_t match = ts_query_block_match(q, h);
+        bool counted = false;
+
+        r->blocks++;
+
+        if (match == TS_BLOCK_NONE)
+        {
+            r->blocks_skipped++;
+            scan->seq += h->count;
+            continue;
+        }
+
+        if (match == TS_BLOCK_ALL)
+        {
+            if (q->points > 0)
+            {
+                uint32_t b = ts_query_bucket(r, h->time_min);
+                if (b == ts_query_bucket(r, h->time_max))
+                {
+                    ts_query_summary_add_block(&r->summary, h);
+                    ts_query_summary_add_block(&r->buckets[b], h);
+                    r->blocks_summarized++;
+                    scan->seq += h->count;
+                    continue;
+                }
+            }
+            else
+            {
+                ts_query_summary_add_block(&r->summary, h);
+                counted = true;
+                if (!ts_query_block_may_rank(scan, h))
+                {
+                    r->blocks_summarized++;
+                    scan->seq += h->count;
+                    continue;
+                }
+            }
+        }
+
+        if (!TSStore_ReaderDecode(reader, samples))
+        {
+            break; // Corrupt block: the rest of the segment is not trusted
+        }
+        r->blocks_decoded++;
+
+        for (uint16_t i = 0; i < h->count; i++, scan->seq++)
+        {
+            const ts_sample_t *s = &samples[i];
+            if (match != TS_BLOCK_ALL && !ts_query_match(q, s))
+            {
+                continue;
+            }
+
+            if (!counted)
+            {
+                ts_query_summary_add(&r->summary, s);
+            }
+            if (q->points > 0)
+            {
+                ts_query_summary_add(&r->buckets[ts_query_bucket(r, s->time)], s);
+            }
+            else
+            {
+                ts_query_offer(scan, s);
+            }
+        }
+    }
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Reset a query to "everything, newest first"
+ */
+void TSQuery_Init(ts_query_t *query, const char *device)
+{
+    memset(query, 0, sizeof(*query));
+    snprintf(query->device, sizeof(query->device), "%s", device);
+    query->from = INT64_MIN;
+    query->to = INT64_MAX;
+    query->mode = TS_QUERY_MODE_ANY;
+    query->status = TS_QUERY_STATUS_ANY;
+    query->temp_min = query->humi_min = INT32_MIN;
+    query->temp_max = query->humi_max = INT32_MAX;
+    query->sort = TS_QUERY_SORT_TIME_DESC;
+    query->limit = TS_QUERY_LIMIT_DEFAULT;
+}
+
+/**
+ * @brief Run a query
+ */
+bool TSQuery_Run(const char *root, const ts_query_t *query, ts_query_result_t *result)
+{
+    static int64_t days[TS_QUERY_SEGMENTS_MAX];
+    static ts_sample_t samples[TS_STORE_BLOCK_MAX];
+    ts_query_scan_t scan = {.query = query, .result = result};
+    char path[TS_STORE_PATH_MAX];
+
+    memset(result, 0, sizeof(*result));
+    ts_query_summary_init(&result->summary);
+
+    if (query->from > query->to || query->limit > TS_QUERY_LIMIT_MAX ||
+        (uint64_t)query->offset + query->limit > TS_QUERY_WINDOW_MAX ||
+        query->points > TS_QUERY_POINTS_MAX ||
+        (query->mode != TS_QUERY_MODE_ANY &&
+         (query->mode < TS_STORE_MODE_SINGLE || query->mode > TS_STORE_MODE_ARCHIVE)))
+    {
+        return false;
+    }
+
+    uint32_t n = ts_query_list_days(root, query->device, ts_query_day(query->from),
+                                    ts_query_day(query->to), days);
+
+    if (query->points > 0)
+    {
+        if (n == 0)
+        {
+            return true;
+        }
+
+        // Unbounded ends stop at the stored days
+        int64_t from = query->from;
+        int64_t to = query->to;
+        if (from < days[0] * TS_STORE_DAY_SECONDS)
+            from = days[0] * TS_STORE_DAY_SECONDS;
+        if (to > (days[n - 1] + 1) * TS_STORE_DAY_SECONDS - 1)
+            to = (days[n - 1] + 1) * TS_STORE_DAY_SECONDS - 1;
+
+        uint64_t span = (uint64_t)(to - from) + 1;
+        result->bucket_start = from;
+        result->bucket_seconds = (int64_t)((span + query->points - 1) / query->points);
+        result->bucket_count = (uint32_t)((span + result->bucket_seconds - 1) / result->bucket_seconds);
+        result->buckets = malloc(result->bucket_count * sizeof(*result->buckets));
+        if (result->buckets == NULL)
+        {
+            return false;
+        }
+        for (uint32_t i = 0; i < result->bucket_count; i++)
+        {
+            ts_query_summary_init(&result->buckets[i]);
+        }
+    }
+    else
+    {
+        scan.heap_cap = query->offset + query->limit;
+        if (scan.heap_cap > 0 && (scan.heap = malloc(scan.heap_cap * sizeof(*scan.heap))) == NULL)
+        {
+            return false;
+        }
+    }
+
+    // Newest first fills the window with its final rows early, older blocks are then summarized
+    bool backward = query->points == 0 && query->sort == TS_QUERY_SORT_TIME_DESC;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        ts_segment_reader_t reader;
+        int64_t day = days[backward ? n - 1 - i : i];
+
+        if (!TSStore_SegmentPath(path, sizeof(path), root, query->device, day) ||
+            !TSStore_ReaderOpen(&reader, path))
+        {
+            continue;
+        }
+        result->segments++;
+        ts_query_scan_segment(&scan, &reader, samples);
+        TSStore_ReaderClose(&reader);
+    }
+
+    if (query->points == 0)
+    {
+        // Heap sort: pop the worst row to the end until the window is in order
+        for (uint32_t len = scan.heap_len; len > 1; len--)
+        {
+            ts_query_row_t tmp = scan.heap[0];
+            scan.heap[0] = scan.heap[len - 1];
+            scan.heap[len - 1] = tmp;
+            ts_query_sift_down(&scan, 0, len - 1);
+        }
+
+        if (scan.heap_len > query->offset)
+        {
+            result->row_count = scan.heap_len - query->offset;
+            result->rows = malloc(result->row_count * sizeof(*result->rows));
+            if (result->rows == NULL)
+            {
+                free(scan.heap);
+                return false;
+            }
+            for (uint32_t i = 0; i < result->row_count; i++)
+            {
+                result->rows[i] = scan.heap[query->offset + i].sample;
+            }
+        }
+        free(scan.heap);
+    }
+    return true;
+}
+
+/**
+ * @brief Release a query result
+ */
+void TSQuery_Free(ts_query_result_t *result)
+{
+    free(result->rows);
+    free(result->buckets);
+    result->rows = NULL;
+    result->buckets = NULL;
+    result->row_count = 0;
+    result->bucket_count = 0;
+}
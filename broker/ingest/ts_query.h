@@ -0,0 +1,149 @@
+/**
+ * @file ts_query.h
+ *
+ * @brief Time-Series Query - Range, filter, sort/page and downsampling over the store
+ */
+
+#ifndef TS_QUERY_H
+#define TS_QUERY_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include "ts_store.h"
+
+/* DEFINES -------------------------------------------------------------------*/
+
+#define TS_QUERY_LIMIT_DEFAULT 500
+#define TS_QUERY_LIMIT_MAX 100000   // Rows per response
+#define TS_QUERY_WINDOW_MAX 1000000 // offset + limit (rows kept while scanning)
+#define TS_QUERY_POINTS_MAX 10000   // Downsampling buckets
+#define TS_QUERY_SEGMENTS_MAX 8192  // Day segments per query (22 years)
+
+#define TS_QUERY_MODE_ANY -1
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Status filter (error = sensor failure)
+ */
+typedef enum
+{
+    TS_QUERY_STATUS_ANY = 0,
+    TS_QUERY_STATUS_SUCCESS,
+    TS_QUERY_STATUS_ERROR
+} ts_query_status_t;
+
+/**
+ * @brief Row order (same names as the dashboard sort options)
+ */
+typedef enum
+{
+    TS_QUERY_SORT_TIME_DESC = 0,
+    TS_QUERY_SORT_TIME_ASC,
+    TS_QUERY_SORT_TEMP_DESC,
+    TS_QUERY_SORT_TEMP_ASC,
+    TS_QUERY_SORT_HUMI_DESC,
+    TS_QUERY_SORT_HUMI_ASC
+} ts_query_sort_t;
+
+/**
+ * @brief Query parameters
+ *
+ * @details All bounds are inclusive. Rows are returned when points is 0,
+ *          otherwise the range is split into points equal time buckets.
+ */
+typedef struct
+{
+    char device[TS_STORE_DEVICE_MAX];
+    int64_t from;             // Unix time (UTC), INT64_MIN = unbounded
+    int64_t to;               // Unix time (UTC), INT64_MAX = unbounded
+    int mode;                 // TS_STORE_MODE_* or TS_QUERY_MODE_ANY
+    ts_query_status_t status;
+    int32_t temp_min;         // 0.01 C, INT32_MIN = unbounded
+    int32_t temp_max;         // 0.01 C, INT32_MAX = unbounded
+    int32_t humi_min;         // 0.01 %, INT32_MIN = unbounded
+    int32_t humi_max;         // 0.01 %, INT32_MAX = unbounded
+    ts_query_sort_t sort;
+    uint32_t offset;          // Rows skipped (pagination)
+    uint32_t limit;           // Rows returned (0 = summary only)
+    uint32_t points;          // Downsampling buckets (0 = rows)
+} ts_query_t;
+
+/**
+ * @brief Aggregate over a set of samples
+ *
+ * @details Min/max/sum cover valid samples only (no sensor failure), like
+ *          the block summaries of the store.
+ */
+typedef struct
+{
+    uint64_t count; // Matching samples
+    uint64_t valid; // Of which without sensor failure
+    int64_t time_min;
+    int64_t time_max;
+    int32_t temp_min;
+    int32_t temp_max;
+    int32_t humi_min;
+    int32_t humi_max;
+    int64_t temp_sum;
+    int64_t humi_sum;
+} ts_query_summary_t;
+
+/**
+ * @brief Query result
+ */
+typedef struct
+{
+    ts_query_summary_t summary;  // All matching samples (ignores offset/limit)
+
+    ts_sample_t *rows;           // Requested page, in query order
+    uint32_t row_count;
+
+    ts_query_summary_t *buckets; // points entries, bucket i starts at bucket_start + i * bucket_seconds
+    uint32_t bucket_count;
+    int64_t bucket_start;
+    int64_t bucket_seconds;
+
+    /* Scan counters */
+    uint32_t segments;          // Day segments opened
+    uint64_t blocks;            // Blocks in range
+    uint64_t blocks_skipped;    // Excluded by their summary
+    uint64_t blocks_summarized; // Fully matching, used through their summary
+    uint64_t blocks_decoded;    // Decoded sample by sample
+} ts_query_result_t;
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Reset a query to "everything, newest first"
+ *
+ * @param query Query to initialize
+ * @param device Device id
+ */
+void TSQuery_Init(ts_query_t *query, const char *device);
+
+/**
+ * @brief Run a query
+ *
+ * @param root Data directory of the store
+ * @param query Query parameters
+ * @param result Result (release with TSQuery_Free())
+ *
+ * @return true on success (an unknown device is an empty result), false on
+ *         invalid parameters or out of memory
+ *
+ * @note Blocks are skipped or aggregated from their summary whenever the
+ *       summary decides the outcome. Only blocks that straddle a filter
+ *       bound or a bucket edge, or that may hold rows of the requested
+ *       page, are decoded.
+ */
+bool TSQuery_Run(const char *root, const ts_query_t *query, ts_query_result_t *result);
+
+/**
+ * @brief Release a query result
+ *
+ * @param result Result of TSQuery_Run()
+ */
+void TSQuery_Free(ts_query_result_t *result);
+
+#endif /* TS_QUERY_H */
@@ -0,0 +1,229 @@
+/**
+ * @file ts_recent.c
+ *
+ * @brief Recent Window Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include "ts_recent.h"
+#include "ts_query.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+static void ts_recent_put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void ts_recent_put32(uint8_t *p, uint32_t v)
+{
+    ts_recent_put16(p, (uint16_t)v);
+    ts_recent_put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void ts_recent_put64(uint8_t *p, uint64_t v)
+{
+    ts_recent_put32(p, (uint32_t)v);
+    ts_recent_put32(p + 4, (uint32_t)(v >> 32));
+}
+
+static int32_t ts_recent_clamp(int32_t v, int32_t lo, int32_t hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static bool ts_recent_same(const ts_sample_t *a, const ts_sample_t *b)
+{
+    return a->time == b->time && a->temperature == b->temperature &&
+           a->humidity == b->humidity && a->flags == b->flags;
+}
+
+/**
+ * @brief Insert a periodic sample at its time
+ */
+static void ts_recent_insert(ts_recent_t *recent, const ts_sample_t *sample)
+{
+    uint32_t lo = 0, hi = recent->count;
+
+    // First position with a later time (upper bound)
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (recent->samples[mid].time <= sample->time)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // QoS 1 redelivery or a record replayed twice
+    for (uint32_t i = lo; i > 0 && recent->samples[i - 1].time == sample->time; i--)
+    {
+        if (ts_recent_same(&recent->samples[i - 1], sample))
+        {
+            return;
+        }
+    }
+
+    if (recent->count == recent->capacity)
+    {
+        if (lo == 0)
+        {
+            return; // Older than the whole window
+        }
+        // Drop the oldest sample
+        memmove(recent->samples, recent->samples + 1, (lo - 1) * sizeof(ts_sample_t));
+        lo--;
+    }
+    else
+    {
+        memmove(recent->samples + lo + 1, recent->samples + lo, (recent->count - lo) * sizeof(ts_sample_t));
+        recent->count++;
+    }
+
+    recent->samples[lo] = *sample;
+    recent->samples_dirty = true;
+}
+
+/**
+ * @brief Newest samples of one mode from the store
+ *
+ * @return true on success
+ */
+static bool ts_recent_query(const char *root, const char *device, int mode, uint32_t limit,
+                            ts_query_result_t *result)
+{
+    ts_query_t query;
+
+    TSQuery_Init(&query, device);
+    query.mode = mode;
+    query.sort = TS_QUERY_SORT_TIME_DESC;
+    query.limit = limit;
+    return TSQuery_Run(root, &query, result);
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+bool TSRecent_Init(ts_recent_t *recent, uint32_t capacity)
+{
+    memset(recent, 0, sizeof(*recent));
+    if (capacity == 0 || capacity > TS_RECENT_POINTS_MAX)
+    {
+        return false;
+    }
+
+    recent->samples = malloc(capacity * sizeof(ts_sample_t));
+    recent->capacity = capacity;
+    return recent->samples != NULL;
+}
+
+void TSRecent_Free(ts_recent_t *recent)
+{
+    free(recent->samples);
+    memset(recent, 0, sizeof(*recent));
+}
+
+bool TSRecent_Load(ts_recent_t *recent, const char *root, const char *device)
+{
+    ts_query_result_t result;
+
+    if (!ts_recent_query(root, device, TS_STORE_MODE_PERIODIC, recent->capacity, &result))
+    {
+        return false;
+    }
+    // Newest first: add oldest first so every insert appends
+    for (uint32_t i = result.row_count; i > 0; i--)
+    {
+        TSRecent_Add(recent, &result.rows[i - 1]);
+    }
+    TSQuery_Free(&result);
+
+    if (!ts_recent_query(root, device, TS_STORE_MODE_SINGLE, 1, &result))
+    {
+        return false;
+    }
+    if (result.row_count > 0)
+    {
+        TSRecent_Add(recent, &result.rows[0]);
+    }
+    TSQuery_Free(&result);
+    return true;
+}
+
+void TSRecent_Add(ts_recent_t *recent, const ts_sample_t *sample)
+{
+    uint8_t mode = sample->flags & TS_STORE_MODE_MASK;
+
+    if (mode == TS_STORE_MODE_ARCHIVE)
+    {
+        return;
+    }
+
+    if (!recent->has_latest || sample->time >= recent->latest.time)
+    {
+        recent->latest = *sample;
+        recent->has_latest = true;
+        recent->latest_dirty = true;
+    }
+
+    if (mode == TS_STORE_MODE_PERIODIC)
+    {
+        ts_recent_insert(recent, sample);
+    }
+}
+
+size_t TSRecent_Encode(const ts_recent_t *recent, uint8_t *out, size_t size)
+{
+    size_t len = TS_RECENT_SNAPSHOT_SIZE(recent->count);
+    int64_t base = recent->count ? recent->samples[0].time : 0;
+
+    if (size < len)
+    {
+        return 0;
+    }
+
+    ts_recent_put32(out, TS_RECENT_MAGIC);
+    ts_recent_put16(out + 4, (uint16_t)recent->count);
+    ts_recent_put16(out + 6, 0);
+    ts_recent_put64(out + 8, (uint64_t)base);
+
+    uint8_t *p = out + TS_RECENT_HEADER_SIZE;
+    for (uint32_t i = 0; i < recent->count; i++, p += TS_RECENT_POINT_SIZE)
+    {
+        const ts_sample_t *s = &recent->samples[i];
+        uint16_t humi = (uint16_t)ts_recent_clamp(s->humidity, 0, TS_RECENT_HUMI_MASK);
+
+        if (s->flags & TS_STORE_FLAG_SENSOR_FAIL)
+            humi |= TS_RECENT_HUMI_SENSOR_FAIL;
+        if (s->flags & TS_STORE_FLAG_RTC_FAIL)
+            humi |= TS_RECENT_HUMI_RTC_FAIL;
+
+        // Sorted, so the offset is never negative; UINT32_MAX s is 136 years
+        ts_recent_put32(p, (uint32_t)(s->time - base));
+        ts_recent_put16(p + 4, (uint16_t)(int16_t)ts_recent_clamp(s->temperature, INT16_MIN, INT16_MAX));
+        ts_recent_put16(p + 6, humi);
+    }
+    return len;
+}
+
+size_t TSRecent_FormatLatest(const ts_recent_t *recent, long tz_offset, char *out, size_t size)
+{
+    const ts_sample_t *s = &recent->latest;
+    int len;
+
+    if (!recent->has_latest)
+    {
+        return 0;
+    }
+
+    // Device-local timestamp, 0 on RTC failure, like the gateway payload
+    len = snprintf(out, size, "{\"mode\":\"%s\",\"timestamp\":%lld,\"temperature\":%.2f,\"humidity\":%.2f}",
+                   (s->flags & TS_STORE_MODE_MASK) == TS_STORE_MODE_SINGLE ? "SINGLE" : "PERIODIC",
+                   (s->flags & TS_STORE_FLAG_RTC_FAIL) ? 0LL : (long long)(s->time + tz_offset),
+                   s->temperature / 100.0, s->humidity / 100.0);
+    return len > 0 && (size_t)len < size ? (size_t)len : 0;
+}
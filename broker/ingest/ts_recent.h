@@ -0,0 +1,122 @@
+/**
+ * @file ts_recent.h
+ *
+ * @brief Recent Window - Latest reading and last N periodic samples, packed for retained MQTT topics
+ */
+
+#ifndef TS_RECENT_H
+#define TS_RECENT_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include "ts_store.h"
+
+/* DEFINES -------------------------------------------------------------------*/
+
+#define TS_RECENT_POINTS_DEFAULT 500
+#define TS_RECENT_POINTS_MAX 10000
+
+/* Snapshot format (little-endian) */
+#define TS_RECENT_MAGIC 0x31524C44 // "DLR1"
+#define TS_RECENT_HEADER_SIZE 16
+#define TS_RECENT_POINT_SIZE 8
+#define TS_RECENT_SNAPSHOT_SIZE(points) (TS_RECENT_HEADER_SIZE + (size_t)(points) * TS_RECENT_POINT_SIZE)
+
+/* Point humidity word: 0.01 % in the low 14 bits, failure flags on top */
+#define TS_RECENT_HUMI_MASK 0x3FFF
+#define TS_RECENT_HUMI_SENSOR_FAIL 0x8000
+#define TS_RECENT_HUMI_RTC_FAIL 0x4000
+
+#define TS_RECENT_LATEST_MAX 160 // Longest latest-reading JSON
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Recent window of one device
+ *
+ * @details samples holds periodic samples sorted by time (oldest first).
+ *          latest is the newest single or periodic sample. The dirty flags
+ *          tell the owner what to republish.
+ */
+typedef struct
+{
+    ts_sample_t *samples;
+    uint32_t capacity;
+    uint32_t count;
+
+    ts_sample_t latest;
+    bool has_latest;
+
+    bool latest_dirty;
+    bool samples_dirty;
+} ts_recent_t;
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Allocate an empty window
+ *
+ * @param recent Window to initialize
+ * @param capacity Periodic samples kept (1 to TS_RECENT_POINTS_MAX)
+ *
+ * @return true on success
+ */
+bool TSRecent_Init(ts_recent_t *recent, uint32_t capacity);
+
+/**
+ * @brief Release a window
+ *
+ * @param recent Window
+ */
+void TSRecent_Free(ts_recent_t *recent);
+
+/**
+ * @brief Fill the window from the store (service start)
+ *
+ * @param recent Window (empty)
+ * @param root Data directory of the store
+ * @param device Device id
+ *
+ * @return true on success (no data is success)
+ */
+bool TSRecent_Load(ts_recent_t *recent, const char *root, const char *device);
+
+/**
+ * @brief Add a stored sample
+ *
+ * @param recent Window
+ * @param sample Sample (archive samples are ignored)
+ *
+ * @note Late samples (SD backlog replay) are inserted at their time. Samples
+ *       older than a full window and exact repeats are dropped.
+ */
+void TSRecent_Add(ts_recent_t *recent, const ts_sample_t *sample);
+
+/**
+ * @brief Pack the window
+ *
+ * @param recent Window
+ * @param out Output buffer (TS_RECENT_SNAPSHOT_SIZE(recent->count) bytes)
+ * @param size Buffer size
+ *
+ * @return Bytes written, 0 if the buffer is too small
+ *
+ * @details Header: magic u32, count u16, reserved u16, base time i64 (UTC
+ *          seconds of the first point). Point: seconds since base u32,
+ *          temperature i16 (0.01 C), humidity u16 (see TS_RECENT_HUMI_*).
+ */
+size_t TSRecent_Encode(const ts_recent_t *recent, uint8_t *out, size_t size);
+
+/**
+ * @brief Format the latest reading like a gateway data payload
+ *
+ * @param recent Window (has_latest set)
+ * @param tz_offset Device RTC offset from UTC in seconds
+ * @param out Output buffer (TS_RECENT_LATEST_MAX bytes)
+ * @param size Buffer size
+ *
+ * @return Length, 0 if there is no latest reading
+ */
+size_t TSRecent_FormatLatest(const ts_recent_t *recent, long tz_offset, char *out, size_t size);
+
+#endif /* TS_RECENT_H */
@@ -0,0 +1,853 @@
+/**
+ * @file ts_store.c
+ *
+ * @brief Time-Series Store Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include "ts_store.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+#define TS_VARINT_MAX 10 // Bytes for a 64-bit varint
+
+// Worst case payload: three varint columns and the flags column
+#define TS_PAYLOAD_MAX (TS_STORE_BLOCK_MAX * (3 * TS_VARINT_MAX + 1))
+
+_Static_assert(sizeof(ts_file_header_t) == 16, "segment file header must be 16 bytes");
+_Static_assert(sizeof(ts_block_header_t) == 72, "block header must be 72 bytes");
+
+/* PRIVATE VARIABLES ---------------------------------------------------------*/
+
+static uint32_t crc_table[256];
+static bool crc_ready = false;
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+/**
+ * @brief CRC-32 (IEEE 802.3) of a buffer
+ *
+ * @param data Data pointer
+ * @param len Length in bytes
+ *
+ * @return CRC value
+ */
+static uint32_t ts_crc32(const uint8_t *data, size_t len)
+{
+    if (!crc_ready)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            crc_table[i] = c;
+        }
+        crc_ready = true;
+    }
+
+    uint32_t crc = 0xFFFFFFFFu;
+    while (len--)
+    {
+        crc = crc_table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Append a signed value as a zigzag varint
+ *
+ * @param p Output pointer (at least TS_VARINT_MAX bytes free)
+ * @param value Value to encode
+ *
+ * @return Bytes written
+ */
+static size_t ts_put_varint(uint8_t *p, int64_t value)
+{
+    uint64_t z = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    size_t n = 0;
+
+    while (z >= 0x80)
+    {
+        p[n++] = (uint8_t)(z | 0x80);
+        z >>= 7;
+    }
+    p[n++] = (uint8_t)z;
+    return n;
+}
+
+/**
+ * @brief Read a zigzag varint
+ *
+ * @param p Input cursor (advanced)
+ * @param end End of the column
+ * @param value Output value
+ *
+ * @return false if the column is truncated
+ */
+static bool ts_get_varint(const uint8_t **p, const uint8_t *end, int64_t *value)
+{
+    uint64_t z = 0;
+    int shift = 0;
+
+    while (*p < end && shift < 64)
+    {
+        uint8_t b = *(*p)++;
+        z |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        {
+            *value = (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+            return true;
+        }
+        shift += 7;
+    }
+    return false;
+}
+
+/**
+ * @brief Check a device id (used as a directory name)
+ *
+ * @param device Device id
+ *
+ * @return true if it only holds [A-Za-z0-9_-] and fits TS_STORE_DEVICE_MAX
+ */
+static bool ts_device_valid(const char *device)
+{
+    size_t len = 0;
+
+    for (const char *c = device; *c; c++, len++)
+    {
+        bool ok = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') ||
+                  (*c >= '0' && *c <= '9') || *c == '_' || *c == '-';
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return len > 0 && len < TS_STORE_DEVICE_MAX;
+}
+
+/**
+ * @brief Days since epoch of a Unix time (floor, also before 1970)
+ *
+ * @param time Unix time in seconds
+ *
+ * @return Day number
+ */
+static int64_t ts_day(int64_t time)
+{
+    int64_t day = time / TS_STORE_DAY_SECONDS;
+    return (time % TS_STORE_DAY_SECONDS < 0) ? day - 1 : day;
+}
+
+/**
+ * @brief Drop a torn tail so appends continue after the last complete block
+ *
+ * @param store Store handle
+ * @param fd Segment file
+ * @param path Segment path (for the log)
+ *
+ * @return true if the segment is usable
+ */
+static bool ts_recover_tail(ts_store_t *store, int fd, const char *path)
+{
+    ts_file_header_t file_header;
+    ts_block_header_t header;
+    off_t good;
+    off_t size = lseek(fd, 0, SEEK_END);
+
+    if (pread(fd, &file_header, sizeof(file_header), 0) != (ssize_t)sizeof(file_header) ||
+        file_header.magic != TS_STORE_FILE_MAGIC || file_header.version != TS_STORE_VERSION)
+    {
+        fprintf(stderr, "[STORE] %s: not a segment file\n", path);
+        return false;
+    }
+
+    // Headers only: the CRC is checked by readers, a complete block is kept
+    good = sizeof(file_header);
+    while (pread(fd, &header, sizeof(header), good) == (ssize_t)sizeof(header) &&
+           header.magic == TS_STORE_BLOCK_MAGIC)
+    {
+        off_t next = good + (off_t)sizeof(header) + header.time_len + header.temp_len +
+                     header.humi_len + header.count;
+        if (next > size)
+        {
+            break;
+        }
+        good = next;
+    }
+
+    if (good < size)
+    {
+        fprintf(stderr, "[STORE] %s: dropping %lld torn bytes\n", path, (long long)(size - good));
+        if (ftruncate(fd, good) != 0)
+        {
+            return false;
+        }
+        store->stats.truncated++;
+    }
+    return true;
+}
+
+/**
+ * @brief Open or create a day segment
+ *
+ * @param store Store handle
+ * @param device Device id
+ * @param day Days since epoch
+ *
+ * @return File descriptor, -1 on error
+ */
+static int ts_open_segment(ts_store_t *store, const char *device, int64_t day)
+{
+    char path[TS_STORE_PATH_MAX];
+    int fd;
+
+    if (!TSStore_SegmentPath(path, sizeof(path), store->root, device, day))
+    {
+        return -1;
+    }
+
+    // Device directory
+    char *slash = strrchr(path, '/');
+    *slash = '\0';
+    if (mkdir(path, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr, "[STORE] mkdir %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    *slash = '/';
+
+    fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr, "[STORE] open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    if (lseek(fd, 0, SEEK_END) == 0)
+    {
+        ts_file_header_t header = {
+            .magic = TS_STORE_FILE_MAGIC,
+            .version = TS_STORE_VERSION,
+            .day = day,
+        };
+        if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header))
+        {
+            close(fd);
+            return -1;
+        }
+        store->stats.bytes += sizeof(header);
+    }
+    else if (!ts_recover_tail(store, fd, path))
+    {
+        close(fd);
+        return -1;
+    }
+
+    store->stats.segments++;
+    return fd;
+}
+
+/**
+ * @brief Encode samples as one block (header and payload)
+ *
+ * @param out Output buffer (sizeof(ts_block_header_t) + TS_PAYLOAD_MAX bytes)
+ * @param s Samples
+ * @param count Number of samples (1 to TS_STORE_BLOCK_MAX)
+ *
+ * @return Block length in bytes
+ */
+static size_t ts_encode_block(uint8_t *out, const ts_sample_t *s, uint16_t count)
+{
+    ts_block_header_t *header = (ts_block_header_t *)out;
+    uint8_t *payload = out + sizeof(*header);
+    uint8_t *p = payload;
+
+    memset(header, 0, sizeof(*header));
+    header->magic = TS_STORE_BLOCK_MAGIC;
+    header->count = count;
+    header->time_min = INT64_MAX;
+    header->time_max = INT64_MIN;
+    header->temp_min = header->humi_min = INT32_MAX;
+    header->temp_max = header->humi_max = INT32_MIN;
+
+    // Time column: first value absolute, then deltas (mostly one interval)
+    for (uint16_t i = 0; i < count; i++)
+    {
+        p += ts_put_varint(p, i ? s[i].time - s[i - 1].time : s[i].time);
+        if (s[i].time < header->time_min)
+            header->time_min = s[i].time;
+        if (s[i].time > header->time_max)
+            header->time_max = s[i].time;
+    }
+    header->time_len = (uint32_t)(p - payload);
+
+    // Value columns: deltas of fixed-point values (slow drift = 1-2 bytes)
+    uint8_t *col = p;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        p += ts_put_varint(p, (int64_t)s[i].temperature - (i ? s[i - 1].temperature : 0));
+    }
+    header->temp_len = (uint32_t)(p - col);
+
+    col = p;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        p += ts_put_varint(p, (int64_t)s[i].humidity - (i ? s[i - 1].humidity : 0));
+    }
+    header->humi_len = (uint32_t)(p - col);
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        *p++ = s[i].flags;
+
+        if (s[i].flags & TS_STORE_FLAG_SENSOR_FAIL)
+        {
+            continue;
+        }
+        header->valid++;
+        header->temp_sum += s[i].temperature;
+        header->humi_sum += s[i].humidity;
+        if (s[i].temperature < header->temp_min)
+            header->temp_min = s[i].temperature;
+        if (s[i].temperature > header->temp_max)
+            header->temp_max = s[i].temperature;
+        if (s[i].humidity < header->humi_min)
+            header->humi_min = s[i].humidity;
+        if (s[i].humidity > header->humi_max)
+            header->humi_max = s[i].humidity;
+    }
+
+    header->crc = ts_crc32(payload, (size_t)(p - payload));
+    return (size_t)(p - out);
+}
+
+/**
+ * @brief Encode and write the pending samples of a segment as one block
+ *
+ * @param store Store handle
+ * @param writer Segment writer
+ *
+ * @return true on success (also when nothing was pending)
+ */
+static bool ts_write_block(ts_store_t *store, ts_writer_t *writer)
+{
+    if (writer->count == 0)
+    {
+        return true;
+    }
+
+    // One write per block: O_APPEND keeps it contiguous, a crash leaves a torn tail at worst
+    size_t len = ts_encode_block(store->scratch, writer->pending, writer->count);
+    ssize_t written = write(writer->fd, store->scratch, len);
+    if (written != (ssize_t)len)
+    {
+        fprintf(stderr, "[STORE] write %s day %lld: %s\n", writer->device,
+                (long long)writer->day, written < 0 ? strerror(errno) : "short write");
+        store->stats.write_errors++;
+        return false;
+    }
+
+    if (store->sync)
+    {
+        fsync(writer->fd);
+    }
+
+    store->stats.blocks++;
+    store->stats.bytes += len;
+    writer->blocks++;
+    writer->count = 0;
+    return true;
+}
+
+/**
+ * @brief Rewrite a segment with full blocks
+ *
+ * @param store Store handle
+ * @param device Device id
+ * @param day Days since epoch
+ *
+ * @details Live data is flushed every second, so a day segment ends up with
+ *          one small block per flush. Once the segment is closed its blocks
+ *          are merged into TS_STORE_BLOCK_MAX sample blocks in a temporary
+ *          file that replaces the segment with rename(). Readers that have
+ *          the old file open keep reading it. A torn or corrupt block ends
+ *          the copy, like it ends a read.
+ */
+static void ts_compact_segment(ts_store_t *store, const char *device, int64_t day)
+{
+    char path[TS_STORE_PATH_MAX];
+    char tmp[TS_STORE_PATH_MAX + 4];
+    ts_segment_reader_t reader;
+    ts_sample_t *pending = malloc(2 * TS_STORE_BLOCK_MAX * sizeof(*pending));
+    uint32_t blocks_in = 0, blocks_out = 0;
+    uint32_t count = 0;
+    bool ok = pending != NULL;
+    int fd = -1;
+
+    if (!ok || !TSStore_SegmentPath(path, sizeof(path), store->root, device, day) ||
+        !TSStore_ReaderOpen(&reader, path))
+    {
+        free(pending);
+        return;
+    }
+
+    // Headers only: nothing to gain if the blocks are already full
+    while (TSStore_ReaderNext(&reader))
+    {
+        blocks_in++;
+        count += reader.header.count;
+    }
+    if (blocks_in <= (count + TS_STORE_BLOCK_MAX - 1) / TS_STORE_BLOCK_MAX)
+    {
+        TSStore_ReaderClose(&reader);
+        free(pending);
+        return;
+    }
+    reader.header.magic = 0;
+    reader.payload_offset = sizeof(ts_file_header_t);
+    blocks_in = 0;
+    count = 0;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        ok = false;
+    }
+    else
+    {
+        ts_file_header_t header = {
+            .magic = TS_STORE_FILE_MAGIC,
+            .version = TS_STORE_VERSION,
+            .day = day,
+        };
+        ok = write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header);
+    }
+
+    // Decode behind the samples still pending, emit full blocks from the front
+    while (ok && TSStore_ReaderNext(&reader) && TSStore_ReaderDecode(&reader, pending + count))
+    {
+        blocks_in++;
+        count += reader.header.count;
+
+        if (count >= TS_STORE_BLOCK_MAX)
+        {
+            size_t len = ts_encode_block(store->scratch, pending, TS_STORE_BLOCK_MAX);
+            ok = write(fd, store->scratch, len) == (ssize_t)len;
+            count -= TS_STORE_BLOCK_MAX;
+            memmove(pending, pending + TS_STORE_BLOCK_MAX, count * sizeof(*pending));
+            blocks_out++;
+        }
+    }
+    if (ok && count > 0)
+    {
+        size_t len = ts_encode_block(store->scratch, pending, (uint16_t)count);
+        ok = write(fd, store->scratch, len) == (ssize_t)len;
+        blocks_out++;
+    }
+    TSStore_ReaderClose(&reader);
+    free(pending);
+
+    if (ok && store->sync)
+    {
+        ok = fsync(fd) == 0;
+    }
+    if (fd >= 0 && close(fd) != 0)
+    {
+        ok = false;
+    }
+
+    if (!ok || rename(tmp, path) != 0)
+    {
+        fprintf(stderr, "[STORE] compact %s: %s\n", path, strerror(errno));
+        unlink(tmp);
+        store->stats.write_errors++;
+        return;
+    }
+
+    store->stats.compacted++;
+    printf("[STORE] compacted %s: %u -> %u blocks\n", path, blocks_in, blocks_out);
+}
+
+/**
+ * @brief Flush and close a writer, compacting its segment if it has small blocks
+ *
+ * @param store Store handle
+ * @param writer Segment writer
+ */
+static void ts_close_writer(ts_store_t *store, ts_writer_t *writer)
+{
+    ts_write_block(store, writer);
+    close(writer->fd);
+
+    // Every flush since open may have left a partial block
+    if (writer->blocks > 0)
+    {
+        ts_compact_segment(store, writer->device, writer->day);
+    }
+    writer->device[0] = '\0';
+}
+
+/**
+ * @brief Find or open the writer of a day segment
+ *
+ * @param store Store handle
+ * @param device Device id
+ * @param day Days since epoch
+ *
+ * @return Writer, NULL on error
+ */
+static ts_writer_t *ts_get_writer(ts_store_t *store, const char *device, int64_t day)
+{
+    ts_writer_t *lru = &store->writers[0];
+    uint32_t hash = TSStore_DeviceHash(device);
+
+    for (int i = 0; i < TS_STORE_OPEN_MAX; i++)
+    {
+        ts_writer_t *w = &store->writers[i];
+        if (w->device[0] && w->hash == hash && w->day == day && strcmp(w->device, device) == 0)
+        {
+            w->last_use = ++store->clock;
+            return w;
+        }
+        if (!w->device[0] || (lru->device[0] && w->last_use < lru->last_use))
+        {
+            lru = w;
+        }
+    }
+
+    // Evict the least recently used segment (old days after an archive replay)
+    if (lru->device[0])
+    {
+        ts_close_writer(store, lru);
+    }
+
+    int fd = ts_open_segment(store, device, day);
+    if (fd < 0)
+    {
+        store->stats.write_errors++;
+        return NULL;
+    }
+
+    strcpy(lru->device, device);
+    lru->hash = hash;
+    lru->day = day;
+    lru->fd = fd;
+    lru->count = 0;
+    lru->blocks = 0;
+    lru->last_use = ++store->clock;
+    return lru;
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Open a store
+ */
+bool TSStore_Open(ts_store_t *store, const char *root, bool sync)
+{
+    memset(store, 0, sizeof(*store));
+
+    if (strlen(root) >= sizeof(store->root))
+    {
+        return false;
+    }
+    strcpy(store->root, root);
+    store->sync = sync;
+
+    if (mkdir(root, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr, "[STORE] mkdir %s: %s\n", root, strerror(errno));
+        return false;
+    }
+
+    store->scratch = malloc(sizeof(ts_block_header_t) + TS_PAYLOAD_MAX);
+    return store->scratch != NULL;
+}
+
+/**
+ * @brief Append a sample
+ */
+bool TSStore_Append(ts_store_t *store, const char *device, const ts_sample_t *sample)
+{
+    if (!ts_device_valid(device))
+    {
+        return false;
+    }
+
+    ts_writer_t *writer = ts_get_writer(store, device, ts_day(sample->time));
+    if (writer == NULL)
+    {
+        return false;
+    }
+
+    writer->pending[writer->count++] = *sample;
+    writer->last_append = (int64_t)time(NULL);
+    store->stats.samples++;
+
+    if (writer->count == TS_STORE_BLOCK_MAX)
+    {
+        return ts_write_block(store, writer);
+    }
+    return true;
+}
+
+/**
+ * @brief Write all pending samples as blocks
+ */
+bool TSStore_Flush(ts_store_t *store)
+{
+    int64_t now = (int64_t)time(NULL);
+    int64_t today = ts_day(now);
+    bool ok = true;
+
+    for (int i = 0; i < TS_STORE_OPEN_MAX; i++)
+    {
+        ts_writer_t *w = &store->writers[i];
+        if (!w->device[0])
+        {
+            continue;
+        }
+
+        if (!ts_write_block(store, w))
+        {
+            ok = false;
+        }
+        else if (w->day < today && now - w->last_append >= TS_STORE_IDLE_CLOSE_S)
+        {
+            ts_close_writer(store, w);
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Flush and close all segments
+ */
+void TSStore_Close(ts_store_t *store)
+{
+    TSStore_Flush(store);
+
+    for (int i = 0; i < TS_STORE_OPEN_MAX; i++)
+    {
+        if (store->writers[i].device[0])
+        {
+            ts_close_writer(store, &store->writers[i]);
+        }
+    }
+
+    free(store->scratch);
+    store->scratch = NULL;
+}
+
+/**
+ * @brief Get store counters
+ */
+void TSStore_GetStats(const ts_store_t *store, ts_store_stats_t *stats)
+{
+    *stats = store->stats;
+}
+
+/**
+ * @brief Hash a device id (FNV-1a)
+ */
+uint32_t TSStore_DeviceHash(const char *device)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*device)
+    {
+        hash = (hash ^ (uint8_t)*device++) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Build the path of a day segment
+ */
+bool TSStore_SegmentPath(char *buf, size_t size, const char *root, const char *device, int64_t day)
+{
+    time_t t = (time_t)(day * TS_STORE_DAY_SECONDS);
+    struct tm tm;
+
+    if (!ts_device_valid(device) || gmtime_r(&t, &tm) == NULL)
+    {
+        return false;
+    }
+
+    int n = snprintf(buf, size, "%s/%s/%04d-%02d-%02d.seg", root, device,
+                     tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+    return n > 0 && (size_t)n < size;
+}
+
+/**
+ * @brief Open a segment for reading
+ */
+bool TSStore_ReaderOpen(ts_segment_reader_t *reader, const char *path)
+{
+    ts_file_header_t file_header;
+    struct stat st;
+    int fd;
+
+    memset(reader, 0, sizeof(*reader));
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // Blocks appended after this point are not seen by this reader
+    bool ok = fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(file_header) &&
+              (reader->data = malloc((size_t)st.st_size)) != NULL;
+    if (ok)
+    {
+        reader->size = (size_t)st.st_size;
+        for (size_t done = 0; ok && done < reader->size;)
+        {
+            ssize_t n = read(fd, reader->data + done, reader->size - done);
+            if (n <= 0)
+            {
+                reader->size = done; // Shrunk while reading (torn tail dropped)
+                break;
+            }
+            done += (size_t)n;
+        }
+    }
+    close(fd);
+
+    if (ok && reader->size >= sizeof(file_header))
+    {
+        memcpy(&file_header, reader->data, sizeof(file_header));
+        ok = file_header.magic == TS_STORE_FILE_MAGIC && file_header.version == TS_STORE_VERSION;
+    }
+    else
+    {
+        ok = false;
+    }
+
+    if (!ok)
+    {
+        TSStore_ReaderClose(reader);
+        return false;
+    }
+
+    reader->day = file_header.day;
+    reader->payload_offset = sizeof(file_header);
+    return true;
+}
+
+/**
+ * @brief Advance to the next block
+ */
+bool TSStore_ReaderNext(ts_segment_reader_t *reader)
+{
+    // Skip the payload of the current block (if any)
+    size_t offset = reader->payload_offset;
+    if (reader->header.magic == TS_STORE_BLOCK_MAGIC)
+    {
+        offset += (size_t)reader->header.time_len + reader->header.temp_len +
+                  reader->header.humi_len + reader->header.count;
+    }
+
+    reader->header.magic = 0;
+    if (offset + sizeof(reader->header) > reader->size)
+    {
+        return false;
+    }
+
+    ts_block_header_t header;
+    memcpy(&header, reader->data + offset, sizeof(header));
+    size_t payload = (size_t)header.time_len + header.temp_len + header.humi_len + header.count;
+
+    // Torn block: the payload runs past the end of the file
+    if (header.magic != TS_STORE_BLOCK_MAGIC || header.count == 0 ||
+        header.count > TS_STORE_BLOCK_MAX || payload > TS_PAYLOAD_MAX ||
+        offset + sizeof(header) + payload > reader->size)
+    {
+        return false;
+    }
+
+    reader->header = header;
+    reader->payload_offset = offset + sizeof(header);
+    return true;
+}
+
+/**
+ * @brief Decode the current block
+ */
+bool TSStore_ReaderDecode(ts_segment_reader_t *reader, ts_sample_t *samples)
+{
+    const ts_block_header_t *h = &reader->header;
+    size_t len = (size_t)h->time_len + h->temp_len + h->humi_len + h->count;
+
+    if (h->magic != TS_STORE_BLOCK_MAGIC)
+    {
+        return false;
+    }
+
+    const uint8_t *p = reader->data + reader->payload_offset;
+    if (ts_crc32(p, len) != h->crc)
+    {
+        return false;
+    }
+
+    const uint8_t *end = p + h->time_len;
+    int64_t v = 0, prev = 0;
+
+    for (uint16_t i = 0; i < h->count; i++)
+    {
+        if (!ts_get_varint(&p, end, &v))
+            return false;
+        prev = i ? prev + v : v;
+        samples[i].time = prev;
+    }
+
+    end = p + h->temp_len;
+    prev = 0;
+    for (uint16_t i = 0; i < h->count; i++)
+    {
+        if (!ts_get_varint(&p, end, &v))
+            return false;
+        prev += v;
+        samples[i].temperature = (int32_t)prev;
+    }
+
+    end = p + h->humi_len;
+    prev = 0;
+    for (uint16_t i = 0; i < h->count; i++)
+    {
+        if (!ts_get_varint(&p, end, &v))
+            return false;
+        prev += v;
+        samples[i].humidity = (int32_t)prev;
+    }
+
+    for (uint16_t i = 0; i < h->count; i++)
+    {
+        samples[i].flags = *p++;
+    }
+    return true;
+}
+
+/**
+ * @brief Close a segment reader
+ */
+void TSStore_ReaderClose(ts_segment_reader_t *reader)
+{
+    free(reader->data);
+    reader->data = NULL;
+    reader->size = 0;
+}
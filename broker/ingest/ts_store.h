@@ -0,0 +1,264 @@
+/**
+ * @file ts_store.h
+ *
+ * @brief Time-Series Store - Per-device, per-day columnar segments of sensor samples
+ */
+
+#ifndef TS_STORE_H
+#define TS_STORE_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+/* Configuration */
+#define TS_STORE_BLOCK_MAX 1024   // Samples per block (flushed earlier by TSStore_Flush())
+#define TS_STORE_OPEN_MAX 512     // Day segments kept open for writing (LRU), one per active device
+#define TS_STORE_DEVICE_MAX 32    // Max device id length including terminator
+#define TS_STORE_PATH_MAX 512     // Max segment path length
+#define TS_STORE_DAY_SECONDS 86400 // Segment length (UTC days)
+#define TS_STORE_IDLE_CLOSE_S 60    // Past days idle this long are closed and compacted
+
+/* On-disk format */
+#define TS_STORE_FILE_MAGIC 0x47534C44  // "DLSG" segment file header
+#define TS_STORE_BLOCK_MAGIC 0x4B424C44 // "DLBK" block header
+#define TS_STORE_VERSION 1
+
+/* Sample flags */
+#define TS_STORE_MODE_SINGLE 0x00
+#define TS_STORE_MODE_PERIODIC 0x01
+#define TS_STORE_MODE_ARCHIVE 0x02 // Replayed from the SD archive (SD QUERY)
+#define TS_STORE_MODE_MASK 0x03
+#define TS_STORE_FLAG_SENSOR_FAIL 0x04 // Temperature and humidity both 0 (SHT3X failure)
+#define TS_STORE_FLAG_RTC_FAIL 0x08    // Device timestamp 0, receive time used instead
+#define TS_STORE_FLAG_BACKLOG 0x10     // Replayed from the SD backlog after an outage
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief One sensor sample
+ */
+typedef struct
+{
+    int64_t time;        // Unix time in seconds (UTC)
+    int32_t temperature; // Temperature in 0.01 Celsius
+    int32_t humidity;    // Humidity in 0.01 percent
+    uint8_t flags;       // TS_STORE_MODE_* | TS_STORE_FLAG_*
+} ts_sample_t;
+
+/**
+ * @brief Segment file header (16 bytes, little-endian)
+ */
+typedef struct
+{
+    uint32_t magic;   // TS_STORE_FILE_MAGIC
+    uint16_t version; // TS_STORE_VERSION
+    uint16_t reserved;
+    int64_t day;      // Days since 1970-01-01 (UTC)
+} ts_file_header_t;
+
+/**
+ * @brief Block header and summary (72 bytes, little-endian)
+ *
+ * @details Followed by the payload: delta-encoded zigzag varint columns for
+ *          time, temperature and humidity, then one flags byte per sample.
+ *          Min/max/sum cover valid samples only (no sensor failure), so
+ *          queries can skip or aggregate a block without decoding it.
+ */
+typedef struct
+{
+    uint32_t magic;    // TS_STORE_BLOCK_MAGIC
+    uint16_t count;    // Samples in the block
+    uint16_t valid;    // Samples without TS_STORE_FLAG_SENSOR_FAIL
+    uint32_t time_len; // Time column length in bytes
+    uint32_t temp_len; // Temperature column length in bytes
+    uint32_t humi_len; // Humidity column length in bytes
+    uint32_t crc;      // CRC-32 of the payload
+    int64_t time_min;  // Earliest sample time
+    int64_t time_max;  // Latest sample time
+    int32_t temp_min;
+    int32_t temp_max;
+    int32_t humi_min;
+    int32_t humi_max;
+    int64_t temp_sum;
+    int64_t humi_sum;
+} ts_block_header_t;
+
+/**
+ * @brief Day segment open for appending
+ */
+typedef struct
+{
+    char device[TS_STORE_DEVICE_MAX]; // Empty when the slot is free
+    uint32_t hash;                    // TSStore_DeviceHash(device)
+    int64_t day;                      // Days since epoch
+    int fd;                           // Segment file (O_APPEND)
+    uint64_t last_use;                // LRU stamp
+    int64_t last_append;              // Wall clock of the last append (idle close)
+    uint32_t blocks;                  // Blocks written since open (compaction check)
+    uint16_t count;                   // Pending samples
+    ts_sample_t pending[TS_STORE_BLOCK_MAX];
+} ts_writer_t;
+
+/**
+ * @brief Store counters (cumulative since open)
+ */
+typedef struct
+{
+    uint64_t samples;       // Samples appended
+    uint64_t blocks;        // Blocks written
+    uint64_t bytes;         // Bytes written (headers included)
+    uint64_t segments;      // Segment files opened
+    uint64_t truncated;     // Torn blocks dropped when reopening a segment
+    uint64_t compacted;     // Segments rewritten with full blocks
+    uint64_t write_errors;  // Failed writes or opens
+} ts_store_stats_t;
+
+/**
+ * @brief Store handle
+ */
+typedef struct
+{
+    char root[TS_STORE_PATH_MAX / 2]; // Data directory
+    bool sync;                        // fsync() after every block
+    uint64_t clock;                   // LRU counter
+    ts_writer_t writers[TS_STORE_OPEN_MAX];
+    uint8_t *scratch;                 // Block encoding buffer
+    ts_store_stats_t stats;
+} ts_store_t;
+
+/**
+ * @brief Sequential block reader over one segment file
+ *
+ * @details The file is read into memory once (a day is at most a few MB), so
+ *          walking thousands of small blocks costs no system calls.
+ */
+typedef struct
+{
+    int64_t day;              // From the file header
+    ts_block_header_t header; // Current block
+    size_t payload_offset;    // Offset of the current payload in data
+    uint8_t *data;            // Segment file contents
+    size_t size;              // File size when opened
+} ts_segment_reader_t;
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Open a store
+ *
+ * @param store Store handle
+ * @param root Data directory (created if missing)
+ * @param sync true to fsync() every block (slower, survives power loss)
+ *
+ * @return true on success
+ */
+bool TSStore_Open(ts_store_t *store, const char *root, bool sync);
+
+/**
+ * @brief Append a sample
+ *
+ * @param store Store handle
+ * @param device Device id ([A-Za-z0-9_-], selects the directory)
+ * @param sample Sample to append
+ *
+ * @return true if buffered, false on invalid device id or I/O error
+ *
+ * @note Samples are buffered per day segment and written one block at a
+ *       time. Call TSStore_Flush() periodically to bound the loss on a crash.
+ */
+bool TSStore_Append(ts_store_t *store, const char *device, const ts_sample_t *sample);
+
+/**
+ * @brief Write all pending samples as blocks
+ *
+ * @param store Store handle
+ *
+ * @return true if every block was written
+ *
+ * @note Also closes and compacts segments of past days that have been idle
+ *       for TS_STORE_IDLE_CLOSE_S (day rollover, end of an archive replay)
+ */
+bool TSStore_Flush(ts_store_t *store);
+
+/**
+ * @brief Flush, compact and close all segments
+ *
+ * @param store Store handle
+ */
+void TSStore_Close(ts_store_t *store);
+
+/**
+ * @brief Get store counters
+ *
+ * @param store Store handle
+ * @param stats Pointer to structure to fill
+ */
+void TSStore_GetStats(const ts_store_t *store, ts_store_stats_t *stats);
+
+/**
+ * @brief Hash a device id (FNV-1a)
+ *
+ * @param device Device id
+ *
+ * @return Hash, used to skip string compares in per-device lookups
+ */
+uint32_t TSStore_DeviceHash(const char *device);
+
+/**
+ * @brief Build the path of a day segment
+ *
+ * @param buf Output buffer
+ * @param size Buffer size
+ * @param root Data directory
+ * @param device Device id
+ * @param day Days since epoch
+ *
+ * @return true if the path fits
+ */
+bool TSStore_SegmentPath(char *buf, size_t size, const char *root, const char *device, int64_t day);
+
+/**
+ * @brief Open a segment for reading
+ *
+ * @param reader Reader handle
+ * @param path Segment file path
+ *
+ * @return true if the file header is valid
+ */
+bool TSStore_ReaderOpen(ts_segment_reader_t *reader, const char *path);
+
+/**
+ * @brief Advance to the next block
+ *
+ * @param reader Reader handle
+ *
+ * @return true if a block header was read into reader->header, false at the
+ *         end of the file or at a torn block
+ *
+ * @note The payload is not read, so a block can be skipped on its summary alone
+ */
+bool TSStore_ReaderNext(ts_segment_reader_t *reader);
+
+/**
+ * @brief Decode the current block
+ *
+ * @param reader Reader handle
+ * @param samples Output array of at least reader->header.count entries
+ *
+ * @return true if the payload was read and its CRC matched
+ */
+bool TSStore_ReaderDecode(ts_segment_reader_t *reader, ts_sample_t *samples);
+
+/**
+ * @brief Close a segment reader
+ *
+ * @param reader Reader handle
+ */
+void TSStore_ReaderClose(ts_segment_reader_t *reader);
+
+#endif /* TS_STORE_H */
@@ -28,4 +28,17 @@
 #define BUTTON_DEBOUNCE_TIME_MS CONFIG_BUTTON_DEBOUNCE_TIME_MS
 #endif
 
+/* Long / Double Press Configuration */
+#ifndef CONFIG_BUTTON_LONG_PRESS_MS
+#define BUTTON_LONG_PRESS_MS 1000 // Default 1s if not configured
+#else
+#define BUTTON_LONG_PRESS_MS CONFIG_BUTTON_LONG_PRESS_MS
+#endif
+
+#ifndef CONFIG_BUTTON_DOUBLE_PRESS_MS
+#define BUTTON_DOUBLE_PRESS_MS 300 // Default 300ms if not configured
+#else
+#define BUTTON_DOUBLE_PRESS_MS CONFIG_BUTTON_DOUBLE_PRESS_MS
+#endif
+
 #endif /* BUTTON_CONFIG_H */
@@ -7,12 +7,25 @@
 /* INCLUDES ------------------------------------------------------------------*/
 
 #include "button_handler.h"
+#include "esp_attr.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "freertos/task.h"
 #include <string.h>
 
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Event passed from the debounce timer to the button task
+ */
+typedef struct
+{
+    button_handler_t *button; // NULL = stop request
+    button_event_t event;
+} button_event_msg_t;
+
 /* PRIVATE VARIABLES --------------------------------------------------------*/
 
 /* Private variables */
@@ -20,79 +33,211 @@ static const char *TAG = "BUTTON_HANDLER";
 static button_handler_t g_buttons[BUTTON_MAX_HANDLERS];
 static uint8_t g_button_count = 0;
 static TaskHandle_t g_button_task_handle = NULL;
+static QueueHandle_t g_event_queue = NULL;
 static bool g_task_running = false;
 
+// Guards the state machines: edges come from the GPIO ISR, timeouts from the esp_timer task
+static portMUX_TYPE g_button_lock = portMUX_INITIALIZER_UNLOCKED;
+
 /* PRIVATE FUNCTIONS --------------------------------------------------------*/
 
 /* Private function prototypes */
 static void button_task(void *arg);
+static void button_isr_handler(void *arg);
+static void button_timer_callback(void *arg);
 static bool is_button_pressed(gpio_num_t gpio_num);
-static bool should_process_press(button_handler_t *button);
+static button_handler_t *find_button(gpio_num_t gpio_num);
 
 /* PRIVATE FUNCTION IMPLEMENTATIONS -----------------------------------------*/
 
 /**
- * @brief Button monitoring task
+ * @brief Button event task
+ *
+ * @details Blocks on the event queue and runs the callbacks, so a slow
+ *          callback delays other callbacks but never press detection.
  */
 static void button_task(void *arg)
 {
-    ESP_LOGI(TAG, "Button monitoring task started");
+    button_event_msg_t msg;
+
+    ESP_LOGI(TAG, "Button event task started");
 
     while (g_task_running)
     {
-        // Check all registered buttons
-        for (uint8_t i = 0; i < g_button_count; i++)
+        if (xQueueReceive(g_event_queue, &msg, portMAX_DELAY) != pdTRUE || msg.button == NULL)
+        {
+            continue;
+        }
+
+        button_handler_t *button = msg.button;
+        button_press_callback_t callback = NULL;
+
+        switch (msg.event)
+        {
+        case BUTTON_EVENT_PRESS:
+            ESP_LOGI(TAG, "Button GPIO_%d pressed", button->gpio_num);
+            callback = button->callback;
+            break;
+
+        case BUTTON_EVENT_LONG_PRESS:
+            ESP_LOGI(TAG, "Button GPIO_%d long press", button->gpio_num);
+            callback = button->long_callback;
+            break;
+
+        case BUTTON_EVENT_DOUBLE_PRESS:
+            ESP_LOGI(TAG, "Button GPIO_%d double press", button->gpio_num);
+            callback = button->double_callback;
+            break;
+        }
+
+        if (callback)
         {
-            button_handler_t *button = &g_buttons[i];
+            callback(button->gpio_num);
+        }
+    }
+
+    ESP_LOGI(TAG, "Button event task stopped");
+    g_button_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief GPIO edge interrupt
+ *
+ * @param arg Button handler (button_handler_t*)
+ *
+ * @details Starts the debounce timer on the first edge. Further edges
+ *          (contact bounce) are ignored until the timer samples the pin.
+ */
+static void IRAM_ATTR button_isr_handler(void *arg)
+{
+    button_handler_t *button = (button_handler_t *)arg;
+
+    portENTER_CRITICAL_ISR(&g_button_lock);
+    if (!button->debouncing)
+    {
+        button->debouncing = true;
+        esp_timer_stop(button->timer); // Cancel a pending long/double press timeout
+        esp_timer_start_once(button->timer, BUTTON_DEBOUNCE_TIME_MS * 1000ULL);
+    }
+    portEXIT_CRITICAL_ISR(&g_button_lock);
+}
+
+/**
+ * @brief Debounce / long press / double press timer
+ *
+ * @param arg Button handler (button_handler_t*)
+ *
+ * @details After a debounce the pin level is stable and drives the state
+ *          machine. Otherwise the timer is a long press or double press
+ *          timeout. Detected events are posted to the button task.
+ */
+static void button_timer_callback(void *arg)
+{
+    button_handler_t *button = (button_handler_t *)arg;
+    bool has_event = false;
+    button_event_t event = BUTTON_EVENT_PRESS;
+    int64_t now_us = esp_timer_get_time();
+    bool pressed = is_button_pressed(button->gpio_num);
 
-            if (!button->initialized)
+    portENTER_CRITICAL(&g_button_lock);
+
+    if (button->debouncing)
+    {
+        button->debouncing = false;
+
+        switch (button->state)
+        {
+        case BUTTON_STATE_IDLE:
+            if (pressed)
             {
-                continue;
+                button->state = BUTTON_STATE_PRESSED;
+                button->edge_time_us = now_us;
+                if (button->long_callback)
+                {
+                    esp_timer_start_once(button->timer, BUTTON_LONG_PRESS_MS * 1000ULL);
+                }
             }
+            break;
 
-            // Check if button is pressed (LOW = pressed with pull-up)
-            if (is_button_pressed(button->gpio_num))
+        case BUTTON_STATE_PRESSED:
+            if (!pressed)
             {
-                // Check debounce - enough time since last press?
-                if (should_process_press(button))
+                if (button->double_callback)
                 {
-                    // Update last press time IMMEDIATELY to prevent multiple triggers
-                    button->last_press_time = esp_timer_get_time() / 1000;
-
-                    // Small delay to confirm it's not a glitch
-                    vTaskDelay(pdMS_TO_TICKS(50));
-
-                    if (!is_button_pressed(button->gpio_num))
-                    {
-                        // False trigger, button not actually pressed
-                        continue;
-                    }
-
-                    // Call callback
-                    if (button->callback)
-                    {
-                        ESP_LOGI(TAG, "Button GPIO_%d pressed", button->gpio_num);
-                        button->callback(button->gpio_num);
-                    }
-
-                    // Wait for button release to avoid multiple triggers
-                    while (is_button_pressed(button->gpio_num))
-                    {
-                        vTaskDelay(pdMS_TO_TICKS(50));
-                    }
-
-                    // Small delay after release
-                    vTaskDelay(pdMS_TO_TICKS(50));
+                    button->state = BUTTON_STATE_WAIT_DOUBLE;
+                    button->edge_time_us = now_us;
+                    esp_timer_start_once(button->timer, BUTTON_DOUBLE_PRESS_MS * 1000ULL);
                 }
+                else
+                {
+                    button->state = BUTTON_STATE_IDLE;
+                    has_event = true;
+                    event = BUTTON_EVENT_PRESS;
+                }
+            }
+            else if (button->long_callback)
+            {
+                // Bounce while held: resume the long press timeout
+                int64_t remain_us = BUTTON_LONG_PRESS_MS * 1000LL - (now_us - button->edge_time_us);
+                esp_timer_start_once(button->timer, remain_us > 0 ? (uint64_t)remain_us : 1);
+            }
+            break;
+
+        case BUTTON_STATE_HELD:
+            if (!pressed)
+            {
+                button->state = BUTTON_STATE_IDLE;
+            }
+            break;
+
+        case BUTTON_STATE_WAIT_DOUBLE:
+            if (pressed)
+            {
+                button->state = BUTTON_STATE_HELD;
+                has_event = true;
+                event = BUTTON_EVENT_DOUBLE_PRESS;
+            }
+            else
+            {
+                // Glitch while released: keep waiting for the rest of the window
+                int64_t remain_us = BUTTON_DOUBLE_PRESS_MS * 1000LL - (now_us - button->edge_time_us);
+                esp_timer_start_once(button->timer, remain_us > 0 ? (uint64_t)remain_us : 1);
             }
+            break;
         }
 
-        vTaskDelay(pdMS_TO_TICKS(20)); // Check every 20ms (reduced from 10ms to save CPU)
+        // Level changed again while the edge interrupt was ignored: debounce once more
+        if (is_button_pressed(button->gpio_num) != pressed)
+        {
+            button->debouncing = true;
+            esp_timer_stop(button->timer);
+            esp_timer_start_once(button->timer, BUTTON_DEBOUNCE_TIME_MS * 1000ULL);
+        }
+    }
+    else if (button->state == BUTTON_STATE_PRESSED && pressed)
+    {
+        button->state = BUTTON_STATE_HELD;
+        has_event = true;
+        event = BUTTON_EVENT_LONG_PRESS;
+    }
+    else if (button->state == BUTTON_STATE_WAIT_DOUBLE)
+    {
+        button->state = BUTTON_STATE_IDLE;
+        has_event = true;
+        event = BUTTON_EVENT_PRESS;
     }
 
-    ESP_LOGI(TAG, "Button monitoring task stopped");
-    g_button_task_handle = NULL;
-    vTaskDelete(NULL);
+    portEXIT_CRITICAL(&g_button_lock);
+
+    if (has_event && g_event_queue)
+    {
+        button_event_msg_t msg = {.button = button, .event = event};
+        if (xQueueSend(g_event_queue, &msg, 0) != pdTRUE)
+        {
+            ESP_LOGW(TAG, "Event queue full, GPIO_%d event dropped", button->gpio_num);
+        }
+    }
 }
 
 /**
@@ -109,18 +254,23 @@ static bool is_button_pressed(gpio_num_t gpio_num)
 }
 
 /**
- * @brief Check if button press should be processed (debounce)
+ * @brief Find a registered button
  *
- * @param button Pointer to button handler
+ * @param gpio_num GPIO number of the button
  *
- * @return true if enough time has passed since last press, false otherwise
+ * @return Button handler, or NULL if not initialized
  */
-static bool should_process_press(button_handler_t *button)
+static button_handler_t *find_button(gpio_num_t gpio_num)
 {
-    uint32_t current_time = esp_timer_get_time() / 1000; // Convert to ms
-    uint32_t time_since_last_press = current_time - button->last_press_time;
+    for (uint8_t i = 0; i < g_button_count; i++)
+    {
+        if (g_buttons[i].initialized && g_buttons[i].gpio_num == gpio_num)
+        {
+            return &g_buttons[i];
+        }
+    }
 
-    return (time_since_last_press >= BUTTON_DEBOUNCE_TIME_MS);
+    return NULL;
 }
 
 /* PUBLIC API ---------------------------------------------------------------*/
@@ -142,16 +292,35 @@ bool Button_Init(gpio_num_t gpio_num, button_press_callback_t callback)
         return false;
     }
 
+    // Event queue shared by all buttons (created with the first one)
+    if (g_event_queue == NULL)
+    {
+        g_event_queue = xQueueCreate(BUTTON_EVENT_QUEUE_LEN, sizeof(button_event_msg_t));
+        if (g_event_queue == NULL)
+        {
+            ESP_LOGE(TAG, "Failed to create event queue");
+            return false;
+        }
+    }
+
+    // GPIO ISR service is shared with other components, already installed is fine
+    esp_err_t ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE)
+    {
+        ESP_LOGE(TAG, "Failed to install GPIO ISR service: %s", esp_err_to_name(ret));
+        return false;
+    }
+
     // Configure GPIO with internal pull-up
     gpio_config_t io_conf = {
         .pin_bit_mask = (1ULL << gpio_num),
         .mode = GPIO_MODE_INPUT,
         .pull_up_en = GPIO_PULLUP_ENABLE, // Enable internal pull-up
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE // No interrupt, polling mode
+        .intr_type = GPIO_INTR_ANYEDGE // Press and release edges start the debounce timer
     };
 
-    esp_err_t ret = gpio_config(&io_conf);
+    ret = gpio_config(&io_conf);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to configure GPIO_%d: %s", gpio_num, esp_err_to_name(ret));
@@ -160,14 +329,66 @@ bool Button_Init(gpio_num_t gpio_num, button_press_callback_t callback)
 
     // Register button
     button_handler_t *button = &g_buttons[g_button_count];
+    memset(button, 0, sizeof(*button));
     button->gpio_num = gpio_num;
     button->callback = callback;
-    button->last_press_time = 0;
-    button->initialized = true;
+    button->state = BUTTON_STATE_IDLE;
+
+    esp_timer_create_args_t timer_args = {
+        .callback = button_timer_callback,
+        .arg = button,
+        .name = "button"};
+
+    ret = esp_timer_create(&timer_args, &button->timer);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create timer for GPIO_%d: %s", gpio_num, esp_err_to_name(ret));
+        return false;
+    }
+
+    ret = gpio_isr_handler_add(gpio_num, button_isr_handler, button);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to add ISR for GPIO_%d: %s", gpio_num, esp_err_to_name(ret));
+        esp_timer_delete(button->timer);
+        button->timer = NULL;
+        return false;
+    }
 
+    button->initialized = true;
     g_button_count++;
 
-    ESP_LOGI(TAG, "Button GPIO_%d initialized (pull-up enabled)", gpio_num);
+    ESP_LOGI(TAG, "Button GPIO_%d initialized (pull-up, edge interrupt)", gpio_num);
+    return true;
+}
+
+/**
+ * @brief Set long press callback
+ */
+bool Button_SetLongPressCallback(gpio_num_t gpio_num, button_press_callback_t callback)
+{
+    button_handler_t *button = find_button(gpio_num);
+    if (button == NULL)
+    {
+        return false;
+    }
+
+    button->long_callback = callback;
+    return true;
+}
+
+/**
+ * @brief Set double press callback
+ */
+bool Button_SetDoublePressCallback(gpio_num_t gpio_num, button_press_callback_t callback)
+{
+    button_handler_t *button = find_button(gpio_num);
+    if (button == NULL)
+    {
+        return false;
+    }
+
+    button->double_callback = callback;
     return true;
 }
 
@@ -193,7 +414,7 @@ bool Button_StartTask(void)
     BaseType_t ret = xTaskCreate(
         button_task,
         "button_task",
-        4096, // Increased stack size from 2048 to 4096 bytes
+        4096, // Callbacks send UART commands and publish MQTT state
         NULL,
         4, // Priority (lower than UART task priority 5)
         &g_button_task_handle);
@@ -205,7 +426,7 @@ bool Button_StartTask(void)
         return false;
     }
 
-    ESP_LOGI(TAG, "Task started (monitoring %d buttons)", g_button_count);
+    ESP_LOGI(TAG, "Task started (%d buttons)", g_button_count);
     return true;
 }
 
@@ -222,6 +443,10 @@ void Button_StopTask(void)
     ESP_LOGI(TAG, "Stopping task...");
     g_task_running = false;
 
+    // Wake the task so it sees the stop request
+    button_event_msg_t msg = {.button = NULL, .event = BUTTON_EVENT_PRESS};
+    xQueueSend(g_event_queue, &msg, pdMS_TO_TICKS(100));
+
     // Wait for task to finish
     vTaskDelay(pdMS_TO_TICKS(100));
 }
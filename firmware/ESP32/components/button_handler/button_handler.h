@@ -12,12 +12,14 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "driver/gpio.h"
+#include "esp_timer.h"
 #include "button_config.h"
 
 /* DEFINES -------------------------------------------------------------------*/
 
 /* Configuration */
-#define BUTTON_MAX_HANDLERS 4 // Maximum number of buttons
+#define BUTTON_MAX_HANDLERS 4    // Maximum number of buttons
+#define BUTTON_EVENT_QUEUE_LEN 8 // Detected presses waiting for the button task
 
 /* TYPEDEFS ------------------------------------------------------------------*/
 
@@ -28,15 +30,41 @@
  */
 typedef void (*button_press_callback_t)(gpio_num_t gpio_num);
 
+/**
+ * @brief Button event type
+ */
+typedef enum
+{
+    BUTTON_EVENT_PRESS,        // Short press (released before the long-press time)
+    BUTTON_EVENT_LONG_PRESS,   // Held for BUTTON_LONG_PRESS_MS
+    BUTTON_EVENT_DOUBLE_PRESS, // Second press within BUTTON_DOUBLE_PRESS_MS of a release
+} button_event_t;
+
+/**
+ * @brief Debounce state machine state
+ */
+typedef enum
+{
+    BUTTON_STATE_IDLE,        // Released
+    BUTTON_STATE_PRESSED,     // Pressed, nothing reported yet
+    BUTTON_STATE_HELD,        // Pressed, long/double press already reported
+    BUTTON_STATE_WAIT_DOUBLE, // Released, waiting for a second press
+} button_state_t;
+
 /**
  * @brief Button handler structure
  */
 typedef struct
 {
-    gpio_num_t gpio_num;              // GPIO number
-    button_press_callback_t callback; // Callback when button pressed
-    uint32_t last_press_time;         // Last press timestamp (for debounce)
-    bool initialized;                 // Initialization state
+    gpio_num_t gpio_num;                     // GPIO number
+    button_press_callback_t callback;        // Callback on short press
+    button_press_callback_t long_callback;   // Callback on long press (NULL = none)
+    button_press_callback_t double_callback; // Callback on double press (NULL = none)
+    esp_timer_handle_t timer;                // Debounce / long / double press timer
+    volatile button_state_t state;           // State machine state
+    volatile bool debouncing;                // Debounce timer running, edges ignored
+    int64_t edge_time_us;                    // Time of the last debounced press/release
+    bool initialized;                        // Initialization state
 } button_handler_t;
 
 /* PUBLIC API ----------------------------------------------------------------*/
@@ -49,17 +77,44 @@ typedef struct
  *
  * @return true if initialized successfully, false otherwise
  *
- * @details Configures GPIO with internal pull-up resistor.
- *          Button should connect GPIO to GND when pressed.
+ * @details Configures GPIO with internal pull-up resistor and an interrupt
+ *          on both edges. Button should connect GPIO to GND when pressed.
  */
 bool Button_Init(gpio_num_t gpio_num, button_press_callback_t callback);
 
+/**
+ * @brief Set long press callback
+ *
+ * @param gpio_num GPIO number of an initialized button
+ * @param callback Called once when the button is held for BUTTON_LONG_PRESS_MS
+ *
+ * @return true if set, false if the button is not initialized
+ *
+ * @details A long press does not also report a short press on release.
+ */
+bool Button_SetLongPressCallback(gpio_num_t gpio_num, button_press_callback_t callback);
+
+/**
+ * @brief Set double press callback
+ *
+ * @param gpio_num GPIO number of an initialized button
+ * @param callback Called when a second press starts within BUTTON_DOUBLE_PRESS_MS
+ *
+ * @return true if set, false if the button is not initialized
+ *
+ * @details With a double press callback, short presses are reported
+ *          BUTTON_DOUBLE_PRESS_MS after release instead of immediately.
+ */
+bool Button_SetDoublePressCallback(gpio_num_t gpio_num, button_press_callback_t callback);
+
 /**
  * @brief Start button handler task
  *
  * @return true if task started successfully, false otherwise
  *
- * @details Creates FreeRTOS task to monitor button states.
+ * @details Creates FreeRTOS task that runs the callbacks of the events
+ *          detected by the GPIO interrupts and debounce timers. The task
+ *          blocks on the event queue, so it never wakes while idle.
  */
 bool Button_StartTask(void);
 
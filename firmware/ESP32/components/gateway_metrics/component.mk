@@ -0,0 +1,4 @@
+# Component makefile for legacy build system (ESP-IDF v3.x and earlier)
+
+COMPONENT_ADD_INCLUDEDIRS := .
+COMPONENT_SRCDIRS := .
@@ -0,0 +1,216 @@
+/**
+ * @file gateway_metrics.c
+ *
+ * @brief Gateway Metrics Library Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include "gateway_metrics.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* PRIVATE VARIABLES ---------------------------------------------------------*/
+
+static const char *TAG = "GW_METRICS";
+
+static uint32_t g_interval_ms = 0;
+static uint32_t g_last_report_ms = 0;
+static gateway_metrics_input_t g_previous;
+static bool g_has_previous = false;
+
+static char g_task_names[GATEWAY_METRICS_MAX_TASKS][GATEWAY_METRICS_TASK_NAME_LEN];
+static uint8_t g_task_count = 0;
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+/**
+ * @brief Append formatted text to the document
+ *
+ * @param buffer Document buffer
+ * @param buffer_size Size of the buffer
+ * @param pos Current length, advanced on success
+ * @param fmt printf format
+ *
+ * @return true if the text fit, false if truncated
+ */
+static bool metrics_append(char *buffer, size_t buffer_size, size_t *pos, const char *fmt, ...)
+{
+    if (*pos >= buffer_size)
+    {
+        return false;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buffer + *pos, buffer_size - *pos, fmt, args);
+    va_end(args);
+
+    if (len < 0 || (size_t)len >= buffer_size - *pos)
+    {
+        *pos = buffer_size;
+        return false;
+    }
+
+    *pos += len;
+    return true;
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize gateway metrics
+ */
+bool GatewayMetrics_Init(uint32_t interval_ms)
+{
+    if (interval_ms == 0)
+    {
+        return false;
+    }
+
+    g_interval_ms = interval_ms;
+    g_last_report_ms = 0;
+    g_has_previous = false;
+    g_task_count = 0;
+    memset(&g_previous, 0, sizeof(g_previous));
+
+    ESP_LOGI(TAG, "Init: report every %lu ms", (unsigned long)interval_ms);
+    return true;
+}
+
+/**
+ * @brief Add a task to the stack high-water mark report
+ */
+bool GatewayMetrics_WatchTask(const char *name)
+{
+    if (!name || g_task_count >= GATEWAY_METRICS_MAX_TASKS)
+    {
+        return false;
+    }
+
+    strncpy(g_task_names[g_task_count], name, GATEWAY_METRICS_TASK_NAME_LEN - 1);
+    g_task_names[g_task_count][GATEWAY_METRICS_TASK_NAME_LEN - 1] = '\0';
+    g_task_count++;
+    return true;
+}
+
+/**
+ * @brief Check if a report is due
+ */
+bool GatewayMetrics_IsDue(uint32_t now_ms)
+{
+    if (g_interval_ms == 0)
+    {
+        return false;
+    }
+
+    return !g_has_previous || (now_ms - g_last_report_ms) >= g_interval_ms;
+}
+
+/**
+ * @brief Create the metrics JSON document
+ */
+int GatewayMetrics_Format(const gateway_metrics_input_t *input, uint32_t now_ms,
+                          char *buffer, size_t buffer_size)
+{
+    if (!input || !buffer || buffer_size == 0)
+    {
+        return -1;
+    }
+
+    // Differences against the previous report (first report: since boot)
+    const gateway_metrics_input_t *prev = &g_previous;
+    uint32_t elapsed_ms = g_has_previous ? (now_ms - g_last_report_ms) : now_ms;
+    float elapsed_s = (elapsed_ms > 0) ? elapsed_ms / 1000.0f : 1.0f;
+
+    uint32_t d_bytes = input->uart_rx_bytes - prev->uart_rx_bytes;
+    uint32_t d_lines = input->uart_rx_lines - prev->uart_rx_lines;
+    uint32_t d_published = input->mqtt_published - prev->mqtt_published;
+    uint32_t d_acked = input->mqtt_acked - prev->mqtt_acked;
+
+    uint32_t publish_avg_us = d_published
+                                  ? (uint32_t)((input->mqtt_publish_total_us - prev->mqtt_publish_total_us) / d_published)
+                                  : 0;
+    uint32_t ack_avg_ms = d_acked
+                              ? (uint32_t)((input->mqtt_ack_total_ms - prev->mqtt_ack_total_ms) / d_acked)
+                              : 0;
+
+    size_t pos = 0;
+    bool ok = true;
+
+    ok &= metrics_append(buffer, buffer_size, &pos,
+                         "{\"uptime\":%lu,\"interval\":%lu,"
+                         "\"uart\":{\"bps\":%.1f,\"lps\":%.2f,\"bytes\":%lu,\"lines\":%lu,"
+                         "\"overflows\":%lu,\"dropped\":%lu,\"rejected\":%lu,\"too_long\":%lu,"
+                         "\"fifo_overflows\":%lu,\"baud\":%lu,\"link_errors\":%lu,\"demotions\":%lu},"
+                         "\"parse_errors\":%lu,",
+                         (unsigned long)(now_ms / 1000), (unsigned long)(elapsed_ms / 1000),
+                         d_bytes / elapsed_s, d_lines / elapsed_s,
+                         (unsigned long)input->uart_rx_bytes, (unsigned long)input->uart_rx_lines,
+                         (unsigned long)input->uart_ring_overflows, (unsigned long)input->uart_dropped_bytes,
+                         (unsigned long)input->uart_rejected_lines, (unsigned long)input->uart_long_lines,
+                         (unsigned long)input->uart_fifo_overflows, (unsigned long)input->uart_baud,
+                         (unsigned long)input->uart_link_errors, (unsigned long)input->uart_demotions,
+                         (unsigned long)input->parse_failures);
+
+    ok &= metrics_append(buffer, buffer_size, &pos,
+                         "\"mqtt\":{\"published\":%lu,\"failed\":%lu,"
+                         "\"publish_us\":{\"avg\":%lu,\"max\":%lu},\"ack_ms\":{\"avg\":%lu,\"max\":%lu},"
+                         "\"outbox\":%ld,\"queue\":%lu,\"busy\":%lu,\"connects\":%lu,\"retries\":%lu},"
+                         "\"wifi\":{\"reconnects\":%lu,\"rssi\":%d},",
+                         (unsigned long)input->mqtt_published, (unsigned long)input->mqtt_publish_failed,
+                         (unsigned long)publish_avg_us, (unsigned long)input->mqtt_publish_max_us,
+                         (unsigned long)ack_avg_ms, (unsigned long)input->mqtt_ack_max_ms,
+                         (long)input->mqtt_outbox_bytes, (unsigned long)input->mqtt_queue_depth,
+                         (unsigned long)input->mqtt_backpressure, (unsigned long)input->mqtt_connects,
+                         (unsigned long)input->mqtt_reconnect_attempts,
+                         (unsigned long)input->wifi_reconnects, input->wifi_rssi);
+
+    if (input->power_save)
+    {
+        // Share of the interval spent out of light sleep
+        float awake_pct = (input->power_awake_ms - prev->power_awake_ms) * 100.0f / (elapsed_s * 1000.0f);
+        ok &= metrics_append(buffer, buffer_size, &pos,
+                             "\"power\":{\"awake_pct\":%.1f,\"wakes\":%lu,\"unscheduled\":%lu},",
+                             awake_pct, (unsigned long)input->power_wakes,
+                             (unsigned long)input->power_unscheduled);
+    }
+
+    ok &= metrics_append(buffer, buffer_size, &pos, "\"heap\":{\"free\":%lu,\"min\":%lu},\"stack\":{",
+                         (unsigned long)esp_get_free_heap_size(),
+                         (unsigned long)esp_get_minimum_free_heap_size());
+
+    // Stack high-water marks in bytes (tasks not running are skipped)
+    bool first = true;
+    for (uint8_t i = 0; i < g_task_count; i++)
+    {
+        TaskHandle_t task = xTaskGetHandle(g_task_names[i]);
+        if (task == NULL)
+        {
+            continue;
+        }
+
+        ok &= metrics_append(buffer, buffer_size, &pos, "%s\"%s\":%lu", first ? "" : ",",
+                             g_task_names[i], (unsigned long)uxTaskGetStackHighWaterMark(task));
+        first = false;
+    }
+
+    ok &= metrics_append(buffer, buffer_size, &pos, "}}");
+
+    g_previous = *input;
+    g_last_report_ms = now_ms;
+    g_has_previous = true;
+
+    if (!ok)
+    {
+        ESP_LOGW(TAG, "Metrics document truncated");
+        return -1;
+    }
+
+    return (int)pos;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file gateway_metrics.h
+ *
+ * @brief Gateway Metrics Library for ESP32
+ */
+
+#ifndef GATEWAY_METRICS_H
+#define GATEWAY_METRICS_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+#define GATEWAY_METRICS_MAX_TASKS 6      // Tasks whose stack high-water mark is reported
+#define GATEWAY_METRICS_TASK_NAME_LEN 16 // configMAX_TASK_NAME_LEN on ESP-IDF
+#define GATEWAY_METRICS_MSG_LEN 768      // Buffer size for the metrics document
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @typedef gateway_metrics_input_t
+ *
+ * @brief Cumulative counters collected from the gateway components
+ *
+ * @details All counters are totals since boot. Rates and interval averages
+ *          are computed by GatewayMetrics_Format() from the difference to
+ *          the previous report.
+ */
+typedef struct
+{
+    // STM32 UART link
+    uint32_t uart_rx_bytes;       /*!< Bytes received */
+    uint32_t uart_rx_lines;       /*!< Valid lines received */
+    uint32_t uart_rejected_lines; /*!< Lines dropped by validation */
+    uint32_t uart_long_lines;     /*!< Lines longer than the line buffer */
+    uint32_t uart_ring_overflows; /*!< "Ring buffer full, data lost" events */
+    uint32_t uart_dropped_bytes;  /*!< Bytes lost to ring buffer overflow */
+    uint32_t uart_fifo_overflows; /*!< UART driver FIFO/buffer overflows */
+    uint32_t uart_baud;           /*!< Negotiated baud rate */
+    uint32_t uart_link_errors;    /*!< Framing/parity errors and noise bytes */
+    uint32_t uart_demotions;      /*!< Rates dropped because of link errors */
+
+    // JSON parser
+    uint32_t parse_failures; /*!< Lines the JSON parser rejected */
+
+    // MQTT
+    uint32_t mqtt_published;          /*!< Messages handed to the client outbox */
+    uint32_t mqtt_publish_failed;     /*!< Messages dropped (queue full, no memory) */
+    uint64_t mqtt_publish_total_us;   /*!< Sum of publish-to-outbox times */
+    uint32_t mqtt_publish_max_us;     /*!< Longest publish-to-outbox time */
+    uint32_t mqtt_acked;              /*!< QoS 1/2 acknowledges */
+    uint64_t mqtt_ack_total_ms;       /*!< Sum of publish-to-acknowledge times */
+    uint32_t mqtt_ack_max_ms;         /*!< Longest publish-to-acknowledge time */
+    int32_t mqtt_outbox_bytes;        /*!< Current outbox size (-1 = unknown) */
+    uint32_t mqtt_queue_depth;        /*!< Messages in the publish queue */
+    uint32_t mqtt_backpressure;       /*!< Times back-pressure was raised */
+    uint32_t mqtt_connects;           /*!< Successful connections */
+    uint32_t mqtt_reconnect_attempts; /*!< Reconnect attempts */
+
+    // WiFi
+    uint32_t wifi_reconnects; /*!< WiFi connections restored after a loss */
+    int8_t wifi_rssi;         /*!< Current RSSI in dBm (0 = not connected) */
+
+    // Power manager (only reported when power_save is set)
+    bool power_save;            /*!< Light sleep enabled */
+    uint32_t power_wakes;       /*!< Awake windows opened */
+    uint64_t power_awake_ms;    /*!< Time light sleep was blocked */
+    uint32_t power_unscheduled; /*!< Samples that arrived with no window open */
+} gateway_metrics_input_t;
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize gateway metrics
+ *
+ * @param interval_ms Report interval in milliseconds
+ *
+ * @return true if successful
+ */
+bool GatewayMetrics_Init(uint32_t interval_ms);
+
+/**
+ * @brief Add a task to the stack high-water mark report
+ *
+ * @param name FreeRTOS task name (e.g. "stm32_uart")
+ *
+ * @return true if added, false if the list is full
+ *
+ * @details The task is looked up by name at every report, so tasks that
+ *          start later (e.g. "mqtt_task") or are deleted are handled.
+ */
+bool GatewayMetrics_WatchTask(const char *name);
+
+/**
+ * @brief Check if a report is due
+ *
+ * @param now_ms Current time in milliseconds
+ *
+ * @return true if the report interval has elapsed since the last report
+ */
+bool GatewayMetrics_IsDue(uint32_t now_ms);
+
+/**
+ * @brief Create the metrics JSON document
+ *
+ * @param input Cumulative counters
+ * @param now_ms Current time in milliseconds
+ * @param buffer Buffer to store JSON string
+ * @param buffer_size Size of the buffer (GATEWAY_METRICS_MSG_LEN recommended)
+ *
+ * @return Number of characters written, or -1 on error/truncation
+ *
+ * @details Computes per-second rates and interval averages against the
+ *          previous call, then stores @p input as the new reference.
+ *          Adds free heap and watched task stack high-water marks.
+ */
+int GatewayMetrics_Format(const gateway_metrics_input_t *input, uint32_t now_ms,
+                          char *buffer, size_t buffer_size);
+
+#endif /* GATEWAY_METRICS_H */
@@ -193,11 +193,43 @@ bool JSON_Parser_Init(json_sensor_parser_t *parser,
     parser->single_callback = single_callback;
     parser->periodic_callback = periodic_callback;
     parser->error_callback = error_callback;
+    parser->archive_callback = NULL;
+    parser->backlog_callback = NULL;
 
     ESP_LOGI(TAG, "JSON sensor parser initialized");
     return true;
 }
 
+/**
+ * @brief Set callback for records streamed from the STM32 SD archive
+ */
+void JSON_Parser_SetArchiveCallback(json_sensor_parser_t *parser,
+                                    sensor_data_callback_t archive_callback)
+{
+    if (!parser)
+    {
+        ESP_LOGE(TAG, "Parser is NULL");
+        return;
+    }
+
+    parser->archive_callback = archive_callback;
+}
+
+/**
+ * @brief Set callback for records replayed from the STM32 SD buffer
+ */
+void JSON_Parser_SetBacklogCallback(json_sensor_parser_t *parser,
+                                    sensor_data_callback_t backlog_callback)
+{
+    if (!parser)
+    {
+        ESP_LOGE(TAG, "Parser is NULL");
+        return;
+    }
+
+    parser->backlog_callback = backlog_callback;
+}
+
 /**
  * @brief Parse JSON sensor data line
  */
@@ -259,6 +291,12 @@ sensor_data_t JSON_Parser_ParseLine(json_sensor_parser_t *parser, const char *js
         data.humidity = hum;
     }
 
+    // Extract suppressed sample count (optional, only sent in deadband mode)
+    json_get_uint(json_line, JSON_FIELD_SUPPRESSED, &data.suppressed);
+
+    // Extract SD buffer sequence number (optional, only sent on backlog replay)
+    data.has_sequence = json_get_uint(json_line, JSON_FIELD_SEQUENCE, &data.sequence_num);
+
     // Validate that we have at least one sensor reading
     if (!data.has_temperature && !data.has_humidity)
     {
@@ -337,6 +375,13 @@ bool JSON_Parser_ProcessLine(json_sensor_parser_t *parser, const char *json_line
         return false;
     }
 
+    // Replayed SD records have their own route, whatever mode they were taken in
+    if (data.has_sequence && parser->backlog_callback)
+    {
+        parser->backlog_callback(&data);
+        return true;
+    }
+
     // Call appropriate callback based on mode
     switch (data.mode)
     {
@@ -354,6 +399,13 @@ bool JSON_Parser_ProcessLine(json_sensor_parser_t *parser, const char *json_line
         }
         break;
 
+    case SENSOR_MODE_ARCHIVE:
+        if (parser->archive_callback)
+        {
+            parser->archive_callback(&data);
+        }
+        break;
+
     default:
         ESP_LOGW(TAG, "No callback for sensor mode: %d", data.mode);
         return false;
@@ -380,6 +432,10 @@ sensor_mode_t JSON_Parser_GetMode(const char *mode_str)
     {
         return SENSOR_MODE_PERIODIC;
     }
+    else if (strcmp(mode_str, JSON_MODE_ARCHIVE) == 0)
+    {
+        return SENSOR_MODE_ARCHIVE;
+    }
 
     return SENSOR_MODE_UNKNOWN;
 }
@@ -395,6 +451,8 @@ const char *JSON_Parser_GetModeString(sensor_mode_t mode)
         return JSON_MODE_SINGLE;
     case SENSOR_MODE_PERIODIC:
         return JSON_MODE_PERIODIC;
+    case SENSOR_MODE_ARCHIVE:
+        return JSON_MODE_ARCHIVE;
     default:
         return "UNKNOWN";
     }
@@ -21,12 +21,15 @@
 /* Sensor modes */
 #define JSON_MODE_SINGLE "SINGLE"
 #define JSON_MODE_PERIODIC "PERIODIC"
+#define JSON_MODE_ARCHIVE "ARCHIVE"
 
 /* JSON field names */
 #define JSON_FIELD_MODE "mode"
 #define JSON_FIELD_TIMESTAMP "timestamp"
 #define JSON_FIELD_TEMPERATURE "temperature"
 #define JSON_FIELD_HUMIDITY "humidity"
+#define JSON_FIELD_SUPPRESSED "suppressed"
+#define JSON_FIELD_SEQUENCE "seq"
 
 /* TYPEDEFS ------------------------------------------------------------------*/
 
@@ -38,7 +41,8 @@ typedef enum
 {
     SENSOR_MODE_UNKNOWN = 0, /*!< Invalid or unknown mode */
     SENSOR_MODE_SINGLE,      /*!< One-shot measurement mode */
-    SENSOR_MODE_PERIODIC     /*!< Continuous measurement mode */
+    SENSOR_MODE_PERIODIC,    /*!< Continuous measurement mode */
+    SENSOR_MODE_ARCHIVE      /*!< Record streamed back from STM32 SD archive */
 } sensor_mode_t;
 
 /**
@@ -63,6 +67,13 @@ typedef struct
     bool has_humidity; /*!< Humidity field available */
     float humidity;    /*!< Relative humidity in % (0.00 = sensor failure) */
 
+    /* Deadband reporting */
+    uint32_t suppressed; /*!< Samples skipped by STM32 since previous report (0 = none) */
+
+    /* SD backlog replay */
+    bool has_sequence;     /*!< Record replayed from the STM32 SD buffer */
+    uint32_t sequence_num; /*!< SD buffer sequence number (idempotent record key) */
+
     /* Future extensibility: Add more sensor fields here
      * Example:
      * bool has_pressure;
@@ -93,6 +104,8 @@ typedef struct
     sensor_data_callback_t single_callback;   /*!< Callback for SINGLE mode data */
     sensor_data_callback_t periodic_callback; /*!< Callback for PERIODIC mode data */
     sensor_data_callback_t error_callback;    /*!< Callback for parsing errors (optional) */
+    sensor_data_callback_t archive_callback;  /*!< Callback for ARCHIVE query results (optional) */
+    sensor_data_callback_t backlog_callback;  /*!< Callback for records replayed from the SD buffer (optional) */
 } json_sensor_parser_t;
 
 /* PUBLIC API ----------------------------------------------------------------*/
@@ -114,6 +127,29 @@ bool JSON_Parser_Init(json_sensor_parser_t *parser,
                       sensor_data_callback_t periodic_callback,
                       sensor_data_callback_t error_callback);
 
+/**
+ * @brief Set callback for records streamed from the STM32 SD archive
+ *
+ * @param parser Parser structure
+ * @param archive_callback Callback for ARCHIVE mode records (NULL to disable)
+ *
+ * @note Call after JSON_Parser_Init(). Without a callback ARCHIVE lines are dropped.
+ */
+void JSON_Parser_SetArchiveCallback(json_sensor_parser_t *parser,
+                                    sensor_data_callback_t archive_callback);
+
+/**
+ * @brief Set callback for records replayed from the STM32 SD buffer
+ *
+ * @param parser Parser structure
+ * @param backlog_callback Callback for lines carrying a "seq" field (NULL to disable)
+ *
+ * @note Call after JSON_Parser_Init(). Without a callback replayed records go
+ *       to the SINGLE/PERIODIC callbacks like live data.
+ */
+void JSON_Parser_SetBacklogCallback(json_sensor_parser_t *parser,
+                                    sensor_data_callback_t backlog_callback);
+
 /**
  * @brief Parse JSON sensor data line
  *
@@ -144,7 +180,7 @@ bool JSON_Parser_ProcessLine(json_sensor_parser_t *parser, const char *json_line
 /**
  * @brief Get sensor mode from string
  *
- * @param mode_str Mode string ("SINGLE" or "PERIODIC")
+ * @param mode_str Mode string ("SINGLE", "PERIODIC" or "ARCHIVE")
  *
  * @return sensor_mode_t enum value
  */
@@ -155,7 +191,7 @@ sensor_mode_t JSON_Parser_GetMode(const char *mode_str);
  *
  * @param mode sensor_mode_t enum value
  *
- * @return Mode string ("SINGLE", "PERIODIC", or "UNKNOWN")
+ * @return Mode string ("SINGLE", "PERIODIC", "ARCHIVE" or "UNKNOWN")
  */
 const char *JSON_Parser_GetModeString(sensor_mode_t mode);
 
@@ -21,18 +21,54 @@ int JSON_Utils_CreateSensorData(char *buffer, size_t buffer_size,
                                 const char *mode,
                                 uint32_t timestamp,
                                 float temperature,
-                                float humidity)
+                                float humidity,
+                                uint32_t suppressed)
 {
     if (!buffer || buffer_size == 0 || !mode)
     {
         return -1;
     }
 
+    if (suppressed > 0)
+    {
+        return snprintf(buffer, buffer_size,
+                        "{\"mode\":\"%s\",\"timestamp\":%" PRIu32 ",\"temperature\":%.2f,\"humidity\":%.2f,\"suppressed\":%" PRIu32 "}",
+                        mode, timestamp, temperature, humidity, suppressed);
+    }
+
     return snprintf(buffer, buffer_size,
                     "{\"mode\":\"%s\",\"timestamp\":%" PRIu32 ",\"temperature\":%.2f,\"humidity\":%.2f}",
                     mode, timestamp, temperature, humidity);
 }
 
+/**
+ * @brief Create JSON message for a record replayed from the STM32 SD buffer
+ */
+int JSON_Utils_CreateBacklogData(char *buffer, size_t buffer_size,
+                                 const char *mode,
+                                 uint32_t timestamp,
+                                 float temperature,
+                                 float humidity,
+                                 uint32_t suppressed,
+                                 uint32_t sequence_num)
+{
+    if (!buffer || buffer_size == 0 || !mode)
+    {
+        return -1;
+    }
+
+    if (suppressed > 0)
+    {
+        return snprintf(buffer, buffer_size,
+                        "{\"mode\":\"%s\",\"timestamp\":%" PRIu32 ",\"temperature\":%.2f,\"humidity\":%.2f,\"suppressed\":%" PRIu32 ",\"seq\":%" PRIu32 "}",
+                        mode, timestamp, temperature, humidity, suppressed, sequence_num);
+    }
+
+    return snprintf(buffer, buffer_size,
+                    "{\"mode\":\"%s\",\"timestamp\":%" PRIu32 ",\"temperature\":%.2f,\"humidity\":%.2f,\"seq\":%" PRIu32 "}",
+                    mode, timestamp, temperature, humidity, sequence_num);
+}
+
 /**
  * @brief Create JSON system state message
  */
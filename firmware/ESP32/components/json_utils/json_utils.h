@@ -31,6 +31,7 @@
  * @param timestamp Unix timestamp (0 = RTC failure)
  * @param temperature Temperature in Celsius (0.00 = sensor failure)
  * @param humidity Humidity in % (0.00 = sensor failure)
+ * @param suppressed Samples skipped by deadband reporting (field omitted if 0)
  * 
  * @return Number of characters written, or -1 on error
  * 
@@ -40,7 +41,32 @@ int JSON_Utils_CreateSensorData(char *buffer, size_t buffer_size,
                                  const char *mode,
                                  uint32_t timestamp,
                                  float temperature,
-                                 float humidity);
+                                 float humidity,
+                                 uint32_t suppressed);
+
+/**
+ * @brief Create JSON message for a record replayed from the STM32 SD buffer
+ * 
+ * @param buffer Output buffer for JSON string
+ * @param buffer_size Size of output buffer
+ * @param mode Mode the record was taken in ("SINGLE" or "PERIODIC")
+ * @param timestamp Unix timestamp (0 = RTC failure)
+ * @param temperature Temperature in Celsius (0.00 = sensor failure)
+ * @param humidity Humidity in % (0.00 = sensor failure)
+ * @param suppressed Samples skipped by deadband reporting (field omitted if 0)
+ * @param sequence_num SD buffer sequence number
+ * 
+ * @return Number of characters written, or -1 on error
+ * 
+ * @example Output: {"mode":"PERIODIC","timestamp":1760739567,"temperature":30.59,"humidity":73.97,"seq":1042}
+ */
+int JSON_Utils_CreateBacklogData(char *buffer, size_t buffer_size,
+                                 const char *mode,
+                                 uint32_t timestamp,
+                                 float temperature,
+                                 float humidity,
+                                 uint32_t suppressed,
+                                 uint32_t sequence_num);
 
 /**
  * @brief Create JSON system state message
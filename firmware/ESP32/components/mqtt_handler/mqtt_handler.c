@@ -10,13 +10,40 @@
 #include "esp_log.h"
 #include "esp_wifi.h"
 #include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
 
+/* DEFINES -------------------------------------------------------------------*/
+
+#define MQTT_PUBLISH_TASK_STACK 3072
+#define MQTT_PUBLISH_TASK_PRIORITY 5
+#define MQTT_PUBLISH_RETRY_MS 20 // Wait while disconnected or outbox full
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Message waiting in the publish queue
+ */
+typedef struct
+{
+  char topic[MQTT_MAX_TOPIC_LEN];
+  char *data; /*!< Heap copy, freed by the publish task */
+  int len;
+  int qos;
+  int retain;
+  int64_t queued_us;
+} mqtt_publish_item_t;
+
 /* PRIVATE VARIABLES ---------------------------------------------------------*/
 
 static const char *TAG = "MQTT_HANDLER";
 
+// Guards stats and pending[]: publishes come from several tasks, acknowledges from the MQTT task
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
 /* PRIVATE FUNCTIONS ---------------------------------------------------------*/
 
 /**
@@ -35,6 +62,312 @@ static void mqtt_reset_backoff(mqtt_handler_t *mqtt)
   }
 }
 
+/**
+ * @brief Notify the application of a connection/back-pressure change
+ *
+ * @param mqtt MQTT handler instance
+ */
+static void mqtt_notify_status(mqtt_handler_t *mqtt)
+{
+  if (mqtt->status_callback)
+  {
+    mqtt->status_callback();
+  }
+}
+
+/**
+ * @brief Apply a changed client configuration before connecting
+ *
+ * @param mqtt MQTT handler instance
+ */
+static void mqtt_apply_config(mqtt_handler_t *mqtt)
+{
+  if (!mqtt->config_pending)
+  {
+    return;
+  }
+
+  esp_err_t ret = esp_mqtt_set_config(mqtt->client, &mqtt->config);
+  if (ret != ESP_OK)
+  {
+    ESP_LOGW(TAG, "Config update failed: %s", esp_err_to_name(ret));
+    return;
+  }
+
+  mqtt->config_pending = false;
+  ESP_LOGI(TAG, "Keepalive: %d s", mqtt->config.session.keepalive);
+}
+
+/**
+ * @brief Match a broker acknowledge to its publish
+ *
+ * @param mqtt MQTT handler instance
+ * @param msg_id Acknowledged message ID
+ */
+static void mqtt_track_ack(mqtt_handler_t *mqtt, int msg_id)
+{
+  int64_t now_us = esp_timer_get_time();
+
+  taskENTER_CRITICAL(&stats_lock);
+  for (int i = 0; i < MQTT_PENDING_ACKS; i++)
+  {
+    if (mqtt->pending[i].msg_id == msg_id)
+    {
+      uint32_t ack_ms = (uint32_t)((now_us - mqtt->pending[i].start_us) / 1000);
+      mqtt->pending[i].msg_id = 0;
+      mqtt->stats.acked++;
+      mqtt->stats.ack_total_ms += ack_ms;
+      if (ack_ms > mqtt->stats.ack_max_ms)
+      {
+        mqtt->stats.ack_max_ms = ack_ms;
+      }
+      break;
+    }
+  }
+  taskEXIT_CRITICAL(&stats_lock);
+}
+
+/**
+ * @brief Remember a QoS 1/2 message until its acknowledge
+ *
+ * @param mqtt MQTT handler instance
+ * @param msg_id Message ID returned by the client
+ * @param start_us Time the message entered the outbox
+ *
+ * @details Called with stats_lock held. The oldest slot is reused when full.
+ */
+static void mqtt_track_publish(mqtt_handler_t *mqtt, int msg_id, int64_t start_us)
+{
+  int slot = 0;
+  for (int i = 0; i < MQTT_PENDING_ACKS; i++)
+  {
+    if (mqtt->pending[i].msg_id == 0)
+    {
+      slot = i;
+      break;
+    }
+    if (mqtt->pending[i].start_us < mqtt->pending[slot].start_us)
+    {
+      slot = i;
+    }
+  }
+  mqtt->pending[slot].msg_id = msg_id;
+  mqtt->pending[slot].start_us = start_us;
+}
+
+/**
+ * @brief Publish task: moves queued messages into the client outbox
+ *
+ * @param pvParameters MQTT handler instance (mqtt_handler_t*)
+ *
+ * @details Messages stay queued while disconnected or while the outbox holds
+ *          more than MQTT_OUTBOX_LIMIT_BYTES, so a slow broker fills the
+ *          queue (and raises back-pressure) instead of the heap. The MQTT
+ *          task sends the outbox; this task never touches the network.
+ */
+static void mqtt_publish_task(void *pvParameters)
+{
+  mqtt_handler_t *mqtt = (mqtt_handler_t *)pvParameters;
+  mqtt_publish_item_t item;
+
+  while (1)
+  {
+    if (!mqtt->connected ||
+        esp_mqtt_client_get_outbox_size(mqtt->client) > MQTT_OUTBOX_LIMIT_BYTES)
+    {
+      vTaskDelay(pdMS_TO_TICKS(MQTT_PUBLISH_RETRY_MS));
+      continue;
+    }
+
+    if (xQueueReceive(mqtt->publish_queue, &item, portMAX_DELAY) != pdTRUE)
+    {
+      continue;
+    }
+
+    // Drained to the release level: let the application drop back-pressure
+    if (mqtt->congested && uxQueueMessagesWaiting(mqtt->publish_queue) == MQTT_BACKPRESSURE_LOW)
+    {
+      mqtt_notify_status(mqtt);
+    }
+
+    // store=true so QoS 0 messages go through the outbox as well
+    int msg_id = esp_mqtt_client_enqueue(mqtt->client, item.topic, item.data,
+                                         item.len, item.qos, item.retain, true);
+    if (msg_id < 0)
+    {
+      // Client out of memory or stopping: keep the order and retry later
+      if (xQueueSendToFront(mqtt->publish_queue, &item, 0) == pdTRUE)
+      {
+        vTaskDelay(pdMS_TO_TICKS(MQTT_PUBLISH_RETRY_MS));
+        continue;
+      }
+
+      ESP_LOGE(TAG, "Publish failed: %s", item.topic);
+      taskENTER_CRITICAL(&stats_lock);
+      mqtt->stats.publish_failed++;
+      taskEXIT_CRITICAL(&stats_lock);
+      free(item.data);
+      continue;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    uint32_t wait_us = (uint32_t)(now_us - item.queued_us);
+
+    taskENTER_CRITICAL(&stats_lock);
+    mqtt->stats.published++;
+    mqtt->stats.publish_total_us += wait_us;
+    if (wait_us > mqtt->stats.publish_max_us)
+    {
+      mqtt->stats.publish_max_us = wait_us;
+    }
+    if (item.qos > 0 && msg_id > 0)
+    {
+      mqtt_track_publish(mqtt, msg_id, now_us);
+    }
+    taskEXIT_CRITICAL(&stats_lock);
+
+    free(item.data);
+  }
+}
+
+/**
+ * @brief Free all messages left in the publish queue
+ *
+ * @param mqtt MQTT handler instance
+ */
+static void mqtt_flush_queue(mqtt_handler_t *mqtt)
+{
+  mqtt_publish_item_t item;
+
+  while (xQueueReceive(mqtt->publish_queue, &item, 0) == pdTRUE)
+  {
+    free(item.data);
+  }
+}
+
+/**
+ * @brief Find or add the child of a trie node for one filter level
+ *
+ * @param mqtt MQTT handler instance
+ * @param parent Parent node index
+ * @param level Filter level (not NUL-terminated)
+ * @param len Length of level
+ *
+ * @return Child node index, -1 if the trie is full
+ */
+static int mqtt_route_child(mqtt_handler_t *mqtt, int parent, const char *level, size_t len)
+{
+  for (int n = mqtt->route_nodes[parent].child; n >= 0; n = mqtt->route_nodes[n].sibling)
+  {
+    if (mqtt->route_nodes[n].level_len == len &&
+        memcmp(mqtt->route_nodes[n].level, level, len) == 0)
+    {
+      return n;
+    }
+  }
+
+  if (mqtt->route_node_count >= MQTT_ROUTE_NODES_MAX)
+  {
+    return -1;
+  }
+
+  int n = mqtt->route_node_count++;
+  mqtt_route_node_t *node = &mqtt->route_nodes[n];
+  memcpy(node->level, level, len);
+  node->level[len] = '\0';
+  node->level_len = len;
+  node->child = -1;
+  node->route = -1;
+  node->sibling = mqtt->route_nodes[parent].child;
+  mqtt->route_nodes[parent].child = n;
+  return n;
+}
+
+/**
+ * @brief Call the route of a trie node, if it has one
+ *
+ * @return 1 if a handler was called, 0 otherwise
+ */
+static int mqtt_route_call(mqtt_handler_t *mqtt, int node, const mqtt_view_t *topic,
+                           const mqtt_view_t *data)
+{
+  int route = mqtt->route_nodes[node].route;
+  if (route < 0)
+  {
+    return 0;
+  }
+
+  mqtt->routes[route].handler(topic, data, mqtt->routes[route].arg);
+  return 1;
+}
+
+/**
+ * @brief Dispatch a message to every route below a trie node
+ *
+ * @param mqtt MQTT handler instance
+ * @param node Trie node matched so far
+ * @param level Start of the next topic level, NULL once every level is matched
+ * @param topic Received topic
+ * @param data Received payload
+ *
+ * @return Number of handlers called
+ *
+ * @details A "#" child also matches its parent level ("a/#" matches "a").
+ *          Wildcards at the first level do not match topics starting with
+ *          '$' (broker system topics).
+ */
+static int mqtt_route_dispatch(mqtt_handler_t *mqtt, int node, const char *level,
+                               const mqtt_view_t *topic, const mqtt_view_t *data)
+{
+  const char *end = topic->ptr + topic->len;
+  const char *next = NULL;
+  size_t len = 0;
+  int called = 0;
+
+  if (level == NULL)
+  {
+    called += mqtt_route_call(mqtt, node, topic, data);
+  }
+  else
+  {
+    const char *slash = memchr(level, '/', end - level);
+    len = (slash ? slash : end) - level;
+    next = slash ? slash + 1 : NULL; // "a/" has an empty last level
+  }
+
+  bool system_topic = (node == 0 && level != NULL && len > 0 && level[0] == '$');
+
+  for (int n = mqtt->route_nodes[node].child; n >= 0; n = mqtt->route_nodes[n].sibling)
+  {
+    const mqtt_route_node_t *child = &mqtt->route_nodes[n];
+
+    if (child->level_len == 1 && child->level[0] == '#')
+    {
+      if (!system_topic)
+      {
+        called += mqtt_route_call(mqtt, n, topic, data);
+      }
+    }
+    else if (level == NULL)
+    {
+      continue;
+    }
+    else if (child->level_len == 1 && child->level[0] == '+')
+    {
+      if (!system_topic)
+      {
+        called += mqtt_route_dispatch(mqtt, n, next, topic, data);
+      }
+    }
+    else if (child->level_len == len && memcmp(child->level, level, len) == 0)
+    {
+      called += mqtt_route_dispatch(mqtt, n, next, topic, data);
+    }
+  }
+
+  return called;
+}
+
 /**
  * @brief MQTT event handler for processing client events
  *
@@ -46,7 +379,7 @@ static void mqtt_reset_backoff(mqtt_handler_t *mqtt)
  *          - MQTT_EVENT_CONNECTED: Updates connection status
  *          - MQTT_EVENT_DISCONNECTED: Updates disconnection status
  *          - MQTT_EVENT_SUBSCRIBED/UNSUBSCRIBED: Logs subscription status
- *          - MQTT_EVENT_DATA: Processes incoming messages, forwards to user callback
+ *          - MQTT_EVENT_DATA: Dispatches incoming messages to routes, else the data callback
  *          - MQTT_EVENT_ERROR: Logs errors, marks as disconnected
  */
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
@@ -60,7 +393,9 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
   case MQTT_EVENT_CONNECTED:
     ESP_LOGI(TAG, "Connected");
     mqtt->connected = true;
+    mqtt->stats.connects++;
     mqtt_reset_backoff(mqtt); // Reset retry counter on successful connection
+    mqtt_notify_status(mqtt);
     break;
 
   case MQTT_EVENT_DISCONNECTED:
@@ -68,8 +403,10 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
     if (mqtt->connected)
     {
       ESP_LOGI(TAG, "Disconnected");
+      mqtt->stats.disconnects++;
     }
     mqtt->connected = false;
+    mqtt_notify_status(mqtt);
     break;
 
   case MQTT_EVENT_SUBSCRIBED:
@@ -82,12 +419,33 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
 
   case MQTT_EVENT_PUBLISHED:
     // Don't log every publish - too verbose
+    mqtt_track_ack(mqtt, event->msg_id);
     break;
 
   case MQTT_EVENT_DATA:
+  {
+    // Larger than the client receive buffer: delivered in fragments, no commands are that long
+    if (event->current_data_offset != 0 || event->data_len != event->total_data_len)
+    {
+      if (event->current_data_offset == 0)
+      {
+        ESP_LOGW(TAG, "RX %.*s: %d bytes, dropped (fragmented)", event->topic_len,
+                 event->topic, event->total_data_len);
+      }
+      break;
+    }
+
     ESP_LOGI(TAG, "RX %.*s: %.*s", event->topic_len, event->topic,
              event->data_len, event->data);
 
+    // Routes get views into the receive buffer, no copies
+    mqtt_view_t topic_view = {event->topic, event->topic_len};
+    mqtt_view_t data_view = {event->data, event->data_len};
+    if (mqtt_route_dispatch(mqtt, 0, topic_view.ptr, &topic_view, &data_view) > 0)
+    {
+      break;
+    }
+
     // Call callback if available
     if (mqtt->data_callback)
     {
@@ -111,6 +469,7 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
       mqtt->data_callback(topic, data, event->data_len);
     }
     break;
+  }
 
   case MQTT_EVENT_ERROR:
     // Only log error details if it's not a simple disconnect
@@ -119,6 +478,7 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
       ESP_LOGE(TAG, "Error (type=%d)", event->error_handle->error_type);
     }
     mqtt->connected = false;
+    mqtt_notify_status(mqtt);
     break;
 
   default:
@@ -147,6 +507,22 @@ bool MQTT_Handler_Init(mqtt_handler_t *mqtt, const char *broker_url,
   mqtt->connected = false;
   mqtt->retry_count = 0;        // Initialize retry counter
   mqtt->last_retry_time_ms = 0; // Initialize retry timer
+  memset(&mqtt->stats, 0, sizeof(mqtt->stats));
+  memset(mqtt->pending, 0, sizeof(mqtt->pending));
+  mqtt->publish_queue = NULL;
+  mqtt->publish_task = NULL;
+  mqtt->congested = false;
+  mqtt->status_callback = NULL;
+  mqtt->config_pending = false;
+
+  // Route trie: empty root only
+  mqtt->route_nodes[0].level[0] = '\0';
+  mqtt->route_nodes[0].level_len = 0;
+  mqtt->route_nodes[0].child = -1;
+  mqtt->route_nodes[0].sibling = -1;
+  mqtt->route_nodes[0].route = -1;
+  mqtt->route_node_count = 1;
+  mqtt->route_count = 0;
 
   // Generate client ID from MAC
   uint8_t mac[6];
@@ -162,7 +538,7 @@ bool MQTT_Handler_Init(mqtt_handler_t *mqtt, const char *broker_url,
       .network.reconnect_timeout_ms = 2000,   // 2s initial retry (will use exponential backoff)
       .network.timeout_ms = 5000,             // Connection timeout: 5s (was 15s - too long)
       .credentials.client_id = mqtt->client_id,
-      .session.keepalive = 60, // KeepAlive: 60s heartbeat
+      .session.keepalive = MQTT_KEEPALIVE_DEFAULT_S, // KeepAlive: 60s heartbeat
   };
 
   // Set credentials if provided
@@ -176,7 +552,8 @@ bool MQTT_Handler_Init(mqtt_handler_t *mqtt, const char *broker_url,
     mqtt_cfg.credentials.authentication.password = password;
   }
 
-  // Initialize MQTT client
+  // Initialize MQTT client (config kept for MQTT_Handler_SetKeepAlive)
+  mqtt->config = mqtt_cfg;
   mqtt->client = esp_mqtt_client_init(&mqtt_cfg);
   if (mqtt->client == NULL)
   {
@@ -196,6 +573,23 @@ bool MQTT_Handler_Init(mqtt_handler_t *mqtt, const char *broker_url,
     return false;
   }
 
+  // Publish queue and task (decouple callers from the network)
+  mqtt->publish_queue = xQueueCreate(MQTT_PUBLISH_QUEUE_LEN, sizeof(mqtt_publish_item_t));
+  if (mqtt->publish_queue == NULL ||
+      xTaskCreate(mqtt_publish_task, "mqtt_publish", MQTT_PUBLISH_TASK_STACK, mqtt,
+                  MQTT_PUBLISH_TASK_PRIORITY, &mqtt->publish_task) != pdPASS)
+  {
+    ESP_LOGE(TAG, "Failed to create publish queue/task");
+    if (mqtt->publish_queue)
+    {
+      vQueueDelete(mqtt->publish_queue);
+      mqtt->publish_queue = NULL;
+    }
+    esp_mqtt_client_destroy(mqtt->client);
+    mqtt->client = NULL;
+    return false;
+  }
+
   ESP_LOGI(TAG, "Init: %s [%s]", broker_url, mqtt->client_id);
   return true;
 }
@@ -210,6 +604,8 @@ bool MQTT_Handler_Start(mqtt_handler_t *mqtt)
     return false;
   }
 
+  mqtt_apply_config(mqtt);
+
   esp_err_t ret = esp_mqtt_client_start(mqtt->client);
   if (ret != ESP_OK)
   {
@@ -263,9 +659,12 @@ bool MQTT_Handler_Reconnect(mqtt_handler_t *mqtt)
   // Time to reconnect - attempt reconnect
   mqtt->last_retry_time_ms = now_ms;
   mqtt->retry_count++;
+  mqtt->stats.reconnect_attempts++;
 
   ESP_LOGI(TAG, "Reconnect attempt #%" PRIu32, mqtt->retry_count);
 
+  mqtt_apply_config(mqtt);
+
   esp_err_t ret = esp_mqtt_client_reconnect(mqtt->client);
   if (ret != ESP_OK)
   {
@@ -299,14 +698,79 @@ int MQTT_Handler_Subscribe(mqtt_handler_t *mqtt, const char *topic, int qos)
   return msg_id;
 }
 
+/**
+ * @brief Route messages matching a topic filter to a handler
+ */
+bool MQTT_Handler_Route(mqtt_handler_t *mqtt, const char *topic_filter,
+                        mqtt_route_handler_t handler, void *arg)
+{
+  if (!mqtt || !topic_filter || !handler || topic_filter[0] == '\0')
+  {
+    return false;
+  }
+
+  // Wildcards must fill a whole level, "#" only as the last one
+  for (const char *level = topic_filter; level; )
+  {
+    const char *slash = strchr(level, '/');
+    size_t len = slash ? (size_t)(slash - level) : strlen(level);
+    bool wildcard = (len == 1 && (level[0] == '+' || level[0] == '#'));
+
+    if ((!wildcard && (memchr(level, '+', len) || memchr(level, '#', len))) ||
+        (level[0] == '#' && slash) || len >= MQTT_ROUTE_LEVEL_MAX)
+    {
+      ESP_LOGE(TAG, "Invalid route filter: %s", topic_filter);
+      return false;
+    }
+    level = slash ? slash + 1 : NULL;
+  }
+
+  int node = 0;
+  for (const char *level = topic_filter; level; )
+  {
+    const char *slash = strchr(level, '/');
+    size_t len = slash ? (size_t)(slash - level) : strlen(level);
+
+    node = mqtt_route_child(mqtt, node, level, len);
+    if (node < 0)
+    {
+      ESP_LOGE(TAG, "Route table full: %s", topic_filter);
+      return false;
+    }
+    level = slash ? slash + 1 : NULL;
+  }
+
+  int route = mqtt->route_nodes[node].route;
+  if (route < 0)
+  {
+    if (mqtt->route_count >= MQTT_ROUTES_MAX)
+    {
+      ESP_LOGE(TAG, "Route table full: %s", topic_filter);
+      return false;
+    }
+    route = mqtt->route_count++;
+    mqtt->route_nodes[node].route = route;
+  }
+
+  mqtt->routes[route].handler = handler;
+  mqtt->routes[route].arg = arg;
+  return true;
+}
+
 /**
  * @brief Publish data to MQTT topic
  */
 int MQTT_Handler_Publish(mqtt_handler_t *mqtt, const char *topic,
                          const char *data, int data_len, int qos, int retain)
 {
-  if (!mqtt || !mqtt->client || !topic || !data)
+  if (!mqtt || !mqtt->publish_queue || !topic || !data)
+  {
+    return -1;
+  }
+
+  if (strlen(topic) >= MQTT_MAX_TOPIC_LEN)
   {
+    ESP_LOGE(TAG, "Topic too long: %s", topic);
     return -1;
   }
 
@@ -315,14 +779,41 @@ int MQTT_Handler_Publish(mqtt_handler_t *mqtt, const char *topic,
     data_len = strlen(data);
   }
 
-  int msg_id = esp_mqtt_client_publish(mqtt->client, topic,
-                                       data, data_len, qos, retain);
-  if (msg_id < 0)
+  mqtt_publish_item_t item;
+  strcpy(item.topic, topic);
+  item.data = malloc(data_len > 0 ? data_len : 1);
+  item.len = data_len;
+  item.qos = qos;
+  item.retain = retain;
+  item.queued_us = esp_timer_get_time();
+
+  if (item.data == NULL)
   {
-    ESP_LOGE(TAG, "Publish failed: %s", topic);
+    ESP_LOGE(TAG, "Publish failed (no memory): %s", topic);
+    taskENTER_CRITICAL(&stats_lock);
+    mqtt->stats.publish_failed++;
+    taskEXIT_CRITICAL(&stats_lock);
+    return -1;
   }
+  memcpy(item.data, data, data_len);
 
-  return msg_id;
+  if (xQueueSend(mqtt->publish_queue, &item, 0) != pdTRUE)
+  {
+    ESP_LOGW(TAG, "Publish queue full, dropped: %s", topic);
+    free(item.data);
+    taskENTER_CRITICAL(&stats_lock);
+    mqtt->stats.publish_failed++;
+    taskEXIT_CRITICAL(&stats_lock);
+    return -1;
+  }
+
+  // Filled to the raise level: let the application signal back-pressure
+  if (!mqtt->congested && uxQueueMessagesWaiting(mqtt->publish_queue) == MQTT_BACKPRESSURE_HIGH)
+  {
+    mqtt_notify_status(mqtt);
+  }
+
+  return 0;
 }
 
 bool MQTT_Handler_IsConnected(mqtt_handler_t *mqtt)
@@ -330,6 +821,101 @@ bool MQTT_Handler_IsConnected(mqtt_handler_t *mqtt)
   return mqtt ? mqtt->connected : false;
 }
 
+/**
+ * @brief Get publish and connection counters
+ */
+void MQTT_Handler_GetStats(mqtt_handler_t *mqtt, mqtt_handler_stats_t *stats)
+{
+  if (!mqtt || !stats)
+  {
+    return;
+  }
+
+  taskENTER_CRITICAL(&stats_lock);
+  *stats = mqtt->stats;
+  taskEXIT_CRITICAL(&stats_lock);
+}
+
+/**
+ * @brief Set connection/back-pressure change callback
+ */
+void MQTT_Handler_SetStatusCallback(mqtt_handler_t *mqtt, mqtt_status_callback_t callback)
+{
+  if (mqtt)
+  {
+    mqtt->status_callback = callback;
+  }
+}
+
+/**
+ * @brief Set MQTT keepalive
+ */
+void MQTT_Handler_SetKeepAlive(mqtt_handler_t *mqtt, uint16_t keepalive_s)
+{
+  if (!mqtt || keepalive_s == 0 || mqtt->config.session.keepalive == keepalive_s)
+  {
+    return;
+  }
+
+  mqtt->config.session.keepalive = keepalive_s;
+  mqtt->config_pending = true;
+}
+
+/**
+ * @brief Check publish back-pressure
+ */
+bool MQTT_Handler_IsCongested(mqtt_handler_t *mqtt)
+{
+  if (!mqtt || !mqtt->publish_queue)
+  {
+    return false;
+  }
+
+  UBaseType_t depth = uxQueueMessagesWaiting(mqtt->publish_queue);
+
+  if (!mqtt->congested && depth >= MQTT_BACKPRESSURE_HIGH)
+  {
+    mqtt->congested = true;
+    taskENTER_CRITICAL(&stats_lock);
+    mqtt->stats.backpressure++;
+    taskEXIT_CRITICAL(&stats_lock);
+    ESP_LOGW(TAG, "Back-pressure on (%u queued)", (unsigned)depth);
+  }
+  else if (mqtt->congested && depth <= MQTT_BACKPRESSURE_LOW)
+  {
+    mqtt->congested = false;
+    ESP_LOGI(TAG, "Back-pressure off (%u queued)", (unsigned)depth);
+  }
+
+  return mqtt->congested;
+}
+
+/**
+ * @brief Get number of messages waiting in the publish queue
+ */
+uint32_t MQTT_Handler_GetQueueDepth(mqtt_handler_t *mqtt)
+{
+  if (!mqtt || !mqtt->publish_queue)
+  {
+    return 0;
+  }
+
+  return (uint32_t)uxQueueMessagesWaiting(mqtt->publish_queue);
+}
+
+/**
+ * @brief Get MQTT client outbox size
+ */
+int MQTT_Handler_GetOutboxSize(mqtt_handler_t *mqtt)
+{
+  if (!mqtt || !mqtt->client)
+  {
+    return -1;
+  }
+
+  return esp_mqtt_client_get_outbox_size(mqtt->client);
+}
+
 void MQTT_Handler_Stop(mqtt_handler_t *mqtt)
 {
   if (!mqtt || !mqtt->client)
@@ -349,6 +935,19 @@ void MQTT_Handler_Deinit(mqtt_handler_t *mqtt)
     return;
   }
 
+  if (mqtt->publish_task)
+  {
+    vTaskDelete(mqtt->publish_task);
+    mqtt->publish_task = NULL;
+  }
+
+  if (mqtt->publish_queue)
+  {
+    mqtt_flush_queue(mqtt);
+    vQueueDelete(mqtt->publish_queue);
+    mqtt->publish_queue = NULL;
+  }
+
   if (mqtt->client)
   {
     esp_mqtt_client_destroy(mqtt->client);
@@ -356,5 +955,6 @@ void MQTT_Handler_Deinit(mqtt_handler_t *mqtt)
   }
 
   mqtt->connected = false;
+  mqtt->congested = false;
   ESP_LOGI(TAG, "Deinitialized");
 }
\ No newline at end of file
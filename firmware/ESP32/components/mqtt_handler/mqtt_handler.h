@@ -10,13 +10,39 @@
 /* INCLUDES ------------------------------------------------------------------*/
 
 #include "mqtt_client.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 /* DEFINES ------------------------------------------------------------------*/
 
 #define MQTT_MAX_TOPIC_LEN 64
 #define MQTT_MAX_DATA_LEN 256
+#define MQTT_PENDING_ACKS 8 // QoS 1/2 publishes tracked for acknowledge latency
+
+#define MQTT_ROUTES_MAX 16       // Handlers registered with MQTT_Handler_Route()
+#define MQTT_ROUTE_NODES_MAX 48  // Topic filter trie nodes (one per distinct filter level)
+#define MQTT_ROUTE_LEVEL_MAX 24  // Longest filter level, including the terminator
+
+#ifdef CONFIG_MQTT_PUBLISH_QUEUE_LEN
+#define MQTT_PUBLISH_QUEUE_LEN CONFIG_MQTT_PUBLISH_QUEUE_LEN
+#else
+#define MQTT_PUBLISH_QUEUE_LEN 16
+#endif
+
+#ifdef CONFIG_MQTT_OUTBOX_LIMIT_BYTES
+#define MQTT_OUTBOX_LIMIT_BYTES CONFIG_MQTT_OUTBOX_LIMIT_BYTES
+#else
+#define MQTT_OUTBOX_LIMIT_BYTES 8192
+#endif
+
+#define MQTT_BACKPRESSURE_HIGH (MQTT_PUBLISH_QUEUE_LEN * 3 / 4) // Queued messages to signal back-pressure
+#define MQTT_BACKPRESSURE_LOW (MQTT_PUBLISH_QUEUE_LEN / 4)      // Queued messages to release it
+
+#define MQTT_KEEPALIVE_DEFAULT_S 60 // Keepalive until MQTT_Handler_SetKeepAlive() is called
 
 /* TYPEDEFS ------------------------------------------------------------------*/
 
@@ -31,6 +57,104 @@
  */
 typedef void (*mqtt_data_callback_t)(const char *topic, const char *data, int data_len);
 
+/**
+ * @typedef mqtt_view_t
+ *
+ * @brief Length-delimited view into a received message (not NUL-terminated)
+ */
+typedef struct
+{
+  const char *ptr; /*!< First byte (points into the client's receive buffer) */
+  int len;         /*!< Length in bytes */
+} mqtt_view_t;
+
+/**
+ * @brief True if a view holds exactly the given string literal
+ */
+#define MQTT_VIEW_IS(view, literal) \
+  ((view)->len == (int)sizeof(literal) - 1 && memcmp((view)->ptr, (literal), sizeof(literal) - 1) == 0)
+
+/**
+ * @typedef mqtt_route_handler_t
+ *
+ * @brief Handler for messages matching a filter registered with MQTT_Handler_Route()
+ *
+ * @param topic Topic the message was received on
+ * @param data  Message payload
+ * @param arg   Argument given at registration
+ *
+ * @details Called from the MQTT task. The views are only valid during the
+ *          call; copy anything that must outlive it.
+ */
+typedef void (*mqtt_route_handler_t)(const mqtt_view_t *topic, const mqtt_view_t *data, void *arg);
+
+/**
+ * @typedef mqtt_status_callback_t
+ *
+ * @brief Callback function type for connection/back-pressure changes
+ *
+ * @details Called from the MQTT task, the publish task or the publishing
+ *          task when the connection or the publish queue state may have
+ *          changed. Must not block (e.g. only notify a task).
+ */
+typedef void (*mqtt_status_callback_t)(void);
+
+/**
+ * @typedef mqtt_handler_stats_t
+ *
+ * @brief Publish and connection counters (cumulative since init)
+ */
+typedef struct
+{
+  uint32_t published;          /*!< Messages handed to the client outbox */
+  uint32_t publish_failed;     /*!< Messages rejected (queue full, no memory, client error) */
+  uint64_t publish_total_us;   /*!< Sum of publish-to-outbox times */
+  uint32_t publish_max_us;     /*!< Longest publish-to-outbox time */
+  uint32_t acked;              /*!< QoS 1/2 publishes acknowledged by the broker */
+  uint64_t ack_total_ms;       /*!< Sum of publish-to-acknowledge times */
+  uint32_t ack_max_ms;         /*!< Longest publish-to-acknowledge time */
+  uint32_t connects;           /*!< Successful connections */
+  uint32_t disconnects;        /*!< Connection losses */
+  uint32_t reconnect_attempts; /*!< MQTT_Handler_Reconnect() attempts */
+  uint32_t backpressure;       /*!< Times back-pressure was raised */
+} mqtt_handler_stats_t;
+
+/**
+ * @typedef mqtt_pending_ack_t
+ *
+ * @brief QoS 1/2 publish waiting for its broker acknowledge
+ */
+typedef struct
+{
+  int msg_id;       /*!< Message ID (0 = free slot) */
+  int64_t start_us; /*!< esp_timer time of the publish */
+} mqtt_pending_ack_t;
+
+/**
+ * @typedef mqtt_route_t
+ *
+ * @brief Registered route handler
+ */
+typedef struct
+{
+  mqtt_route_handler_t handler; /*!< Message handler */
+  void *arg;                    /*!< Passed back to the handler */
+} mqtt_route_t;
+
+/**
+ * @typedef mqtt_route_node_t
+ *
+ * @brief One topic filter level in the route trie
+ */
+typedef struct
+{
+  char level[MQTT_ROUTE_LEVEL_MAX]; /*!< Filter level ("+" and "#" are wildcards) */
+  uint8_t level_len;                /*!< Length of level */
+  int16_t child;                    /*!< First child node, -1 if none */
+  int16_t sibling;                  /*!< Next node with the same parent, -1 if none */
+  int16_t route;                    /*!< Route of the filter ending here, -1 if none */
+} mqtt_route_node_t;
+
 /**
  * @typedef mqtt_handler_t
  *
@@ -45,11 +169,23 @@ typedef void (*mqtt_data_callback_t)(const char *topic, const char *data, int da
 typedef struct
 {
   esp_mqtt_client_handle_t client;    /*!< ESP32 MQTT client handle */
-  mqtt_data_callback_t data_callback; /*!< Callback for incoming messages */
+  mqtt_data_callback_t data_callback; /*!< Callback for messages no route matches */
   bool connected;                     /*!< Connection status */
   char client_id[32];                 /*!< Unique client identifier */
   uint32_t retry_count;               /*!< Retry attempt counter (for exponential backoff) */
   uint32_t last_retry_time_ms;        /*!< Timestamp of last retry attempt */
+  mqtt_handler_stats_t stats;         /*!< Publish and connection counters */
+  mqtt_pending_ack_t pending[MQTT_PENDING_ACKS]; /*!< Publishes awaiting acknowledge */
+  QueueHandle_t publish_queue;        /*!< Messages waiting for the publish task */
+  TaskHandle_t publish_task;          /*!< Task moving messages into the client outbox */
+  bool congested;                     /*!< Back-pressure state (with hysteresis) */
+  mqtt_status_callback_t status_callback; /*!< Connection/back-pressure change notification */
+  esp_mqtt_client_config_t config;    /*!< Client configuration (kept for keepalive changes) */
+  bool config_pending;                /*!< config changed, apply before next connect */
+  mqtt_route_node_t route_nodes[MQTT_ROUTE_NODES_MAX]; /*!< Topic filter trie, [0] is the root */
+  uint16_t route_node_count;          /*!< Trie nodes in use */
+  mqtt_route_t routes[MQTT_ROUTES_MAX]; /*!< Registered handlers */
+  uint16_t route_count;               /*!< Routes in use */
 } mqtt_handler_t;
 
 /* PUBLIC API ----------------------------------------------------------------*/
@@ -61,7 +197,7 @@ typedef struct
  * @param broker_url MQTT broker URL
  * @param username Username (can be NULL)
  * @param password Password (can be NULL)
- * @param callback Data received callback function
+ * @param callback Callback for messages no route matches (can be NULL)
  *
  * @return true if successful
  */
@@ -89,17 +225,43 @@ bool MQTT_Handler_Start(mqtt_handler_t *mqtt);
  */
 int MQTT_Handler_Subscribe(mqtt_handler_t *mqtt, const char *topic, int qos);
 
+/**
+ * @brief Route messages matching a topic filter to a handler
+ *
+ * @param mqtt MQTT handler structure
+ * @param topic_filter Filter, "+" matches one level and a trailing "#" any remaining levels
+ * @param handler Handler called with views of the topic and payload
+ * @param arg Passed back to the handler
+ *
+ * @return true if registered, false if the filter is invalid or the route table is full
+ *
+ * @details Register routes after MQTT_Handler_Init() and before
+ *          MQTT_Handler_Start(); the table is read from the MQTT task without
+ *          locking. Incoming topics are matched level by level against a
+ *          trie of the filters, and every matching route is called. Messages
+ *          no route matches go to the data callback given to
+ *          MQTT_Handler_Init(). Registering the same filter again replaces
+ *          its handler. Subscribing is still done with MQTT_Handler_Subscribe().
+ */
+bool MQTT_Handler_Route(mqtt_handler_t *mqtt, const char *topic_filter,
+                        mqtt_route_handler_t handler, void *arg);
+
 /**
  * @brief Publish data to MQTT topic
  *
  * @param mqtt MQTT handler structure
  * @param topic Topic to publish
- * @param data Data to publish
+ * @param data Data to publish (copied)
  * @param data_len Data length (0 for null-terminated string)
  * @param qos QoS level (0-2)
  * @param retain Retain flag
  *
- * @return Message ID if successful, -1 if failed
+ * @return 0 if queued, -1 if failed (queue full, no memory or invalid parameters)
+ *
+ * @details Never blocks on the network: the message is copied into a bounded
+ *          queue and moved into the client outbox by the publish task, which
+ *          the MQTT task then sends. Messages are held in the queue while
+ *          disconnected or while the outbox exceeds MQTT_OUTBOX_LIMIT_BYTES.
  */
 int MQTT_Handler_Publish(mqtt_handler_t *mqtt, const char *topic,
                          const char *data, int data_len, int qos, int retain);
@@ -122,6 +284,68 @@ bool MQTT_Handler_IsConnected(mqtt_handler_t *mqtt);
  */
 bool MQTT_Handler_Reconnect(mqtt_handler_t *mqtt);
 
+/**
+ * @brief Get publish and connection counters
+ *
+ * @param mqtt MQTT handler structure
+ * @param stats Pointer to structure to fill
+ */
+void MQTT_Handler_GetStats(mqtt_handler_t *mqtt, mqtt_handler_stats_t *stats);
+
+/**
+ * @brief Set connection/back-pressure change callback
+ *
+ * @param mqtt MQTT handler structure
+ * @param callback Called on connect, disconnect and when the publish queue
+ *                 reaches MQTT_BACKPRESSURE_HIGH or drains to MQTT_BACKPRESSURE_LOW
+ *
+ * @details Lets the application wait for events instead of polling
+ *          MQTT_Handler_IsConnected() / MQTT_Handler_IsCongested().
+ */
+void MQTT_Handler_SetStatusCallback(mqtt_handler_t *mqtt, mqtt_status_callback_t callback);
+
+/**
+ * @brief Set MQTT keepalive
+ *
+ * @param mqtt MQTT handler structure
+ * @param keepalive_s Keepalive in seconds
+ *
+ * @details Applied at the next MQTT_Handler_Start() / MQTT_Handler_Reconnect(),
+ *          because the broker uses the value sent in CONNECT.
+ */
+void MQTT_Handler_SetKeepAlive(mqtt_handler_t *mqtt, uint16_t keepalive_s);
+
+/**
+ * @brief Check publish back-pressure
+ *
+ * @param mqtt MQTT handler structure
+ *
+ * @return true while the publish queue is congested
+ *
+ * @details Raised when MQTT_BACKPRESSURE_HIGH messages are queued and
+ *          released when the queue drains to MQTT_BACKPRESSURE_LOW. The
+ *          application forwards it to the STM32 so it buffers to SD.
+ */
+bool MQTT_Handler_IsCongested(mqtt_handler_t *mqtt);
+
+/**
+ * @brief Get number of messages waiting in the publish queue
+ *
+ * @param mqtt MQTT handler structure
+ *
+ * @return Queued messages
+ */
+uint32_t MQTT_Handler_GetQueueDepth(mqtt_handler_t *mqtt);
+
+/**
+ * @brief Get MQTT client outbox size
+ *
+ * @param mqtt MQTT handler structure
+ *
+ * @return Bytes of QoS 1/2 messages waiting for acknowledge or resend, -1 if not initialized
+ */
+int MQTT_Handler_GetOutboxSize(mqtt_handler_t *mqtt);
+
 /**
  * @brief Stop MQTT client
  *
@@ -0,0 +1,315 @@
+/**
+ * @file power_manager.c
+ *
+ * @brief Gateway Power Manager Library Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include "power_manager.h"
+#include "driver/gpio.h"
+#include "driver/uart.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+/* DEFINES -------------------------------------------------------------------*/
+
+#define POWER_UART_WAKE_THRESHOLD 3 // RX edges needed to wake (ESP-IDF minimum)
+
+/* PRIVATE VARIABLES ---------------------------------------------------------*/
+
+static const char *TAG = "POWER_MANAGER";
+
+static bool g_initialized = false;
+static esp_pm_lock_handle_t g_awake_lock = NULL;
+static SemaphoreHandle_t g_mutex = NULL;
+
+static esp_timer_handle_t g_release_timer = NULL; // Closes the awake window
+static esp_timer_handle_t g_sample_timer = NULL;  // Opens a window before the next sample
+
+static bool g_lock_held = false;
+static int64_t g_held_since_us = 0;
+static int64_t g_hold_until_us = 0;
+static int64_t g_scheduled_until_us = 0;
+static uint32_t g_interval_ms = 0;
+
+static power_manager_stats_t g_stats;
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+/**
+ * @brief Open or extend the awake window (g_mutex held)
+ *
+ * @param now_us Current time in microseconds
+ * @param duration_ms Window length in milliseconds
+ */
+static void power_hold(int64_t now_us, uint32_t duration_ms)
+{
+    int64_t until_us = now_us + (int64_t)duration_ms * 1000;
+
+    if (!g_lock_held)
+    {
+        esp_pm_lock_acquire(g_awake_lock);
+        g_lock_held = true;
+        g_held_since_us = now_us;
+        g_stats.wakes++;
+    }
+
+    if (until_us > g_hold_until_us)
+    {
+        g_hold_until_us = until_us;
+        esp_timer_stop(g_release_timer);
+        esp_timer_start_once(g_release_timer, (uint64_t)(until_us - now_us));
+    }
+}
+
+/**
+ * @brief Release timer callback: close the awake window
+ *
+ * @param arg Not used
+ */
+static void power_release_cb(void *arg)
+{
+    xSemaphoreTake(g_mutex, portMAX_DELAY);
+
+    int64_t now_us = esp_timer_get_time();
+    if (g_lock_held && now_us >= g_hold_until_us)
+    {
+        g_stats.awake_ms += (uint64_t)(now_us - g_held_since_us) / 1000;
+        g_lock_held = false;
+        esp_pm_lock_release(g_awake_lock);
+    }
+
+    xSemaphoreGive(g_mutex);
+}
+
+/**
+ * @brief Start the sample timer for the next expected sample (g_mutex held)
+ *
+ * @param delay_ms Time until the window must open
+ */
+static void power_schedule(uint32_t delay_ms)
+{
+    esp_timer_stop(g_sample_timer);
+    if (g_interval_ms > 0)
+    {
+        esp_timer_start_once(g_sample_timer, (uint64_t)(delay_ms > 0 ? delay_ms : 1) * 1000);
+    }
+}
+
+/**
+ * @brief Sample timer callback: a sample is due in WAKE_GUARD_MS
+ *
+ * @param arg Not used
+ *
+ * @details Keeps firing every interval, so a lost sample does not stop the
+ *          schedule. PowerManager_OnSample() re-anchors it.
+ */
+static void power_sample_cb(void *arg)
+{
+    xSemaphoreTake(g_mutex, portMAX_DELAY);
+
+    int64_t now_us = esp_timer_get_time();
+    uint32_t window_ms = POWER_MANAGER_WAKE_GUARD_MS + POWER_MANAGER_AWAKE_MS;
+
+    power_hold(now_us, window_ms);
+    g_scheduled_until_us = now_us + (int64_t)window_ms * 1000;
+    g_stats.scheduled++;
+    power_schedule(g_interval_ms);
+
+    xSemaphoreGive(g_mutex);
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize power management
+ */
+bool PowerManager_Init(void)
+{
+    if (g_initialized)
+    {
+        return true;
+    }
+
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = POWER_MANAGER_MAX_FREQ_MHZ,
+        .min_freq_mhz = POWER_MANAGER_MIN_FREQ_MHZ,
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        .light_sleep_enable = true,
+#endif
+    };
+
+    esp_err_t ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "PM configure failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    // APB_FREQ_MAX blocks light sleep and keeps the UART clock exact
+    ret = esp_pm_lock_create(ESP_PM_APB_FREQ_MAX, 0, "gw_awake", &g_awake_lock);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "PM lock create failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    g_mutex = xSemaphoreCreateMutex();
+
+    const esp_timer_create_args_t release_args = {
+        .callback = power_release_cb,
+        .name = "pm_release",
+    };
+    const esp_timer_create_args_t sample_args = {
+        .callback = power_sample_cb,
+        .name = "pm_sample",
+    };
+
+    if (g_mutex == NULL ||
+        esp_timer_create(&release_args, &g_release_timer) != ESP_OK ||
+        esp_timer_create(&sample_args, &g_sample_timer) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create timers");
+        return false;
+    }
+
+    g_initialized = true;
+
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    ESP_LOGI(TAG, "Init: %d-%d MHz, light sleep enabled",
+             POWER_MANAGER_MIN_FREQ_MHZ, POWER_MANAGER_MAX_FREQ_MHZ);
+    return true;
+#else
+    ESP_LOGW(TAG, "Init: %d-%d MHz, light sleep needs CONFIG_FREERTOS_USE_TICKLESS_IDLE",
+             POWER_MANAGER_MIN_FREQ_MHZ, POWER_MANAGER_MAX_FREQ_MHZ);
+    return false;
+#endif
+#else
+    ESP_LOGW(TAG, "Power management needs CONFIG_PM_ENABLE");
+    return false;
+#endif
+}
+
+/**
+ * @brief Allow the STM32 link to wake the chip
+ */
+bool PowerManager_EnableUartWake(int uart_num, int rx_pin)
+{
+    if (uart_set_wakeup_threshold(uart_num, POWER_UART_WAKE_THRESHOLD) == ESP_OK &&
+        esp_sleep_enable_uart_wakeup(uart_num) == ESP_OK)
+    {
+        ESP_LOGI(TAG, "Wake on UART%d RX", uart_num);
+        return true;
+    }
+
+    // Not every port can wake the chip (ESP32: UART0/1 only), use the RX pin level
+    if (gpio_wakeup_enable(rx_pin, GPIO_INTR_LOW_LEVEL) == ESP_OK &&
+        esp_sleep_enable_gpio_wakeup() == ESP_OK)
+    {
+        ESP_LOGI(TAG, "Wake on GPIO%d (UART%d RX)", rx_pin, uart_num);
+        return true;
+    }
+
+    ESP_LOGW(TAG, "No wakeup source for UART%d", uart_num);
+    return false;
+}
+
+/**
+ * @brief Block light sleep for a while
+ */
+void PowerManager_StayAwake(uint32_t duration_ms)
+{
+    if (!g_initialized)
+    {
+        return;
+    }
+
+    xSemaphoreTake(g_mutex, portMAX_DELAY);
+    power_hold(esp_timer_get_time(), duration_ms);
+    xSemaphoreGive(g_mutex);
+}
+
+/**
+ * @brief Set the expected sample interval
+ */
+void PowerManager_ExpectSamples(uint32_t interval_ms)
+{
+    if (!g_initialized)
+    {
+        return;
+    }
+
+    xSemaphoreTake(g_mutex, portMAX_DELAY);
+
+    if (interval_ms != g_interval_ms)
+    {
+        g_interval_ms = interval_ms;
+        // First sample follows the command about one interval later
+        power_schedule(interval_ms > POWER_MANAGER_WAKE_GUARD_MS
+                           ? interval_ms - POWER_MANAGER_WAKE_GUARD_MS
+                           : 0);
+        ESP_LOGI(TAG, "Expecting samples every %lu ms", (unsigned long)interval_ms);
+    }
+
+    xSemaphoreGive(g_mutex);
+}
+
+/**
+ * @brief Report a received periodic sample
+ */
+void PowerManager_OnSample(void)
+{
+    if (!g_initialized)
+    {
+        return;
+    }
+
+    xSemaphoreTake(g_mutex, portMAX_DELAY);
+
+    int64_t now_us = esp_timer_get_time();
+    if (g_interval_ms > 0)
+    {
+        if (now_us > g_scheduled_until_us)
+        {
+            g_stats.unscheduled++; // Woken by the line itself, its first bytes may be lost
+        }
+
+        power_schedule(g_interval_ms > POWER_MANAGER_WAKE_GUARD_MS
+                           ? g_interval_ms - POWER_MANAGER_WAKE_GUARD_MS
+                           : 0);
+    }
+
+    xSemaphoreGive(g_mutex);
+}
+
+/**
+ * @brief Get awake window counters
+ */
+void PowerManager_GetStats(power_manager_stats_t *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+
+    if (!g_initialized)
+    {
+        *stats = (power_manager_stats_t){0};
+        return;
+    }
+
+    xSemaphoreTake(g_mutex, portMAX_DELAY);
+    *stats = g_stats;
+    if (g_lock_held)
+    {
+        // Include the window that is open now
+        stats->awake_ms += (uint64_t)(esp_timer_get_time() - g_held_since_us) / 1000;
+    }
+    xSemaphoreGive(g_mutex);
+}
@@ -0,0 +1,122 @@
+/**
+ * @file power_manager.h
+ *
+ * @brief Gateway Power Manager Library for ESP32
+ */
+
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+/* DEFINES -------------------------------------------------------------------*/
+
+/* CPU Frequency Configuration */
+#ifndef CONFIG_GATEWAY_POWER_MAX_FREQ_MHZ
+#define POWER_MANAGER_MAX_FREQ_MHZ 160 // Default 160MHz if not configured
+#else
+#define POWER_MANAGER_MAX_FREQ_MHZ CONFIG_GATEWAY_POWER_MAX_FREQ_MHZ
+#endif
+
+#ifndef CONFIG_GATEWAY_POWER_MIN_FREQ_MHZ
+#define POWER_MANAGER_MIN_FREQ_MHZ 40 // Default 40MHz (XTAL) if not configured
+#else
+#define POWER_MANAGER_MIN_FREQ_MHZ CONFIG_GATEWAY_POWER_MIN_FREQ_MHZ
+#endif
+
+/* Awake Window Configuration */
+#ifndef CONFIG_GATEWAY_POWER_WAKE_GUARD_MS
+#define POWER_MANAGER_WAKE_GUARD_MS 200 // Default 200ms if not configured
+#else
+#define POWER_MANAGER_WAKE_GUARD_MS CONFIG_GATEWAY_POWER_WAKE_GUARD_MS
+#endif
+
+#ifndef CONFIG_GATEWAY_POWER_AWAKE_MS
+#define POWER_MANAGER_AWAKE_MS 1000 // Default 1s if not configured
+#else
+#define POWER_MANAGER_AWAKE_MS CONFIG_GATEWAY_POWER_AWAKE_MS
+#endif
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @typedef power_manager_stats_t
+ *
+ * @brief Awake window counters (cumulative since init)
+ */
+typedef struct
+{
+    uint32_t wakes;       /*!< Awake windows opened (light sleep blocked) */
+    uint64_t awake_ms;    /*!< Total time light sleep was blocked */
+    uint32_t scheduled;   /*!< Windows opened ahead of an expected sample */
+    uint32_t unscheduled; /*!< Samples that arrived with no window open */
+} power_manager_stats_t;
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize power management
+ *
+ * @return true if automatic light sleep was enabled
+ *
+ * @details Scales the CPU between POWER_MANAGER_MAX_FREQ_MHZ and
+ *          POWER_MANAGER_MIN_FREQ_MHZ. Requires CONFIG_PM_ENABLE and
+ *          CONFIG_FREERTOS_USE_TICKLESS_IDLE. Light sleep is entered by the
+ *          idle task whenever no task is ready and no awake window is open.
+ */
+bool PowerManager_Init(void);
+
+/**
+ * @brief Allow the STM32 link to wake the chip
+ *
+ * @param uart_num UART port connected to the STM32
+ * @param rx_pin GPIO of that UART's RX line
+ *
+ * @return true if a wakeup source was enabled
+ *
+ * @details Uses the UART wakeup (RX edge count) where the port supports it,
+ *          otherwise a low-level GPIO wakeup on the RX pin. The bytes that
+ *          wake the chip are not received.
+ */
+bool PowerManager_EnableUartWake(int uart_num, int rx_pin);
+
+/**
+ * @brief Block light sleep for a while
+ *
+ * @param duration_ms Window length in milliseconds (extends an open window)
+ *
+ * @details Holds an APB_FREQ_MAX lock, which also keeps the UART baud rate
+ *          exact while awake. Safe to call from any task, not from an ISR.
+ */
+void PowerManager_StayAwake(uint32_t duration_ms);
+
+/**
+ * @brief Set the expected sample interval
+ *
+ * @param interval_ms STM32 periodic interval (0 = no periodic samples)
+ *
+ * @details An awake window is opened POWER_MANAGER_WAKE_GUARD_MS before
+ *          each expected sample, so it is received in full.
+ */
+void PowerManager_ExpectSamples(uint32_t interval_ms);
+
+/**
+ * @brief Report a received periodic sample
+ *
+ * @details Re-anchors the wake schedule on the actual arrival time, so STM32
+ *          and ESP32 clock drift does not accumulate.
+ */
+void PowerManager_OnSample(void);
+
+/**
+ * @brief Get awake window counters
+ *
+ * @param stats Pointer to structure to fill
+ */
+void PowerManager_GetStats(power_manager_stats_t *stats);
+
+#endif /* POWER_MANAGER_H */
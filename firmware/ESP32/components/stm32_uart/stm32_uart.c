@@ -10,14 +10,33 @@
 #include "driver/uart.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_random.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <stdio.h>
 #include <string.h>
 
+/* DEFINES -------------------------------------------------------------------*/
+
+#define STM32_UART_RX_BUFFER_SIZE 1024 // UART driver RX buffer
+#define STM32_UART_SWITCH_DELAY_MS 10  // STM32 switches after its reply has left
+
 /* PRIVATE VARIABLES ---------------------------------------------------------*/
 
 static const char *TAG = "STM32_UART";
 
+// Candidate rates, must match uart_supported_baud[] on the STM32
+static const int stm32_uart_baud_steps[STM32_UART_BAUD_STEPS] = {115200, 230400, 460800, 921600, 2000000};
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+typedef enum
+{
+    UART_TRIAL_OK,      // Both ends committed the new rate
+    UART_TRIAL_FAILED,  // Both ends are back at the previous rate
+    UART_TRIAL_UNKNOWN, // Commit not confirmed, STM32 rate unknown
+} uart_trial_result_t;
+
 /* PRIVATE FUNCTIONS ---------------------------------------------------------*/
 
 /**
@@ -130,41 +149,373 @@ static bool STM32_UART_CleanLine(const char *input, char *output, size_t output_
 }
 
 /**
- * @brief UART event task to handle incoming data
+ * @brief Notify the application of link activity
  *
- * @param pvParameters Pointer to stm32_uart_t structure
+ * @param uart STM32 UART structure
  */
-static void uart_event_task(void *pvParameters)
+static void uart_notify_activity(stm32_uart_t *uart)
+{
+    if (uart->activity_callback)
+    {
+        uart->activity_callback();
+    }
+}
+
+/**
+ * @brief Move bytes waiting in the UART driver into the ring buffer
+ *
+ * @param uart STM32 UART structure
+ */
+static void uart_read_pending(stm32_uart_t *uart)
 {
-    stm32_uart_t *uart = (stm32_uart_t *)pvParameters;
     uint8_t data[128];
+    int len;
 
-    while (uart->initialized)
+    while ((len = uart_read_bytes(uart->uart_num, data, sizeof(data), 0)) > 0)
     {
-        int len = uart_read_bytes(uart->uart_num, data, sizeof(data), pdMS_TO_TICKS(100));
+        uart->stats.rx_bytes += len;
 
-        if (len > 0)
+        // Put data into ring buffer
+        for (int i = 0; i < len; i++)
         {
-            // Put data into ring buffer
-            for (int i = 0; i < len; i++)
+            if (!RingBuffer_Put(&uart->rx_buffer, data[i]))
             {
-                if (!RingBuffer_Put(&uart->rx_buffer, data[i]))
-                {
-                    ESP_LOGW(TAG, "Ring buffer full, data lost");
-                    break;
-                }
+                uart->stats.ring_overflows++;
+                uart->stats.dropped_bytes += len - i;
+                ESP_LOGW(TAG, "Ring buffer full, data lost");
+                break;
             }
         }
 
-        // Process received data
+        // Drain lines as we go so a burst never fills the ring buffer
         STM32_UART_ProcessData(uart);
+    }
+}
+
+/**
+ * @brief UART event task to handle incoming data
+ *
+ * @param pvParameters Pointer to stm32_uart_t structure
+ *
+ * @details Blocks on the driver event queue, so the task only runs when
+ *          the STM32 sends something (no polling, the chip can sleep).
+ */
+static void uart_event_task(void *pvParameters)
+{
+    stm32_uart_t *uart = (stm32_uart_t *)pvParameters;
+    uart_event_t event;
 
-        vTaskDelay(pdMS_TO_TICKS(10));
+    while (uart->initialized)
+    {
+        if (xQueueReceive(uart->event_queue, &event, portMAX_DELAY) != pdTRUE)
+        {
+            continue;
+        }
+
+        switch (event.type)
+        {
+        case UART_DATA:
+            uart_notify_activity(uart);
+            uart_read_pending(uart);
+            break;
+
+        case UART_FRAME_ERR:
+        case UART_PARITY_ERR:
+            // Usually a baud rate mismatch or a marginal link
+            uart->stats.frame_errors++;
+            break;
+
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            // Reader fell behind: drop the backlog, the partial line is rejected
+            uart->stats.fifo_overflows++;
+            ESP_LOGW(TAG, "UART driver overflow, input flushed");
+            uart_flush_input(uart->uart_num);
+            xQueueReset(uart->event_queue);
+            break;
+
+        default:
+            break;
+        }
     }
 
     vTaskDelete(NULL);
 }
 
+/**
+ * @brief CRC-16/CCITT-FALSE, same as UART_Crc16() on the STM32
+ *
+ * @param data Data
+ * @param len Length in bytes
+ *
+ * @return CRC
+ */
+static uint16_t uart_crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (len--)
+    {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Total link errors (framing/parity errors and noise bytes)
+ *
+ * @param uart STM32 UART structure
+ *
+ * @return Error count since init
+ */
+static uint32_t uart_link_errors(const stm32_uart_t *uart)
+{
+    return uart->stats.frame_errors + uart->stats.noise_bytes;
+}
+
+/**
+ * @brief Find a rate in the candidate table
+ *
+ * @param baud Baud rate
+ *
+ * @return Index, or -1 if not a candidate
+ */
+static int uart_baud_index(int baud)
+{
+    for (int i = 0; i < STM32_UART_BAUD_STEPS; i++)
+    {
+        if (stm32_uart_baud_steps[i] == baud)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Start a new link error window at the current rate
+ *
+ * @param uart STM32 UART structure
+ */
+static void uart_link_rebaseline(stm32_uart_t *uart)
+{
+    uart->last_check_errors = uart_link_errors(uart);
+    uart->last_check_tick = xTaskGetTickCount();
+}
+
+/**
+ * @brief Switch the local UART to another rate (link_mutex held)
+ *
+ * @param uart STM32 UART structure
+ * @param baud Baud rate
+ */
+static void uart_switch_baud(stm32_uart_t *uart, int baud)
+{
+    uart_wait_tx_done(uart->uart_num, pdMS_TO_TICKS(50));
+    uart_set_baudrate(uart->uart_num, baud);
+    uart->baud_rate = baud;
+}
+
+/**
+ * @brief Send one negotiation line (link_mutex held)
+ *
+ * @param uart STM32 UART structure
+ * @param line Command without line ending
+ *
+ * @return true if sent
+ *
+ * @details The leading newline ends whatever the STM32 received at a
+ *          mismatched rate, so the command is not glued to garbage.
+ */
+static bool uart_send_line(stm32_uart_t *uart, const char *line)
+{
+    char buffer[STM32_UART_MAX_LINE_LENGTH];
+    int len = snprintf(buffer, sizeof(buffer), "\n%s\n", line);
+    if (len <= 0 || len >= (int)sizeof(buffer))
+    {
+        return false;
+    }
+
+    uart_notify_activity(uart);
+
+    int sent = uart_write_bytes(uart->uart_num, buffer, len);
+    uart_wait_tx_done(uart->uart_num, pdMS_TO_TICKS(50));
+
+    return sent == len;
+}
+
+/**
+ * @brief Wait for a "UART ..." reply from the STM32
+ *
+ * @param uart STM32 UART structure
+ * @param prefix Reply prefix to wait for (other replies are skipped)
+ * @param reply Buffer for the reply
+ * @param reply_size Size of reply buffer
+ *
+ * @return true if a matching reply arrived within STM32_UART_REPLY_TIMEOUT_MS
+ */
+static bool uart_wait_reply(stm32_uart_t *uart, const char *prefix, char *reply, size_t reply_size)
+{
+    char line[STM32_UART_MAX_LINE_LENGTH];
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(STM32_UART_REPLY_TIMEOUT_MS);
+    TickType_t elapsed;
+
+    while ((elapsed = xTaskGetTickCount() - start) < timeout)
+    {
+        if (xQueueReceive(uart->reply_queue, line, timeout - elapsed) != pdTRUE)
+        {
+            break;
+        }
+
+        if (strncmp(line, prefix, strlen(prefix)) == 0)
+        {
+            snprintf(reply, reply_size, "%s", line);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Send a negotiation command and wait for its reply (link_mutex held)
+ *
+ * @param uart STM32 UART structure
+ * @param command Command without line ending
+ * @param prefix Reply prefix to wait for
+ * @param reply Buffer for the reply
+ * @param reply_size Size of reply buffer
+ *
+ * @return true if a matching reply arrived
+ */
+static bool uart_transact(stm32_uart_t *uart, const char *command, const char *prefix,
+                          char *reply, size_t reply_size)
+{
+    xQueueReset(uart->reply_queue);
+
+    if (!uart_send_line(uart, command))
+    {
+        return false;
+    }
+
+    return uart_wait_reply(uart, prefix, reply, reply_size);
+}
+
+/**
+ * @brief Bring both ends back to the base rate (link_mutex held)
+ *
+ * @param uart STM32 UART structure
+ *
+ * @return true if the STM32 confirmed
+ *
+ * @details The STM32 switches before it replies, so the reply is expected
+ *          at the base rate. If it does not come (the STM32 was reset, or
+ *          kept a rate whose commit reply was lost), "UART RESET" is sent at
+ *          every candidate rate and checked once more at the base rate.
+ */
+static bool uart_reset_link(stm32_uart_t *uart)
+{
+    char reply[STM32_UART_MAX_LINE_LENGTH];
+
+    xQueueReset(uart->reply_queue);
+    uart_send_line(uart, "UART RESET");
+    uart_switch_baud(uart, uart->base_baud);
+    if (uart_wait_reply(uart, "UART RESET OK", reply, sizeof(reply)))
+    {
+        return true;
+    }
+
+    for (int i = STM32_UART_BAUD_STEPS - 1; i >= 0; i--)
+    {
+        if (stm32_uart_baud_steps[i] != uart->base_baud)
+        {
+            uart_switch_baud(uart, stm32_uart_baud_steps[i]);
+            uart_send_line(uart, "UART RESET");
+        }
+    }
+
+    uart_switch_baud(uart, uart->base_baud);
+    vTaskDelay(pdMS_TO_TICKS(STM32_UART_SWITCH_DELAY_MS)); // Let replies sent during the sweep pass
+
+    return uart_transact(uart, "UART RESET", "UART RESET OK", reply, sizeof(reply));
+}
+
+/**
+ * @brief Try one candidate rate (link_mutex held)
+ *
+ * @param uart STM32 UART structure
+ * @param index Candidate index in stm32_uart_baud_steps
+ *
+ * @return Trial result
+ *
+ * @details The echoed pattern checks the ESP32 -> STM32 direction (CRC on
+ *          the STM32) and the STM32 -> ESP32 direction (exact echo) at once.
+ */
+static uart_trial_result_t uart_try_baud(stm32_uart_t *uart, int index)
+{
+    stm32_uart_baud_stats_t *baud_stats = &uart->baud_stats[index];
+    int previous = uart->baud_rate;
+    char command[STM32_UART_MAX_LINE_LENGTH];
+    char expected[STM32_UART_MAX_LINE_LENGTH];
+    char reply[STM32_UART_MAX_LINE_LENGTH];
+
+    baud_stats->attempts++;
+
+    // Acknowledged at the current rate, then the STM32 switches on trial
+    snprintf(command, sizeof(command), "UART BAUD %d", baud_stats->baud);
+    if (!uart_transact(uart, command, "UART BAUD ", reply, sizeof(reply)) ||
+        strncmp(reply, "UART BAUD OK", 12) != 0)
+    {
+        baud_stats->failures++;
+        // A lost acknowledge may still have switched the STM32, let it revert
+        vTaskDelay(pdMS_TO_TICKS(STM32_UART_TRIAL_TIMEOUT_MS + STM32_UART_REPLY_TIMEOUT_MS));
+        return UART_TRIAL_FAILED;
+    }
+
+    uart_switch_baud(uart, baud_stats->baud);
+    vTaskDelay(pdMS_TO_TICKS(STM32_UART_SWITCH_DELAY_MS));
+
+    for (int round = 0; round < STM32_UART_TEST_ROUNDS; round++)
+    {
+        char pattern[STM32_UART_TEST_PATTERN_LEN + 1];
+
+        // Printable, no spaces: the STM32 tokenizes on whitespace
+        for (int i = 0; i < STM32_UART_TEST_PATTERN_LEN; i++)
+        {
+            pattern[i] = (char)(0x21 + esp_random() % 94);
+        }
+        pattern[STM32_UART_TEST_PATTERN_LEN] = '\0';
+
+        uint16_t crc = uart_crc16((const uint8_t *)pattern, STM32_UART_TEST_PATTERN_LEN);
+        snprintf(command, sizeof(command), "UART TEST %s %04X", pattern, crc);
+        snprintf(expected, sizeof(expected), "UART TEST OK %s %04X", pattern, crc);
+
+        if (!uart_transact(uart, command, "UART TEST ", reply, sizeof(reply)) ||
+            strcmp(reply, expected) != 0)
+        {
+            baud_stats->failures++;
+            uart_switch_baud(uart, previous);
+            vTaskDelay(pdMS_TO_TICKS(STM32_UART_TRIAL_TIMEOUT_MS + STM32_UART_REPLY_TIMEOUT_MS));
+            return UART_TRIAL_FAILED;
+        }
+    }
+
+    if (!uart_transact(uart, "UART COMMIT", "UART COMMIT ", reply, sizeof(reply)) ||
+        strncmp(reply, "UART COMMIT OK", 14) != 0)
+    {
+        baud_stats->failures++;
+        return UART_TRIAL_UNKNOWN;
+    }
+
+    return UART_TRIAL_OK;
+}
+
 /* PUBLIC API ----------------------------------------------------------------*/
 
 /**
@@ -181,10 +532,28 @@ bool STM32_UART_Init(stm32_uart_t *uart, int uart_num, int baud_rate,
     // Initialize structure
     uart->uart_num = uart_num;
     uart->baud_rate = baud_rate;
+    uart->base_baud = baud_rate;
     uart->tx_pin = tx_pin;
     uart->rx_pin = rx_pin;
     uart->data_callback = callback;
+    uart->activity_callback = NULL;
+    uart->event_queue = NULL;
+    uart->task = NULL;
     uart->initialized = false;
+    memset(&uart->stats, 0, sizeof(uart->stats));
+    memset(uart->baud_stats, 0, sizeof(uart->baud_stats));
+    for (int i = 0; i < STM32_UART_BAUD_STEPS; i++)
+    {
+        uart->baud_stats[i].baud = stm32_uart_baud_steps[i];
+    }
+
+    uart->link_mutex = xSemaphoreCreateMutex();
+    uart->reply_queue = xQueueCreate(STM32_UART_REPLY_QUEUE_LEN, STM32_UART_MAX_LINE_LENGTH);
+    if (!uart->link_mutex || !uart->reply_queue)
+    {
+        ESP_LOGE(TAG, "Failed to create link mutex/reply queue");
+        return false;
+    }
 
     // Initialize ring buffer
     RingBuffer_Init(&uart->rx_buffer);
@@ -199,7 +568,8 @@ bool STM32_UART_Init(stm32_uart_t *uart, int uart_num, int baud_rate,
         .source_clk = UART_SCLK_DEFAULT,
     };
 
-    esp_err_t ret = uart_driver_install(uart_num, 1024, 0, 0, NULL, 0);
+    esp_err_t ret = uart_driver_install(uart_num, STM32_UART_RX_BUFFER_SIZE, 0,
+                                        STM32_UART_EVENT_QUEUE_LEN, &uart->event_queue, 0);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "UART driver install failed: %s", esp_err_to_name(ret));
@@ -228,6 +598,7 @@ bool STM32_UART_Init(stm32_uart_t *uart, int uart_num, int baud_rate,
         vTaskDelay(pdMS_TO_TICKS(50));
     }
 
+    uart_link_rebaseline(uart);
     uart->initialized = true;
     ESP_LOGI(TAG, "STM32 UART%d initialized: TXD=%d, RXD=%d, Baud=%d",
              uart_num, tx_pin, rx_pin, baud_rate);
@@ -245,6 +616,11 @@ bool STM32_UART_SendCommand(stm32_uart_t *uart, const char *command)
         return false;
     }
 
+    // Wait for a running baud rate negotiation
+    xSemaphoreTake(uart->link_mutex, portMAX_DELAY);
+
+    uart_notify_activity(uart);
+
     // Clear RX buffer before sending to prevent old data contamination
     uart_flush_input(uart->uart_num);
     RingBuffer_Clear(&uart->rx_buffer);
@@ -260,6 +636,8 @@ bool STM32_UART_SendCommand(stm32_uart_t *uart, const char *command)
     // Wait for transmission complete
     uart_wait_tx_done(uart->uart_num, pdMS_TO_TICKS(50));
 
+    xSemaphoreGive(uart->link_mutex);
+
     if (sent == len)
     {
         ESP_LOGI(TAG, "-> STM32: %s", command);
@@ -272,6 +650,17 @@ bool STM32_UART_SendCommand(stm32_uart_t *uart, const char *command)
     }
 }
 
+/**
+ * @brief Set link activity callback
+ */
+void STM32_UART_SetActivityCallback(stm32_uart_t *uart, stm32_activity_callback_t callback)
+{
+    if (uart)
+    {
+        uart->activity_callback = callback;
+    }
+}
+
 /**
  * @brief Process data received from STM32
  */
@@ -298,14 +687,25 @@ void STM32_UART_ProcessData(stm32_uart_t *uart)
 
                 // FIXED: Clean up the line before processing
                 char cleaned_line[STM32_UART_MAX_LINE_LENGTH];
-                if (STM32_UART_CleanLine(line_buffer, cleaned_line, sizeof(cleaned_line)))
+                if (strncmp(line_buffer, "UART ", 5) == 0)
                 {
+                    // Baud rate negotiation reply, not sensor data
+                    xQueueSend(uart->reply_queue, line_buffer, 0);
+                }
+                else if (STM32_UART_CleanLine(line_buffer, cleaned_line, sizeof(cleaned_line)))
+                {
+                    uart->stats.rx_lines++;
+
                     // Only call callback if line contains valid data
                     if (uart->data_callback)
                     {
                         uart->data_callback(cleaned_line);
                     }
                 }
+                else
+                {
+                    uart->stats.rejected_lines++;
+                }
 
                 line_pos = 0;
             }
@@ -319,9 +719,14 @@ void STM32_UART_ProcessData(stm32_uart_t *uart)
         {
             // Line too long, reset
             ESP_LOGW(TAG, "Line too long, resetting buffer");
+            uart->stats.long_lines++;
             line_pos = 0;
         }
-        // Ignore non-printable characters silently
+        else
+        {
+            // Non-printable characters are dropped, but count as link noise
+            uart->stats.noise_bytes++;
+        }
     }
 }
 
@@ -335,7 +740,7 @@ bool STM32_UART_StartTask(stm32_uart_t *uart)
         return false;
     }
 
-    BaseType_t ret = xTaskCreate(uart_event_task, "stm32_uart", 4096, uart, 5, NULL);
+    BaseType_t ret = xTaskCreate(uart_event_task, "stm32_uart", 4096, uart, 5, &uart->task);
     if (ret != pdPASS)
     {
         ESP_LOGE(TAG, "Failed to create UART task");
@@ -346,6 +751,149 @@ bool STM32_UART_StartTask(stm32_uart_t *uart)
     return true;
 }
 
+/**
+ * @brief Negotiate the fastest baud rate the link carries
+ */
+int STM32_UART_Negotiate(stm32_uart_t *uart, int max_baud)
+{
+    if (!uart || !uart->initialized)
+    {
+        return 0;
+    }
+
+    xSemaphoreTake(uart->link_mutex, portMAX_DELAY);
+    uart->stats.negotiations++;
+
+    if (!uart_reset_link(uart))
+    {
+        ESP_LOGW(TAG, "STM32 did not confirm UART RESET, staying at %d", uart->base_baud);
+    }
+    else
+    {
+        for (int i = 0; i < STM32_UART_BAUD_STEPS; i++)
+        {
+            stm32_uart_baud_stats_t *baud_stats = &uart->baud_stats[i];
+
+            if (baud_stats->baud <= uart->baud_rate)
+            {
+                continue;
+            }
+            if (baud_stats->baud > max_baud)
+            {
+                break;
+            }
+            if (baud_stats->failures + baud_stats->demotions >= STM32_UART_BAUD_MAX_FAILURES)
+            {
+                // Higher rates are unlikely to do better than one that keeps failing
+                ESP_LOGW(TAG, "Skipping %d baud and above (%lu failures, %lu demotions)",
+                         baud_stats->baud, (unsigned long)baud_stats->failures,
+                         (unsigned long)baud_stats->demotions);
+                break;
+            }
+
+            uart_trial_result_t result = uart_try_baud(uart, i);
+            if (result == UART_TRIAL_OK)
+            {
+                ESP_LOGI(TAG, "Link OK at %d baud", baud_stats->baud);
+                continue;
+            }
+
+            ESP_LOGW(TAG, "Link failed at %d baud", baud_stats->baud);
+            if (result == UART_TRIAL_UNKNOWN && !uart_reset_link(uart))
+            {
+                ESP_LOGW(TAG, "STM32 did not confirm UART RESET, staying at %d", uart->base_baud);
+            }
+            break;
+        }
+    }
+
+    uart_link_rebaseline(uart);
+    ESP_LOGI(TAG, "STM32 link running at %d baud", uart->baud_rate);
+
+    xSemaphoreGive(uart->link_mutex);
+    return uart->baud_rate;
+}
+
+/**
+ * @brief Return the local side to the base rate
+ */
+void STM32_UART_ResetBaud(stm32_uart_t *uart)
+{
+    if (!uart || !uart->initialized)
+    {
+        return;
+    }
+
+    xSemaphoreTake(uart->link_mutex, portMAX_DELAY);
+    if (uart->baud_rate != uart->base_baud)
+    {
+        uart_switch_baud(uart, uart->base_baud);
+        ESP_LOGI(TAG, "STM32 link back to %d baud", uart->base_baud);
+    }
+    uart_link_rebaseline(uart);
+    xSemaphoreGive(uart->link_mutex);
+}
+
+/**
+ * @brief Demote the baud rate if the link error rate is too high
+ */
+bool STM32_UART_CheckLink(stm32_uart_t *uart)
+{
+    if (!uart || !uart->initialized)
+    {
+        return false;
+    }
+
+    xSemaphoreTake(uart->link_mutex, portMAX_DELAY);
+
+    if (xTaskGetTickCount() - uart->last_check_tick < pdMS_TO_TICKS(STM32_UART_LINK_CHECK_MS))
+    {
+        xSemaphoreGive(uart->link_mutex);
+        return false;
+    }
+
+    uint32_t errors = uart_link_errors(uart) - uart->last_check_errors;
+    uart_link_rebaseline(uart);
+
+    int index = uart_baud_index(uart->baud_rate);
+    if (index >= 0)
+    {
+        uart->baud_stats[index].link_errors += errors;
+    }
+
+    bool demote = index > 0 && uart->baud_rate > uart->base_baud &&
+                  errors >= STM32_UART_LINK_ERROR_LIMIT;
+    if (demote)
+    {
+        uart->baud_stats[index].demotions++;
+        uart->stats.demotions++;
+        ESP_LOGW(TAG, "%lu link errors at %d baud, falling back",
+                 (unsigned long)errors, uart->baud_rate);
+    }
+
+    xSemaphoreGive(uart->link_mutex);
+
+    if (demote)
+    {
+        STM32_UART_Negotiate(uart, stm32_uart_baud_steps[index - 1]);
+    }
+
+    return demote;
+}
+
+/**
+ * @brief Get reception counters
+ */
+void STM32_UART_GetStats(const stm32_uart_t *uart, stm32_uart_stats_t *stats)
+{
+    if (!uart || !stats)
+    {
+        return;
+    }
+
+    *stats = uart->stats;
+}
+
 /**
  * @brief Deinitialize STM32 UART communication
  *
@@ -360,10 +908,29 @@ void STM32_UART_Deinit(stm32_uart_t *uart)
 
     uart->initialized = false;
 
+    // The task blocks on the event queue, stop it before the driver deletes the queue
+    if (uart->task)
+    {
+        vTaskDelete(uart->task);
+        uart->task = NULL;
+    }
+
     if (uart->uart_num >= 0 && uart->uart_num < UART_NUM_MAX)
     {
         uart_driver_delete(uart->uart_num);
     }
 
+    if (uart->reply_queue)
+    {
+        vQueueDelete(uart->reply_queue);
+        uart->reply_queue = NULL;
+    }
+
+    if (uart->link_mutex)
+    {
+        vSemaphoreDelete(uart->link_mutex);
+        uart->link_mutex = NULL;
+    }
+
     ESP_LOGI(TAG, "STM32 UART%d deinitialized", uart->uart_num);
 }
\ No newline at end of file
@@ -13,10 +13,33 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "ring_buffer.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 
 /* DEFINES -------------------------------------------------------------------*/
 
 #define STM32_UART_MAX_LINE_LENGTH 128
+#define STM32_UART_EVENT_QUEUE_LEN 16 // UART driver event queue length
+
+/* Baud Rate Negotiation Configuration */
+#ifndef CONFIG_STM32_UART_MAX_BAUD
+#define STM32_UART_MAX_BAUD 2000000 // Default 2 Mbps if not configured
+#else
+#define STM32_UART_MAX_BAUD CONFIG_STM32_UART_MAX_BAUD
+#endif
+
+#define STM32_UART_BAUD_STEPS 5          // 115200, 230400, 460800, 921600, 2000000
+#define STM32_UART_TEST_ROUNDS 3         // Test patterns per candidate rate
+#define STM32_UART_TEST_PATTERN_LEN 48   // Must not exceed UART_TEST_PATTERN_MAX on the STM32
+#define STM32_UART_REPLY_TIMEOUT_MS 200  // Wait for a "UART ..." reply
+#define STM32_UART_TRIAL_TIMEOUT_MS 1000 // Must match UART_BAUD_TRIAL_TIMEOUT_MS on the STM32
+#define STM32_UART_BAUD_MAX_FAILURES 2   // Failed trials + demotions before a rate is skipped
+#define STM32_UART_LINK_CHECK_MS 10000   // Link error evaluation window
+#define STM32_UART_LINK_ERROR_LIMIT 8    // Link errors per window that demote the rate
+#define STM32_UART_REPLY_QUEUE_LEN 4     // Pending "UART ..." replies
 
 /* TYPEDEFS ------------------------------------------------------------------*/
 
@@ -32,27 +55,98 @@
  */
 typedef void (*stm32_data_callback_t)(const char *line);
 
+/**
+ * @typedef stm32_activity_callback_t
+ *
+ * @brief Function pointer type for link activity
+ *
+ * @details Called before a command is sent and whenever bytes arrive, so
+ *          the application can keep the chip out of light sleep while the
+ *          STM32 is talking.
+ */
+typedef void (*stm32_activity_callback_t)(void);
+
+/**
+ * @typedef stm32_uart_stats_t
+ *
+ * @brief Reception counters (cumulative since init)
+ *
+ * @details Written only by the UART task, read by anyone. Each field is a
+ *          32-bit word so reads are never torn.
+ */
+typedef struct
+{
+    uint32_t rx_bytes;       /*!< Bytes read from the UART driver */
+    uint32_t rx_lines;       /*!< Valid lines passed to the callback */
+    uint32_t rejected_lines; /*!< Lines dropped by validation */
+    uint32_t long_lines;     /*!< Lines longer than STM32_UART_MAX_LINE_LENGTH */
+    uint32_t ring_overflows; /*!< Reads that did not fit in the ring buffer */
+    uint32_t dropped_bytes;  /*!< Bytes lost to ring buffer overflow */
+    uint32_t frame_errors;   /*!< Framing/parity errors reported by the driver */
+    uint32_t noise_bytes;    /*!< Non-printable bytes inside lines */
+    uint32_t fifo_overflows; /*!< Driver FIFO/buffer overflows (input flushed) */
+    uint32_t negotiations;   /*!< Baud rate negotiations run */
+    uint32_t demotions;      /*!< Rates dropped because of link errors */
+} stm32_uart_stats_t;
+
+/**
+ * @typedef stm32_uart_baud_stats_t
+ *
+ * @brief Negotiation history of one candidate baud rate
+ *
+ * @details A rate whose failures + demotions reach
+ *          STM32_UART_BAUD_MAX_FAILURES is no longer tried.
+ */
+typedef struct
+{
+    int baud;             /*!< Baud rate */
+    uint32_t attempts;    /*!< Trials started */
+    uint32_t failures;    /*!< Trials that failed (no reply or bad test pattern) */
+    uint32_t link_errors; /*!< Link errors counted while running at this rate */
+    uint32_t demotions;   /*!< Times the rate was dropped because of link errors */
+} stm32_uart_baud_stats_t;
+
 /**
  * @typedef stm32_uart_t
  *
  * @brief STM32 UART communication structure
  *
  * @param uart_num UART port number
- * @param baud_rate Baud rate
+ * @param baud_rate Current baud rate
+ * @param base_baud Boot baud rate of both ends
  * @param tx_pin TX GPIO pin
  * @param rx_pin RX GPIO pin
  * @param rx_buffer Ring buffer for received data
  * @param data_callback Function pointer for received data lines
+ * @param activity_callback Function pointer for link activity
+ * @param event_queue UART driver event queue
+ * @param task UART task handle
+ * @param link_mutex Serializes commands and negotiation
+ * @param reply_queue "UART ..." replies waiting for the negotiation
+ * @param baud_stats Negotiation history per candidate rate
+ * @param last_check_errors Link errors at the last link check
+ * @param last_check_tick Tick of the last link check
+ * @param stats Reception counters
  * @param initialized Initialization state flag
  */
 typedef struct
 {
     int uart_num;                        /*!< UART port number */
-    int baud_rate;                       /*!< Baud rate */
+    int baud_rate;                       /*!< Current baud rate */
+    int base_baud;                       /*!< Boot baud rate of both ends */
     int tx_pin;                          /*!< TX GPIO pin */
     int rx_pin;                          /*!< TX GPIO pin */
     ring_buffer_t rx_buffer;             /*!< Ring buffer for received data */
     stm32_data_callback_t data_callback; /*!< Callback for received data lines */
+    stm32_activity_callback_t activity_callback; /*!< Callback for link activity */
+    QueueHandle_t event_queue;           /*!< UART driver event queue */
+    TaskHandle_t task;                   /*!< UART task handle */
+    SemaphoreHandle_t link_mutex;        /*!< Serializes commands and negotiation */
+    QueueHandle_t reply_queue;           /*!< "UART ..." replies for the negotiation */
+    stm32_uart_baud_stats_t baud_stats[STM32_UART_BAUD_STEPS]; /*!< Per rate history */
+    uint32_t last_check_errors;          /*!< Link errors at the last link check */
+    TickType_t last_check_tick;          /*!< Tick of the last link check */
+    stm32_uart_stats_t stats;            /*!< Reception counters */
     bool initialized;                    /*!< Initialization state flag */
 } stm32_uart_t;
 
@@ -83,6 +177,14 @@ bool STM32_UART_Init(stm32_uart_t *uart, int uart_num, int baud_rate,
  */
 bool STM32_UART_SendCommand(stm32_uart_t *uart, const char *command);
 
+/**
+ * @brief Set link activity callback
+ *
+ * @param uart STM32 UART structure
+ * @param callback Called on every send and reception (NULL to disable)
+ */
+void STM32_UART_SetActivityCallback(stm32_uart_t *uart, stm32_activity_callback_t callback);
+
 /**
  * @brief Process received data (call from task)
  *
@@ -99,6 +201,55 @@ void STM32_UART_ProcessData(stm32_uart_t *uart);
  */
 bool STM32_UART_StartTask(stm32_uart_t *uart);
 
+/**
+ * @brief Negotiate the fastest baud rate the link carries
+ *
+ * @param uart STM32 UART structure
+ * @param max_baud Highest rate to try
+ *
+ * @return Baud rate in use afterwards (base rate if nothing better works)
+ *
+ * @details Returns both ends to the base rate, then steps up through the
+ *          candidate rates. Each step switches the STM32 on trial, checks
+ *          STM32_UART_TEST_ROUNDS random patterns with a CRC-16 in both
+ *          directions and commits. The first failing rate ends the search;
+ *          the STM32 reverts on its own after STM32_UART_TRIAL_TIMEOUT_MS.
+ *          Blocks for up to a few seconds, call from the main task.
+ */
+int STM32_UART_Negotiate(stm32_uart_t *uart, int max_baud);
+
+/**
+ * @brief Return the local side to the base rate
+ *
+ * @param uart STM32 UART structure
+ *
+ * @details Call when the STM32 is reset (relay power-cycle), it boots at
+ *          the base rate.
+ */
+void STM32_UART_ResetBaud(stm32_uart_t *uart);
+
+/**
+ * @brief Demote the baud rate if the link error rate is too high
+ *
+ * @param uart STM32 UART structure
+ *
+ * @return true if the rate was renegotiated
+ *
+ * @details Evaluates framing errors and noise bytes every
+ *          STM32_UART_LINK_CHECK_MS. At STM32_UART_LINK_ERROR_LIMIT or more
+ *          above the base rate, renegotiates with the next lower rate as
+ *          the limit. Call periodically from the main task.
+ */
+bool STM32_UART_CheckLink(stm32_uart_t *uart);
+
+/**
+ * @brief Get reception counters
+ *
+ * @param uart STM32 UART structure
+ * @param stats Pointer to structure to fill
+ */
+void STM32_UART_GetStats(const stm32_uart_t *uart, stm32_uart_stats_t *stats);
+
 /**
  * @brief Deinitialize STM32 UART
  *
@@ -32,22 +32,44 @@
 #include "mqtt_handler.h"
 #endif
 
+#ifdef CONFIG_GATEWAY_METRICS_ENABLE
+#include "gateway_metrics.h"
+#endif
+
+#ifdef CONFIG_GATEWAY_POWER_SAVE
+#include "power_manager.h"
+#endif
+
 #ifdef CONFIG_ENABLE_COAP
 #include "coap_handler.h"
 #endif
 
 /* DEFINES ------------------------------------------------------------------*/
 
+// Main loop wait: short while connections come up, long once everything is idle
+#define MAIN_LOOP_POLL_MS 200
+#define MAIN_LOOP_IDLE_MS 5000
+
 #ifdef CONFIG_ENABLE_MQTT
 
+// Every topic lives under datalogger/<client id>/ (see build_device_topics)
+#define TOPIC_ROOT "datalogger"
+#define TOPIC_MAX_LEN 64
+
 // Command topics
-#define TOPIC_STM32_COMMAND "datalogger/stm32/command"
-#define TOPIC_RELAY_CONTROL "datalogger/esp32/relay/control"
-#define TOPIC_SYSTEM_STATE "datalogger/esp32/system/state"
+#define TOPIC_STM32_COMMAND "stm32/command"
+#define TOPIC_RELAY_CONTROL "esp32/relay/control"
+#define TOPIC_SYSTEM_STATE "esp32/system/state"
+#define TOPIC_ESP32_METRICS "esp32/metrics"
 
 // Data topics - JSON format
-#define TOPIC_STM32_DATA_SINGLE "datalogger/stm32/single/data"
-#define TOPIC_STM32_DATA_PERIODIC "datalogger/stm32/periodic/data"
+#define TOPIC_STM32_DATA_SINGLE "stm32/single/data"
+#define TOPIC_STM32_DATA_PERIODIC "stm32/periodic/data"
+#define TOPIC_STM32_DATA_ARCHIVE "stm32/archive/data"
+#define TOPIC_STM32_DATA_BACKLOG "stm32/backlog/data"
+
+// Longest keepalive used for slow sampling intervals
+#define MQTT_KEEPALIVE_MAX_S 7200
 
 #endif
 
@@ -57,6 +79,21 @@ static const char *TAG = "MQTT_BRIDGE_APP";
 
 #ifdef CONFIG_ENABLE_MQTT
 static mqtt_handler_t mqtt_handler;
+
+/**
+ * @brief Full topic names of this gateway (datalogger/<client id>/...)
+ */
+static struct
+{
+    char stm32_command[TOPIC_MAX_LEN];
+    char relay_control[TOPIC_MAX_LEN];
+    char system_state[TOPIC_MAX_LEN];
+    char esp32_metrics[TOPIC_MAX_LEN];
+    char data_single[TOPIC_MAX_LEN];
+    char data_periodic[TOPIC_MAX_LEN];
+    char data_archive[TOPIC_MAX_LEN];
+    char data_backlog[TOPIC_MAX_LEN];
+} g_topics;
 #endif
 
 #ifdef CONFIG_ENABLE_COAP
@@ -69,13 +106,18 @@ static stm32_uart_t stm32_uart;
 static relay_control_t relay_control;
 static json_sensor_parser_t json_parser; // Use new JSON parser
 
+// Main task, woken by event callbacks
+static TaskHandle_t g_main_task = NULL;
+
 // Global state tracking
 static bool g_periodic_active = false;
 static bool g_device_on = false;
 static bool g_mqtt_reconnected = false; // Track MQTT reconnection events
+static volatile bool g_uart_renegotiate = true; // STM32 link at base rate, negotiate from the main loop
 
 // Button state tracking
 static uint8_t g_interval_index = 0; // Current interval index (0-5)
+static uint32_t g_interval_s = 5;    // STM32 periodic interval (STM32 boot default 5s)
 
 // WiFi/MQTT reconnection tracking
 static uint32_t g_last_wifi_retry_ms = 0;
@@ -83,10 +125,61 @@ static bool g_wifi_disconnected_notified = false; // Track if STM32 was notified
 static uint32_t g_wifi_reconnect_time_ms = 0;     // Track when WiFi reconnected
 static bool g_mqtt_started = false;               // Track if MQTT has been started (for boot stabilization)
 
+// Gateway metrics counters not kept by a component
+static uint32_t g_parse_failures = 0; // Lines rejected by the JSON parser (UART task)
+static uint32_t g_wifi_reconnects = 0; // WiFi connections restored after a loss
+
 // Periodic interval values (in seconds)
 static const uint16_t INTERVAL_VALUES[] = {5, 30, 60, 600, 1800, 3600};
 static const uint8_t INTERVAL_COUNT = sizeof(INTERVAL_VALUES) / sizeof(INTERVAL_VALUES[0]);
 
+/* SCHEDULING FUNCTIONS ------------------------------------------------------*/
+
+/**
+ * @brief Wake the main loop
+ *
+ * @details Called by WiFi and MQTT events, so the main loop reacts at once
+ *          instead of polling. Matches mqtt_status_callback_t.
+ */
+static void notify_main_loop(void)
+{
+    if (g_main_task)
+    {
+        xTaskNotifyGive(g_main_task);
+    }
+}
+
+/**
+ * @brief Apply the sampling interval to light sleep and MQTT keepalive
+ *
+ * @details Called whenever periodic mode or the interval changes. With
+ *          CONFIG_GATEWAY_POWER_SAVE the chip wakes just before each
+ *          expected sample, and the keepalive is stretched to two intervals
+ *          (60s to MQTT_KEEPALIVE_MAX_S) so pings do not wake the radio
+ *          between samples. The keepalive is used from the next connection.
+ */
+static void apply_sampling_schedule(void)
+{
+#ifdef CONFIG_GATEWAY_POWER_SAVE
+    uint32_t interval_s = g_periodic_active ? g_interval_s : 0;
+
+    PowerManager_ExpectSamples(interval_s * 1000);
+
+#ifdef CONFIG_ENABLE_MQTT
+    uint32_t keepalive_s = 2 * interval_s;
+    if (keepalive_s < MQTT_KEEPALIVE_DEFAULT_S)
+    {
+        keepalive_s = MQTT_KEEPALIVE_DEFAULT_S;
+    }
+    else if (keepalive_s > MQTT_KEEPALIVE_MAX_S)
+    {
+        keepalive_s = MQTT_KEEPALIVE_MAX_S;
+    }
+    MQTT_Handler_SetKeepAlive(&mqtt_handler, (uint16_t)keepalive_s);
+#endif
+#endif
+}
+
 /* STATE SYNCHRONIZATION FUNCTIONS -------------------------------------------*/
 
 /**
@@ -113,7 +206,7 @@ static void create_state_message(char *buffer, size_t buffer_size)
 /**
  * @brief Publish current state via MQTT
  *
- * @details Publishes the current state to the TOPIC_SYSTEM_STATE topic
+ * @details Publishes the current state to the system state topic
  *          with retain flag.
  */
 static void publish_current_state(void)
@@ -128,7 +221,7 @@ static void publish_current_state(void)
     create_state_message(state_msg, sizeof(state_msg));
 
     // Publish with retain flag so new clients get latest state
-    MQTT_Handler_Publish(&mqtt_handler, TOPIC_SYSTEM_STATE, state_msg, 0, 1, 1);
+    MQTT_Handler_Publish(&mqtt_handler, g_topics.system_state, state_msg, 0, 1, 1);
     ESP_LOGI(TAG, "State published: %s", state_msg);
 #endif
 
@@ -162,6 +255,7 @@ static void update_and_publish_state(bool device_on, bool periodic_active)
         g_periodic_active = periodic_active;
         state_changed = true;
         ESP_LOGI(TAG, "Periodic state changed: %s", periodic_active ? "ON" : "OFF");
+        apply_sampling_schedule();
     }
 
     if (state_changed)
@@ -191,10 +285,11 @@ static void on_single_sensor_data(const sensor_data_t *data)
                                 JSON_Parser_GetModeString(data->mode),
                                 data->timestamp,
                                 data->has_temperature ? data->temperature : 0.0f,
-                                data->has_humidity ? data->humidity : 0.0f);
+                                data->has_humidity ? data->humidity : 0.0f,
+                                data->suppressed);
 
-    // Publish immediately, MQTT_Handler will queue if not connected
-    MQTT_Handler_Publish(&mqtt_handler, TOPIC_STM32_DATA_SINGLE, json_msg, 0, 0, 0);
+    // Queued without blocking, so UART draining never waits for the network
+    MQTT_Handler_Publish(&mqtt_handler, g_topics.data_single, json_msg, 0, 0, 0);
 
     ESP_LOGI(TAG, "SINGLE: T=%.1f°C H=%.1f%%",
              data->has_temperature ? data->temperature : 0.0f,
@@ -225,21 +320,77 @@ static void on_periodic_sensor_data(const sensor_data_t *data)
                                 JSON_Parser_GetModeString(data->mode),
                                 data->timestamp,
                                 data->has_temperature ? data->temperature : 0.0f,
-                                data->has_humidity ? data->humidity : 0.0f);
+                                data->has_humidity ? data->humidity : 0.0f,
+                                data->suppressed);
 
-    // Publish immediately, MQTT_Handler will queue if not connected
-    MQTT_Handler_Publish(&mqtt_handler, TOPIC_STM32_DATA_PERIODIC, json_msg, 0, 0, 0);
+    // Queued without blocking, so UART draining never waits for the network
+    MQTT_Handler_Publish(&mqtt_handler, g_topics.data_periodic, json_msg, 0, 0, 0);
 
     ESP_LOGI(TAG, "PERIODIC: T=%.1f°C H=%.1f%%",
              data->has_temperature ? data->temperature : 0.0f,
              data->has_humidity ? data->humidity : 0.0f);
 #endif
 
+#ifdef CONFIG_GATEWAY_POWER_SAVE
+    // Next wake is planned from this arrival
+    PowerManager_OnSample();
+#endif
+
 #ifdef CONFIG_ENABLE_COAP
     // TODO: Add COAP publish logic here if needed
 #endif
 }
 
+/**
+ * @brief Callback when an archived record is received
+ *
+ * @param data Pointer to received sensor data
+ *
+ * @details Publishes records streamed by an "SD QUERY" command so the web
+ *          dashboard can backfill gaps straight from the device.
+ */
+static void on_archive_sensor_data(const sensor_data_t *data)
+{
+#ifdef CONFIG_ENABLE_MQTT
+    char json_msg[256];
+    JSON_Utils_CreateSensorData(json_msg, sizeof(json_msg),
+                                JSON_Parser_GetModeString(data->mode),
+                                data->timestamp,
+                                data->has_temperature ? data->temperature : 0.0f,
+                                data->has_humidity ? data->humidity : 0.0f,
+                                data->suppressed);
+
+    MQTT_Handler_Publish(&mqtt_handler, g_topics.data_archive, json_msg, 0, 1, 0);
+#endif
+}
+
+/**
+ * @brief Callback when a record replayed from the SD buffer is received
+ *
+ * @param data Pointer to received sensor data
+ *
+ * @details Readings buffered while MQTT was down come back tagged with their
+ *          SD sequence number. They go to their own topic so consumers can
+ *          store them in bulk, keyed by the sequence number, whatever the
+ *          live measurement state is. QoS 1: the STM32 has already dropped
+ *          the record from its buffer.
+ */
+static void on_backlog_sensor_data(const sensor_data_t *data)
+{
+#ifdef CONFIG_ENABLE_MQTT
+    char json_msg[256];
+    JSON_Utils_CreateBacklogData(json_msg, sizeof(json_msg),
+                                 JSON_Parser_GetModeString(data->mode),
+                                 data->timestamp,
+                                 data->has_temperature ? data->temperature : 0.0f,
+                                 data->has_humidity ? data->humidity : 0.0f,
+                                 data->suppressed,
+                                 data->sequence_num);
+
+    MQTT_Handler_Publish(&mqtt_handler, g_topics.data_backlog, json_msg, 0, 1, 0);
+#endif
+}
+
 /**
  * @brief Callback when data is received from STM32
  *
@@ -253,9 +404,25 @@ static void on_stm32_data_received(const char *line)
     // ESP_LOGI(TAG, "← STM32: %s", line);
 
     // Parse and process JSON sensor data
-    JSON_Parser_ProcessLine(&json_parser, line);
+    if (!JSON_Parser_ProcessLine(&json_parser, line))
+    {
+        g_parse_failures++;
+    }
 }
 
+#ifdef CONFIG_GATEWAY_POWER_SAVE
+/**
+ * @brief Callback on STM32 link activity
+ *
+ * @details Keeps the chip out of light sleep while a line is being
+ *          received, parsed and published.
+ */
+static void on_stm32_activity(void)
+{
+    PowerManager_StayAwake(POWER_MANAGER_AWAKE_MS);
+}
+#endif
+
 /**
  * @brief Callback when relay state changes
  *
@@ -285,88 +452,157 @@ static void on_relay_state_changed(bool state)
     // Update and publish state (this notifies web)
     update_and_publish_state(state, new_periodic_state);
 
+#ifdef CONFIG_STM32_UART_AUTOBAUD
+    // The power-cycle resets the STM32 to the base rate, follow it at once
+    STM32_UART_ResetBaud(&stm32_uart);
+#endif
+
 #ifdef CONFIG_ENABLE_MQTT
     // CRITICAL: When relay toggles, STM32 gets reset and misses MQTT status
     // Wait 500ms for STM32 to boot, then resend current MQTT status
     vTaskDelay(pdMS_TO_TICKS(500));
 
-    bool mqtt_connected = MQTT_Handler_IsConnected(&mqtt_handler);
-    if (mqtt_connected)
-    {
-        STM32_UART_SendCommand(&stm32_uart, "MQTT CONNECTED");
-        ESP_LOGI(TAG, "TX STM32: MQTT CONNECTED (relay toggled)");
-    }
-    else
+    const char *mqtt_status = "MQTT DISCONNECTED";
+    if (MQTT_Handler_IsConnected(&mqtt_handler))
     {
-        STM32_UART_SendCommand(&stm32_uart, "MQTT DISCONNECTED");
-        ESP_LOGI(TAG, "TX STM32: MQTT DISCONNECTED (relay toggled)");
+        mqtt_status = MQTT_Handler_IsCongested(&mqtt_handler) ? "MQTT BUSY" : "MQTT CONNECTED";
     }
+    STM32_UART_SendCommand(&stm32_uart, mqtt_status);
+    ESP_LOGI(TAG, "TX STM32: %s (relay toggled)", mqtt_status);
+#endif
+
+#ifdef CONFIG_STM32_UART_AUTOBAUD
+    // STM32 rebooted at the base rate, negotiate again once it is up
+    g_uart_renegotiate = true;
+    notify_main_loop();
 #endif
 }
 
 #ifdef CONFIG_ENABLE_MQTT
 /**
- * @brief Callback when MQTT data is received
+ * @brief Copy a received payload into a NUL-terminated buffer
+ *
+ * @param view Payload view
+ * @param buf Destination buffer
+ * @param size Size of buf
+ *
+ * @return true if copied, false if the payload does not fit
+ *
+ * @details Only for handlers whose downstream API takes a C string.
+ */
+static bool mqtt_view_to_string(const mqtt_view_t *view, char *buf, size_t size)
+{
+    if (view->len < 0 || (size_t)view->len >= size)
+    {
+        ESP_LOGW(TAG, "Payload too long (%d bytes), ignored", view->len);
+        return false;
+    }
+
+    memcpy(buf, view->ptr, view->len);
+    buf[view->len] = '\0';
+    return true;
+}
+
+/**
+ * @brief Route handler for STM32 commands from web
  *
  * @param topic Topic of the received message
  * @param data Message payload
- * @param data_len Length of the payload
+ * @param arg Unused
  *
- * @details Handles commands for STM32 sensor, relay control, and state sync.
+ * @details Forwards the command to the STM32 and tracks periodic state.
  */
-static void on_mqtt_data_received(const char *topic, const char *data, int data_len)
+static void on_stm32_command(const mqtt_view_t *topic, const mqtt_view_t *data, void *arg)
 {
     // Don't log here - MQTT handler already logs incoming messages
+    char command[STM32_UART_MAX_LINE_LENGTH - 1]; // Room for the appended '\n'
+    if (!mqtt_view_to_string(data, command, sizeof(command)))
+    {
+        return;
+    }
 
-    // Handle STM32 commands from web
-    if (strcmp(topic, TOPIC_STM32_COMMAND) == 0)
+    // Forward command to STM32
+    if (!STM32_UART_SendCommand(&stm32_uart, command))
     {
-        // Forward command to STM32
-        if (STM32_UART_SendCommand(&stm32_uart, data))
-        {
-            // Update periodic state based on command (for state tracking only)
-            if (strcmp(data, "PERIODIC ON") == 0)
-            {
-                update_and_publish_state(g_device_on, true);
-            }
-            else if (strcmp(data, "PERIODIC OFF") == 0)
-            {
-                update_and_publish_state(g_device_on, false);
-            }
-        }
-        else
-        {
-            ESP_LOGE(TAG, "Failed to forward to STM32: %s", data);
-        }
+        ESP_LOGE(TAG, "Failed to forward to STM32: %s", command);
+        return;
+    }
+
+    // Update periodic state based on command (for state tracking only)
+    if (MQTT_VIEW_IS(data, "PERIODIC ON"))
+    {
+        update_and_publish_state(g_device_on, true);
     }
-    // Handle relay commands
-    else if (strcmp(topic, TOPIC_RELAY_CONTROL) == 0)
+    else if (MQTT_VIEW_IS(data, "PERIODIC OFF"))
     {
-        if (Relay_ProcessCommand(&relay_control, data))
-        {
-            ESP_LOGI(TAG, "Relay command processed: %s", data);
-        }
-        else
-        {
-            ESP_LOGW(TAG, "Unknown relay command: %s", data);
-        }
+        update_and_publish_state(g_device_on, false);
     }
-    // Handle state sync requests - only on ESP32 boot or reconnect
-    else if (strcmp(topic, TOPIC_SYSTEM_STATE) == 0 &&
-             strstr(data, "REQUEST"))
+    else
     {
-        // Only respond if MQTT just reconnected (flag set by connection handler)
-        if (g_mqtt_reconnected)
-        {
-            ESP_LOGI(TAG, "State sync requested after reconnect");
-            publish_current_state();
-            g_mqtt_reconnected = false; // Clear flag after responding
-        }
-        else
+        unsigned int interval_s;
+        if (sscanf(command, "SET PERIODIC INTERVAL %u", &interval_s) == 1 && interval_s > 0)
         {
-            ESP_LOGD(TAG, "Ignoring state sync request (no reconnect event)");
+            g_interval_s = interval_s;
+            apply_sampling_schedule();
         }
     }
+}
+
+/**
+ * @brief Route handler for relay commands
+ *
+ * @param topic Topic of the received message
+ * @param data Message payload
+ * @param arg Unused
+ */
+static void on_relay_control(const mqtt_view_t *topic, const mqtt_view_t *data, void *arg)
+{
+    char command[MQTT_MAX_DATA_LEN];
+    if (!mqtt_view_to_string(data, command, sizeof(command)))
+    {
+        return;
+    }
+
+    if (Relay_ProcessCommand(&relay_control, command))
+    {
+        ESP_LOGI(TAG, "Relay command processed: %s", command);
+    }
+    else
+    {
+        ESP_LOGW(TAG, "Unknown relay command: %s", command);
+    }
+}
+
+/**
+ * @brief Route handler for the state topic
+ *
+ * @param topic Topic of the received message
+ * @param data Message payload
+ * @param arg Unused
+ *
+ * @details Answers state sync requests - only on ESP32 boot or reconnect.
+ *          The retained state published by the gateway itself arrives here
+ *          too and is ignored.
+ */
+static void on_state_request(const mqtt_view_t *topic, const mqtt_view_t *data, void *arg)
+{
+    if (!MQTT_VIEW_IS(data, "REQUEST"))
+    {
+        return;
+    }
+
+    // Only respond if MQTT just reconnected (flag set by connection handler)
+    if (g_mqtt_reconnected)
+    {
+        ESP_LOGI(TAG, "State sync requested after reconnect");
+        publish_current_state();
+        g_mqtt_reconnected = false; // Clear flag after responding
+    }
+    else
+    {
+        ESP_LOGD(TAG, "Ignoring state sync request (no reconnect event)");
+    }
+
     // REMOVED: State synchronization from web to ESP32
     // Let web handle state synchronization to avoid relay bouncing
     // Web will sync its UI based on ESP32's published state
@@ -443,6 +679,8 @@ static void on_wifi_event(wifi_state_t state, void *arg)
     default:
         break;
     }
+
+    notify_main_loop();
 }
 
 /* BUTTON CALLBACK FUNCTIONS -------------------------------------------------*/
@@ -535,11 +773,44 @@ static void on_button_interval_pressed(gpio_num_t gpio_num)
     snprintf(cmd, sizeof(cmd), "SET PERIODIC INTERVAL %d", interval);
 
     ESP_LOGI(TAG, "Button: Interval %ds", interval);
-    STM32_UART_SendCommand(&stm32_uart, cmd);
+    if (STM32_UART_SendCommand(&stm32_uart, cmd))
+    {
+        g_interval_s = interval;
+        apply_sampling_schedule();
+    }
 }
 
 /* INITIALIZATION FUNCTIONS --------------------------------------------------*/
 
+#ifdef CONFIG_ENABLE_MQTT
+/**
+ * @brief Build the per-device topic names
+ *
+ * @param device_id MQTT client ID (ESP32_XXXXXX, unique per gateway)
+ *
+ * @details Several loggers can share one broker: each publishes and listens
+ *          under datalogger/<device_id>/, and consumers subscribe with a
+ *          wildcard (datalogger/+/stm32/+/data) and read the device from the
+ *          second topic level.
+ */
+static void build_device_topics(const char *device_id)
+{
+#define BUILD_TOPIC(field, suffix) \
+    snprintf(g_topics.field, sizeof(g_topics.field), TOPIC_ROOT "/%s/" suffix, device_id)
+
+    BUILD_TOPIC(stm32_command, TOPIC_STM32_COMMAND);
+    BUILD_TOPIC(relay_control, TOPIC_RELAY_CONTROL);
+    BUILD_TOPIC(system_state, TOPIC_SYSTEM_STATE);
+    BUILD_TOPIC(esp32_metrics, TOPIC_ESP32_METRICS);
+    BUILD_TOPIC(data_single, TOPIC_STM32_DATA_SINGLE);
+    BUILD_TOPIC(data_periodic, TOPIC_STM32_DATA_PERIODIC);
+    BUILD_TOPIC(data_archive, TOPIC_STM32_DATA_ARCHIVE);
+    BUILD_TOPIC(data_backlog, TOPIC_STM32_DATA_BACKLOG);
+
+#undef BUILD_TOPIC
+}
+#endif
+
 /**
  * @brief Initialize all components
  *
@@ -561,11 +832,24 @@ static bool initialize_components(void)
                            CONFIG_BROKER_URL,
                            CONFIG_MQTT_USERNAME,
                            CONFIG_MQTT_PASSWORD,
-                           on_mqtt_data_received))
+                           NULL))
     {
         ESP_LOGE(TAG, "Failed to initialize MQTT Handler");
         success = false;
     }
+    build_device_topics(mqtt_handler.client_id);
+
+    // Incoming commands are dispatched by topic (subscribed in subscribe_mqtt_topics)
+    if (!MQTT_Handler_Route(&mqtt_handler, g_topics.stm32_command, on_stm32_command, NULL) ||
+        !MQTT_Handler_Route(&mqtt_handler, g_topics.relay_control, on_relay_control, NULL) ||
+        !MQTT_Handler_Route(&mqtt_handler, g_topics.system_state, on_state_request, NULL))
+    {
+        ESP_LOGE(TAG, "Failed to register MQTT routes");
+        success = false;
+    }
+
+    // Connection and back-pressure changes wake the main loop
+    MQTT_Handler_SetStatusCallback(&mqtt_handler, notify_main_loop);
 #endif
 
 #ifdef CONFIG_ENABLE_COAP
@@ -591,6 +875,8 @@ static bool initialize_components(void)
         ESP_LOGE(TAG, "Failed to initialize JSON Sensor Parser");
         success = false;
     }
+    JSON_Parser_SetArchiveCallback(&json_parser, on_archive_sensor_data);
+    JSON_Parser_SetBacklogCallback(&json_parser, on_backlog_sensor_data);
 
     // Initialize global state with actual hardware state
     g_device_on = Relay_GetState(&relay_control);
@@ -628,6 +914,16 @@ static bool initialize_components(void)
         ESP_LOGI(TAG, "All button handlers initialized");
     }
 
+#ifdef CONFIG_GATEWAY_METRICS_ENABLE
+    // Gateway metrics (stack high-water marks of these tasks are reported)
+    GatewayMetrics_Init(CONFIG_GATEWAY_METRICS_INTERVAL_MS);
+    GatewayMetrics_WatchTask("main");
+    GatewayMetrics_WatchTask("stm32_uart");
+    GatewayMetrics_WatchTask("button_task");
+    GatewayMetrics_WatchTask("mqtt_task");
+    GatewayMetrics_WatchTask("mqtt_publish");
+#endif
+
     return success;
 }
 
@@ -682,9 +978,9 @@ static bool start_services(void)
 static void subscribe_mqtt_topics(void)
 {
     // Subscribe to command topics
-    MQTT_Handler_Subscribe(&mqtt_handler, TOPIC_STM32_COMMAND, 1);
-    MQTT_Handler_Subscribe(&mqtt_handler, TOPIC_RELAY_CONTROL, 1);
-    MQTT_Handler_Subscribe(&mqtt_handler, TOPIC_SYSTEM_STATE, 1);
+    MQTT_Handler_Subscribe(&mqtt_handler, g_topics.stm32_command, 1);
+    MQTT_Handler_Subscribe(&mqtt_handler, g_topics.relay_control, 1);
+    MQTT_Handler_Subscribe(&mqtt_handler, g_topics.system_state, 1);
 
     // Set reconnection flag to allow next REQUEST to trigger state publish
     g_mqtt_reconnected = true;
@@ -694,6 +990,77 @@ static void subscribe_mqtt_topics(void)
 }
 #endif
 
+#ifdef CONFIG_GATEWAY_METRICS_ENABLE
+/**
+ * @brief Publish gateway metrics if the report interval has elapsed
+ *
+ * @param now_ms Current time in milliseconds
+ *
+ * @details Collects the UART, parser, MQTT and WiFi counters and publishes
+ *          them as one JSON document on the metrics topic (QoS 0).
+ */
+static void publish_metrics(uint32_t now_ms)
+{
+    if (!MQTT_Handler_IsConnected(&mqtt_handler) || !GatewayMetrics_IsDue(now_ms))
+    {
+        return;
+    }
+
+    gateway_metrics_input_t input = {0};
+
+    stm32_uart_stats_t uart_stats;
+    STM32_UART_GetStats(&stm32_uart, &uart_stats);
+    input.uart_rx_bytes = uart_stats.rx_bytes;
+    input.uart_rx_lines = uart_stats.rx_lines;
+    input.uart_rejected_lines = uart_stats.rejected_lines;
+    input.uart_long_lines = uart_stats.long_lines;
+    input.uart_ring_overflows = uart_stats.ring_overflows;
+    input.uart_dropped_bytes = uart_stats.dropped_bytes;
+    input.uart_fifo_overflows = uart_stats.fifo_overflows;
+    input.uart_baud = stm32_uart.baud_rate;
+    input.uart_link_errors = uart_stats.frame_errors + uart_stats.noise_bytes;
+    input.uart_demotions = uart_stats.demotions;
+
+    input.parse_failures = g_parse_failures;
+
+    mqtt_handler_stats_t mqtt_stats;
+    MQTT_Handler_GetStats(&mqtt_handler, &mqtt_stats);
+    input.mqtt_published = mqtt_stats.published;
+    input.mqtt_publish_failed = mqtt_stats.publish_failed;
+    input.mqtt_publish_total_us = mqtt_stats.publish_total_us;
+    input.mqtt_publish_max_us = mqtt_stats.publish_max_us;
+    input.mqtt_acked = mqtt_stats.acked;
+    input.mqtt_ack_total_ms = mqtt_stats.ack_total_ms;
+    input.mqtt_ack_max_ms = mqtt_stats.ack_max_ms;
+    input.mqtt_outbox_bytes = MQTT_Handler_GetOutboxSize(&mqtt_handler);
+    input.mqtt_queue_depth = MQTT_Handler_GetQueueDepth(&mqtt_handler);
+    input.mqtt_backpressure = mqtt_stats.backpressure;
+    input.mqtt_connects = mqtt_stats.connects;
+    input.mqtt_reconnect_attempts = mqtt_stats.reconnect_attempts;
+
+    input.wifi_reconnects = g_wifi_reconnects;
+    if (wifi_manager_get_rssi(&input.wifi_rssi) != ESP_OK)
+    {
+        input.wifi_rssi = 0;
+    }
+
+#ifdef CONFIG_GATEWAY_POWER_SAVE
+    power_manager_stats_t power_stats;
+    PowerManager_GetStats(&power_stats);
+    input.power_save = true;
+    input.power_wakes = power_stats.wakes;
+    input.power_awake_ms = power_stats.awake_ms;
+    input.power_unscheduled = power_stats.unscheduled;
+#endif
+
+    char metrics_msg[GATEWAY_METRICS_MSG_LEN];
+    if (GatewayMetrics_Format(&input, now_ms, metrics_msg, sizeof(metrics_msg)) > 0)
+    {
+        MQTT_Handler_Publish(&mqtt_handler, g_topics.esp32_metrics, metrics_msg, 0, 0, 0);
+    }
+}
+#endif
+
 /* MAIN APPLICATION ----------------------------------------------------------*/
 
 void app_main(void)
@@ -708,6 +1075,9 @@ void app_main(void)
     ESP_LOGI(TAG, "Free heap: %lu bytes", esp_get_free_heap_size());
     ESP_LOGI(TAG, "IDF version: %s", esp_get_idf_version());
 
+    // Event callbacks notify this task
+    g_main_task = xTaskGetCurrentTaskHandle();
+
     // Initialize WiFi LED indicator GPIO
     gpio_config_t io_conf = {
         .pin_bit_mask = (1ULL << WIFI_LED_GPIO),
@@ -773,6 +1143,15 @@ void app_main(void)
     }
     ESP_LOGI(TAG, "STM32 UART initialized successfully");
 
+#ifdef CONFIG_GATEWAY_POWER_SAVE
+    // Automatic light sleep, woken by the STM32 link and the sample schedule
+    if (PowerManager_Init())
+    {
+        PowerManager_EnableUartWake(CONFIG_MQTT_UART_PORT_NUM, CONFIG_MQTT_UART_RXD);
+        STM32_UART_SetActivityCallback(&stm32_uart, on_stm32_activity);
+    }
+#endif
+
     // Initialize and connect WiFi using custom WiFi Manager
     ESP_LOGI(TAG, "=== Initializing WiFi Manager ===");
     wifi_manager_config_t wifi_config = wifi_manager_get_default_config();
@@ -843,11 +1222,14 @@ void app_main(void)
     ESP_LOGI(TAG, "MQTT Configuration:");
     ESP_LOGI(TAG, "MQTT Broker: %s", CONFIG_BROKER_URL);
     ESP_LOGI(TAG, "Topics:");
-    ESP_LOGI(TAG, "Command: %s", TOPIC_STM32_COMMAND);
-    ESP_LOGI(TAG, "Relay: %s", TOPIC_RELAY_CONTROL);
-    ESP_LOGI(TAG, "State: %s", TOPIC_SYSTEM_STATE);
-    ESP_LOGI(TAG, "Single Data: %s", TOPIC_STM32_DATA_SINGLE);
-    ESP_LOGI(TAG, "Periodic Data: %s", TOPIC_STM32_DATA_PERIODIC);
+    ESP_LOGI(TAG, "Command: %s", g_topics.stm32_command);
+    ESP_LOGI(TAG, "Relay: %s", g_topics.relay_control);
+    ESP_LOGI(TAG, "State: %s", g_topics.system_state);
+    ESP_LOGI(TAG, "Single Data: %s", g_topics.data_single);
+    ESP_LOGI(TAG, "Periodic Data: %s", g_topics.data_periodic);
+#ifdef CONFIG_GATEWAY_METRICS_ENABLE
+    ESP_LOGI(TAG, "Metrics: %s (every %d ms)", g_topics.esp32_metrics, CONFIG_GATEWAY_METRICS_INTERVAL_MS);
+#endif
 #endif
 
 #ifdef CONFIG_ENABLE_COAP
@@ -860,6 +1242,7 @@ void app_main(void)
 
 #ifdef CONFIG_ENABLE_MQTT
     bool last_mqtt = MQTT_Handler_IsConnected(&mqtt_handler);
+    bool last_congested = false;
 #endif
 
 #ifdef CONFIG_ENABLE_COAP
@@ -898,6 +1281,19 @@ void app_main(void)
         wifi_state_t wifi_state = wifi_manager_get_state();
         uint32_t now_ms = esp_timer_get_time() / 1000; // Convert to milliseconds
 
+#ifdef CONFIG_STM32_UART_AUTOBAUD
+        // Step the STM32 link up after boot and relay power-cycles, drop it on errors
+        if (g_uart_renegotiate)
+        {
+            g_uart_renegotiate = false;
+            STM32_UART_Negotiate(&stm32_uart, STM32_UART_MAX_BAUD);
+        }
+        else
+        {
+            STM32_UART_CheckLink(&stm32_uart);
+        }
+#endif
+
         // WiFi reconnection logic - ONLY retry if WiFi has FAILED (exhausted all retries)
         // Don't interfere while WiFi Manager is doing its own retries (CONNECTING state)
         if (wifi_state == WIFI_STATE_FAILED)
@@ -933,6 +1329,7 @@ void app_main(void)
         {
             ESP_LOGI(TAG, "WiFi restored, network stabilizing...");
             g_wifi_reconnect_time_ms = now_ms; // Mark reconnect time
+            g_wifi_reconnects++;
         }
 
         // Start MQTT after 4 seconds of WiFi being stable (both on boot and reconnect)
@@ -983,6 +1380,16 @@ void app_main(void)
             ESP_LOGI(TAG, "TX STM32: MQTT DISCONNECTED");
         }
 
+        // Publish queue back-pressure changed - STM32 buffers to SD while BUSY
+        bool congested_now = mqtt_now && MQTT_Handler_IsCongested(&mqtt_handler);
+        if (mqtt_now && congested_now != last_congested)
+        {
+            const char *mqtt_status = congested_now ? "MQTT BUSY" : "MQTT CONNECTED";
+            STM32_UART_SendCommand(&stm32_uart, mqtt_status);
+            ESP_LOGI(TAG, "TX STM32: %s", mqtt_status);
+        }
+        last_congested = congested_now;
+
         // Log status changes only
         if (relay_now != last_relay || periodic_now != last_periodic ||
             mqtt_now != last_mqtt || wifi_now != last_wifi)
@@ -1001,6 +1408,10 @@ void app_main(void)
         last_wifi = wifi_now;
 #endif
 
+#ifdef CONFIG_GATEWAY_METRICS_ENABLE
+        publish_metrics(now_ms);
+#endif
+
 #ifdef CONFIG_ENABLE_COAP
         // TODO: Uncomment if you have COAP handler
         // bool coap_now = CoAP_Handler_IsConnected(&coap_handler);
@@ -1019,6 +1430,11 @@ void app_main(void)
         // last_coap = coap_now;
         // last_wifi = wifi_now;
 #endif
-        vTaskDelay(pdMS_TO_TICKS(200));
+        // Poll while connections come up, otherwise sleep until an event wakes us
+        bool settling = !wifi_now;
+#ifdef CONFIG_ENABLE_MQTT
+        settling = settling || !mqtt_now || congested_now;
+#endif
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(settling ? MAIN_LOOP_POLL_MS : MAIN_LOOP_IDLE_MS));
     }
 }
\ No newline at end of file
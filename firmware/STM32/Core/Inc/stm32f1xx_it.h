@@ -57,6 +57,13 @@ void PendSV_Handler(void);
 void SysTick_Handler(void);
 void USART1_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void PVD_IRQHandler(void);
+void EXTI0_IRQHandler(void);
+void EXTI15_10_IRQHandler(void);
+void I2C1_EV_IRQHandler(void);
+void I2C1_ER_IRQHandler(void);
+void DMA1_Channel6_IRQHandler(void);
+void DMA1_Channel7_IRQHandler(void);
 
 /* USER CODE END EFP */
 
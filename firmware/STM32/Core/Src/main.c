@@ -26,11 +26,18 @@
 #include <stdbool.h>
 #include <time.h>
 #include "uart.h"
+#include "i2c_bus.h"
 #include "sht3x.h"
 #include "ds3231.h"
+#include "rtc_clock.h"
 #include "data_manager.h"
 #include "wifi_manager.h"
 #include "sd_card_manager.h"
+#include "sd_archive.h"
+#include "sd_fat32.h"
+#include "power_monitor.h"
+#include "low_power.h"
+#include "profiler.h"
 #include "sensor_json_output.h"
 #include "print_cli.h"
 #include "ili9225.h"
@@ -47,6 +54,8 @@
 /* USER CODE BEGIN PD */
 
 #define PERIODIC_PRINT_INTERVAL_MS 5000 // Interval to print periodic data (5 seconds)
+#define SD_QUERY_SEND_INTERVAL_MS 20     // Delay between streamed archive records
+#define SD_REPLAY_SEND_INTERVAL_MS 20    // Delay between replayed buffered records
 
 /* USER CODE END PD */
 
@@ -144,12 +153,18 @@ int main(void)
 
   UART_Init(&huart1);
 
+  /* I2C transaction queue shared by SHT3X and DS3231 (recovers a hung bus) */
+  I2CBus_Init(&hi2c1);
+
   /* Initialize SHT3X */
   SHT3X_Init(&g_sht3x, &hi2c1, SHT3X_I2C_ADDR_GND);
 
   /* Initialize DS3231 */
   DS3231_Init(&g_ds3231, &hi2c1);
 
+  /* Software clock: read RTC once, then count the DS3231 1 Hz square wave */
+  RTCClock_Init();
+
   /* Initialize DataManager */
   DataManager_Init();
 
@@ -162,6 +177,17 @@ int main(void)
   {
     PRINT_CLI("[WARN] SD Card NOT available! Data will be lost when WiFi disconnected.\r\n");
   }
+  else
+  {
+    /* Archive region lives on the same card, after the FIFO buffer */
+    SDArchive_Init();
+  }
+
+  /* Brown-out detection: flush SD metadata before the supply collapses */
+  PowerMonitor_Init();
+
+  /* DS3231 alarm wake source for low power mode (SET POWER LOW) */
+  LowPower_Init();
 
   /* Initialize ILI9225 TFT Display */
   ILI9225_Init();
@@ -170,6 +196,9 @@ int main(void)
   /* Initialize Display Library */
   display_init();
 
+  /* Main loop stage timing (STATS command) */
+  Profiler_Init();
+
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -178,6 +207,8 @@ int main(void)
   // Display update variables
   static uint32_t last_display_update_ms = 0;
   static bool is_periodic_active = false;
+  static bool loop_slept = false; // Previous iteration entered STOP mode
+  uint32_t stage_start;
 
   while (1)
   {
@@ -185,9 +216,23 @@ int main(void)
 
     /* USER CODE BEGIN 3 */
 
+    Profiler_LoopMark(loop_slept);
+    loop_slept = false;
+
+    stage_start = PROFILER_START();
     UART_Handle();
+    PROFILER_STOP(PROFILER_STAGE_UART, stage_start);
+
+    stage_start = PROFILER_START();
+    I2CBus_Process();
+    PROFILER_STOP(PROFILER_STAGE_I2C, stage_start);
+
+    PowerMonitor_Process();
+
+    RTCClock_Process();
 
     /* Handle periodic sensor data fetch */
+    stage_start = PROFILER_START();
     if (SHT3X_IS_PERIODIC_STATE(g_sht3x.currentState))
     {
       is_periodic_active = true;
@@ -195,15 +240,15 @@ int main(void)
 
       if ((int32_t)(now - next_fetch_ms) >= 0 && last_fetch_ms != now)
       {
-        // Fetch data from sensor
-        SHT3X_FetchData(&g_sht3x, &outT, &outRH);
-
-        // Update data manager with periodic data
-        DataManager_UpdatePeriodic(outT, outRH);
+        // Queue the fetch, the result is collected below without blocking
+        SHT3X_FetchStart(&g_sht3x);
 
         // Toggle GPIO
         HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_13);
 
+        // Sampling period error against the configured interval
+        Profiler_SampleMark(now, periodic_interval_ms);
+
         // Record this fetch time to prevent duplicates
         last_fetch_ms = now;
 
@@ -214,6 +259,40 @@ int main(void)
     else
     {
       is_periodic_active = false;
+      Profiler_SampleReset();
+    }
+
+    /* Collect the periodic fetch once the I2C bus has completed it */
+    if (SHT3X_FetchPoll(&g_sht3x, &outT, &outRH))
+    {
+      // Update data manager with periodic data
+      DataManager_UpdatePeriodic(outT, outRH);
+
+      // Wake-to-sample latency when woken from STOP
+      LowPower_MarkSample();
+    }
+    PROFILER_STOP(PROFILER_STAGE_FETCH, stage_start);
+
+    /* Append every new report to the SD archive (never drained, queried by time) */
+    uint32_t report_timestamp = 0;
+    if (DataManager_IsDataReady())
+    {
+      const data_manager_state_t *state = DataManager_GetState();
+
+      // Timestamp from the software clock (no I2C)
+      report_timestamp = RTCClock_Now();
+
+      stage_start = PROFILER_START();
+
+      const char *report_mode = (state->mode == DATA_MANAGER_MODE_SINGLE) ? "SINGLE" : "PERIODIC";
+
+      SDArchive_Append(report_timestamp, state->sht3x.temperature, state->sht3x.humidity,
+                       report_mode, state->suppressed);
+
+      // Per-day CSV file (no-op unless SD_FAT32_ENABLE mounted a volume)
+      SDFat32_LogRecord(report_timestamp, state->sht3x.temperature, state->sht3x.humidity,
+                        report_mode, state->suppressed);
+      PROFILER_STOP(PROFILER_STAGE_ARCHIVE, stage_start);
     }
 
     /* MQTT-aware data routing logic */
@@ -229,18 +308,21 @@ int main(void)
       static uint32_t last_sd_send_ms = 0;
       uint32_t now_ms = HAL_GetTick();
 
-      if (SDCardManager_GetBufferedCount() > 0 && (now_ms - last_sd_send_ms) >= 100) // 100ms delay between SD records
+      if (SDCardManager_GetBufferedCount() > 0 && (now_ms - last_sd_send_ms) >= SD_REPLAY_SEND_INTERVAL_MS)
       {
+        stage_start = PROFILER_START();
         static sd_data_record_t buffered_record;
         if (SDCardManager_ReadData(&buffered_record))
         {
-          // Format buffered record as JSON using the same function DataManager uses
-          char json_buffer[128];
-          int len = sensor_json_format(json_buffer, sizeof(json_buffer),
-                                       buffered_record.mode,
-                                       buffered_record.temperature,
-                                       buffered_record.humidity,
-                                       buffered_record.timestamp);
+          // Tagged with its sequence number: the gateway routes it to the backlog topic
+          char json_buffer[SENSOR_JSON_BACKLOG_MAX];
+          int len = sensor_json_format_backlog(json_buffer, sizeof(json_buffer),
+                                               buffered_record.mode,
+                                               buffered_record.temperature,
+                                               buffered_record.humidity,
+                                               buffered_record.timestamp,
+                                               buffered_record.suppressed,
+                                               buffered_record.sequence_num);
 
           // Send to ESP32 via UART
           if (len > 0)
@@ -252,74 +334,102 @@ int main(void)
             last_sd_send_ms = now_ms;
           }
         }
+        PROFILER_STOP(PROFILER_STAGE_SD_REPLAY, stage_start);
       }
     }
     else
     {
-      /* MQTT DISCONNECTED - Buffer data to SD card (don't print to UART) */
+      /* MQTT DISCONNECTED or BUSY - Buffer data to SD card (don't print to UART) */
 
       if (DataManager_IsDataReady())
       {
         const data_manager_state_t *state = DataManager_GetState();
 
-        // Get timestamp from RTC (if available)
-        uint32_t timestamp = 0;
-        struct tm time;
-        if (DS3231_Get_Time(&g_ds3231, &time) == HAL_OK)
-        {
-          timestamp = (uint32_t)mktime(&time);
-        }
-        else
-        {
-          timestamp = HAL_GetTick() / 1000; // Use systick as fallback
-        }
-
         // Determine mode string
         const char *mode_str = (state->mode == DATA_MANAGER_MODE_SINGLE) ? "SINGLE" : "PERIODIC";
 
-        // Write to SD card buffer
-        SDCardManager_WriteData(timestamp, state->sht3x.temperature, state->sht3x.humidity, mode_str);
+        // Write to SD card buffer (timestamp taken when the report was archived)
+        stage_start = PROFILER_START();
+        SDCardManager_WriteData(report_timestamp, state->sht3x.temperature, state->sht3x.humidity, mode_str,
+                                state->suppressed);
+        PROFILER_STOP(PROFILER_STAGE_SD_WRITE, stage_start);
 
         // Clear flag to allow next data
         DataManager_ClearDataReady();
       }
     }
 
-    /* Update Display (every 1 second for smooth clock update OR when forced) */
-    uint32_t now_ms = HAL_GetTick();
-    if (now_ms - last_display_update_ms >= 1000 || force_display_update)
+    /* Stream SD archive query results (non-blocking, one record per loop) */
+    static uint32_t last_query_send_ms = 0;
+    if (SDArchive_IsQueryActive() && (HAL_GetTick() - last_query_send_ms) >= SD_QUERY_SEND_INTERVAL_MS)
     {
-      // Get current timestamp from RTC (ALWAYS read from DS3231, not increment)
-      time_t current_time = 0;
-      struct tm time;
-      if (DS3231_Get_Time(&g_ds3231, &time) == HAL_OK)
-      {
-        current_time = mktime(&time);
-      }
-      else
+      stage_start = PROFILER_START();
+      static sd_data_record_t archived_record;
+      if (SDArchive_QueryNext(&archived_record))
       {
-        current_time = HAL_GetTick() / 1000; // Fallback to systick
+        char json_buffer[128];
+        int len = sensor_json_format(json_buffer, sizeof(json_buffer),
+                                     "ARCHIVE",
+                                     archived_record.temperature,
+                                     archived_record.humidity,
+                                     archived_record.timestamp,
+                                     archived_record.suppressed);
+        if (len > 0)
+        {
+          PRINT_CLI(json_buffer);
+        }
+        last_query_send_ms = HAL_GetTick();
       }
+      PROFILER_STOP(PROFILER_STAGE_QUERY, stage_start);
+    }
+
+    /* Update Display (every 1 second for smooth clock update OR when forced) */
+    uint32_t now_ms = HAL_GetTick();
+    if (!LowPower_IsEnabled() && (now_ms - last_display_update_ms >= 1000 || force_display_update))
+    {
+      // Current time from the software clock (disciplined by the DS3231 square wave)
+      time_t current_time = (time_t)RTCClock_Now();
 
       // Get sensor data from data manager
       const data_manager_state_t *state = DataManager_GetState();
       float display_temp = state->sht3x.valid ? state->sht3x.temperature : 0.0f;
       float display_humi = state->sht3x.valid ? state->sht3x.humidity : 0.0f;
 
-      // Determine MQTT connection status
-      bool mqtt_connected = (mqtt_current_state == MQTT_STATE_CONNECTED);
+      // Determine MQTT connection status (BUSY is still connected)
+      bool mqtt_connected = (mqtt_current_state != MQTT_STATE_DISCONNECTED);
 
       // Calculate interval in seconds
       int interval_seconds = periodic_interval_ms / 1000;
 
       // Update display
+      stage_start = PROFILER_START();
       display_update(current_time, display_temp, display_humi,
                      mqtt_connected, is_periodic_active, interval_seconds);
+      PROFILER_STOP(PROFILER_STAGE_DISPLAY, stage_start);
 
       // Reset flags after update
       last_display_update_ms = now_ms;
       force_display_update = false; // Clear force update flag
     }
+
+    /* Low power mode: STOP until the next periodic fetch once there is nothing left to do */
+    if (LowPower_IsEnabled() && is_periodic_active && UART_IsIdle(LOW_POWER_UART_QUIET_MS) &&
+        I2CBus_IsIdle() && !DataManager_IsDataReady() && !SDArchive_IsQueryActive() &&
+        !(mqtt_current_state == MQTT_STATE_CONNECTED && SDCardManager_GetBufferedCount() > 0))
+    {
+      int32_t until_fetch_ms = (int32_t)(next_fetch_ms - HAL_GetTick());
+      if (until_fetch_ms > 0)
+      {
+        if (LowPower_Sleep((uint32_t)until_fetch_ms) > 0)
+        {
+          // Alarm interrupts stopped the square wave while sleeping
+          RTCClock_Resume();
+
+          // Cycle counter was stopped, do not count this iteration as loop jitter
+          loop_slept = true;
+        }
+      }
+    }
   }
   /* USER CODE END 3 */
 }
@@ -377,7 +487,7 @@ static void MX_I2C1_Init(void)
 
   /* USER CODE END I2C1_Init 1 */
   hi2c1.Instance = I2C1;
-  hi2c1.Init.ClockSpeed = 100000;
+  hi2c1.Init.ClockSpeed = 400000;
   hi2c1.Init.DutyCycle = I2C_DUTYCYCLE_2;
   hi2c1.Init.OwnAddress1 = 0;
   hi2c1.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
@@ -555,6 +665,25 @@ static void MX_GPIO_Init(void)
 
 /* USER CODE BEGIN 4 */
 
+/**
+ * @brief GPIO EXTI callback (overrides weak HAL definition)
+ *
+ * @details The DS3231 INT/SQW pin carries the alarm while sleeping and the
+ *          1 Hz square wave otherwise.
+ */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  if (LowPower_HandleWake(GPIO_Pin))
+  {
+    return;
+  }
+
+  if (GPIO_Pin == RTC_CLOCK_SQW_PIN)
+  {
+    RTCClock_HandleEdge();
+  }
+}
+
 /* USER CODE END 4 */
 
 /**
@@ -137,6 +137,16 @@ void MQTT_CONNECTED_PARSER(uint8_t argc, char **argv);
  */
 void MQTT_DISCONNECTED_PARSER(uint8_t argc, char **argv);
 
+/**
+ * @brief Command parser for MQTT BUSY notification
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself
+ */
+void MQTT_BUSY_PARSER(uint8_t argc, char **argv);
+
 /**
  * @brief Command parser for SD CLEAR command
  *
@@ -147,4 +157,167 @@ void MQTT_DISCONNECTED_PARSER(uint8_t argc, char **argv);
  */
 void SD_CLEAR_PARSER(uint8_t argc, char **argv);
 
+/**
+ * @brief Command parser for SD QUERY command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Format:
+ *       SD QUERY <FROM_UNIX> <TO_UNIX> or SD QUERY STOP.
+ *       Archived records are streamed by the main loop.
+ */
+void SD_QUERY_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for SET REPORT DEADBAND command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Format:
+ *       SET REPORT DEADBAND <TEMP_C> <HUMI_PCT> <HEARTBEAT_S>
+ */
+void SET_REPORT_DEADBAND_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for SET REPORT ALL command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Restores reporting of every sample.
+ */
+void SET_REPORT_ALL_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for SET POWER command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Format: SET POWER LOW or
+ *       SET POWER NORMAL. LOW sleeps in STOP mode between periodic samples.
+ */
+void SET_POWER_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for POWER STATUS command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Prints low power statistics.
+ */
+void POWER_STATUS_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for I2C STATUS command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Prints per-device transfer, error
+ *       and timeout counters and the number of bus recoveries.
+ */
+void I2C_STATUS_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for STATS command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Prints min/avg/max and a histogram
+ *       for each main loop stage, loop period and jitter, and the
+ *       periodic sampling period error.
+ */
+void STATS_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for STATS RESET command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Clears all profiler statistics.
+ */
+void STATS_RESET_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for UART BAUD command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Replies "UART BAUD OK <rate>" at the
+ *       current rate, then switches to <rate> on trial (see UART_TryBaudRate()).
+ */
+void UART_BAUD_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for UART TEST command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Checks the CRC-16 of the pattern and
+ *       echoes "UART TEST OK <pattern> <crc>", or replies "UART TEST FAIL".
+ */
+void UART_TEST_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for UART COMMIT command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Keeps the trial baud rate.
+ */
+void UART_COMMIT_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for UART RESET command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Returns to UART_BAUD_DEFAULT and
+ *       replies "UART RESET OK" at that rate.
+ */
+void UART_RESET_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for UART STATUS command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Prints the baud rate and the link
+ *       error counters.
+ */
+void UART_STATUS_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for SET DISPLAY command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Format: SET DISPLAY STATUS or
+ *       SET DISPLAY TREND. TREND shows the scrolling sample history.
+ */
+void SET_DISPLAY_PARSER(uint8_t argc, char **argv);
+
+/**
+ * @brief Command parser for FMT BENCH command
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ *
+ * @note argv[0] is the command itself. Only registered when
+ *       FIXED_FMT_BENCHMARK is 1. Prints average cycles per JSON record.
+ */
+void FMT_BENCH_PARSER(uint8_t argc, char **argv);
+
 #endif /* CMD_PARSER_H */
@@ -12,6 +12,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+/* DEFINES -------------------------------------------------------------------*/
+
+#define DATA_MANAGER_HISTORY_LEN 180 // Periodic samples kept in RAM (trend view)
+
 /* TYPEDEFS ------------------------------------------------------------------*/
 
 /**
@@ -24,6 +28,15 @@ typedef enum
     DATA_MANAGER_MODE_PERIODIC
 } data_manager_mode_t;
 
+/**
+ * @brief Periodic reporting mode enumeration
+ */
+typedef enum
+{
+    DATA_MANAGER_REPORT_ALL = 0, // Report every periodic sample
+    DATA_MANAGER_REPORT_DEADBAND // Report only on change beyond deadband or heartbeat
+} data_manager_report_mode_t;
+
 /**
  * @brief Sensor data structure for SHT3X
  */
@@ -34,16 +47,43 @@ typedef struct
     bool valid;        // Data validity flag
 } sensor_data_sht3x_t;
 
+/**
+ * @brief Periodic sample kept in the RAM history
+ */
+typedef struct
+{
+    int16_t temperature; // Temperature in 0.1 Celsius
+    uint16_t humidity;   // Humidity in 0.1 percent
+} data_manager_sample_t;
+
+/**
+ * @brief Deadband reporting configuration and tracking
+ */
+typedef struct
+{
+    data_manager_report_mode_t mode; // Current reporting mode
+    float temp_deadband;             // Temperature deadband in Celsius
+    float humi_deadband;             // Humidity deadband in percentage
+    uint32_t heartbeat_ms;           // Max silence before a report is forced
+    float last_temperature;          // Last reported temperature
+    float last_humidity;             // Last reported humidity
+    uint32_t last_report_ms;         // Tick of the last reported sample
+    bool has_reference;              // Last reported values are valid
+    uint32_t suppressed;             // Samples suppressed since last report
+} data_manager_report_t;
+
 /**
  * @brief Complete data manager state structure
  */
 typedef struct
 {
-    data_manager_mode_t mode;  // Current measurement mode
-    uint32_t timestamp;        // Unix timestamp from RTC
-    sensor_data_sht3x_t sht3x; // SHT3X sensor data
-    /* ... */                  // Placeholder for future sensors
-    bool data_ready;           // Flag indicating new data available
+    data_manager_mode_t mode;     // Current measurement mode
+    uint32_t timestamp;           // Unix timestamp from RTC
+    sensor_data_sht3x_t sht3x;    // SHT3X sensor data
+    /* ... */                     // Placeholder for future sensors
+    bool data_ready;              // Flag indicating new data available
+    uint32_t suppressed;          // Samples suppressed before the ready one
+    data_manager_report_t report; // Periodic reporting configuration
 } data_manager_state_t;
 
 /* PUBLIC API ----------------------------------------------------------------*/
@@ -71,15 +111,35 @@ void DataManager_UpdateSingle(float temperature, float humidity);
  * @param temperature Temperature value from sensor
  * @param humidity Humidity value from sensor
  *
- * @note This function updates internal state and sets data_ready flag
+ * @note This function updates internal state and sets data_ready flag.
+ *       In DEADBAND reporting mode the flag is only set when the sample
+ *       leaves the deadband or the heartbeat expires; otherwise the sample
+ *       is counted as suppressed.
  */
 void DataManager_UpdatePeriodic(float temperature, float humidity);
 
+/**
+ * @brief Configure periodic reporting mode
+ *
+ * @param mode DATA_MANAGER_REPORT_ALL or DATA_MANAGER_REPORT_DEADBAND
+ * @param temp_deadband Temperature deadband in Celsius (DEADBAND mode only)
+ * @param humi_deadband Humidity deadband in percentage (DEADBAND mode only)
+ * @param heartbeat_ms Max silence in milliseconds before a report is forced
+ *
+ * @note The reference values are reset, so the next periodic sample is
+ *       always reported.
+ */
+void DataManager_SetReportMode(data_manager_report_mode_t mode,
+                               float temp_deadband,
+                               float humi_deadband,
+                               uint32_t heartbeat_ms);
+
 /**
  * @brief Print the current sensor data in JSON format
  *
  * @details Outputs: {"mode":"SINGLE|PERIODIC","timestamp":...,"temperature":...,"humidity":...}\r\n
- *          Only prints if data_ready flag is set
+ *          A "suppressed" field is appended when samples were suppressed
+ *          by DEADBAND reporting. Only prints if data_ready flag is set
  *
  * @return true if data was printed, false if no data ready
  */
@@ -92,6 +152,27 @@ bool DataManager_Print(void);
  */
 const data_manager_state_t *DataManager_GetState(void);
 
+/**
+ * @brief Get the number of periodic samples taken since init
+ *
+ * @return Sample sequence number (the history holds the last
+ *         DATA_MANAGER_HISTORY_LEN of them)
+ *
+ * @note Every periodic sample is recorded, including those suppressed
+ *       by DEADBAND reporting
+ */
+uint32_t DataManager_GetHistorySeq(void);
+
+/**
+ * @brief Get a sample from the RAM history
+ *
+ * @param age 0 = newest sample, 1 = the one before, ...
+ * @param sample Pointer to sample to fill
+ *
+ * @return true if the history holds a sample of that age
+ */
+bool DataManager_GetHistory(uint16_t age, data_manager_sample_t *sample);
+
 /**
  * @brief Clear the data_ready flag
  *
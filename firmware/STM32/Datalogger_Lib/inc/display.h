@@ -15,6 +15,17 @@
 #include <stdbool.h>
 #include <time.h>
 
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Display view enumeration
+ */
+typedef enum
+{
+    DISPLAY_VIEW_STATUS = 0, // Time, latest values and system status
+    DISPLAY_VIEW_TREND       // Scrolling temperature/humidity trend
+} display_view_t;
+
 /* PUBLIC API ----------------------------------------------------------------*/
 
 /**
@@ -37,6 +48,22 @@ void display_init(void);
 void display_update(time_t time_unix, float temperature, float humidity,
                     bool mqtt_on, bool periodic_on, int interval);
 
+/**
+ * @brief Select the display view
+ *
+ * @param view DISPLAY_VIEW_STATUS or DISPLAY_VIEW_TREND
+ *
+ * @note The view is redrawn by the next display_update()
+ */
+void display_set_view(display_view_t view);
+
+/**
+ * @brief Get the current display view
+ *
+ * @return Current view
+ */
+display_view_t display_get_view(void);
+
 /**
  * @brief Clear entire display
  */
@@ -0,0 +1,181 @@
+/**
+ * @file fixed_fmt.h
+ *
+ * @brief Fixed Format - Integer/fixed-point text formatting without printf or float printf
+ */
+
+#ifndef FIXED_FMT_H
+#define FIXED_FMT_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+/* Configuration */
+#define FIXED_FMT_MAX_DECIMALS 4 // Largest precision accepted by %.Nf and FixedFmt_Fixed()
+#define FIXED_FMT_BENCHMARK 0    // 1 = add the FMT BENCH command (links newlib snprintf for comparison)
+#define FIXED_FMT_BENCH_RUNS 100 // Records formatted per benchmark pass
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Append cursor over a caller-owned buffer
+ */
+typedef struct
+{
+    char *buf;     // Destination buffer
+    size_t size;   // Buffer size including the terminator
+    size_t len;    // Characters written so far
+    bool overflow; // Set when output was truncated
+} fixed_fmt_t;
+
+/**
+ * @brief Benchmark result (average cycles per formatted record)
+ */
+typedef struct
+{
+    uint32_t snprintf_cycles; // Previous snprintf("%.2f") path
+    uint32_t fixed_cycles;    // FixedFmt append path
+    uint32_t vformat_cycles;  // FixedFmt_Format() with the same format string
+} fixed_fmt_bench_t;
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Start appending into a buffer
+ *
+ * @param f Cursor to initialize
+ * @param buf Destination buffer
+ * @param size Buffer size in bytes (including the terminator)
+ */
+void FixedFmt_Init(fixed_fmt_t *f, char *buf, size_t size);
+
+/**
+ * @brief Append a character
+ *
+ * @param f Cursor
+ * @param c Character
+ */
+void FixedFmt_Char(fixed_fmt_t *f, char c);
+
+/**
+ * @brief Append a string
+ *
+ * @param f Cursor
+ * @param s Null-terminated string (NULL appends nothing)
+ */
+void FixedFmt_Str(fixed_fmt_t *f, const char *s);
+
+/**
+ * @brief Append an unsigned decimal number
+ *
+ * @param f Cursor
+ * @param value Number
+ * @param width Minimum digits, zero padded (0 = no padding)
+ */
+void FixedFmt_U32(fixed_fmt_t *f, uint32_t value, uint8_t width);
+
+/**
+ * @brief Append a signed decimal number
+ *
+ * @param f Cursor
+ * @param value Number
+ */
+void FixedFmt_I32(fixed_fmt_t *f, int32_t value);
+
+/**
+ * @brief Append a fixed-point number
+ *
+ * @param f Cursor
+ * @param value Value scaled by 10^decimals (e.g. centi-degrees for decimals = 2)
+ * @param decimals Digits after the point (0 to FIXED_FMT_MAX_DECIMALS)
+ *
+ * @note FixedFmt_Fixed(f, -5, 2) appends "-0.05".
+ */
+void FixedFmt_Fixed(fixed_fmt_t *f, int32_t value, uint8_t decimals);
+
+/**
+ * @brief Append a float like printf "%.Nf"
+ *
+ * @param f Cursor
+ * @param value Float value
+ * @param decimals Digits after the point (0 to FIXED_FMT_MAX_DECIMALS)
+ *
+ * @note Same digits as FixedFmt_Fixed(f, FixedFmt_FromFloat(value, decimals),
+ *       decimals), but the sign is taken from the float, so negative values
+ *       that round to zero print "-0.00" as printf does. NaN prints 0 and
+ *       values beyond the int32 range saturate (printf: "nan", "inf", digits).
+ */
+void FixedFmt_Float(fixed_fmt_t *f, float value, uint8_t decimals);
+
+/**
+ * @brief Terminate the buffer
+ *
+ * @param f Cursor
+ *
+ * @return Characters written (excluding terminator), or -1 if truncated
+ */
+int FixedFmt_End(fixed_fmt_t *f);
+
+/**
+ * @brief Convert a float to a scaled integer, rounded like printf
+ *
+ * @param value Float value
+ * @param decimals Digits to keep (0 to FIXED_FMT_MAX_DECIMALS)
+ *
+ * @return value * 10^decimals, rounded and saturated to int32
+ *
+ * @note Scales the mantissa by 10^decimals in a 64-bit integer and rounds
+ *       the exact remainder half to even, so the digits match "%.Nf". No
+ *       float arithmetic, division or printf. A negative value that rounds
+ *       to zero returns 0 and loses its sign; use FixedFmt_Float() for text.
+ */
+int32_t FixedFmt_FromFloat(float value, uint8_t decimals);
+
+/**
+ * @brief printf-style formatting without newlib printf
+ *
+ * @param buf Destination buffer
+ * @param size Buffer size in bytes (including the terminator)
+ * @param fmt Format string
+ * @param args Argument list
+ *
+ * @return Characters written (excluding terminator), or -1 if truncated
+ *
+ * @details Supports %d %i %u %o %x %X %p %c %s %f %% with the '-' and '0'
+ *          flags, field width, precision (strings and %f) and the l/h length
+ *          modifiers. %f is converted to fixed point (default precision 6
+ *          is limited to FIXED_FMT_MAX_DECIMALS).
+ */
+int FixedFmt_VFormat(char *buf, size_t size, const char *fmt, va_list args);
+
+/**
+ * @brief printf-style formatting without newlib printf
+ *
+ * @param buf Destination buffer
+ * @param size Buffer size in bytes (including the terminator)
+ * @param fmt Format string
+ * @param ... Arguments
+ *
+ * @return Characters written (excluding terminator), or -1 if truncated
+ */
+int FixedFmt_Format(char *buf, size_t size, const char *fmt, ...);
+
+#if FIXED_FMT_BENCHMARK
+/**
+ * @brief Measure record formatting cost with the DWT cycle counter
+ *
+ * @param result Pointer to structure to fill
+ *
+ * @note Formats the same sensor record FIXED_FMT_BENCH_RUNS times with each
+ *       method. Interrupts stay enabled, so run it on an idle system.
+ */
+void FixedFmt_Benchmark(fixed_fmt_bench_t *result);
+#endif
+
+#endif /* FIXED_FMT_H */
@@ -0,0 +1,212 @@
+/**
+ * @file i2c_bus.h
+ *
+ * @brief I2C Bus - Prioritized transaction queue with interrupt/DMA completion and bus recovery
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stm32f1xx_hal.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+/* Configuration */
+#define I2C_BUS_QUEUE_SIZE 8          // Transactions waiting or in flight
+#define I2C_BUS_MAX_DEVICES 4         // Registered devices (per-device priority and stats)
+#define I2C_BUS_DEFAULT_TIMEOUT_MS 10 // Timeout for transfers to unregistered addresses
+#define I2C_BUS_DMA_MIN_LEN 2         // Shorter transfers use interrupts (F1 DMA needs >= 2 bytes)
+#define I2C_BUS_IRQ_PRIORITY 1        // I2C1 EV/ER and DMA1 channel 6/7, same level as USART1
+
+/* Recovery pins (I2C1 on PB6/PB7) */
+#define I2C_BUS_SCL_PORT GPIOB
+#define I2C_BUS_SCL_PIN GPIO_PIN_6
+#define I2C_BUS_SDA_PORT GPIOB
+#define I2C_BUS_SDA_PIN GPIO_PIN_7
+#define I2C_BUS_RECOVERY_CLOCKS 9  // SCL pulses to release a slave holding SDA
+#define I2C_BUS_RECOVERY_HALF_US 5 // Half SCL period while bit-banging (100 kHz)
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Transaction priority (lower value is served first)
+ */
+typedef enum
+{
+    I2C_BUS_PRIO_HIGH = 0, // Time-critical sampling (SHT3X fetch)
+    I2C_BUS_PRIO_NORMAL,   // Configuration and housekeeping (DS3231)
+    I2C_BUS_PRIO_LOW       // Background work
+} i2c_bus_prio_t;
+
+/**
+ * @brief Transaction type
+ */
+typedef enum
+{
+    I2C_BUS_WRITE = 0, // START, address+W, data, STOP
+    I2C_BUS_READ,      // START, address+R, data, STOP
+    I2C_BUS_MEM_WRITE, // Register/command address followed by data
+    I2C_BUS_MEM_READ   // Register/command address, repeated START, data
+} i2c_bus_op_t;
+
+/**
+ * @brief Completion callback
+ *
+ * @param status HAL_OK, HAL_ERROR (NACK or bus error) or HAL_TIMEOUT
+ * @param ctx User context passed in the transaction
+ *
+ * @note Called from I2CBus_Process() in main loop context, never from an
+ *       interrupt. Must not start a blocking transfer.
+ */
+typedef void (*i2c_bus_done_t)(HAL_StatusTypeDef status, void *ctx);
+
+/**
+ * @brief Transaction descriptor
+ */
+typedef struct
+{
+    uint16_t address;     // Device address (shifted for HAL)
+    i2c_bus_op_t op;      // Transaction type
+    uint16_t mem_addr;    // Register/command address (MEM_* only)
+    uint16_t mem_size;    // I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT (MEM_* only)
+    uint8_t *data;        // Data buffer, must stay valid until completion
+    uint16_t len;         // Data length in bytes
+    i2c_bus_done_t done;  // Completion callback (may be NULL)
+    void *ctx;            // Callback context
+} i2c_bus_xfer_t;
+
+/**
+ * @brief Per-device accounting
+ */
+typedef struct
+{
+    uint16_t address;    // Device address (shifted for HAL)
+    i2c_bus_prio_t prio; // Queue priority
+    uint32_t timeout_ms; // Transfer timeout
+    uint32_t ok;         // Completed transfers
+    uint32_t errors;     // NACK / bus / arbitration errors
+    uint32_t timeouts;   // Transfers aborted after timeout_ms
+    uint32_t max_us;     // Longest submit-to-completion time
+} i2c_bus_device_t;
+
+/**
+ * @brief Bus-wide statistics
+ */
+typedef struct
+{
+    uint32_t queued;     // Transactions waiting or in flight
+    uint32_t rejected;   // Submits refused because the queue was full
+    uint32_t recoveries; // 9-clock bus recoveries performed
+    uint8_t devices;     // Registered devices
+} i2c_bus_stats_t;
+
+/* EXTERNAL VARIABLES --------------------------------------------------------*/
+
+// DMA handles linked to the I2C1 handle (serviced in stm32f1xx_it.c)
+extern DMA_HandleTypeDef hdma_i2c1_tx;
+extern DMA_HandleTypeDef hdma_i2c1_rx;
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize the I2C bus manager
+ *
+ * @details Links DMA1 channel 6 (TX) and channel 7 (RX) to the handle and
+ *          enables the I2C event/error and DMA interrupts. If SDA is held low
+ *          at boot the bus is recovered before returning.
+ *
+ * @param hi2c Pointer to the initialized I2C handle (hi2c1)
+ *
+ * @note Call after MX_I2C1_Init() and before any driver uses the bus.
+ */
+void I2CBus_Init(I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief Register a device with its priority and timeout
+ *
+ * @param address Device address (shifted for HAL)
+ * @param prio Queue priority of its transactions
+ * @param timeout_ms Transfer timeout before the bus is recovered
+ *
+ * @return true if registered (or updated), false if the table is full
+ */
+bool I2CBus_RegisterDevice(uint16_t address, i2c_bus_prio_t prio, uint32_t timeout_ms);
+
+/**
+ * @brief Queue a transaction
+ *
+ * @param xfer Transaction descriptor (copied, the data buffer is not)
+ *
+ * @return true if queued, false if the queue is full or parameters are invalid
+ *
+ * @note Completion is reported through xfer->done from I2CBus_Process().
+ */
+bool I2CBus_Submit(const i2c_bus_xfer_t *xfer);
+
+/**
+ * @brief Run a transaction and wait for it to complete
+ *
+ * @param xfer Transaction descriptor (done/ctx are ignored)
+ *
+ * @return HAL_OK, HAL_ERROR or HAL_TIMEOUT
+ *
+ * @note Blocks for at most the device timeout plus queued higher priority
+ *       work. Used by driver calls that must return a result.
+ */
+HAL_StatusTypeDef I2CBus_Transfer(const i2c_bus_xfer_t *xfer);
+
+/**
+ * @brief Check whether a device acknowledges its address
+ *
+ * @param address Device address (shifted for HAL)
+ * @param trials Number of attempts
+ *
+ * @return true if the device answered, false otherwise
+ *
+ * @note Waits for the queue to drain, then probes in blocking mode.
+ */
+bool I2CBus_IsDeviceReady(uint16_t address, uint32_t trials);
+
+/**
+ * @brief Start queued transactions, check timeouts and report completions
+ *
+ * @note Call from the main loop. Also called internally while waiting in
+ *       I2CBus_Transfer().
+ */
+void I2CBus_Process(void);
+
+/**
+ * @brief Release a hung bus with 9 SCL clocks and a STOP, then re-initialize I2C
+ *
+ * @note Any transaction in flight completes with HAL_TIMEOUT.
+ */
+void I2CBus_Recover(void);
+
+/**
+ * @brief Check if no transaction is waiting or in flight
+ *
+ * @return true if the bus is idle
+ */
+bool I2CBus_IsIdle(void);
+
+/**
+ * @brief Get bus statistics
+ *
+ * @param stats Pointer to structure to fill
+ */
+void I2CBus_GetStats(i2c_bus_stats_t *stats);
+
+/**
+ * @brief Get accounting of a registered device
+ *
+ * @param index Device index (0 to stats.devices - 1)
+ *
+ * @return Pointer to the device entry, NULL if index is out of range
+ */
+const i2c_bus_device_t *I2CBus_GetDevice(uint8_t index);
+
+#endif /* I2C_BUS_H */
@@ -69,6 +69,14 @@ extern SPI_HandleTypeDef ILI9225_SPI_PORT;
 #define ILI9225_HEIGHT ILI9225_LCD_WIDTH
 #endif
 
+// Hardware scroll moves gate lines: screen rows in portrait, columns in landscape
+#define ILI9225_SCROLL_LINES ILI9225_LCD_HEIGHT
+#if ILI9225_ROTATION == 0 || ILI9225_ROTATION == 2
+#define ILI9225_SCROLL_ALONG_X 0 // Scroll axis is Y
+#else
+#define ILI9225_SCROLL_ALONG_X 1 // Scroll axis is X
+#endif
+
 /* COLOR DEFINITIONS (RGB565) ---------------------------------------------- */
 
 #define ILI9225_BLACK 0x0000
@@ -118,6 +126,13 @@ void ILI9225_InvertDisplay(bool invert);
  */
 void ILI9225_DisplayOn(bool on);
 
+/**
+ * @brief Enter or leave standby mode (GRAM is kept)
+ *
+ * @param sleep true to enter standby, false to resume
+ */
+void ILI9225_Sleep(bool sleep);
+
 /**
  * @brief Set display brightness (if supported)
  *
@@ -239,6 +254,31 @@ void ILI9225_FillTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
  */
 void ILI9225_DrawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data);
 
+// Hardware Scrolling
+
+/**
+ * @brief Set the hardware scroll area
+ *
+ * @param first First screen line of the area (X in landscape, Y in portrait)
+ * @param last Last screen line of the area
+ *
+ * @note Resets the scroll offset. Lines outside the area stay fixed.
+ */
+void ILI9225_SetScrollArea(uint16_t first, uint16_t last);
+
+/**
+ * @brief Scroll the area by one line towards its first screen line
+ *
+ * @return Screen line (at the end of the area) that now shows the oldest
+ *         content and must be redrawn
+ */
+uint16_t ILI9225_ScrollLine(void);
+
+/**
+ * @brief Disable scrolling (whole panel, offset 0)
+ */
+void ILI9225_ResetScroll(void);
+
 // Text Functions (if fonts enabled)
 #ifdef ILI9225_USE_FONTS
 
@@ -0,0 +1,118 @@
+/**
+ * @file low_power.h
+ *
+ * @brief Low Power - STOP mode between periodic samples, woken by the DS3231 alarm
+ */
+
+#ifndef LOW_POWER_H
+#define LOW_POWER_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stm32f1xx_hal.h>
+#include "rtc_clock.h"
+
+/* DEFINES -------------------------------------------------------------------*/
+
+/* Wake pins */
+#define LOW_POWER_RTC_INT_PIN RTC_CLOCK_SQW_PIN // DS3231 INT/SQW, configured by RTCClock_Init()
+#define LOW_POWER_UART_RX_PORT GPIOA      // USART1 RX, armed as EXTI only while sleeping
+#define LOW_POWER_UART_RX_PIN GPIO_PIN_10 // EXTI10
+#define LOW_POWER_UART_RX_IRQn EXTI15_10_IRQn
+
+/* Configuration */
+#define LOW_POWER_MIN_SLEEP_S 2        // Do not sleep for less than this
+#define LOW_POWER_UART_QUIET_MS 500    // Stay awake this long after the last UART byte
+#define LOW_POWER_RUN_CURRENT_UA 25000 // MCU + peripherals awake at 64 MHz (for estimate)
+#define LOW_POWER_STOP_CURRENT_UA 150  // Board in STOP, display in standby (for estimate)
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Low power statistics
+ */
+typedef struct
+{
+    uint32_t sleeps;            // Number of STOP entries
+    uint32_t alarm_wakes;       // Wakes by DS3231 alarm
+    uint32_t uart_wakes;        // Wakes by UART activity
+    uint32_t last_latency_us;   // Last wake-to-sample latency
+    uint32_t max_latency_us;    // Worst wake-to-sample latency
+    uint64_t sleep_ms;          // Total time in STOP
+    uint64_t awake_ms;          // Total time awake while enabled
+    uint32_t avg_current_ua;    // Estimated average current
+} low_power_stats_t;
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize low power wake sources
+ *
+ * @details Sets the USART1 RX wake priority and enables the DWT cycle
+ *          counter used for latency measurement.
+ *
+ * @note The DS3231 INT/SQW EXTI is configured by RTCClock_Init(). While
+ *       sleeping it carries the alarm instead of the square wave; call
+ *       RTCClock_Resume() after LowPower_Sleep() returns.
+ */
+void LowPower_Init(void);
+
+/**
+ * @brief Enable or disable low power mode
+ *
+ * @param enable true to sleep between samples, false for normal operation
+ *
+ * @note The display is put in standby while enabled. DS3231 alarm
+ *       interrupts are disabled again when low power mode is turned off.
+ */
+void LowPower_SetEnabled(bool enable);
+
+/**
+ * @brief Check if low power mode is enabled
+ *
+ * @return true if enabled, false otherwise
+ */
+bool LowPower_IsEnabled(void);
+
+/**
+ * @brief Enter STOP mode until the DS3231 alarm or UART activity
+ *
+ * @param sleep_ms Time until the next scheduled sample
+ *
+ * @return Time spent in STOP in ms (0 if not slept)
+ *
+ * @details Programs DS3231 alarm 1 for the last second edge before
+ *          now + sleep_ms, suspends SysTick and enters STOP with the
+ *          low-power regulator. After wake the PLL is restored and the HAL
+ *          tick is advanced by the time slept, measured from the square wave
+ *          edge tracked by rtc_clock, so all HAL_GetTick() schedules stay valid.
+ */
+uint32_t LowPower_Sleep(uint32_t sleep_ms);
+
+/**
+ * @brief Mark that the sample after a wake has been taken
+ *
+ * @details Records the wake-to-sample latency measured with the DWT cycle
+ *          counter. Does nothing if there was no wake since the last call.
+ */
+void LowPower_MarkSample(void);
+
+/**
+ * @brief EXTI handler for wake sources (call from HAL_GPIO_EXTI_Callback)
+ *
+ * @param pin EXTI pin that fired
+ *
+ * @return true if the edge was a wake event (consumed), false otherwise
+ */
+bool LowPower_HandleWake(uint16_t pin);
+
+/**
+ * @brief Get low power statistics
+ *
+ * @param stats Pointer to structure to fill
+ */
+void LowPower_GetStats(low_power_stats_t *stats);
+
+#endif /* LOW_POWER_H */
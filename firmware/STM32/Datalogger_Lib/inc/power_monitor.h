@@ -0,0 +1,58 @@
+/**
+ * @file power_monitor.h
+ *
+ * @brief Power Monitor - PVD brown-out detection and emergency SD flush
+ */
+
+#ifndef POWER_MONITOR_H
+#define POWER_MONITOR_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stm32f1xx_hal.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+/* Configuration */
+#define POWER_MONITOR_PVD_LEVEL PWR_PVDLEVEL_7 // 2.9 V threshold (3.3 V rail, SD needs >= 2.7 V)
+#define POWER_MONITOR_IRQ_PRIORITY 0           // Above USART1 so the flush is never delayed
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize the power monitor
+ *
+ * @details Enables the PVD at POWER_MONITOR_PVD_LEVEL with an interrupt on
+ *          both edges. When VDD falls below the threshold the buffer and
+ *          archive metadata are written to the SD card from the interrupt.
+ *
+ * @note Call after SDCardManager_Init() and SDArchive_Init().
+ */
+void PowerMonitor_Init(void);
+
+/**
+ * @brief Finish a deferred emergency flush (call from the main loop)
+ *
+ * @details If the PVD fired while an SD transaction was in progress the
+ *          flush is completed here. The FAT32 log is also synced here, never
+ *          from the interrupt, because its state is not interrupt-safe.
+ */
+void PowerMonitor_Process(void);
+
+/**
+ * @brief Check if VDD is currently below the PVD threshold
+ *
+ * @return true if supply is low, false otherwise
+ */
+bool PowerMonitor_IsLow(void);
+
+/**
+ * @brief Get number of emergency flushes since boot
+ *
+ * @return Flush count
+ */
+uint32_t PowerMonitor_GetFlushCount(void);
+
+#endif /* POWER_MONITOR_H */
@@ -28,7 +28,9 @@ extern UART_HandleTypeDef huart1;
  * @param fmt Format string (like printf)
  * @param ... Variable arguments
  * 
- * @note Uses HAL_UART_Transmit to send data over UART
+ * @note Uses HAL_UART_Transmit to send data over UART. Formatting is done by
+ *       FixedFmt_VFormat() (no newlib printf); output longer than
+ *       BUFFER_PRINT - 1 characters is truncated.
  */
 void PRINT_CLI(char *fmt, ...);
 
@@ -0,0 +1,162 @@
+/**
+ * @file profiler.h
+ *
+ * @brief Profiler - DWT cycle counter timing of the main loop stages
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stm32f1xx_hal.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+/* Configuration */
+#define PROFILER_ENABLE 1       // 0 = PROFILER_START/STOP compile to nothing
+#define PROFILER_HIST_BUCKETS 8 // Histogram buckets, x4 per bucket starting at 16 us
+
+/**
+ * @brief Stage timing macros
+ *
+ * @code
+ * uint32_t t0 = PROFILER_START();
+ * UART_Handle();
+ * PROFILER_STOP(PROFILER_STAGE_UART, t0);
+ * @endcode
+ */
+#if PROFILER_ENABLE
+#define PROFILER_START() (DWT->CYCCNT)
+#define PROFILER_STOP(stage, start) Profiler_Record((stage), DWT->CYCCNT - (start))
+#else
+#define PROFILER_START() (0U)
+#define PROFILER_STOP(stage, start) ((void)(start))
+#endif
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Profiled main loop stages
+ */
+typedef enum
+{
+    PROFILER_STAGE_UART = 0,  // UART_Handle() (command parsing and execution)
+    PROFILER_STAGE_I2C,       // I2CBus_Process()
+    PROFILER_STAGE_FETCH,     // SHT3X fetch start/poll and DataManager update
+    PROFILER_STAGE_ARCHIVE,   // SDArchive_Append() and SDFat32_LogRecord()
+    PROFILER_STAGE_SD_WRITE,  // SDCardManager_WriteData() while offline
+    PROFILER_STAGE_SD_REPLAY, // Buffered record read, JSON and UART send
+    PROFILER_STAGE_QUERY,     // SD QUERY result streaming
+    PROFILER_STAGE_DISPLAY,   // display_update()
+    PROFILER_STAGE_COUNT
+} profiler_stage_t;
+
+/**
+ * @brief Timing statistics (microseconds unless noted)
+ */
+typedef struct
+{
+    uint32_t count;                       // Samples recorded
+    uint32_t min_us;                      // Shortest
+    uint32_t max_us;                      // Longest
+    uint32_t avg_us;                      // Mean
+    uint32_t hist[PROFILER_HIST_BUCKETS]; // <16, <64, <256 us, <1, <4, <16, <64 ms, >=64 ms
+} profiler_timing_t;
+
+/**
+ * @brief Sampling period error (actual - configured interval, milliseconds)
+ */
+typedef struct
+{
+    uint32_t count;  // Periods measured
+    int32_t min_ms;  // Earliest sample relative to schedule
+    int32_t max_ms;  // Latest sample relative to schedule
+    int32_t avg_ms;  // Mean error
+} profiler_period_t;
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize the profiler
+ *
+ * @details Enables the DWT cycle counter and clears all statistics.
+ */
+void Profiler_Init(void);
+
+/**
+ * @brief Record a stage duration
+ *
+ * @param stage Stage
+ * @param cycles Duration in CPU cycles
+ *
+ * @note Normally called through PROFILER_STOP(). Constant time: one
+ *       division and a count-leading-zeros for the histogram bucket.
+ */
+void Profiler_Record(profiler_stage_t stage, uint32_t cycles);
+
+/**
+ * @brief Mark the top of the main loop
+ *
+ * @details Records the loop period (time since the previous call). A period
+ *          that includes STOP mode is discarded, as the cycle counter does
+ *          not run while stopped.
+ *
+ * @param slept true if the previous iteration entered STOP mode
+ */
+void Profiler_LoopMark(bool slept);
+
+/**
+ * @brief Record a periodic sample start for sampling period error
+ *
+ * @param now_ms HAL_GetTick() at the fetch
+ * @param interval_ms Configured periodic interval
+ *
+ * @note The first sample after periodic mode starts only sets the reference.
+ */
+void Profiler_SampleMark(uint32_t now_ms, uint32_t interval_ms);
+
+/**
+ * @brief Forget the sampling period reference (periodic mode stopped)
+ */
+void Profiler_SampleReset(void);
+
+/**
+ * @brief Get stage timing
+ *
+ * @param stage Stage
+ * @param timing Pointer to structure to fill
+ */
+void Profiler_GetStage(profiler_stage_t stage, profiler_timing_t *timing);
+
+/**
+ * @brief Get loop period timing
+ *
+ * @param timing Pointer to structure to fill
+ */
+void Profiler_GetLoop(profiler_timing_t *timing);
+
+/**
+ * @brief Get sampling period error
+ *
+ * @param period Pointer to structure to fill
+ */
+void Profiler_GetPeriod(profiler_period_t *period);
+
+/**
+ * @brief Get stage name
+ *
+ * @param stage Stage
+ *
+ * @return Short upper case name (e.g. "UART")
+ */
+const char *Profiler_StageName(profiler_stage_t stage);
+
+/**
+ * @brief Clear all statistics
+ */
+void Profiler_Reset(void);
+
+#endif /* PROFILER_H */
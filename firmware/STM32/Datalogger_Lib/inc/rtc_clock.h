@@ -0,0 +1,101 @@
+/**
+ * @file rtc_clock.h
+ *
+ * @brief RTC Clock - Unix time disciplined by the DS3231 1 Hz square wave
+ */
+
+#ifndef RTC_CLOCK_H
+#define RTC_CLOCK_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stm32f1xx_hal.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+/* DS3231 INT/SQW pin (open-drain, shared with the low power alarm wake) */
+#define RTC_CLOCK_SQW_PORT GPIOB
+#define RTC_CLOCK_SQW_PIN GPIO_PIN_0 // EXTI0
+#define RTC_CLOCK_SQW_IRQn EXTI0_IRQn
+
+/* Configuration */
+#define RTC_CLOCK_RESYNC_INTERVAL_S 600 // Seconds between RTC reads
+#define RTC_CLOCK_RESYNC_WINDOW_MS 500  // Only read the RTC this soon after an edge
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize the clock
+ *
+ * @details Reads the DS3231 once, enables its 1 Hz square wave and the
+ *          falling-edge EXTI on RTC_CLOCK_SQW_PIN. Each edge advances the
+ *          second counter; milliseconds are interpolated from SysTick.
+ *
+ * @note DS3231_Init() must have been called before.
+ */
+void RTCClock_Init(void);
+
+/**
+ * @brief Get current Unix time
+ *
+ * @return Unix timestamp in seconds
+ *
+ * @note O(1), no I2C. If the square wave stops, the clock free-runs on
+ *       SysTick from the last edge until the next resync.
+ */
+uint32_t RTCClock_Now(void);
+
+/**
+ * @brief Get current Unix time with milliseconds
+ *
+ * @param ms Pointer to store milliseconds (0-999), may be NULL
+ *
+ * @return Unix timestamp in seconds
+ */
+uint32_t RTCClock_NowMs(uint16_t *ms);
+
+/**
+ * @brief Set the clock after the RTC was written (SET TIME)
+ *
+ * @param timestamp Unix timestamp just written to the DS3231
+ */
+void RTCClock_Set(uint32_t timestamp);
+
+/**
+ * @brief Re-enable the square wave and resync after low power sleep
+ *
+ * @note Alarm interrupts (INTCN = 1) stop the square wave while sleeping.
+ */
+void RTCClock_Resume(void);
+
+/**
+ * @brief Periodic resync with the DS3231 (call from the main loop)
+ *
+ * @details Reads the RTC every RTC_CLOCK_RESYNC_INTERVAL_S, right after an
+ *          edge so no edge can fall inside the I2C read, and corrects the
+ *          second counter if it drifted.
+ */
+void RTCClock_Process(void);
+
+/**
+ * @brief Square wave edge handler (call from HAL_GPIO_EXTI_Callback)
+ */
+void RTCClock_HandleEdge(void);
+
+/**
+ * @brief Check if square wave edges are arriving
+ *
+ * @return true if an edge was seen within the last 1.5 s
+ */
+bool RTCClock_IsDisciplined(void);
+
+/**
+ * @brief Get number of corrections applied by resync
+ *
+ * @return Correction count since boot
+ */
+uint32_t RTCClock_GetCorrections(void);
+
+#endif /* RTC_CLOCK_H */
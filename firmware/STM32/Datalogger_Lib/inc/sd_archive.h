@@ -0,0 +1,143 @@
+/**
+ * @file sd_archive.h
+ *
+ * @brief SD Archive - Append-only, time-indexed sensor data history on SD card
+ */
+
+#ifndef SD_ARCHIVE_H
+#define SD_ARCHIVE_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sd_card_manager.h"
+
+/* DEFINES -------------------------------------------------------------------*/
+
+/* Configuration */
+#define SD_ARCHIVE_INDEX_STRIDE 1024 // Records covered by one index entry
+#define SD_ARCHIVE_INDEX_ENTRIES 256 // Index entries kept in RAM (1 KB)
+#define SD_ARCHIVE_SIZE (SD_ARCHIVE_INDEX_STRIDE * SD_ARCHIVE_INDEX_ENTRIES) // Max records (128 MB)
+#define SD_ARCHIVE_META_INTERVAL 16  // Appends between metadata saves
+#define SD_ARCHIVE_QUERY_SCAN_MAX 16 // Max blocks read per SDArchive_QueryNext() call
+
+/* Layout (placed right after the FIFO buffer region, relative to the raw region base) */
+#define SD_ARCHIVE_META_BLOCK (SD_DATA_START_BLOCK + SD_BUFFER_SIZE)
+#define SD_ARCHIVE_INDEX_START_BLOCK (SD_ARCHIVE_META_BLOCK + 1)
+#define SD_ARCHIVE_INDEX_BLOCKS ((SD_ARCHIVE_INDEX_ENTRIES * sizeof(uint32_t) + 511) / 512)
+#define SD_ARCHIVE_DATA_START_BLOCK (SD_ARCHIVE_INDEX_START_BLOCK + SD_ARCHIVE_INDEX_BLOCKS)
+
+/* Raw region = FIFO buffer + archive, relative to SDCardManager_GetBaseBlock() */
+#define SD_RAW_REGION_BLOCKS (SD_ARCHIVE_DATA_START_BLOCK + SD_ARCHIVE_SIZE)
+
+#define SD_ARCHIVE_MAGIC 0x48435241 // "ARCH"
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Archive metadata structure
+ */
+typedef struct
+{
+    uint32_t magic;          // SD_ARCHIVE_MAGIC when the region is formatted
+    uint32_t total;          // Records ever appended (logical write position)
+    uint32_t last_timestamp; // Timestamp of the newest record
+    uint32_t unordered;      // Last logical record older than its predecessor (0 if none)
+} sd_archive_metadata_t;
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize SD Archive
+ *
+ * @details Loads metadata and the sparse timestamp index into RAM, then
+ *          recovers records appended after the last metadata save.
+ *
+ * @note SDCardManager_Init() must have succeeded before calling this.
+ *
+ * @return true if archive is ready, false otherwise
+ */
+bool SDArchive_Init(void);
+
+/**
+ * @brief Append a sensor record to the archive
+ *
+ * @param timestamp Unix timestamp
+ * @param temperature Temperature value
+ * @param humidity Humidity value
+ * @param mode_str "SINGLE" or "PERIODIC"
+ * @param suppressed Samples suppressed before this one (0 if none)
+ *
+ * @return true if the record was written, false on SD error
+ *
+ * @note When full, the oldest index chunk is overwritten. A timestamp older
+ *       than the previous record (RTC set back or not running) is still
+ *       written, but queries fall back to a full scan until it is overwritten.
+ */
+bool SDArchive_Append(uint32_t timestamp, float temperature, float humidity, const char *mode_str,
+                      uint32_t suppressed);
+
+/**
+ * @brief Save archive metadata if it has unsaved appends
+ *
+ * @return true if metadata is up to date on the card, false on SD error
+ *
+ * @note Safe to call from the PVD interrupt while SD_IsBusy() is 0.
+ */
+bool SDArchive_Flush(void);
+
+/**
+ * @brief Start a time range query
+ *
+ * @param from First Unix timestamp to include
+ * @param to Last Unix timestamp to include
+ *
+ * @return true if the query was started, false if archive not ready or range invalid
+ *
+ * @note Uses the sparse index to seek, then results are pulled with
+ *       SDArchive_QueryNext(). The live FIFO buffer is not touched. If the
+ *       readable history is not in time order, every record is scanned.
+ */
+bool SDArchive_StartQuery(uint32_t from, uint32_t to);
+
+/**
+ * @brief Fetch next record of the active query
+ *
+ * @param record Pointer to buffer where data will be read into
+ *
+ * @return true if a matching record was read, false otherwise
+ *
+ * @note Reads at most SD_ARCHIVE_QUERY_SCAN_MAX blocks per call so the main
+ *       loop is never blocked. A false return does not mean the query ended;
+ *       check SDArchive_IsQueryActive().
+ */
+bool SDArchive_QueryNext(sd_data_record_t *record);
+
+/**
+ * @brief Abort the active query
+ */
+void SDArchive_StopQuery(void);
+
+/**
+ * @brief Check if a query is in progress
+ *
+ * @return true if a query is in progress
+ */
+bool SDArchive_IsQueryActive(void);
+
+/**
+ * @brief Get number of records currently held in the archive
+ *
+ * @return Number of readable records (0 to SD_ARCHIVE_SIZE)
+ */
+uint32_t SDArchive_GetCount(void);
+
+/**
+ * @brief Check if SD Archive is initialized and ready
+ *
+ * @return true if archive is ready, false otherwise
+ */
+bool SDArchive_IsReady(void);
+
+#endif /* SD_ARCHIVE_H */
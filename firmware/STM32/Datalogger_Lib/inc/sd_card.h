@@ -126,6 +126,28 @@ uint8_t SD_ReadBlock(uint32_t block_addr, uint8_t *buffer);
  */
 uint8_t SD_WriteBlock(uint32_t block_addr, uint8_t *buffer);
 
+/**
+ * @brief Write consecutive blocks to SD card (CMD25)
+ *
+ * @param block_addr First block address to write
+ * @param *buffer Pointer to data (must be at least count * 512 bytes)
+ * @param count Number of blocks to write
+ *
+ * @return uint8_t 0 = success, non-zero = error code
+ *
+ * @note One command and one busy phase per transfer instead of per block.
+ */
+uint8_t SD_WriteMultiBlock(uint32_t block_addr, uint8_t *buffer, uint32_t count);
+
+/**
+ * @brief Check if an SD transaction is in progress
+ *
+ * @return uint8_t 1 while CS is asserted, 0 when the bus is idle
+ *
+ * @note Used by interrupt handlers that must not break into a transaction.
+ */
+uint8_t SD_IsBusy(void);
+
 /**
  * @brief Get SD card type
  *
@@ -19,6 +19,11 @@
 #define SD_BUFFER_SIZE 204800 // Max number of records to buffer
 #define SD_DATA_BLOCK 1       // SD block address to store buffer metadata
 #define SD_DATA_START_BLOCK 2 // Starting block for actual data
+#define SD_META_SAVE_INTERVAL 16 // Buffer operations between metadata saves
+
+/* Record check word: tells a record written by this firmware from stale or blank blocks */
+#define SD_RECORD_MAGIC 0x44524345 // "ECRD"
+#define SD_RECORD_CHECK(seq, ts) ((uint32_t)(seq) ^ (uint32_t)(ts) ^ SD_RECORD_MAGIC)
 
 /* TYPEDEFS ------------------------------------------------------------------*/
 
@@ -32,7 +37,9 @@ typedef struct
     float humidity;        // Humidity in percentage (4 bytes)
     char mode[16];         // "SINGLE" or "PERIODIC" (16 bytes)
     uint32_t sequence_num; // Sequence number (4 bytes)
-    uint8_t padding[480];  // Padding to 512 bytes (512 - 32 = 480)
+    uint32_t suppressed;   // Samples suppressed by deadband reporting (4 bytes)
+    uint32_t check;        // SD_RECORD_CHECK(sequence_num, timestamp) (4 bytes)
+    uint8_t padding[472];  // Padding to 512 bytes (512 - 40 = 472)
 } sd_data_record_t;
 
 /**
@@ -51,6 +58,9 @@ typedef struct
 /**
  * @brief Initialize SD Card Manager
  *
+ * @details Loads buffer metadata, then recovers records written after the
+ *          last metadata save (e.g. after a power loss).
+ *
  * @return true if SD card initialized successfully, false otherwise
  */
 bool SDCardManager_Init(void);
@@ -62,10 +72,12 @@ bool SDCardManager_Init(void);
  * @param temperature Temperature value
  * @param humidity Humidity value
  * @param mode_str "SINGLE" or "PERIODIC"
+ * @param suppressed Samples suppressed before this one (0 if none)
  *
  * @return true if data was buffered, false if buffer is full or SD error
  */
-bool SDCardManager_WriteData(uint32_t timestamp, float temperature, float humidity, const char *mode_str);
+bool SDCardManager_WriteData(uint32_t timestamp, float temperature, float humidity, const char *mode_str,
+                             uint32_t suppressed);
 
 /**
  * @brief Read next buffered data record from SD card
@@ -87,6 +99,10 @@ uint32_t SDCardManager_GetBufferedCount(void);
  * @brief Remove (mark as sent) the last read record
  *
  * @return true if record was removed, false if no records to remove
+ *
+ * @note Metadata is saved every SD_META_SAVE_INTERVAL operations or when the
+ *       buffer becomes empty. Removals lost on power failure without a flush
+ *       are sent again after reboot.
  */
 bool SDCardManager_RemoveRecord(void);
 
@@ -97,6 +113,15 @@ bool SDCardManager_RemoveRecord(void);
  */
 bool SDCardManager_ClearBuffer(void);
 
+/**
+ * @brief Save buffer metadata if it has unsaved changes
+ *
+ * @return true if metadata is up to date on the card, false on SD error
+ *
+ * @note Safe to call from the PVD interrupt while SD_IsBusy() is 0.
+ */
+bool SDCardManager_Flush(void);
+
 /**
  * @brief Check if SD card is initialized and ready
  *
@@ -104,6 +129,14 @@ bool SDCardManager_ClearBuffer(void);
  */
 bool SDCardManager_IsReady(void);
 
+/**
+ * @brief Get first block of the raw region
+ *
+ * @return 0 when raw blocks use the whole card, otherwise the first block of
+ *         the contiguous FAT32 region file (SD_FAT32_ENABLE)
+ */
+uint32_t SDCardManager_GetBaseBlock(void);
+
 /**
  * @brief Get last error code
  *
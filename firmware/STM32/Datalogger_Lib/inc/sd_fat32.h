@@ -0,0 +1,83 @@
+/**
+ * @file sd_fat32.h
+ *
+ * @brief SD FAT32 - Minimal FAT32 writer for per-day CSV logs and raw regions
+ */
+
+#ifndef SD_FAT32_H
+#define SD_FAT32_H
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* DEFINES -------------------------------------------------------------------*/
+
+/* Configuration */
+#define SD_FAT32_ENABLE 0                // 1 = keep a FAT32 filesystem on the card
+#define SD_FAT32_PREALLOC_CLUSTERS 64    // Clusters reserved per allocation run
+#define SD_FAT32_LOG_BUFFER_BLOCKS 2     // Log blocks staged in RAM (multi-block write)
+#define SD_FAT32_SYNC_INTERVAL 32        // Records between directory/FAT/FSInfo updates
+#define SD_FAT32_REGION_NAME "RAWBUF  BIN" // 8.3 name of the raw buffer region file
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Mount the FAT32 volume on the SD card
+ *
+ * @details Accepts an MBR with a FAT32 partition (type 0x0B/0x0C) or a
+ *          partitionless volume. Only 512-byte sectors are supported.
+ *
+ * @note SD_Init() must have succeeded before calling this.
+ *
+ * @return true if a FAT32 volume was found, false otherwise
+ */
+bool SDFat32_Mount(void);
+
+/**
+ * @brief Open or create a contiguous file used as a raw block region
+ *
+ * @param name83 11-character 8.3 name without dot (e.g. "RAWBUF  BIN")
+ * @param blocks Required size in 512-byte blocks
+ * @param first_block Pointer to store the first absolute block of the file
+ *
+ * @return true if the region is available, false otherwise
+ *
+ * @note The file is preallocated as ONE contiguous cluster run, so raw
+ *       block I/O inside it never breaks the filesystem.
+ */
+bool SDFat32_OpenRegion(const char *name83, uint32_t blocks, uint32_t *first_block);
+
+/**
+ * @brief Append a sensor record to the per-day CSV file
+ *
+ * @param timestamp Unix timestamp (selects the YYYYMMDD.CSV file)
+ * @param temperature Temperature value
+ * @param humidity Humidity value
+ * @param mode_str "SINGLE" or "PERIODIC"
+ * @param suppressed Samples suppressed before this one (0 if none)
+ *
+ * @return true if the record was staged, false if not mounted or SD error
+ *
+ * @note Data is written when the staging buffer is full; directory size,
+ *       FAT and FSInfo are updated every SD_FAT32_SYNC_INTERVAL records.
+ */
+bool SDFat32_LogRecord(uint32_t timestamp, float temperature, float humidity, const char *mode_str,
+                       uint32_t suppressed);
+
+/**
+ * @brief Write staged data, directory entry, FAT and FSInfo to the card
+ *
+ * @return true if successful, false otherwise
+ */
+bool SDFat32_Sync(void);
+
+/**
+ * @brief Check if the FAT32 volume is mounted
+ *
+ * @return true if mounted, false otherwise
+ */
+bool SDFat32_IsMounted(void);
+
+#endif /* SD_FAT32_H */
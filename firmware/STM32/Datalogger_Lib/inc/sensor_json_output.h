@@ -9,8 +9,13 @@
 
 /* INCLUDES ------------------------------------------------------------------*/
 
+#include <stddef.h>
 #include <stdint.h>
 
+/* DEFINES -------------------------------------------------------------------*/
+
+#define SENSOR_JSON_BACKLOG_MAX 160 // Longest backlog line, every field at its widest
+
 /* PUBLIC API ----------------------------------------------------------------*/
 
 /**
@@ -22,6 +27,7 @@
  * @param temperature The temperature value in Celsius
  * @param humidity The humidity value in percentage
  * @param timestamp Unix timestamp (if 0, will read from RTC)
+ * @param suppressed Samples suppressed before this one (field omitted if 0)
  *
  * @return int Number of characters written (excluding null terminator), or -1 on error
  *
@@ -30,7 +36,32 @@
  */
 int sensor_json_format(char *buffer, size_t buffer_size,
                        const char *mode, float temperature, float humidity,
-                       uint32_t timestamp);
+                       uint32_t timestamp, uint32_t suppressed);
+
+/**
+ * @brief Formats a record replayed from the SD buffer into a JSON string.
+ *
+ * @param buffer Pointer to destination buffer (SENSOR_JSON_BACKLOG_MAX bytes is always enough)
+ * @param buffer_size Size of the destination buffer
+ * @param mode Mode the record was taken in ("SINGLE" or "PERIODIC")
+ * @param temperature The temperature value in Celsius
+ * @param humidity The humidity value in percentage
+ * @param timestamp Unix timestamp taken when the record was buffered
+ * @param suppressed Samples suppressed before this one (field omitted if 0)
+ * @param sequence_num SD buffer sequence number of the record
+ *
+ * @return int Number of characters written (excluding null terminator), or -1 on error
+ *
+ * @details Same line as sensor_json_format() with a trailing "seq" field.
+ *          The gateway publishes lines carrying "seq" on the backlog topic
+ *          instead of the live one, and the ingest side uses the number as
+ *          an idempotent record key, so a record replayed twice (reset
+ *          before SDCardManager_RemoveRecord()) is stored once.
+ */
+int sensor_json_format_backlog(char *buffer, size_t buffer_size,
+                               const char *mode, float temperature, float humidity,
+                               uint32_t timestamp, uint32_t suppressed,
+                               uint32_t sequence_num);
 
 /**
  * @brief Formats sensor data into a JSON string and prints it via UART.
@@ -38,11 +69,13 @@ int sensor_json_format(char *buffer, size_t buffer_size,
  * @param mode A string literal, must be "SINGLE" or "PERIODIC".
  * @param temperature The temperature value in Celsius.
  * @param humidity The humidity value in percentage.
+ * @param suppressed Samples suppressed before this one (field omitted if 0).
  *
  * @details This function is thread-safe as it uses a static buffer internally.
  *          It handles potential buffer overflows.
  *          The output strictly follows the JSON format specification.
  */
-void sensor_json_output_send(const char *mode, float temperature, float humidity);
+void sensor_json_output_send(const char *mode, float temperature, float humidity,
+                             uint32_t suppressed);
 
 #endif /* SENSOR_JSON_OUTPUT_H */
\ No newline at end of file
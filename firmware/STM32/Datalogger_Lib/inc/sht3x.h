@@ -9,13 +9,14 @@
 
 /* INCLUDES ------------------------------------------------------------------*/
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stm32f1xx_hal.h>
 
 /* DEFINES -------------------------------------------------------------------*/
 
-// Define I2C timeout in ms
-#define SHT3X_I2C_TIMEOUT 100
+// Define I2C timeout in ms (6-byte read takes ~0.2 ms at 400 kHz)
+#define SHT3X_I2C_TIMEOUT 10
 
 // Define address of the SHT3x sensor (7-bit)
 #define SHT3X_I2C_ADDR_GND 0x44 << 1
@@ -85,6 +86,18 @@ typedef enum
 	SHT3X_PERIODIC_10MPS  /*!< periodic with  10 measurements per second (mps) */
 } sht3x_mode_t;
 
+/**
+ * @typedef enum sht3x_fetch_t
+ *
+ * @brief Progress of an asynchronous periodic fetch
+ */
+typedef enum
+{
+	SHT3X_FETCH_IDLE = 0, /*!< no fetch started */
+	SHT3X_FETCH_BUSY,	  /*!< read queued on the I2C bus */
+	SHT3X_FETCH_DONE	  /*!< frame received (or failed), waiting for SHT3X_FetchPoll() */
+} sht3x_fetch_t;
+
 /**
  * @typedef struct sht3x_t
  *
@@ -97,6 +110,9 @@ typedef struct
 	float temperature, humidity; /*!< last measured values */
 	sht3x_mode_t currentState;	 /*!< current mode (idle, single shot, periodic) */
 	sht3x_repeat_t modeRepeat;	 /*!< current repeatability (high, medium, low) */
+	uint8_t rxFrame[SHT3X_RAW_DATA_SIZE]; /*!< async fetch buffer (filled by the I2C bus) */
+	sht3x_fetch_t fetchState;			  /*!< async fetch progress */
+	HAL_StatusTypeDef fetchResult;		  /*!< async fetch bus result */
 } sht3x_t;
 
 /* EXTERNAL VARIABLES --------------------------------------------------------*/
@@ -180,4 +196,27 @@ SHT3X_StatusTypeDef SHT3X_Stop_Periodic(sht3x_t *dev);
  */
 void SHT3X_FetchData(sht3x_t *dev, float *outT, float *outRH);
 
+/** @brief Queues a periodic fetch on the I2C bus without waiting for it
+ *
+ * @param dev Pointer to the SHT3x device structure
+ *
+ * @return SHT3X_StatusTypeDef SHT3X_OK if queued, SHT3X_ERROR if not periodic or queue full
+ *
+ * @note The result is collected with SHT3X_FetchPoll(). A failed start is also
+ *       reported there, so the caller always gets one result per start.
+ */
+SHT3X_StatusTypeDef SHT3X_FetchStart(sht3x_t *dev);
+
+/** @brief Collects the result of SHT3X_FetchStart()
+ *
+ * @param dev Pointer to the SHT3x device structure
+ * @param outT Pointer to store the fetched temperature value (0.0 on failure)
+ * @param outRH Pointer to store the fetched relative humidity value (0.0 on failure)
+ *
+ * @return true once per started fetch when it has finished, false otherwise
+ *
+ * @note Results arriving after periodic mode was stopped are discarded.
+ */
+bool SHT3X_FetchPoll(sht3x_t *dev, float *outT, float *outRH);
+
 #endif /* SHT3X_H */
@@ -9,6 +9,7 @@
 
 /* INCLUDES ------------------------------------------------------------------*/
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stm32f1xx_hal.h>
 
@@ -17,6 +18,27 @@
 // Define buffer size for UART
 #define BUFFER_UART 128
 
+// Baud rate negotiation with the ESP32 (see README_UART.md)
+#define UART_BAUD_DEFAULT 115200        // Boot rate, must match MX_USART1_UART_Init() and the ESP32
+#define UART_BAUD_TRIAL_TIMEOUT_MS 1000 // A trial rate not confirmed in time is reverted
+#define UART_TEST_PATTERN_MAX 64        // Longest "UART TEST" pattern
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Link error counters (cumulative since boot)
+ */
+typedef struct
+{
+	uint32_t baud;          // Current baud rate
+	uint32_t overruns;      // Bytes lost because the previous one was not read in time
+	uint32_t frame_errors;  // Missing stop bit (usually a baud rate mismatch)
+	uint32_t noise_errors;  // Noise detected while sampling a bit
+	uint32_t parity_errors; // Parity mismatch (parity is disabled, should stay 0)
+	uint32_t test_failures; // "UART TEST" patterns with a bad CRC
+	uint32_t trial_reverts; // Trial rates reverted on timeout
+} uart_link_stats_t;
+
 /* EXTERNAL VARIABLES --------------------------------------------------------*/
 
 // Global UART handle (to be defined in main.c)
@@ -64,4 +86,99 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
  */
 void UART_Handle(void);
 
+/**
+ * @brief Check if UART has been quiet for a given time
+ *
+ * @param quiet_ms Minimum time since the last received byte
+ *
+ * @return true if no data is pending and nothing was received for quiet_ms
+ *
+ * @details Used by low power mode to avoid sleeping in the middle of a
+ *          command from the ESP32.
+ */
+bool UART_IsIdle(uint32_t quiet_ms);
+
+/**
+ * @brief Check if a baud rate can be negotiated
+ *
+ * @param baud Baud rate
+ *
+ * @return true for 115200, 230400, 460800, 921600 and 2000000
+ */
+bool UART_IsSupportedBaud(uint32_t baud);
+
+/**
+ * @brief Switch to a baud rate immediately and keep it
+ *
+ * @param baud Supported baud rate
+ *
+ * @details Waits for the last transmitted byte, then reprograms USART1 and
+ *          restarts reception. Cancels a pending trial.
+ */
+void UART_SetBaudRate(uint32_t baud);
+
+/**
+ * @brief Switch to a baud rate on trial
+ *
+ * @param baud Supported baud rate
+ *
+ * @return true if switched
+ *
+ * @details UART_Handle() reverts to the last committed rate if no valid
+ *          test pattern or commit arrives for UART_BAUD_TRIAL_TIMEOUT_MS,
+ *          so a rate the link cannot carry never locks the ESP32 out.
+ */
+bool UART_TryBaudRate(uint32_t baud);
+
+/**
+ * @brief Keep the trial baud rate
+ *
+ * @return true if a trial was pending
+ */
+bool UART_CommitBaudRate(void);
+
+/**
+ * @brief Get the current baud rate
+ *
+ * @return Baud rate
+ */
+uint32_t UART_GetBaudRate(void);
+
+/**
+ * @brief Verify a test pattern received from the ESP32
+ *
+ * @param pattern Received pattern
+ * @param crc CRC-16/CCITT received with it
+ *
+ * @return true if the CRC matches (also restarts the trial timeout)
+ */
+bool UART_CheckTestPattern(const char *pattern, uint16_t crc);
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ *
+ * @param data Data
+ * @param len Length in bytes
+ *
+ * @return CRC
+ */
+uint16_t UART_Crc16(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Get link error counters
+ *
+ * @param stats Pointer to structure to fill
+ */
+void UART_GetLinkStats(uart_link_stats_t *stats);
+
+/**
+ * @brief UART error callback (called from HAL)
+ *
+ * @param huart Pointer to UART handle
+ *
+ * @details Counts overrun, framing, noise and parity errors and restarts
+ *          reception, which the HAL stops after an overrun.
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
 #endif /* UART_H */
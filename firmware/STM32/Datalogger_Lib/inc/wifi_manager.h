@@ -22,7 +22,8 @@
 typedef enum
 {
     MQTT_STATE_DISCONNECTED,
-    MQTT_STATE_CONNECTED
+    MQTT_STATE_CONNECTED,
+    MQTT_STATE_BUSY // Connected, but the ESP32 publish queue is congested
 } mqtt_state_t;
 
 /* PUBLIC API ----------------------------------------------------------------*/
@@ -9,6 +9,7 @@
 #include <stddef.h>
 #include "cmd_func.h"
 #include "cmd_parser.h"
+#include "fixed_fmt.h"
 
 /* VARIABLES -----------------------------------------------------------------*/
 
@@ -56,9 +57,59 @@ command_function_t cmdTable[] = {
 	{.cmdString = "MQTT DISCONNECTED", // MQTT Disconnected Notification
 	 .func = MQTT_DISCONNECTED_PARSER},
 
+	{.cmdString = "MQTT BUSY", // MQTT Publish Queue Congested Notification
+	 .func = MQTT_BUSY_PARSER},
+
 	{.cmdString = "SD CLEAR", // Clear SD card buffer
 	 .func = SD_CLEAR_PARSER},
 
+	{.cmdString = "SD QUERY", // Stream archived records in a time range
+	 .func = SD_QUERY_PARSER},
+
+	{.cmdString = "SET REPORT DEADBAND", // Report periodic data only on change or heartbeat
+	 .func = SET_REPORT_DEADBAND_PARSER},
+
+	{.cmdString = "SET REPORT ALL", // Report every periodic sample (default)
+	 .func = SET_REPORT_ALL_PARSER},
+
+	{.cmdString = "SET POWER", // Sleep in STOP mode between periodic samples
+	 .func = SET_POWER_PARSER},
+
+	{.cmdString = "POWER STATUS", // Print low power statistics
+	 .func = POWER_STATUS_PARSER},
+
+	{.cmdString = "I2C STATUS", // Print I2C bus transfer and recovery counters
+	 .func = I2C_STATUS_PARSER},
+
+	{.cmdString = "STATS RESET", // Clear main loop timing statistics (before "STATS")
+	 .func = STATS_RESET_PARSER},
+
+	{.cmdString = "STATS", // Print main loop stage timing, jitter and sampling period error
+	 .func = STATS_PARSER},
+
+	{.cmdString = "UART BAUD", // Switch to a new baud rate on trial (negotiation)
+	 .func = UART_BAUD_PARSER},
+
+	{.cmdString = "UART TEST", // Check a test pattern CRC at the trial baud rate
+	 .func = UART_TEST_PARSER},
+
+	{.cmdString = "UART COMMIT", // Keep the trial baud rate
+	 .func = UART_COMMIT_PARSER},
+
+	{.cmdString = "UART RESET", // Return to the default baud rate
+	 .func = UART_RESET_PARSER},
+
+	{.cmdString = "UART STATUS", // Print baud rate and link error counters
+	 .func = UART_STATUS_PARSER},
+
+	{.cmdString = "SET DISPLAY", // Switch between status and trend view
+	 .func = SET_DISPLAY_PARSER},
+
+#if FIXED_FMT_BENCHMARK
+	{.cmdString = "FMT BENCH", // Compare record formatting cycles (snprintf vs fixed point)
+	 .func = FMT_BENCH_PARSER},
+#endif
+
 	{.cmdString = NULL, .func = NULL}, // Table terminator
 
 };
@@ -15,6 +15,14 @@
 #include "wifi_manager.h"
 #include "sht3x.h"
 #include "sd_card_manager.h"
+#include "sd_archive.h"
+#include "low_power.h"
+#include "rtc_clock.h"
+#include "i2c_bus.h"
+#include "fixed_fmt.h"
+#include "profiler.h"
+#include "uart.h"
+#include "display.h"
 #include "stm32f1xx_hal.h"
 
 /* DEFINES -------------------------------------------------------------------*/
@@ -25,6 +33,33 @@
 // External variables for timing and state control
 extern mqtt_state_t mqtt_current_state;
 
+/* PRIVATE FUNCTIONS --------------------------------------------------------*/
+
+/**
+ * @brief Print one timing line of the STATS command
+ */
+static void stats_print_timing(const char *name, const profiler_timing_t *t)
+{
+	char hist[8 * PROFILER_HIST_BUCKETS];
+	fixed_fmt_t f;
+
+	FixedFmt_Init(&f, hist, sizeof(hist));
+	for (uint8_t i = 0; i < PROFILER_HIST_BUCKETS; i++)
+	{
+		if (i > 0)
+		{
+			FixedFmt_Char(&f, '/');
+		}
+		FixedFmt_U32(&f, t->hist[i], 0);
+	}
+	FixedFmt_End(&f);
+
+	// Two lines: PRINT_CLI output is limited to BUFFER_PRINT characters
+	PRINT_CLI("[STATS] %s: n %lu | min %lu | avg %lu | max %lu us\r\n", name, (unsigned long)t->count,
+			  (unsigned long)t->min_us, (unsigned long)t->avg_us, (unsigned long)t->max_us);
+	PRINT_CLI("[STATS] %s hist: %s\r\n", name, hist);
+}
+
 /* PUBLIC API ----------------------------------------------------------------*/
 
 void CHECK_UART_STATUS(uint8_t argc, char **argv)
@@ -135,6 +170,9 @@ void DS3231_Set_Time_Parser(uint8_t argc, char **argv)
 
 	if (status == HAL_OK)
 	{
+		time.tm_isdst = 0;
+		RTCClock_Set((uint32_t)mktime(&time));
+
 		PRINT_CLI("DS3231 TIME SET: 20%02d-%02d-%02d %02d:%02d:%02d (WD:%d)\r\n",
 				  year, month, day, hour, min, sec, weekday);
 	}
@@ -249,7 +287,10 @@ void SET_TIME_PARSER(uint8_t argc, char **argv)
 	}
 
 	// Call DS3231_Set_Time with struct tm pointer
-	DS3231_Set_Time(&g_ds3231, time);
+	if (DS3231_Set_Time(&g_ds3231, time) == HAL_OK)
+	{
+		RTCClock_Set((uint32_t)timestamp);
+	}
 
 	// Force display update immediately after setting time
 	extern bool force_display_update;
@@ -300,6 +341,22 @@ void MQTT_DISCONNECTED_PARSER(uint8_t argc, char **argv)
 	mqtt_current_state = MQTT_STATE_DISCONNECTED;
 }
 
+/**
+ * @brief Command parser for MQTT BUSY notification
+ *
+ * @details Sent by the ESP32 while its publish queue is congested. Live data
+ *          is buffered to SD until MQTT CONNECTED is received again.
+ */
+void MQTT_BUSY_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 2) // "MQTT BUSY" = 2 words
+	{
+		return;
+	}
+
+	mqtt_current_state = MQTT_STATE_BUSY;
+}
+
 /**
  * @brief Command parser for SD CLEAR command
  */
@@ -320,3 +377,354 @@ void SD_CLEAR_PARSER(uint8_t argc, char **argv)
 		PRINT_CLI("FAILED to clear SD buffer!\r\n");
 	}
 }
+
+/**
+ * @brief Command parser for SD QUERY command
+ */
+void SD_QUERY_PARSER(uint8_t argc, char **argv)
+{
+	// SD QUERY STOP
+	if (argc == 3 && strcmp(argv[2], "STOP") == 0)
+	{
+		SDArchive_StopQuery();
+		PRINT_CLI("[SD] Query stopped\r\n");
+		return;
+	}
+
+	// SD QUERY <FROM_UNIX> <TO_UNIX>
+	if (argc != 4)
+	{
+		PRINT_CLI("SD QUERY <FROM_UNIX> <TO_UNIX>\r\n");
+		return;
+	}
+
+	uint32_t from = (uint32_t)strtoul(argv[2], NULL, 10);
+	uint32_t to = (uint32_t)strtoul(argv[3], NULL, 10);
+
+	if (!SDArchive_StartQuery(from, to))
+	{
+		PRINT_CLI("[SD] Query FAILED\r\n");
+		return;
+	}
+
+	PRINT_CLI("[SD] Query %lu-%lu | Archive: %lu\r\n",
+			  (unsigned long)from, (unsigned long)to, (unsigned long)SDArchive_GetCount());
+}
+
+/**
+ * @brief Command parser for SET REPORT DEADBAND command
+ */
+void SET_REPORT_DEADBAND_PARSER(uint8_t argc, char **argv)
+{
+	// SET REPORT DEADBAND <TEMP_C> <HUMI_PCT> <HEARTBEAT_S>
+	if (argc != 6)
+	{
+		PRINT_CLI("SET REPORT DEADBAND <TEMP_C> <HUMI_PCT> <HEARTBEAT_S>\r\n");
+		return;
+	}
+
+	float temp_deadband = (float)atof(argv[3]);
+	float humi_deadband = (float)atof(argv[4]);
+	uint32_t heartbeat_s = (uint32_t)atol(argv[5]);
+
+	// Validate parameters (heartbeat must be at least one sample interval)
+	if (temp_deadband < 0.0f || humi_deadband < 0.0f || heartbeat_s == 0)
+	{
+		PRINT_CLI("[CMD] INVALID DEADBAND PARAMETERS\r\n");
+		return;
+	}
+
+	DataManager_SetReportMode(DATA_MANAGER_REPORT_DEADBAND,
+							  temp_deadband, humi_deadband, heartbeat_s * 1000);
+
+	PRINT_CLI("[CMD] REPORT DEADBAND T=%.2f H=%.2f HB=%lus\r\n",
+			  temp_deadband, humi_deadband, (unsigned long)heartbeat_s);
+}
+
+/**
+ * @brief Command parser for SET REPORT ALL command
+ */
+void SET_REPORT_ALL_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 3) // "SET REPORT ALL" = 3 words
+	{
+		return;
+	}
+
+	DataManager_SetReportMode(DATA_MANAGER_REPORT_ALL, 0.0f, 0.0f, 0);
+
+	PRINT_CLI("[CMD] REPORT ALL\r\n");
+}
+
+/**
+ * @brief Command parser for SET POWER command
+ */
+void SET_POWER_PARSER(uint8_t argc, char **argv)
+{
+	// SET POWER LOW | SET POWER NORMAL
+	if (argc != 3)
+	{
+		PRINT_CLI("SET POWER LOW|NORMAL\r\n");
+		return;
+	}
+
+	if (strcmp(argv[2], "LOW") == 0)
+	{
+		LowPower_SetEnabled(true);
+		PRINT_CLI("[CMD] POWER LOW\r\n");
+	}
+	else if (strcmp(argv[2], "NORMAL") == 0)
+	{
+		LowPower_SetEnabled(false);
+
+		// Redraw the display after standby
+		extern bool force_display_update;
+		force_display_update = true;
+
+		PRINT_CLI("[CMD] POWER NORMAL\r\n");
+	}
+}
+
+/**
+ * @brief Command parser for POWER STATUS command
+ */
+void POWER_STATUS_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 2) // "POWER STATUS" = 2 words
+	{
+		return;
+	}
+
+	low_power_stats_t stats;
+	LowPower_GetStats(&stats);
+
+	PRINT_CLI("[PWR] %s | Sleeps: %lu (alarm %lu, uart %lu)\r\n",
+			  LowPower_IsEnabled() ? "LOW" : "NORMAL", (unsigned long)stats.sleeps,
+			  (unsigned long)stats.alarm_wakes, (unsigned long)stats.uart_wakes);
+	PRINT_CLI("[PWR] Sleep: %lu s | Awake: %lu s | Avg: ~%lu uA\r\n",
+			  (unsigned long)(stats.sleep_ms / 1000), (unsigned long)(stats.awake_ms / 1000),
+			  (unsigned long)stats.avg_current_ua);
+	PRINT_CLI("[PWR] Wake-to-sample: %lu us (max %lu us)\r\n",
+			  (unsigned long)stats.last_latency_us, (unsigned long)stats.max_latency_us);
+}
+
+/**
+ * @brief Command parser for I2C STATUS command
+ */
+void I2C_STATUS_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 2) // "I2C STATUS" = 2 words
+	{
+		return;
+	}
+
+	i2c_bus_stats_t stats;
+	I2CBus_GetStats(&stats);
+
+	PRINT_CLI("[I2C] Queued: %lu | Rejected: %lu | Recoveries: %lu\r\n",
+			  (unsigned long)stats.queued, (unsigned long)stats.rejected, (unsigned long)stats.recoveries);
+
+	for (uint8_t i = 0; i < stats.devices; i++)
+	{
+		const i2c_bus_device_t *dev = I2CBus_GetDevice(i);
+		PRINT_CLI("[I2C] 0x%02X: ok %lu | err %lu | timeout %lu | max %lu us\r\n",
+				  (unsigned int)(dev->address >> 1), (unsigned long)dev->ok, (unsigned long)dev->errors,
+				  (unsigned long)dev->timeouts, (unsigned long)dev->max_us);
+	}
+}
+
+/**
+ * @brief Command parser for STATS command
+ */
+void STATS_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 1) // "STATS" = 1 word
+	{
+		return;
+	}
+
+	profiler_timing_t timing;
+
+	PRINT_CLI("[STATS] Histogram buckets: <16us/<64us/<256us/<1ms/<4ms/<16ms/<64ms/>=64ms\r\n");
+
+	for (uint8_t i = 0; i < PROFILER_STAGE_COUNT; i++)
+	{
+		Profiler_GetStage((profiler_stage_t)i, &timing);
+		stats_print_timing(Profiler_StageName((profiler_stage_t)i), &timing);
+	}
+
+	Profiler_GetLoop(&timing);
+	stats_print_timing("LOOP", &timing);
+	PRINT_CLI("[STATS] Loop jitter: %lu us\r\n", (unsigned long)(timing.max_us - timing.min_us));
+
+	profiler_period_t period;
+	Profiler_GetPeriod(&period);
+	PRINT_CLI("[STATS] Sample period error: n %lu | min %ld | avg %ld | max %ld ms\r\n",
+			  (unsigned long)period.count, (long)period.min_ms, (long)period.avg_ms, (long)period.max_ms);
+}
+
+/**
+ * @brief Command parser for STATS RESET command
+ */
+void STATS_RESET_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 2) // "STATS RESET" = 2 words
+	{
+		return;
+	}
+
+	Profiler_Reset();
+	PRINT_CLI("[STATS] Statistics cleared\r\n");
+}
+
+/**
+ * @brief Command parser for UART BAUD command
+ */
+void UART_BAUD_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 3) // "UART BAUD <rate>" = 3 words
+	{
+		return;
+	}
+
+	uint32_t baud = strtoul(argv[2], NULL, 10);
+	if (!UART_IsSupportedBaud(baud))
+	{
+		PRINT_CLI("UART BAUD FAIL %lu\r\n", (unsigned long)baud);
+		return;
+	}
+
+	// Acknowledge at the current rate, then switch (reverted unless committed)
+	PRINT_CLI("UART BAUD OK %lu\r\n", (unsigned long)baud);
+	UART_TryBaudRate(baud);
+}
+
+/**
+ * @brief Command parser for UART TEST command
+ */
+void UART_TEST_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 4) // "UART TEST <pattern> <crc>" = 4 words
+	{
+		return;
+	}
+
+	uint16_t crc = (uint16_t)strtoul(argv[3], NULL, 16);
+	if (UART_CheckTestPattern(argv[2], crc))
+	{
+		// Echo back so the ESP32 checks the STM32 -> ESP32 direction too
+		PRINT_CLI("UART TEST OK %s %04X\r\n", argv[2], (unsigned int)crc);
+	}
+	else
+	{
+		PRINT_CLI("UART TEST FAIL\r\n");
+	}
+}
+
+/**
+ * @brief Command parser for UART COMMIT command
+ */
+void UART_COMMIT_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 2) // "UART COMMIT" = 2 words
+	{
+		return;
+	}
+
+	if (UART_CommitBaudRate())
+	{
+		PRINT_CLI("UART COMMIT OK %lu\r\n", (unsigned long)UART_GetBaudRate());
+	}
+	else
+	{
+		PRINT_CLI("UART COMMIT FAIL\r\n");
+	}
+}
+
+/**
+ * @brief Command parser for UART RESET command
+ */
+void UART_RESET_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 2) // "UART RESET" = 2 words
+	{
+		return;
+	}
+
+	// Switch first: the ESP32 waits for the reply at the default rate
+	UART_SetBaudRate(UART_BAUD_DEFAULT);
+	PRINT_CLI("UART RESET OK\r\n");
+}
+
+/**
+ * @brief Command parser for UART STATUS command
+ */
+void UART_STATUS_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 2) // "UART STATUS" = 2 words
+	{
+		return;
+	}
+
+	uart_link_stats_t stats;
+	UART_GetLinkStats(&stats);
+
+	PRINT_CLI("[UART] Baud: %lu | Overrun: %lu | Frame: %lu | Noise: %lu | Parity: %lu\r\n",
+			  (unsigned long)stats.baud, (unsigned long)stats.overruns, (unsigned long)stats.frame_errors,
+			  (unsigned long)stats.noise_errors, (unsigned long)stats.parity_errors);
+	PRINT_CLI("[UART] Test failures: %lu | Trial reverts: %lu\r\n",
+			  (unsigned long)stats.test_failures, (unsigned long)stats.trial_reverts);
+}
+
+/**
+ * @brief Command parser for SET DISPLAY command
+ */
+void SET_DISPLAY_PARSER(uint8_t argc, char **argv)
+{
+	// SET DISPLAY STATUS | SET DISPLAY TREND
+	if (argc != 3)
+	{
+		PRINT_CLI("SET DISPLAY STATUS|TREND\r\n");
+		return;
+	}
+
+	if (strcmp(argv[2], "STATUS") == 0)
+	{
+		display_set_view(DISPLAY_VIEW_STATUS);
+	}
+	else if (strcmp(argv[2], "TREND") == 0)
+	{
+		display_set_view(DISPLAY_VIEW_TREND);
+	}
+	else
+	{
+		PRINT_CLI("SET DISPLAY STATUS|TREND\r\n");
+		return;
+	}
+
+	// Redraw now instead of at the next 1 s tick
+	extern bool force_display_update;
+	force_display_update = true;
+
+	PRINT_CLI("[CMD] DISPLAY %s\r\n", argv[2]);
+}
+
+#if FIXED_FMT_BENCHMARK
+/**
+ * @brief Command parser for FMT BENCH command
+ */
+void FMT_BENCH_PARSER(uint8_t argc, char **argv)
+{
+	if (argc != 2) // "FMT BENCH" = 2 words
+	{
+		return;
+	}
+
+	fixed_fmt_bench_t bench;
+	FixedFmt_Benchmark(&bench);
+
+	PRINT_CLI("[FMT] Cycles/record | snprintf: %lu | fixed: %lu | vformat: %lu\r\n",
+			  (unsigned long)bench.snprintf_cycles, (unsigned long)bench.fixed_cycles,
+			  (unsigned long)bench.vformat_cycles);
+}
+#endif
@@ -116,5 +116,9 @@ void COMMAND_EXECUTE(char *commandBuffer)
 
     command_function_t *command = find_command(argc, argv);
 
+    // Unknown or garbled line (e.g. sent at another baud rate)
+    if (command == NULL)
+        return;
+
     command->func(argc, argv);
 }
@@ -6,16 +6,53 @@
 
 /* INCLUDES ------------------------------------------------------------------*/
 
+#include <math.h>
 #include <string.h>
 #include "data_manager.h"
+#include "fixed_fmt.h"
 #include "sensor_json_output.h"
 #include "print_cli.h"
+#include "stm32f1xx_hal.h"
 
 /* PRIVATE VARIABLES ---------------------------------------------------------*/
 
 // Global data manager state
 static data_manager_state_t g_data_manager_state = {0};
 
+// Periodic sample history (ring, g_history_seq counts every sample)
+static data_manager_sample_t g_history[DATA_MANAGER_HISTORY_LEN];
+static uint32_t g_history_seq = 0;
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+/**
+ * @brief Decide whether a periodic sample must be reported
+ *
+ * @param temperature Temperature value from sensor
+ * @param humidity Humidity value from sensor
+ * @param now_ms Current system tick
+ *
+ * @return true if the sample leaves the deadband or the heartbeat expired
+ */
+static bool _is_report_due(float temperature, float humidity, uint32_t now_ms)
+{
+    const data_manager_report_t *report = &g_data_manager_state.report;
+
+    if (report->mode != DATA_MANAGER_REPORT_DEADBAND || !report->has_reference)
+    {
+        return true;
+    }
+
+    // Compare against the last REPORTED value so slow drift is not lost
+    if (fabsf(temperature - report->last_temperature) > report->temp_deadband ||
+        fabsf(humidity - report->last_humidity) > report->humi_deadband)
+    {
+        return true;
+    }
+
+    return (now_ms - report->last_report_ms) >= report->heartbeat_ms;
+}
+
 /* PUBLIC API ----------------------------------------------------------------*/
 
 /**
@@ -24,8 +61,10 @@ static data_manager_state_t g_data_manager_state = {0};
 void DataManager_Init(void)
 {
     memset(&g_data_manager_state, 0, sizeof(data_manager_state_t));
+    g_history_seq = 0;
     g_data_manager_state.mode = DATA_MANAGER_MODE_IDLE;
     g_data_manager_state.data_ready = false;
+    g_data_manager_state.report.mode = DATA_MANAGER_REPORT_ALL;
 }
 
 /**
@@ -37,6 +76,7 @@ void DataManager_UpdateSingle(float temperature, float humidity)
     g_data_manager_state.sht3x.temperature = temperature;
     g_data_manager_state.sht3x.humidity = humidity;
     g_data_manager_state.sht3x.valid = true;
+    g_data_manager_state.suppressed = 0; // Pending count is kept for the next periodic report
     g_data_manager_state.data_ready = true;
 }
 
@@ -45,13 +85,57 @@ void DataManager_UpdateSingle(float temperature, float humidity)
  */
 void DataManager_UpdatePeriodic(float temperature, float humidity)
 {
+    data_manager_report_t *report = &g_data_manager_state.report;
+    uint32_t now_ms = HAL_GetTick();
+
+    // Always keep the latest sample for the display
     g_data_manager_state.mode = DATA_MANAGER_MODE_PERIODIC;
     g_data_manager_state.sht3x.temperature = temperature;
     g_data_manager_state.sht3x.humidity = humidity;
     g_data_manager_state.sht3x.valid = true;
+
+    // Record it for the trend view (suppressed samples included)
+    data_manager_sample_t *slot = &g_history[g_history_seq % DATA_MANAGER_HISTORY_LEN];
+    slot->temperature = (int16_t)FixedFmt_FromFloat(temperature, 1);
+    slot->humidity = (uint16_t)FixedFmt_FromFloat(humidity, 1);
+    g_history_seq++;
+
+    if (!_is_report_due(temperature, humidity, now_ms))
+    {
+        report->suppressed++;
+        return;
+    }
+
+    // Hand the suppressed count over to this report
+    g_data_manager_state.suppressed = report->suppressed;
+    report->suppressed = 0;
+    report->last_temperature = temperature;
+    report->last_humidity = humidity;
+    report->last_report_ms = now_ms;
+    report->has_reference = true;
+
     g_data_manager_state.data_ready = true;
 }
 
+/**
+ * @brief Configure periodic reporting mode
+ */
+void DataManager_SetReportMode(data_manager_report_mode_t mode,
+                               float temp_deadband,
+                               float humi_deadband,
+                               uint32_t heartbeat_ms)
+{
+    data_manager_report_t *report = &g_data_manager_state.report;
+
+    report->mode = mode;
+    report->temp_deadband = temp_deadband;
+    report->humi_deadband = humi_deadband;
+    report->heartbeat_ms = heartbeat_ms;
+
+    // Force the next periodic sample to be reported
+    report->has_reference = false;
+}
+
 /**
  * @brief Print the current data in JSON format
  */
@@ -84,7 +168,8 @@ bool DataManager_Print(void)
     // Print JSON output
     sensor_json_output_send(mode_str,
                             g_data_manager_state.sht3x.temperature,
-                            g_data_manager_state.sht3x.humidity);
+                            g_data_manager_state.sht3x.humidity,
+                            g_data_manager_state.suppressed);
 
     // Clear data_ready flag after printing
     g_data_manager_state.data_ready = false;
@@ -100,6 +185,28 @@ const data_manager_state_t *DataManager_GetState(void)
     return &g_data_manager_state;
 }
 
+/**
+ * @brief Get the number of periodic samples taken since init
+ */
+uint32_t DataManager_GetHistorySeq(void)
+{
+    return g_history_seq;
+}
+
+/**
+ * @brief Get a sample from the RAM history
+ */
+bool DataManager_GetHistory(uint16_t age, data_manager_sample_t *sample)
+{
+    if (sample == NULL || age >= DATA_MANAGER_HISTORY_LEN || age >= g_history_seq)
+    {
+        return false;
+    }
+
+    *sample = g_history[(g_history_seq - 1 - age) % DATA_MANAGER_HISTORY_LEN];
+    return true;
+}
+
 /**
  * @brief Clear the data_ready flag
  */
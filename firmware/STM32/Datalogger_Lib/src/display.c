@@ -9,7 +9,8 @@
 #include "display.h"
 #include "ili9225.h"
 #include "fonts.h"
-#include <stdio.h>
+#include "fixed_fmt.h"
+#include "data_manager.h"
 #include <string.h>
 
 /* DEFINES -------------------------------------------------------------------*/
@@ -61,6 +62,34 @@
 #define COLOR_ON ILI9225_GREEN       // Green dot for ON
 #define COLOR_OFF ILI9225_RED        // Red dot for OFF
 
+// Trend view - one periodic sample per line of the hardware scroll area.
+// The scroll axis is X in landscape (time runs left to right) and Y in
+// portrait (top to bottom), the values run across the other axis.
+#define TREND_LABEL_LEN 40                                    // Fixed label band at the start of the scroll axis
+#define TREND_LINES (ILI9225_SCROLL_LINES - TREND_LABEL_LEN) // Samples on screen
+#if ILI9225_SCROLL_ALONG_X
+#define TREND_VALUE_LEN ILI9225_HEIGHT // Pixels across the scroll axis
+#else
+#define TREND_VALUE_LEN ILI9225_WIDTH
+#endif
+#define TREND_BAND_LEN 84                                  // Pixels per value band
+#define TREND_TEMP_BAND 0                                  // Temperature band start
+#define TREND_HUMI_BAND (TREND_VALUE_LEN - TREND_BAND_LEN) // Humidity band start
+#define TREND_SEPARATOR (TREND_VALUE_LEN / 2)              // Grid pixel between the bands
+
+// Scale in 0.1 units: margin around the visible min/max, minimum span
+#define TREND_TEMP_MARGIN 5 // 0.5 C
+#define TREND_TEMP_SPAN 40  // 4 C
+#define TREND_HUMI_MARGIN 20 // 2 %RH
+#define TREND_HUMI_SPAN 100  // 10 %RH
+
+#define COLOR_TREND_TEMP ILI9225_ORANGE
+#define COLOR_TREND_HUMI ILI9225_CYAN
+#define COLOR_TREND_GRID ILI9225_DARKGRAY
+
+// ILI9225_DrawImage() sends the buffer in memory order, RGB565 is big-endian
+#define TREND_PIXEL(c) ((uint16_t)(((c) >> 8) | ((c) << 8)))
+
 /* PRIVATE VARIABLES ---------------------------------------------------------*/
 
 // Previous values for change detection
@@ -73,6 +102,16 @@ static bool prev_periodic_on = false;
 static char prev_interval_str[16] = "";
 static bool first_draw = true;
 
+// View selection
+static display_view_t current_view = DISPLAY_VIEW_STATUS;
+static bool view_changed = false;
+
+// Trend view state
+static uint16_t trend_line[TREND_VALUE_LEN]; // One scroll line, byte-swapped
+static uint32_t trend_seq = 0;               // History sequence drawn so far
+static int16_t trend_temp_lo, trend_temp_hi; // Temperature scale (0.1 C)
+static int16_t trend_humi_lo, trend_humi_hi; // Humidity scale (0.1 %RH)
+
 /* ICON DRAWING ------------------------------------------------------------- */
 
 /**
@@ -213,10 +252,14 @@ static void clear_area(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 static void format_time(time_t unix_time, char *buffer)
 {
     struct tm *timeinfo = localtime(&unix_time);
-    sprintf(buffer, "%02d:%02d:%02d",
-            timeinfo->tm_hour,
-            timeinfo->tm_min,
-            timeinfo->tm_sec);
+    fixed_fmt_t out;
+    FixedFmt_Init(&out, buffer, 9);
+    FixedFmt_U32(&out, (uint32_t)timeinfo->tm_hour, 2);
+    FixedFmt_Char(&out, ':');
+    FixedFmt_U32(&out, (uint32_t)timeinfo->tm_min, 2);
+    FixedFmt_Char(&out, ':');
+    FixedFmt_U32(&out, (uint32_t)timeinfo->tm_sec, 2);
+    FixedFmt_End(&out);
 }
 
 /**
@@ -230,11 +273,16 @@ static void format_date(time_t unix_time, char *buffer)
 {
     struct tm *timeinfo = localtime(&unix_time);
     const char *weekdays[] = {"CN", "Th2", "Th3", "Th4", "Th5", "Th6", "Th7"};
-    sprintf(buffer, "%s %02d/%02d/%04d",
-            weekdays[timeinfo->tm_wday],
-            timeinfo->tm_mday,
-            timeinfo->tm_mon + 1,
-            timeinfo->tm_year + 1900);
+    fixed_fmt_t out;
+    FixedFmt_Init(&out, buffer, 20);
+    FixedFmt_Str(&out, weekdays[timeinfo->tm_wday]);
+    FixedFmt_Char(&out, ' ');
+    FixedFmt_U32(&out, (uint32_t)timeinfo->tm_mday, 2);
+    FixedFmt_Char(&out, '/');
+    FixedFmt_U32(&out, (uint32_t)(timeinfo->tm_mon + 1), 2);
+    FixedFmt_Char(&out, '/');
+    FixedFmt_U32(&out, (uint32_t)(timeinfo->tm_year + 1900), 4);
+    FixedFmt_End(&out);
 }
 
 /**
@@ -249,16 +297,300 @@ static void format_date(time_t unix_time, char *buffer)
  */
 static void format_interval(int interval_seconds, char *buffer)
 {
+    fixed_fmt_t out;
+    FixedFmt_Init(&out, buffer, 8);
+
     if (interval_seconds < 60)
     {
         // Show as seconds (5s, 30s, etc.)
-        sprintf(buffer, "%ds", interval_seconds);
+        FixedFmt_I32(&out, interval_seconds);
+        FixedFmt_Char(&out, 's');
     }
     else
     {
         // Show as minutes (1m, 10m, 30m, 60m, etc.)
         int minutes = interval_seconds / 60;
-        sprintf(buffer, "%dm", minutes);
+        FixedFmt_I32(&out, minutes);
+        FixedFmt_Char(&out, 'm');
+    }
+
+    FixedFmt_End(&out);
+}
+
+/* TREND VIEW --------------------------------------------------------------- */
+
+/**
+ * @brief Round down to a multiple of step (also for negative values)
+ *
+ * @param value Value to round
+ * @param step Step size
+ *
+ * @return Rounded value
+ */
+static int16_t trend_floor(int16_t value, int16_t step)
+{
+    return (value >= 0) ? (value / step) * step : -(((step - 1 - value) / step) * step);
+}
+
+/**
+ * @brief Fit a scale around a range of values
+ *
+ * @param min Smallest value
+ * @param max Largest value
+ * @param margin Margin added on both sides
+ * @param span Minimum span of the scale
+ * @param lo Output low end (whole units)
+ * @param hi Output high end (whole units)
+ */
+static void trend_fit(int16_t min, int16_t max, int16_t margin, int16_t span,
+                      int16_t *lo, int16_t *hi)
+{
+    min -= margin;
+    max += margin;
+    if (max - min < span)
+    {
+        int16_t extra = (span - (max - min) + 1) / 2;
+        min -= extra;
+        max += extra;
+    }
+    *lo = trend_floor(min, 10);
+    *hi = -trend_floor(-max, 10);
+}
+
+/**
+ * @brief Convert a value to a pixel across the scroll axis
+ *
+ * @param value Value in 0.1 units
+ * @param lo Scale low end
+ * @param hi Scale high end
+ * @param band Band start pixel
+ *
+ * @return Pixel index in trend_line
+ */
+static uint16_t trend_pos(int16_t value, int16_t lo, int16_t hi, uint16_t band)
+{
+    int32_t scaled = (int32_t)(value - lo) * (TREND_BAND_LEN - 1) / (hi - lo);
+
+    if (scaled < 0)
+        scaled = 0;
+    if (scaled > TREND_BAND_LEN - 1)
+        scaled = TREND_BAND_LEN - 1;
+
+#if ILI9225_SCROLL_ALONG_X
+    return band + TREND_BAND_LEN - 1 - scaled; // Higher values towards the top
+#else
+    return band + scaled; // Higher values towards the right
+#endif
+}
+
+/**
+ * @brief Check that a sample fits the current scales
+ *
+ * @param sample Sample to check
+ *
+ * @return true if no rescale is needed
+ */
+static bool trend_in_scale(const data_manager_sample_t *sample)
+{
+    return sample->temperature >= trend_temp_lo && sample->temperature <= trend_temp_hi &&
+           (int16_t)sample->humidity >= trend_humi_lo && (int16_t)sample->humidity <= trend_humi_hi;
+}
+
+/**
+ * @brief Fill a run of trend_line between two pixels
+ *
+ * @param a First pixel
+ * @param b Last pixel (either order)
+ * @param color RGB565 color
+ */
+static void trend_fill(uint16_t a, uint16_t b, uint16_t color)
+{
+    if (a > b)
+    {
+        uint16_t t = a;
+        a = b;
+        b = t;
+    }
+    while (a <= b)
+    {
+        trend_line[a++] = TREND_PIXEL(color);
+    }
+}
+
+/**
+ * @brief Draw one sample as a full line across the scroll axis
+ *
+ * @param line Screen line on the scroll axis
+ * @param sample Sample to draw (NULL = empty line)
+ * @param prev Previous sample to join the trace to (NULL = none)
+ *
+ * @note One window and one bulk transfer of TREND_VALUE_LEN pixels
+ */
+static void trend_draw_sample(uint16_t line, const data_manager_sample_t *sample,
+                              const data_manager_sample_t *prev)
+{
+    for (uint16_t i = 0; i < TREND_VALUE_LEN; i++)
+    {
+        trend_line[i] = TREND_PIXEL(COLOR_BG);
+    }
+    trend_line[TREND_SEPARATOR] = TREND_PIXEL(COLOR_TREND_GRID);
+
+    if (sample != NULL)
+    {
+        if (prev == NULL)
+        {
+            prev = sample;
+        }
+
+        // Join to the previous sample so steep changes stay continuous
+        trend_fill(trend_pos(sample->temperature, trend_temp_lo, trend_temp_hi, TREND_TEMP_BAND),
+                   trend_pos(prev->temperature, trend_temp_lo, trend_temp_hi, TREND_TEMP_BAND),
+                   COLOR_TREND_TEMP);
+        trend_fill(trend_pos(sample->humidity, trend_humi_lo, trend_humi_hi, TREND_HUMI_BAND),
+                   trend_pos(prev->humidity, trend_humi_lo, trend_humi_hi, TREND_HUMI_BAND),
+                   COLOR_TREND_HUMI);
+    }
+
+#if ILI9225_SCROLL_ALONG_X
+    ILI9225_DrawImage(line, 0, 1, TREND_VALUE_LEN, trend_line);
+#else
+    ILI9225_DrawImage(0, line, TREND_VALUE_LEN, 1, trend_line);
+#endif
+}
+
+/**
+ * @brief Draw the scale labels of one band
+ *
+ * @param band Band start pixel
+ * @param lo Scale low end (whole units)
+ * @param hi Scale high end (whole units)
+ * @param name Band name
+ * @param color Trace color
+ */
+static void trend_draw_scale(uint16_t band, int16_t lo, int16_t hi,
+                             const char *name, uint16_t color)
+{
+    char lo_str[8];
+    char hi_str[8];
+    fixed_fmt_t out;
+
+    FixedFmt_Init(&out, lo_str, sizeof(lo_str));
+    FixedFmt_I32(&out, lo / 10);
+    FixedFmt_End(&out);
+    FixedFmt_Init(&out, hi_str, sizeof(hi_str));
+    FixedFmt_I32(&out, hi / 10);
+    FixedFmt_End(&out);
+
+#if ILI9225_SCROLL_ALONG_X
+    // Label column on the left: high end at the top of the band
+    ILI9225_WriteString(2, band, hi_str, Font_7x10, COLOR_LABEL, COLOR_BG);
+    ILI9225_WriteString(2, band + (TREND_BAND_LEN - FONT_7X10_HEIGHT) / 2, name,
+                        Font_7x10, color, COLOR_BG);
+    ILI9225_WriteString(2, band + TREND_BAND_LEN - FONT_7X10_HEIGHT, lo_str,
+                        Font_7x10, COLOR_LABEL, COLOR_BG);
+#else
+    // Label rows at the top: high end on the right of the band
+    ILI9225_WriteString(band, 4, lo_str, Font_7x10, COLOR_LABEL, COLOR_BG);
+    ILI9225_WriteString(band + TREND_BAND_LEN - strlen(hi_str) * FONT_7X10_WIDTH, 4, hi_str,
+                        Font_7x10, COLOR_LABEL, COLOR_BG);
+    ILI9225_WriteString(band + (TREND_BAND_LEN - strlen(name) * FONT_7X10_WIDTH) / 2, 22, name,
+                        Font_7x10, color, COLOR_BG);
+#endif
+}
+
+/**
+ * @brief Redraw the whole trend view from the sample history
+ *
+ * @note Refits the scales and resets the scroll offset
+ */
+static void trend_redraw(void)
+{
+    data_manager_sample_t sample;
+    data_manager_sample_t prev;
+    int16_t temp_min = INT16_MAX, temp_max = INT16_MIN;
+    int16_t humi_min = INT16_MAX, humi_max = INT16_MIN;
+    uint16_t count = 0;
+
+    while (count < TREND_LINES && DataManager_GetHistory(count, &sample))
+    {
+        if (sample.temperature < temp_min)
+            temp_min = sample.temperature;
+        if (sample.temperature > temp_max)
+            temp_max = sample.temperature;
+        if ((int16_t)sample.humidity < humi_min)
+            humi_min = sample.humidity;
+        if ((int16_t)sample.humidity > humi_max)
+            humi_max = sample.humidity;
+        count++;
+    }
+
+    if (count == 0)
+    {
+        // Empty history: center the scales on room conditions
+        temp_min = temp_max = 250;
+        humi_min = humi_max = 500;
+    }
+
+    trend_fit(temp_min, temp_max, TREND_TEMP_MARGIN, TREND_TEMP_SPAN, &trend_temp_lo, &trend_temp_hi);
+    trend_fit(humi_min, humi_max, TREND_HUMI_MARGIN, TREND_HUMI_SPAN, &trend_humi_lo, &trend_humi_hi);
+
+    ILI9225_SetScrollArea(TREND_LABEL_LEN, ILI9225_SCROLL_LINES - 1);
+
+#if ILI9225_SCROLL_ALONG_X
+    clear_area(0, 0, TREND_LABEL_LEN, ILI9225_HEIGHT);
+#else
+    clear_area(0, 0, ILI9225_WIDTH, TREND_LABEL_LEN);
+#endif
+    trend_draw_scale(TREND_TEMP_BAND, trend_temp_lo, trend_temp_hi, "C", COLOR_TREND_TEMP);
+    trend_draw_scale(TREND_HUMI_BAND, trend_humi_lo, trend_humi_hi, "%RH", COLOR_TREND_HUMI);
+
+    // Oldest sample first, newest at the end of the scroll area
+    for (uint16_t i = 0; i < TREND_LINES; i++)
+    {
+        uint16_t age = TREND_LINES - 1 - i;
+        bool has_sample = DataManager_GetHistory(age, &sample);
+        bool has_prev = (age + 1 < count) && DataManager_GetHistory(age + 1, &prev);
+
+        trend_draw_sample(TREND_LABEL_LEN + i, has_sample ? &sample : NULL,
+                          has_prev ? &prev : NULL);
+    }
+
+    trend_seq = DataManager_GetHistorySeq();
+}
+
+/**
+ * @brief Draw the samples taken since the last update
+ *
+ * @note Each new sample scrolls the area by one line and draws only that
+ *       line. A full redraw is done when a sample leaves the scales or more
+ *       samples are pending than fit on screen.
+ */
+static void trend_update(void)
+{
+    uint32_t seq = DataManager_GetHistorySeq();
+
+    if (seq - trend_seq > TREND_LINES)
+    {
+        trend_redraw();
+        return;
+    }
+
+    while (trend_seq != seq)
+    {
+        data_manager_sample_t sample;
+        data_manager_sample_t prev;
+        uint16_t age = seq - trend_seq - 1;
+
+        DataManager_GetHistory(age, &sample);
+        if (!trend_in_scale(&sample))
+        {
+            trend_redraw();
+            return;
+        }
+
+        bool has_prev = DataManager_GetHistory(age + 1, &prev);
+        trend_draw_sample(ILI9225_ScrollLine(), &sample, has_prev ? &prev : NULL);
+        trend_seq++;
     }
 }
 
@@ -316,6 +648,28 @@ void display_update(time_t time_unix, float temperature, float humidity,
     char buffer[32];
     uint16_t text_x;
 
+    if (view_changed)
+    {
+        view_changed = false;
+        if (current_view == DISPLAY_VIEW_TREND)
+        {
+            ILI9225_FillScreen(COLOR_BG);
+            trend_redraw();
+        }
+        else
+        {
+            ILI9225_ResetScroll();
+            display_init();
+        }
+    }
+
+    if (current_view == DISPLAY_VIEW_TREND)
+    {
+        // Latest values and status are only shown in the status view
+        trend_update();
+        return;
+    }
+
     /* ZONE 1: TIME & DATE (Top, perfectly centered, colored) */
     // TIME - Display in CYAN for visibility (HH:MM:SS = 8 chars)
     format_time(time_unix, buffer);
@@ -344,7 +698,10 @@ void display_update(time_t time_unix, float temperature, float humidity,
 
     /* ZONE 2: TEMPERATURE & HUMIDITY (Center, LARGE, WHITE) */
     // Temperature (Left side) - WHITE for clarity
-    sprintf(buffer, "%.1f", temperature);
+    fixed_fmt_t out;
+    FixedFmt_Init(&out, buffer, sizeof(buffer));
+    FixedFmt_Float(&out, temperature, 1);
+    FixedFmt_End(&out);
     if (strcmp(buffer, prev_temp_str) != 0 || first_draw)
     {
         // Clear temperature area
@@ -367,7 +724,9 @@ void display_update(time_t time_unix, float temperature, float humidity,
     }
 
     // Humidity (Right side) - WHITE for clarity
-    sprintf(buffer, "%.0f", humidity);
+    FixedFmt_Init(&out, buffer, sizeof(buffer));
+    FixedFmt_I32(&out, FixedFmt_FromFloat(humidity, 0));
+    FixedFmt_End(&out);
     if (strcmp(buffer, prev_humi_str) != 0 || first_draw)
     {
         // Clear humidity area
@@ -433,6 +792,26 @@ void display_update(time_t time_unix, float temperature, float humidity,
     first_draw = false;
 }
 
+/**
+ * @brief Select the display view
+ */
+void display_set_view(display_view_t view)
+{
+    if (view != current_view)
+    {
+        current_view = view;
+        view_changed = true;
+    }
+}
+
+/**
+ * @brief Get the current display view
+ */
+display_view_t display_get_view(void)
+{
+    return current_view;
+}
+
 /**
  * @brief Clear entire display
  */
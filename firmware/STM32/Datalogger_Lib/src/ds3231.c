@@ -7,6 +7,7 @@
 /* INCLUDES ------------------------------------------------------------------*/
 
 #include "ds3231.h"
+#include "i2c_bus.h"
 #include <string.h>
 
 /* DEFINES -------------------------------------------------------------------*/
@@ -120,7 +121,12 @@ static int days_since_january_1st(int year, int month, int day)
  */
 static HAL_StatusTypeDef DS3231_Write_Reg(ds3231_t *dev, uint8_t reg, uint8_t *data, uint8_t len)
 {
-    return HAL_I2C_Mem_Write(dev->hi2c, DS3231_ADDR, reg, I2C_MEMADD_SIZE_8BIT, data, len, DS3231_TIMEOUT);
+    if (!dev->hi2c)
+        return HAL_ERROR;
+
+    i2c_bus_xfer_t xfer = {.address = DS3231_ADDR, .op = I2C_BUS_MEM_WRITE, .mem_addr = reg,
+                           .mem_size = I2C_MEMADD_SIZE_8BIT, .data = data, .len = len};
+    return I2CBus_Transfer(&xfer);
 }
 
 /**
@@ -135,7 +141,12 @@ static HAL_StatusTypeDef DS3231_Write_Reg(ds3231_t *dev, uint8_t reg, uint8_t *d
  */
 static HAL_StatusTypeDef DS3231_Read_Reg(ds3231_t *dev, uint8_t reg, uint8_t *data, uint8_t len)
 {
-    return HAL_I2C_Mem_Read(dev->hi2c, DS3231_ADDR, reg, I2C_MEMADD_SIZE_8BIT, data, len, DS3231_TIMEOUT);
+    if (!dev->hi2c)
+        return HAL_ERROR;
+
+    i2c_bus_xfer_t xfer = {.address = DS3231_ADDR, .op = I2C_BUS_MEM_READ, .mem_addr = reg,
+                           .mem_size = I2C_MEMADD_SIZE_8BIT, .data = data, .len = len};
+    return I2CBus_Transfer(&xfer);
 }
 
 /**
@@ -197,6 +208,9 @@ void DS3231_Init(ds3231_t *dev, I2C_HandleTypeDef *hi2c)
     }
 
     dev->hi2c = hi2c;
+
+    // Clock reads are rare (software clock), sampling goes first
+    I2CBus_RegisterDevice(DS3231_ADDR, I2C_BUS_PRIO_NORMAL, DS3231_TIMEOUT);
 }
 
 /**
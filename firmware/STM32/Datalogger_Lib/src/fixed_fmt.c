@@ -0,0 +1,512 @@
+/**
+ * @file fixed_fmt.c
+ *
+ * @brief Fixed Format - Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <string.h>
+#include "fixed_fmt.h"
+
+#if FIXED_FMT_BENCHMARK
+#include <stdio.h>
+#include <stm32f1xx_hal.h>
+#include "sensor_json_output.h"
+#endif
+
+/* PRIVATE VARIABLES --------------------------------------------------------*/
+
+static const uint32_t POW10[FIXED_FMT_MAX_DECIMALS + 1] = {1, 10, 100, 1000, 10000};
+
+/* PRIVATE FUNCTIONS --------------------------------------------------------*/
+
+/**
+ * @brief Render an unsigned number into a scratch buffer
+ *
+ * @param value Number
+ * @param base 8, 10 or 16
+ * @param upper true for 'A'-'F' hex digits
+ * @param out Scratch buffer (at least 11 bytes for base 8)
+ *
+ * @return Number of digits written (not terminated)
+ */
+static uint8_t _utoa(uint32_t value, uint32_t base, bool upper, char *out)
+{
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char rev[11];
+    uint8_t n = 0;
+
+    do
+    {
+        rev[n++] = digits[value % base];
+        value /= base;
+    } while (value != 0);
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        out[i] = rev[n - 1 - i];
+    }
+    return n;
+}
+
+/**
+ * @brief Append a character repeatedly
+ *
+ * @param f Cursor
+ * @param c Character
+ * @param count Repetitions
+ */
+static void _fill(fixed_fmt_t *f, char c, uint32_t count)
+{
+    while (count-- > 0)
+    {
+        FixedFmt_Char(f, c);
+    }
+}
+
+/**
+ * @brief Append a rendered field with width, alignment and zero padding
+ *
+ * @param f Cursor
+ * @param s Field text (may start with '-')
+ * @param len Field length
+ * @param width Minimum field width
+ * @param left Left-align in the field
+ * @param zero Pad with zeros after the sign instead of spaces
+ */
+static void _field(fixed_fmt_t *f, const char *s, size_t len, uint32_t width, bool left, bool zero)
+{
+    uint32_t pad = (width > len) ? (uint32_t)(width - len) : 0;
+
+    if (left)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            FixedFmt_Char(f, s[i]);
+        }
+        _fill(f, ' ', pad);
+        return;
+    }
+
+    if (zero && len > 0 && s[0] == '-')
+    {
+        FixedFmt_Char(f, '-');
+        s++;
+        len--;
+    }
+
+    _fill(f, zero ? '0' : ' ', pad);
+    for (size_t i = 0; i < len; i++)
+    {
+        FixedFmt_Char(f, s[i]);
+    }
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Start appending into a buffer
+ */
+void FixedFmt_Init(fixed_fmt_t *f, char *buf, size_t size)
+{
+    f->buf = buf;
+    f->size = size;
+    f->len = 0;
+    f->overflow = (buf == NULL || size == 0);
+
+    if (!f->overflow)
+    {
+        buf[0] = '\0';
+    }
+}
+
+/**
+ * @brief Append a character
+ */
+void FixedFmt_Char(fixed_fmt_t *f, char c)
+{
+    if (f->len + 1 >= f->size)
+    {
+        f->overflow = true;
+        return;
+    }
+    f->buf[f->len++] = c;
+}
+
+/**
+ * @brief Append a string
+ */
+void FixedFmt_Str(fixed_fmt_t *f, const char *s)
+{
+    if (s == NULL)
+    {
+        return;
+    }
+
+    while (*s != '\0')
+    {
+        if (f->len + 1 >= f->size)
+        {
+            f->overflow = true;
+            return;
+        }
+        f->buf[f->len++] = *s++;
+    }
+}
+
+/**
+ * @brief Append an unsigned decimal number
+ */
+void FixedFmt_U32(fixed_fmt_t *f, uint32_t value, uint8_t width)
+{
+    char digits[10];
+    uint8_t n = _utoa(value, 10, false, digits);
+
+    _field(f, digits, n, width, false, true);
+}
+
+/**
+ * @brief Append a signed decimal number
+ */
+void FixedFmt_I32(fixed_fmt_t *f, int32_t value)
+{
+    if (value < 0)
+    {
+        FixedFmt_Char(f, '-');
+        FixedFmt_U32(f, 0u - (uint32_t)value, 0);
+    }
+    else
+    {
+        FixedFmt_U32(f, (uint32_t)value, 0);
+    }
+}
+
+/**
+ * @brief Append a fixed-point number
+ */
+void FixedFmt_Fixed(fixed_fmt_t *f, int32_t value, uint8_t decimals)
+{
+    if (decimals > FIXED_FMT_MAX_DECIMALS)
+    {
+        decimals = FIXED_FMT_MAX_DECIMALS;
+    }
+
+    uint32_t mag = (value < 0) ? 0u - (uint32_t)value : (uint32_t)value;
+    if (value < 0)
+    {
+        FixedFmt_Char(f, '-');
+    }
+
+    FixedFmt_U32(f, mag / POW10[decimals], 0);
+
+    if (decimals > 0)
+    {
+        FixedFmt_Char(f, '.');
+        FixedFmt_U32(f, mag % POW10[decimals], decimals);
+    }
+}
+
+/**
+ * @brief Append a float like printf "%.Nf"
+ */
+void FixedFmt_Float(fixed_fmt_t *f, float value, uint8_t decimals)
+{
+    // The sign comes from the float: values rounding to zero keep it ("-0.00")
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool negative = (bits >> 31) != 0 && value == value; // NaN prints 0
+    int32_t scaled = FixedFmt_FromFloat(negative ? -value : value, decimals);
+
+    if (negative)
+    {
+        FixedFmt_Char(f, '-');
+    }
+    FixedFmt_Fixed(f, scaled, decimals);
+}
+
+/**
+ * @brief Terminate the buffer
+ */
+int FixedFmt_End(fixed_fmt_t *f)
+{
+    if (f->buf == NULL || f->size == 0)
+    {
+        return -1;
+    }
+
+    f->buf[f->len] = '\0';
+    return f->overflow ? -1 : (int)f->len;
+}
+
+/**
+ * @brief Convert a float to a scaled integer, correctly rounded like printf
+ */
+int32_t FixedFmt_FromFloat(float value, uint8_t decimals)
+{
+    if (decimals > FIXED_FMT_MAX_DECIMALS)
+    {
+        decimals = FIXED_FMT_MAX_DECIMALS;
+    }
+
+    // value = mantissa * 2^exponent, scaled exactly in integers
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    bool negative = (bits >> 31) != 0;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF);
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (exponent == 0xFF)
+    {
+        if (mantissa != 0) // NaN
+        {
+            return 0;
+        }
+        return negative ? -INT32_MAX : INT32_MAX;
+    }
+    if (exponent == 0)
+    {
+        exponent = 1; // Subnormal
+    }
+    else
+    {
+        mantissa |= 0x800000;
+    }
+    exponent -= 150; // Bias 127 + 23 fraction bits
+
+    // < 2^24 * 10^4, fits in 38 bits
+    uint64_t product = (uint64_t)mantissa * POW10[decimals];
+    uint64_t result;
+
+    if (exponent >= 0)
+    {
+        // Already >= 2^47 past 24, saturated below anyway
+        result = (exponent > 24) ? UINT64_MAX : product << exponent;
+    }
+    else if (exponent < -40)
+    {
+        result = 0; // product < 2^38: below one half
+    }
+    else
+    {
+        // Round the exact remainder half to even, as printf does
+        uint32_t shift = (uint32_t)-exponent;
+        uint64_t rest = product & ((1ULL << shift) - 1);
+        uint64_t half = 1ULL << (shift - 1);
+
+        result = product >> shift;
+        if (rest > half || (rest == half && (result & 1)))
+        {
+            result++;
+        }
+    }
+
+    if (result > INT32_MAX)
+    {
+        result = INT32_MAX;
+    }
+    return negative ? -(int32_t)result : (int32_t)result;
+}
+
+/**
+ * @brief printf-style formatting without newlib printf
+ */
+int FixedFmt_VFormat(char *buf, size_t size, const char *fmt, va_list args)
+{
+    fixed_fmt_t f;
+    FixedFmt_Init(&f, buf, size);
+
+    if (fmt == NULL)
+    {
+        return FixedFmt_End(&f);
+    }
+
+    while (*fmt != '\0')
+    {
+        if (*fmt != '%')
+        {
+            FixedFmt_Char(&f, *fmt++);
+            continue;
+        }
+        fmt++;
+
+        // Flags
+        bool left = false;
+        bool zero = false;
+        for (;; fmt++)
+        {
+            if (*fmt == '-')
+                left = true;
+            else if (*fmt == '0')
+                zero = true;
+            else
+                break;
+        }
+
+        // Width and precision
+        uint32_t width = 0;
+        while (*fmt >= '0' && *fmt <= '9')
+        {
+            width = width * 10 + (uint32_t)(*fmt++ - '0');
+        }
+
+        int32_t prec = -1;
+        if (*fmt == '.')
+        {
+            fmt++;
+            prec = 0;
+            while (*fmt >= '0' && *fmt <= '9')
+            {
+                prec = prec * 10 + (*fmt++ - '0');
+            }
+        }
+
+        // Length modifiers (long is 32-bit on Cortex-M)
+        bool is_long = false;
+        while (*fmt == 'l' || *fmt == 'h')
+        {
+            is_long |= (*fmt == 'l');
+            fmt++;
+        }
+
+        char tmp[24];
+        uint8_t n = 0;
+
+        switch (*fmt)
+        {
+        case 'd':
+        case 'i':
+        {
+            long v = is_long ? va_arg(args, long) : (long)va_arg(args, int);
+            uint32_t mag = (uint32_t)v;
+            if (v < 0)
+            {
+                tmp[n++] = '-';
+                mag = 0u - mag;
+            }
+            n += _utoa(mag, 10, false, &tmp[n]);
+            _field(&f, tmp, n, width, left, zero);
+            break;
+        }
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+        {
+            uint32_t v = is_long ? (uint32_t)va_arg(args, unsigned long) : (uint32_t)va_arg(args, unsigned int);
+            uint32_t base = (*fmt == 'u') ? 10 : (*fmt == 'o') ? 8 : 16;
+            n = _utoa(v, base, *fmt == 'X', tmp);
+            _field(&f, tmp, n, width, left, zero);
+            break;
+        }
+        case 'f':
+        {
+            uint8_t decimals = (prec < 0 || prec > FIXED_FMT_MAX_DECIMALS)
+                                   ? FIXED_FMT_MAX_DECIMALS
+                                   : (uint8_t)prec;
+            fixed_fmt_t sub;
+            FixedFmt_Init(&sub, tmp, sizeof(tmp));
+            FixedFmt_Float(&sub, (float)va_arg(args, double), decimals);
+            _field(&f, tmp, sub.len, width, left, zero);
+            break;
+        }
+        case 'p':
+            tmp[0] = '0';
+            tmp[1] = 'x';
+            n = 2 + _utoa((uint32_t)(uintptr_t)va_arg(args, void *), 16, false, &tmp[2]);
+            _field(&f, tmp, n, width, left, false);
+            break;
+        case 'c':
+            tmp[0] = (char)va_arg(args, int);
+            _field(&f, tmp, 1, width, left, false);
+            break;
+        case 's':
+        {
+            const char *s = va_arg(args, const char *);
+            if (s == NULL)
+            {
+                s = "(null)";
+            }
+            size_t len = 0;
+            while (s[len] != '\0' && (prec < 0 || len < (size_t)prec))
+            {
+                len++;
+            }
+            _field(&f, s, len, width, left, false);
+            break;
+        }
+        case '%':
+            FixedFmt_Char(&f, '%');
+            break;
+        case '\0':
+            return FixedFmt_End(&f);
+        default:
+            FixedFmt_Char(&f, '%');
+            FixedFmt_Char(&f, *fmt);
+            break;
+        }
+        fmt++;
+    }
+
+    return FixedFmt_End(&f);
+}
+
+/**
+ * @brief printf-style formatting without newlib printf
+ */
+int FixedFmt_Format(char *buf, size_t size, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int len = FixedFmt_VFormat(buf, size, fmt, args);
+    va_end(args);
+    return len;
+}
+
+#if FIXED_FMT_BENCHMARK
+/**
+ * @brief Measure record formatting cost with the DWT cycle counter
+ */
+void FixedFmt_Benchmark(fixed_fmt_bench_t *result)
+{
+    static const char *json_fmt =
+        "{\"mode\":\"%s\",\"timestamp\":%lu,\"temperature\":%.2f,\"humidity\":%.2f}\r\n";
+    char buffer[128];
+    volatile float temperature = 23.47f; // volatile: keep the compiler from folding the conversions
+    volatile float humidity = 61.08f;
+    uint32_t timestamp = 1760700000;
+    uint32_t start;
+
+    if (!result)
+    {
+        return;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    start = DWT->CYCCNT;
+    for (uint32_t i = 0; i < FIXED_FMT_BENCH_RUNS; i++)
+    {
+        snprintf(buffer, sizeof(buffer), json_fmt, "PERIODIC", (unsigned long)(timestamp + i),
+                 temperature, humidity);
+    }
+    result->snprintf_cycles = (DWT->CYCCNT - start) / FIXED_FMT_BENCH_RUNS;
+
+    start = DWT->CYCCNT;
+    for (uint32_t i = 0; i < FIXED_FMT_BENCH_RUNS; i++)
+    {
+        sensor_json_format(buffer, sizeof(buffer), "PERIODIC", temperature, humidity, timestamp + i, 0);
+    }
+    result->fixed_cycles = (DWT->CYCCNT - start) / FIXED_FMT_BENCH_RUNS;
+
+    start = DWT->CYCCNT;
+    for (uint32_t i = 0; i < FIXED_FMT_BENCH_RUNS; i++)
+    {
+        FixedFmt_Format(buffer, sizeof(buffer), json_fmt, "PERIODIC", (unsigned long)(timestamp + i),
+                        temperature, humidity);
+    }
+    result->vformat_cycles = (DWT->CYCCNT - start) / FIXED_FMT_BENCH_RUNS;
+}
+#endif
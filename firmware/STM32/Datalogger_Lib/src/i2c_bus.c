@@ -0,0 +1,658 @@
+/**
+ * @file i2c_bus.c
+ *
+ * @brief I2C Bus - Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <string.h>
+#include "i2c_bus.h"
+#include "print_cli.h"
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Queue slot state
+ */
+typedef enum
+{
+    SLOT_FREE = 0,
+    SLOT_PENDING,
+    SLOT_ACTIVE,
+    SLOT_DONE
+} slot_state_t;
+
+/**
+ * @brief Queue slot
+ */
+typedef struct
+{
+    i2c_bus_xfer_t xfer;
+    i2c_bus_device_t *dev;     // NULL for unregistered addresses
+    volatile slot_state_t state;
+    i2c_bus_prio_t prio;
+    uint32_t seq;              // Submit order within the same priority
+    uint32_t timeout_ms;
+    uint32_t submit_cycles;    // DWT->CYCCNT at submit
+    uint32_t active_tick;      // HAL tick when the transfer was started
+    HAL_StatusTypeDef result;
+} i2c_bus_slot_t;
+
+/* PUBLIC VARIABLES ----------------------------------------------------------*/
+
+DMA_HandleTypeDef hdma_i2c1_tx;
+DMA_HandleTypeDef hdma_i2c1_rx;
+
+/* PRIVATE VARIABLES --------------------------------------------------------*/
+
+static I2C_HandleTypeDef *bus = NULL;
+
+static i2c_bus_slot_t slots[I2C_BUS_QUEUE_SIZE];
+static uint32_t next_seq = 0;
+
+static i2c_bus_device_t devices[I2C_BUS_MAX_DEVICES];
+static uint8_t device_count = 0;
+
+/* Transfer in flight (written by the completion interrupts) */
+static volatile int8_t active_slot = -1;
+static volatile bool xfer_complete = false;
+static volatile HAL_StatusTypeDef xfer_result = HAL_OK;
+static volatile bool need_recovery = false; // Bus or arbitration error seen
+
+static uint32_t rejected = 0;
+static uint32_t recoveries = 0;
+
+/* PRIVATE FUNCTIONS --------------------------------------------------------*/
+
+/**
+ * @brief Busy-wait using the DWT cycle counter
+ *
+ * @param us Microseconds to wait
+ */
+static void _delay_us(uint32_t us)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles = us * (SystemCoreClock / 1000000U);
+
+    while ((DWT->CYCCNT - start) < cycles)
+    {
+    }
+}
+
+/**
+ * @brief Find a registered device by address
+ *
+ * @param address Device address (shifted for HAL)
+ *
+ * @return Pointer to the device entry, NULL if not registered
+ */
+static i2c_bus_device_t *_find_device(uint16_t address)
+{
+    for (uint8_t i = 0; i < device_count; i++)
+    {
+        if (devices[i].address == address)
+        {
+            return &devices[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Enable or disable the I2C1 and DMA interrupts
+ *
+ * @param enable true to enable, false to disable
+ */
+static void _set_irqs(bool enable)
+{
+    const IRQn_Type irqs[] = {I2C1_EV_IRQn, I2C1_ER_IRQn, DMA1_Channel6_IRQn, DMA1_Channel7_IRQn};
+
+    for (uint32_t i = 0; i < sizeof(irqs) / sizeof(irqs[0]); i++)
+    {
+        if (enable)
+        {
+            HAL_NVIC_SetPriority(irqs[i], I2C_BUS_IRQ_PRIORITY, 0);
+            HAL_NVIC_EnableIRQ(irqs[i]);
+        }
+        else
+        {
+            HAL_NVIC_DisableIRQ(irqs[i]);
+        }
+    }
+}
+
+/**
+ * @brief Record the result of a slot and hand it to I2CBus_Process()
+ *
+ * @param slot Slot that finished
+ * @param status Transfer result
+ */
+static void _finish(i2c_bus_slot_t *slot, HAL_StatusTypeDef status)
+{
+    i2c_bus_device_t *dev = slot->dev;
+
+    if (dev)
+    {
+        if (status == HAL_OK)
+        {
+            dev->ok++;
+        }
+        else if (status == HAL_TIMEOUT)
+        {
+            dev->timeouts++;
+        }
+        else
+        {
+            dev->errors++;
+        }
+
+        uint32_t us = (DWT->CYCCNT - slot->submit_cycles) / (SystemCoreClock / 1000000U);
+        if (us > dev->max_us)
+        {
+            dev->max_us = us;
+        }
+    }
+
+    slot->result = status;
+    slot->state = SLOT_DONE;
+}
+
+/**
+ * @brief Start a transaction in interrupt or DMA mode
+ *
+ * @param x Transaction descriptor
+ *
+ * @return HAL status of the start call
+ */
+static HAL_StatusTypeDef _start(i2c_bus_xfer_t *x)
+{
+    bool dma = (x->len >= I2C_BUS_DMA_MIN_LEN);
+
+    switch (x->op)
+    {
+    case I2C_BUS_WRITE:
+        return dma ? HAL_I2C_Master_Transmit_DMA(bus, x->address, x->data, x->len)
+                   : HAL_I2C_Master_Transmit_IT(bus, x->address, x->data, x->len);
+    case I2C_BUS_READ:
+        return dma ? HAL_I2C_Master_Receive_DMA(bus, x->address, x->data, x->len)
+                   : HAL_I2C_Master_Receive_IT(bus, x->address, x->data, x->len);
+    case I2C_BUS_MEM_WRITE:
+        return dma ? HAL_I2C_Mem_Write_DMA(bus, x->address, x->mem_addr, x->mem_size, x->data, x->len)
+                   : HAL_I2C_Mem_Write_IT(bus, x->address, x->mem_addr, x->mem_size, x->data, x->len);
+    case I2C_BUS_MEM_READ:
+        return dma ? HAL_I2C_Mem_Read_DMA(bus, x->address, x->mem_addr, x->mem_size, x->data, x->len)
+                   : HAL_I2C_Mem_Read_IT(bus, x->address, x->mem_addr, x->mem_size, x->data, x->len);
+    default:
+        return HAL_ERROR;
+    }
+}
+
+/**
+ * @brief Start the highest priority pending transaction
+ */
+static void _start_next(void)
+{
+    int8_t best = -1;
+
+    for (int8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++)
+    {
+        if (slots[i].state != SLOT_PENDING)
+        {
+            continue;
+        }
+        if (best < 0 || slots[i].prio < slots[best].prio ||
+            (slots[i].prio == slots[best].prio && (int32_t)(slots[i].seq - slots[best].seq) < 0))
+        {
+            best = i;
+        }
+    }
+
+    if (best < 0)
+    {
+        return;
+    }
+
+    // BUSY set while nothing is in flight: a slave is holding SDA low
+    if (__HAL_I2C_GET_FLAG(bus, I2C_FLAG_BUSY) != RESET)
+    {
+        I2CBus_Recover();
+    }
+
+    i2c_bus_slot_t *slot = &slots[best];
+
+    xfer_complete = false;
+    need_recovery = false;
+    slot->state = SLOT_ACTIVE;
+    slot->active_tick = HAL_GetTick();
+    active_slot = best;
+
+    if (_start(&slot->xfer) != HAL_OK)
+    {
+        active_slot = -1;
+        _finish(slot, HAL_ERROR);
+    }
+}
+
+/**
+ * @brief Report a completion from interrupt context
+ *
+ * @param hi2c I2C handle that completed
+ * @param status Transfer result
+ */
+static void _complete_from_isr(I2C_HandleTypeDef *hi2c, HAL_StatusTypeDef status)
+{
+    if (hi2c != bus || active_slot < 0)
+    {
+        return;
+    }
+
+    xfer_result = status;
+    xfer_complete = true;
+}
+
+/**
+ * @brief Completion callback used by I2CBus_Transfer()
+ */
+static void _sync_done(HAL_StatusTypeDef status, void *ctx)
+{
+    volatile HAL_StatusTypeDef *result = (volatile HAL_StatusTypeDef *)ctx;
+    *result = status;
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize the I2C bus manager
+ */
+void I2CBus_Init(I2C_HandleTypeDef *hi2c)
+{
+    if (!hi2c)
+    {
+        return;
+    }
+
+    bus = hi2c;
+    memset(slots, 0, sizeof(slots));
+    active_slot = -1;
+
+    // DWT cycle counter for recovery timing and latency accounting
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    hdma_i2c1_tx.Instance = DMA1_Channel6;
+    hdma_i2c1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_i2c1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_i2c1_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_i2c1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_i2c1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_i2c1_tx.Init.Mode = DMA_NORMAL;
+    hdma_i2c1_tx.Init.Priority = DMA_PRIORITY_MEDIUM;
+    HAL_DMA_Init(&hdma_i2c1_tx);
+    __HAL_LINKDMA(bus, hdmatx, hdma_i2c1_tx);
+
+    hdma_i2c1_rx.Instance = DMA1_Channel7;
+    hdma_i2c1_rx.Init = hdma_i2c1_tx.Init;
+    hdma_i2c1_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    HAL_DMA_Init(&hdma_i2c1_rx);
+    __HAL_LINKDMA(bus, hdmarx, hdma_i2c1_rx);
+
+    _set_irqs(true);
+
+    // A reset in the middle of a read can leave a slave driving SDA
+    if (HAL_GPIO_ReadPin(I2C_BUS_SDA_PORT, I2C_BUS_SDA_PIN) == GPIO_PIN_RESET ||
+        __HAL_I2C_GET_FLAG(bus, I2C_FLAG_BUSY) != RESET)
+    {
+        I2CBus_Recover();
+    }
+}
+
+/**
+ * @brief Register a device with its priority and timeout
+ */
+bool I2CBus_RegisterDevice(uint16_t address, i2c_bus_prio_t prio, uint32_t timeout_ms)
+{
+    i2c_bus_device_t *dev = _find_device(address);
+
+    if (!dev)
+    {
+        if (device_count >= I2C_BUS_MAX_DEVICES)
+        {
+            return false;
+        }
+        dev = &devices[device_count++];
+        memset(dev, 0, sizeof(i2c_bus_device_t));
+        dev->address = address;
+    }
+
+    dev->prio = prio;
+    dev->timeout_ms = timeout_ms;
+    return true;
+}
+
+/**
+ * @brief Queue a transaction
+ */
+bool I2CBus_Submit(const i2c_bus_xfer_t *xfer)
+{
+    if (!bus || !xfer || !xfer->data || xfer->len == 0)
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++)
+    {
+        i2c_bus_slot_t *slot = &slots[i];
+        if (slot->state != SLOT_FREE)
+        {
+            continue;
+        }
+
+        slot->xfer = *xfer;
+        slot->dev = _find_device(xfer->address);
+        slot->prio = slot->dev ? slot->dev->prio : I2C_BUS_PRIO_NORMAL;
+        slot->timeout_ms = slot->dev ? slot->dev->timeout_ms : I2C_BUS_DEFAULT_TIMEOUT_MS;
+        slot->seq = next_seq++;
+        slot->submit_cycles = DWT->CYCCNT;
+        slot->state = SLOT_PENDING;
+        return true;
+    }
+
+    rejected++;
+    return false;
+}
+
+/**
+ * @brief Run a transaction and wait for it to complete
+ */
+HAL_StatusTypeDef I2CBus_Transfer(const i2c_bus_xfer_t *xfer)
+{
+    // HAL_BUSY marks "not finished yet", the bus only reports OK/ERROR/TIMEOUT
+    volatile HAL_StatusTypeDef result = HAL_BUSY;
+
+    if (!bus || !xfer || !xfer->data || xfer->len == 0)
+    {
+        return HAL_ERROR;
+    }
+
+    i2c_bus_xfer_t x = *xfer;
+    x.done = _sync_done;
+    x.ctx = (void *)&result;
+
+    // Queue full: every queued transfer is bounded by its timeout
+    while (!I2CBus_Submit(&x))
+    {
+        I2CBus_Process();
+    }
+
+    while (result == HAL_BUSY)
+    {
+        I2CBus_Process();
+    }
+
+    return result;
+}
+
+/**
+ * @brief Check whether a device acknowledges its address
+ */
+bool I2CBus_IsDeviceReady(uint16_t address, uint32_t trials)
+{
+    if (!bus)
+    {
+        return false;
+    }
+
+    while (!I2CBus_IsIdle())
+    {
+        I2CBus_Process();
+    }
+
+    if (__HAL_I2C_GET_FLAG(bus, I2C_FLAG_BUSY) != RESET)
+    {
+        I2CBus_Recover();
+    }
+
+    i2c_bus_device_t *dev = _find_device(address);
+    uint32_t timeout = dev ? dev->timeout_ms : I2C_BUS_DEFAULT_TIMEOUT_MS;
+
+    return HAL_I2C_IsDeviceReady(bus, address, trials, timeout) == HAL_OK;
+}
+
+/**
+ * @brief Start queued transactions, check timeouts and report completions
+ */
+void I2CBus_Process(void)
+{
+    if (!bus)
+    {
+        return;
+    }
+
+    int8_t active = active_slot;
+    if (active >= 0)
+    {
+        i2c_bus_slot_t *slot = &slots[active];
+
+        if (xfer_complete)
+        {
+            active_slot = -1;
+            _finish(slot, xfer_result);
+
+            if (need_recovery)
+            {
+                I2CBus_Recover();
+            }
+        }
+        else if ((HAL_GetTick() - slot->active_tick) > slot->timeout_ms)
+        {
+            // Completes the slot with HAL_TIMEOUT
+            I2CBus_Recover();
+        }
+    }
+
+    if (active_slot < 0)
+    {
+        _start_next();
+    }
+
+    // Report completions (slot is freed first so the callback may resubmit)
+    for (uint8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++)
+    {
+        i2c_bus_slot_t *slot = &slots[i];
+        if (slot->state != SLOT_DONE)
+        {
+            continue;
+        }
+
+        i2c_bus_done_t done = slot->xfer.done;
+        void *ctx = slot->xfer.ctx;
+        HAL_StatusTypeDef result = slot->result;
+
+        slot->state = SLOT_FREE;
+
+        if (done)
+        {
+            done(result, ctx);
+        }
+    }
+}
+
+/**
+ * @brief Release a hung bus with 9 SCL clocks and a STOP, then re-initialize I2C
+ */
+void I2CBus_Recover(void)
+{
+    if (!bus)
+    {
+        return;
+    }
+
+    _set_irqs(false);
+
+    int8_t active = active_slot;
+    active_slot = -1;
+    if (active >= 0)
+    {
+        _finish(&slots[active], HAL_TIMEOUT);
+    }
+
+    if (bus->hdmatx)
+    {
+        HAL_DMA_Abort(bus->hdmatx);
+    }
+    if (bus->hdmarx)
+    {
+        HAL_DMA_Abort(bus->hdmarx);
+    }
+
+    // Releases PB6/PB7 and gates the I2C clock (HAL_I2C_MspDeInit)
+    HAL_I2C_DeInit(bus);
+
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Mode = GPIO_MODE_OUTPUT_OD;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+
+    HAL_GPIO_WritePin(I2C_BUS_SCL_PORT, I2C_BUS_SCL_PIN, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(I2C_BUS_SDA_PORT, I2C_BUS_SDA_PIN, GPIO_PIN_SET);
+    gpio.Pin = I2C_BUS_SCL_PIN;
+    HAL_GPIO_Init(I2C_BUS_SCL_PORT, &gpio);
+    gpio.Pin = I2C_BUS_SDA_PIN;
+    HAL_GPIO_Init(I2C_BUS_SDA_PORT, &gpio);
+    _delay_us(I2C_BUS_RECOVERY_HALF_US);
+
+    // Clock out the byte the slave is still sending until it releases SDA
+    for (uint8_t i = 0; i < I2C_BUS_RECOVERY_CLOCKS; i++)
+    {
+        if (HAL_GPIO_ReadPin(I2C_BUS_SDA_PORT, I2C_BUS_SDA_PIN) == GPIO_PIN_SET)
+        {
+            break;
+        }
+        HAL_GPIO_WritePin(I2C_BUS_SCL_PORT, I2C_BUS_SCL_PIN, GPIO_PIN_RESET);
+        _delay_us(I2C_BUS_RECOVERY_HALF_US);
+        HAL_GPIO_WritePin(I2C_BUS_SCL_PORT, I2C_BUS_SCL_PIN, GPIO_PIN_SET);
+        _delay_us(I2C_BUS_RECOVERY_HALF_US);
+    }
+
+    // STOP condition: SDA rises while SCL is high
+    HAL_GPIO_WritePin(I2C_BUS_SCL_PORT, I2C_BUS_SCL_PIN, GPIO_PIN_RESET);
+    _delay_us(I2C_BUS_RECOVERY_HALF_US);
+    HAL_GPIO_WritePin(I2C_BUS_SDA_PORT, I2C_BUS_SDA_PIN, GPIO_PIN_RESET);
+    _delay_us(I2C_BUS_RECOVERY_HALF_US);
+    HAL_GPIO_WritePin(I2C_BUS_SCL_PORT, I2C_BUS_SCL_PIN, GPIO_PIN_SET);
+    _delay_us(I2C_BUS_RECOVERY_HALF_US);
+    HAL_GPIO_WritePin(I2C_BUS_SDA_PORT, I2C_BUS_SDA_PIN, GPIO_PIN_SET);
+    _delay_us(I2C_BUS_RECOVERY_HALF_US);
+
+    // Restores alternate function pins; SWRST clears a stuck BUSY flag (F1 errata)
+    HAL_I2C_Init(bus);
+
+    _set_irqs(true);
+
+    recoveries++;
+    PRINT_CLI("[I2C] Bus recovered (%lu)\r\n", (unsigned long)recoveries);
+}
+
+/**
+ * @brief Check if no transaction is waiting or in flight
+ */
+bool I2CBus_IsIdle(void)
+{
+    for (uint8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++)
+    {
+        if (slots[i].state != SLOT_FREE)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Get bus statistics
+ */
+void I2CBus_GetStats(i2c_bus_stats_t *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+
+    stats->queued = 0;
+    for (uint8_t i = 0; i < I2C_BUS_QUEUE_SIZE; i++)
+    {
+        if (slots[i].state == SLOT_PENDING || slots[i].state == SLOT_ACTIVE)
+        {
+            stats->queued++;
+        }
+    }
+    stats->rejected = rejected;
+    stats->recoveries = recoveries;
+    stats->devices = device_count;
+}
+
+/**
+ * @brief Get accounting of a registered device
+ */
+const i2c_bus_device_t *I2CBus_GetDevice(uint8_t index)
+{
+    if (index >= device_count)
+    {
+        return NULL;
+    }
+    return &devices[index];
+}
+
+/* HAL CALLBACKS -------------------------------------------------------------*/
+
+/**
+ * @brief Master transmit complete (overrides weak HAL definition)
+ */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    _complete_from_isr(hi2c, HAL_OK);
+}
+
+/**
+ * @brief Master receive complete (overrides weak HAL definition)
+ */
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    _complete_from_isr(hi2c, HAL_OK);
+}
+
+/**
+ * @brief Memory write complete (overrides weak HAL definition)
+ */
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    _complete_from_isr(hi2c, HAL_OK);
+}
+
+/**
+ * @brief Memory read complete (overrides weak HAL definition)
+ */
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    _complete_from_isr(hi2c, HAL_OK);
+}
+
+/**
+ * @brief Transfer error (overrides weak HAL definition)
+ *
+ * @details A NACK is a normal answer from an absent or busy device. Bus and
+ *          arbitration errors mean the lines are in an unknown state, so the
+ *          bus is recovered before the next transfer.
+ */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c == bus && (hi2c->ErrorCode & (HAL_I2C_ERROR_BERR | HAL_I2C_ERROR_ARLO | HAL_I2C_ERROR_TIMEOUT)))
+    {
+        need_recovery = true;
+    }
+
+    _complete_from_isr(hi2c, HAL_ERROR);
+}
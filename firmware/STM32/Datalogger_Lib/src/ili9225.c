@@ -75,6 +75,11 @@ static uint16_t dma_buffer[ILI9225_WIDTH * ILI9225_DMA_BUFFER_LINES];
 // Current rotation
 static uint8_t _rotation = ILI9225_ROTATION;
 
+// Hardware scroll area (GRAM gate lines) and offset
+static uint16_t _scroll_first = 0;
+static uint16_t _scroll_last = ILI9225_SCROLL_LINES - 1;
+static uint16_t _scroll_offset = 0;
+
 /* STATIC FUNCTIONS ---------------------------------------------------------*/
 
 /**
@@ -188,6 +193,20 @@ static void ILI9225_SetWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1
     ILI9225_WriteCommand(ILI9225_GRAM_DATA_REG);
 }
 
+/**
+ * @brief Convert a screen line on the scroll axis to a GRAM gate line
+ *
+ * @param line Screen X (landscape) or Y (portrait)
+ *
+ * @return Gate line address (the mapping is its own inverse)
+ *
+ * @note Same mapping as the vertical RAM address in ILI9225_SetWindow()
+ */
+static uint16_t ILI9225_GateLine(uint16_t line)
+{
+    return (_rotation == 1 || _rotation == 2) ? ILI9225_SCROLL_LINES - line - 1 : line;
+}
+
 /**
  * @brief Perform hardware reset of ILI9225
  */
@@ -337,6 +356,27 @@ void ILI9225_DisplayOn(bool on)
     ILI9225_WriteReg(ILI9225_DISP_CTRL1, on ? 0x1017 : 0x0000);
 }
 
+/**
+ * @brief Enter or leave standby mode
+ */
+void ILI9225_Sleep(bool sleep)
+{
+    if (sleep)
+    {
+        ILI9225_WriteReg(ILI9225_DISP_CTRL1, 0x0000);
+        HAL_Delay(20);
+        ILI9225_WriteReg(ILI9225_POWER_CTRL1, 0x0801); // STB = 1
+    }
+    else
+    {
+        ILI9225_WriteReg(ILI9225_POWER_CTRL1, 0x0800); // STB = 0
+        HAL_Delay(50);
+        ILI9225_WriteReg(ILI9225_DISP_CTRL1, 0x0012);
+        HAL_Delay(50);
+        ILI9225_WriteReg(ILI9225_DISP_CTRL1, 0x1017);
+    }
+}
+
 /**
  * @brief Set display brightness (if supported)
  */
@@ -587,6 +627,57 @@ void ILI9225_DrawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uin
     ILI9225_WriteDataBulk((uint8_t *)data, w * h * 2);
 }
 
+/**
+ * @brief Set the hardware scroll area
+ */
+void ILI9225_SetScrollArea(uint16_t first, uint16_t last)
+{
+    uint16_t a = ILI9225_GateLine(first);
+    uint16_t b = ILI9225_GateLine(last);
+
+    _scroll_first = (a < b) ? a : b;
+    _scroll_last = (a < b) ? b : a;
+    _scroll_offset = 0;
+
+    ILI9225_WriteReg(ILI9225_VERTICAL_SCROLL_CTRL1, _scroll_last);  // SEA
+    ILI9225_WriteReg(ILI9225_VERTICAL_SCROLL_CTRL2, _scroll_first); // SSA
+    ILI9225_WriteReg(ILI9225_VERTICAL_SCROLL_CTRL3, 0);             // SST
+}
+
+/**
+ * @brief Scroll the area by one line
+ */
+uint16_t ILI9225_ScrollLine(void)
+{
+    uint16_t lines = _scroll_last - _scroll_first + 1;
+    uint16_t gate;
+
+    // Gate line g is shown at gate position first + (g - first - SST) mod lines
+    if (_rotation == 1 || _rotation == 2)
+    {
+        // Screen end of the area is its first gate line
+        _scroll_offset = (_scroll_offset + lines - 1) % lines;
+        gate = _scroll_first + _scroll_offset;
+    }
+    else
+    {
+        // Screen end of the area is its last gate line
+        gate = _scroll_first + _scroll_offset;
+        _scroll_offset = (_scroll_offset + 1) % lines;
+    }
+
+    ILI9225_WriteReg(ILI9225_VERTICAL_SCROLL_CTRL3, _scroll_offset);
+    return ILI9225_GateLine(gate);
+}
+
+/**
+ * @brief Disable scrolling
+ */
+void ILI9225_ResetScroll(void)
+{
+    ILI9225_SetScrollArea(0, ILI9225_SCROLL_LINES - 1);
+}
+
 #ifdef ILI9225_USE_FONTS
 /**
  * @brief Write character using specified font
@@ -0,0 +1,284 @@
+/**
+ * @file low_power.c
+ *
+ * @brief Low Power - Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <string.h>
+#include <time.h>
+#include "low_power.h"
+#include "ds3231.h"
+#include "ili9225.h"
+
+/* EXTERNAL VARIABLES -------------------------------------------------------*/
+
+/* Clock setup from main.c (PLL is off after STOP) */
+extern void SystemClock_Config(void);
+
+/* PRIVATE VARIABLES --------------------------------------------------------*/
+
+static bool low_power_enabled = false;
+static volatile bool sleeping = false; // Between STOP entry and clock restore
+static volatile bool woke_by_alarm = false;
+static volatile bool woke_by_uart = false;
+static bool sample_pending = false; // Wake happened, sample not yet taken
+static uint32_t wake_cycles = 0;    // DWT->CYCCNT at wake
+static uint32_t awake_since_ms = 0; // HAL tick when last woken (or enabled)
+static low_power_stats_t g_stats = {0};
+
+/* PRIVATE FUNCTIONS --------------------------------------------------------*/
+
+/**
+ * @brief Arm or disarm USART1 RX as a wake source
+ *
+ * @param arm true before STOP, false after wake
+ *
+ * @note On the F1 an input pin can feed the EXTI and the USART at the same
+ *       time, so RX keeps working. The first byte is lost during clock
+ *       start-up.
+ */
+static void _uart_wake_arm(bool arm)
+{
+    if (arm)
+    {
+        GPIO_InitTypeDef gpio = {0};
+        gpio.Pin = LOW_POWER_UART_RX_PIN;
+        gpio.Mode = GPIO_MODE_IT_FALLING;
+        gpio.Pull = GPIO_PULLUP;
+        HAL_GPIO_Init(LOW_POWER_UART_RX_PORT, &gpio);
+
+        __HAL_GPIO_EXTI_CLEAR_IT(LOW_POWER_UART_RX_PIN);
+        HAL_NVIC_EnableIRQ(LOW_POWER_UART_RX_IRQn);
+    }
+    else
+    {
+        HAL_NVIC_DisableIRQ(LOW_POWER_UART_RX_IRQn);
+        CLEAR_BIT(EXTI->IMR, LOW_POWER_UART_RX_PIN);
+        CLEAR_BIT(EXTI->FTSR, LOW_POWER_UART_RX_PIN);
+    }
+}
+
+/**
+ * @brief Program DS3231 alarm 1 for a given second
+ *
+ * @param wake_time Unix second to wake at (the alarm fires on its edge)
+ *
+ * @return true if the alarm is armed, false on I2C error
+ */
+static bool _rtc_alarm_arm(time_t wake_time)
+{
+    struct tm wake;
+
+    localtime_r(&wake_time, &wake);
+
+    // Match date + time so any interval up to a month works
+    if (DS3231_Set_Alarm(&g_ds3231, DS3231_ALARM_1, &wake, DS3231_ALARM1_MATCH_SECMINHOURDATE,
+                         NULL, DS3231_ALARM2_EVERY_MIN) != HAL_OK ||
+        DS3231_Clear_Alarm_Flags(&g_ds3231, DS3231_ALARM_BOTH) != HAL_OK ||
+        DS3231_Enable_Alarm_Ints(&g_ds3231, DS3231_ALARM_1) != HAL_OK)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize low power wake sources
+ */
+void LowPower_Init(void)
+{
+    HAL_NVIC_SetPriority(LOW_POWER_UART_RX_IRQn, 2, 0);
+
+    // DWT cycle counter for wake-to-sample latency
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Enable or disable low power mode
+ */
+void LowPower_SetEnabled(bool enable)
+{
+    if (enable == low_power_enabled)
+    {
+        return;
+    }
+
+    low_power_enabled = enable;
+
+    if (enable)
+    {
+        memset(&g_stats, 0, sizeof(g_stats));
+        awake_since_ms = HAL_GetTick();
+        ILI9225_Sleep(true);
+    }
+    else
+    {
+        DS3231_Disable_Alarm_Ints(&g_ds3231, DS3231_ALARM_1);
+        DS3231_Clear_Alarm_Flags(&g_ds3231, DS3231_ALARM_BOTH);
+        ILI9225_Sleep(false);
+    }
+}
+
+/**
+ * @brief Check if low power mode is enabled
+ */
+bool LowPower_IsEnabled(void)
+{
+    return low_power_enabled;
+}
+
+/**
+ * @brief Enter STOP mode until the DS3231 alarm or UART activity
+ */
+uint32_t LowPower_Sleep(uint32_t sleep_ms)
+{
+    // Phase within the current second, from the square wave edge tracking
+    uint16_t start_ms = 0;
+    time_t start = (time_t)RTCClock_NowMs(&start_ms);
+    uint32_t start_edge_tick = HAL_GetTick() - start_ms; // HAL tick when 'start' began
+
+    // The alarm fires on a second edge: take the last one before the deadline
+    uint32_t seconds = (start_ms + sleep_ms) / 1000;
+
+    if (!low_power_enabled || seconds < LOW_POWER_MIN_SLEEP_S || !_rtc_alarm_arm(start + (time_t)seconds))
+    {
+        return 0;
+    }
+
+    g_stats.awake_ms += HAL_GetTick() - awake_since_ms;
+
+    woke_by_alarm = false;
+    woke_by_uart = false;
+    _uart_wake_arm(true);
+
+    sleeping = true;
+    uint32_t suspend_tick = HAL_GetTick();
+    HAL_SuspendTick();
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+    // Woken up: clocks are on HSI 8 MHz, restore the PLL first
+    wake_cycles = DWT->CYCCNT;
+    SystemClock_Config();
+    HAL_ResumeTick();
+    sleeping = false;
+    _uart_wake_arm(false);
+
+    // Time slept from the RTC (SysTick was stopped, the software clock too).
+    // Wake happened on (alarm) or after (UART) the edge of a known second,
+    // counted from the edge 'start' began on, minus the ticks already counted
+    // between that edge and STOP entry.
+    uint32_t edges = 0;
+    struct tm now;
+    if (woke_by_alarm)
+    {
+        edges = seconds;
+        g_stats.alarm_wakes++;
+    }
+    else if (DS3231_Get_Time(&g_ds3231, &now) == HAL_OK && mktime(&now) > start)
+    {
+        edges = (uint32_t)(mktime(&now) - start);
+        if (edges > seconds)
+        {
+            edges = seconds;
+        }
+    }
+
+    uint32_t slept_ms = 0;
+    uint32_t wake_tick = start_edge_tick + edges * 1000;
+    if ((int32_t)(wake_tick - suspend_tick) > 0)
+    {
+        slept_ms = wake_tick - suspend_tick;
+    }
+
+    if (woke_by_uart)
+    {
+        g_stats.uart_wakes++;
+    }
+
+    // Release INT (alarm flag holds the line low) and stop further alarms
+    DS3231_Clear_Alarm_Flags(&g_ds3231, DS3231_ALARM_BOTH);
+    DS3231_Disable_Alarm_Ints(&g_ds3231, DS3231_ALARM_1);
+
+    // Keep every HAL_GetTick() based schedule consistent with wall time
+    uwTick += slept_ms;
+
+    g_stats.sleeps++;
+    g_stats.sleep_ms += slept_ms;
+    awake_since_ms = HAL_GetTick();
+    sample_pending = true;
+
+    return slept_ms;
+}
+
+/**
+ * @brief Mark that the sample after a wake has been taken
+ */
+void LowPower_MarkSample(void)
+{
+    if (!sample_pending)
+    {
+        return;
+    }
+
+    sample_pending = false;
+
+    uint32_t cycles = DWT->CYCCNT - wake_cycles;
+    g_stats.last_latency_us = cycles / (HAL_RCC_GetHCLKFreq() / 1000000U);
+    if (g_stats.last_latency_us > g_stats.max_latency_us)
+    {
+        g_stats.max_latency_us = g_stats.last_latency_us;
+    }
+}
+
+/**
+ * @brief Get low power statistics
+ */
+void LowPower_GetStats(low_power_stats_t *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+
+    *stats = g_stats;
+
+    if (low_power_enabled)
+    {
+        stats->awake_ms += HAL_GetTick() - awake_since_ms;
+    }
+
+    uint64_t total_ms = stats->sleep_ms + stats->awake_ms;
+    if (total_ms > 0)
+    {
+        stats->avg_current_ua = (uint32_t)((stats->awake_ms * LOW_POWER_RUN_CURRENT_UA +
+                                            stats->sleep_ms * LOW_POWER_STOP_CURRENT_UA) /
+                                           total_ms);
+    }
+}
+
+/**
+ * @brief EXTI handler for wake sources
+ */
+bool LowPower_HandleWake(uint16_t pin)
+{
+    if (!sleeping)
+    {
+        return false;
+    }
+
+    if (pin == LOW_POWER_RTC_INT_PIN)
+    {
+        woke_by_alarm = true;
+    }
+    else if (pin == LOW_POWER_UART_RX_PIN)
+    {
+        woke_by_uart = true;
+    }
+    return true;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file power_monitor.c
+ *
+ * @brief Power Monitor - Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include "power_monitor.h"
+#include "sd_card.h"
+#include "sd_card_manager.h"
+#include "sd_archive.h"
+#include "sd_fat32.h"
+
+/* PRIVATE VARIABLES --------------------------------------------------------*/
+
+static volatile bool power_low = false;
+static volatile bool flush_pending = false; // PVD fired during an SD transaction
+static volatile bool fat_sync_pending = false;
+static volatile uint32_t flush_count = 0;
+
+/* PRIVATE FUNCTIONS --------------------------------------------------------*/
+
+/**
+ * @brief Write buffer and archive metadata to the SD card
+ *
+ * @details Two block writes at most; both are no-ops when nothing is unsaved.
+ *          Records themselves are always written immediately, so metadata is
+ *          the only state held in RAM.
+ */
+static void _emergency_flush(void)
+{
+    SDCardManager_Flush();
+    SDArchive_Flush();
+
+    flush_pending = false;
+    flush_count++;
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize the power monitor
+ */
+void PowerMonitor_Init(void)
+{
+    PWR_PVDTypeDef pvd = {0};
+
+    pvd.PVDLevel = POWER_MONITOR_PVD_LEVEL;
+    pvd.Mode = PWR_PVD_MODE_IT_RISING_FALLING;
+
+    HAL_PWR_ConfigPVD(&pvd);
+    HAL_PWR_EnablePVD();
+
+    HAL_NVIC_SetPriority(PVD_IRQn, POWER_MONITOR_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(PVD_IRQn);
+}
+
+/**
+ * @brief Finish a deferred emergency flush
+ */
+void PowerMonitor_Process(void)
+{
+    if (flush_pending && !SD_IsBusy())
+    {
+        _emergency_flush();
+    }
+
+    if (fat_sync_pending)
+    {
+        fat_sync_pending = false;
+        SDFat32_Sync();
+    }
+}
+
+/**
+ * @brief Check if VDD is currently below the PVD threshold
+ */
+bool PowerMonitor_IsLow(void)
+{
+    return power_low;
+}
+
+/**
+ * @brief Get number of emergency flushes since boot
+ */
+uint32_t PowerMonitor_GetFlushCount(void)
+{
+    return flush_count;
+}
+
+/**
+ * @brief PVD interrupt callback (overrides weak HAL definition)
+ *
+ * @details PVDO is set while VDD is below the threshold, so the same edge
+ *          interrupt reports both the drop and the recovery.
+ */
+void HAL_PWR_PVDCallback(void)
+{
+    power_low = (__HAL_PWR_GET_FLAG(PWR_FLAG_PVDO) != RESET);
+
+    if (!power_low)
+    {
+        return;
+    }
+
+    fat_sync_pending = SDFat32_IsMounted();
+
+    // Never break into an SD transaction, finish it from the main loop instead
+    if (SD_IsBusy())
+    {
+        flush_pending = true;
+        return;
+    }
+
+    _emergency_flush();
+}
@@ -7,8 +7,8 @@
 /* INCLUDES ------------------------------------------------------------------*/
 
 #include <stdarg.h>
-#include <stdio.h>
 #include "print_cli.h"
+#include "fixed_fmt.h"
 
 /* PUBLIC API ----------------------------------------------------------------*/
 
@@ -20,9 +20,12 @@ void PRINT_CLI(char *fmt, ...)
 	char stringBuffer[BUFFER_PRINT];
 	va_list args;
 	va_start(args, fmt);
-	uint8_t len_str = vsprintf(stringBuffer, fmt, args);
+	int len = FixedFmt_VFormat(stringBuffer, BUFFER_PRINT, fmt, args);
 	va_end(args);
 
+	// Truncated output is still sent (previously vsprintf overran the buffer)
+	uint8_t len_str = (len < 0) ? (uint8_t)(BUFFER_PRINT - 1) : (uint8_t)len;
+
 	if (len_str > 0)
 	{
 		HAL_UART_Transmit(&huart1, (uint8_t *)stringBuffer, len_str, 100);
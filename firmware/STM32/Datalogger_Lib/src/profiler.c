@@ -0,0 +1,240 @@
+/**
+ * @file profiler.c
+ *
+ * @brief Profiler - Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <string.h>
+#include "profiler.h"
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Accumulated timing in cycles
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t sum_cycles;
+    uint32_t hist[PROFILER_HIST_BUCKETS];
+} profiler_acc_t;
+
+/* PRIVATE VARIABLES --------------------------------------------------------*/
+
+static const char *const STAGE_NAMES[PROFILER_STAGE_COUNT] = {
+    "UART", "I2C", "FETCH", "ARCHIVE", "SD WRITE", "SD REPLAY", "QUERY", "DISPLAY"};
+
+static profiler_acc_t stages[PROFILER_STAGE_COUNT];
+static profiler_acc_t loop;
+
+static uint32_t cycles_per_us = 64; // Updated from SystemCoreClock in Profiler_Init()
+static uint32_t loop_last_cycles = 0;
+static bool loop_started = false;
+
+static uint32_t sample_last_ms = 0;
+static bool sample_started = false;
+static uint32_t period_count = 0;
+static int32_t period_min_ms = 0;
+static int32_t period_max_ms = 0;
+static int64_t period_sum_ms = 0;
+
+/* PRIVATE FUNCTIONS --------------------------------------------------------*/
+
+/**
+ * @brief Add one duration to an accumulator
+ *
+ * @param acc Accumulator
+ * @param cycles Duration in CPU cycles
+ */
+static void _accumulate(profiler_acc_t *acc, uint32_t cycles)
+{
+    uint32_t us = cycles / cycles_per_us;
+    uint32_t bucket = 0;
+
+    // Bucket = floor(log4(us / 4)): <16, <64, <256 us, ... >=64 ms
+    if (us >= 16)
+    {
+        bucket = (31U - __CLZ(us) - 2U) / 2U;
+        if (bucket >= PROFILER_HIST_BUCKETS)
+        {
+            bucket = PROFILER_HIST_BUCKETS - 1;
+        }
+    }
+    acc->hist[bucket]++;
+
+    if (acc->count == 0 || cycles < acc->min_cycles)
+    {
+        acc->min_cycles = cycles;
+    }
+    if (cycles > acc->max_cycles)
+    {
+        acc->max_cycles = cycles;
+    }
+    acc->sum_cycles += cycles;
+    acc->count++;
+}
+
+/**
+ * @brief Convert an accumulator to microseconds
+ *
+ * @param acc Accumulator
+ * @param timing Output
+ */
+static void _to_timing(const profiler_acc_t *acc, profiler_timing_t *timing)
+{
+    timing->count = acc->count;
+    timing->min_us = acc->min_cycles / cycles_per_us;
+    timing->max_us = acc->max_cycles / cycles_per_us;
+    timing->avg_us = (acc->count > 0) ? (uint32_t)(acc->sum_cycles / acc->count / cycles_per_us) : 0;
+    memcpy(timing->hist, acc->hist, sizeof(timing->hist));
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize the profiler
+ */
+void Profiler_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    cycles_per_us = SystemCoreClock / 1000000U;
+    if (cycles_per_us == 0)
+    {
+        cycles_per_us = 1;
+    }
+
+    Profiler_Reset();
+}
+
+/**
+ * @brief Record a stage duration
+ */
+void Profiler_Record(profiler_stage_t stage, uint32_t cycles)
+{
+    if (stage >= PROFILER_STAGE_COUNT)
+    {
+        return;
+    }
+
+    _accumulate(&stages[stage], cycles);
+}
+
+/**
+ * @brief Mark the top of the main loop
+ */
+void Profiler_LoopMark(bool slept)
+{
+    uint32_t now = DWT->CYCCNT;
+
+    if (loop_started && !slept)
+    {
+        _accumulate(&loop, now - loop_last_cycles);
+    }
+
+    loop_last_cycles = now;
+    loop_started = true;
+}
+
+/**
+ * @brief Record a periodic sample start for sampling period error
+ */
+void Profiler_SampleMark(uint32_t now_ms, uint32_t interval_ms)
+{
+    if (sample_started)
+    {
+        int32_t error_ms = (int32_t)(now_ms - sample_last_ms - interval_ms);
+
+        if (period_count == 0 || error_ms < period_min_ms)
+        {
+            period_min_ms = error_ms;
+        }
+        if (period_count == 0 || error_ms > period_max_ms)
+        {
+            period_max_ms = error_ms;
+        }
+        period_sum_ms += error_ms;
+        period_count++;
+    }
+
+    sample_last_ms = now_ms;
+    sample_started = true;
+}
+
+/**
+ * @brief Forget the sampling period reference
+ */
+void Profiler_SampleReset(void)
+{
+    sample_started = false;
+}
+
+/**
+ * @brief Get stage timing
+ */
+void Profiler_GetStage(profiler_stage_t stage, profiler_timing_t *timing)
+{
+    if (!timing || stage >= PROFILER_STAGE_COUNT)
+    {
+        return;
+    }
+
+    _to_timing(&stages[stage], timing);
+}
+
+/**
+ * @brief Get loop period timing
+ */
+void Profiler_GetLoop(profiler_timing_t *timing)
+{
+    if (!timing)
+    {
+        return;
+    }
+
+    _to_timing(&loop, timing);
+}
+
+/**
+ * @brief Get sampling period error
+ */
+void Profiler_GetPeriod(profiler_period_t *period)
+{
+    if (!period)
+    {
+        return;
+    }
+
+    period->count = period_count;
+    period->min_ms = period_min_ms;
+    period->max_ms = period_max_ms;
+    period->avg_ms = (period_count > 0) ? (int32_t)(period_sum_ms / (int64_t)period_count) : 0;
+}
+
+/**
+ * @brief Get stage name
+ */
+const char *Profiler_StageName(profiler_stage_t stage)
+{
+    return (stage < PROFILER_STAGE_COUNT) ? STAGE_NAMES[stage] : "?";
+}
+
+/**
+ * @brief Clear all statistics
+ */
+void Profiler_Reset(void)
+{
+    memset(stages, 0, sizeof(stages));
+    memset(&loop, 0, sizeof(loop));
+    loop_started = false;
+
+    period_count = 0;
+    period_min_ms = 0;
+    period_max_ms = 0;
+    period_sum_ms = 0;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file rtc_clock.c
+ *
+ * @brief RTC Clock - Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <time.h>
+#include "rtc_clock.h"
+#include "ds3231.h"
+#include "print_cli.h"
+
+/* PRIVATE VARIABLES --------------------------------------------------------*/
+
+/* Updated by the EXTI edge, read with a retry loop (no IRQ masking) */
+static volatile uint32_t clock_seconds = 0; // Unix second started at the last edge
+static volatile uint32_t edge_tick = 0;     // HAL tick of the last edge
+static volatile uint32_t edge_count = 0;    // Incremented on every edge and every set
+
+static bool resync_pending = true;
+static uint32_t last_resync_s = 0;
+static uint32_t corrections = 0;
+
+/* PRIVATE FUNCTIONS --------------------------------------------------------*/
+
+/**
+ * @brief Read the DS3231 as a Unix timestamp
+ *
+ * @param timestamp Pointer to store the result
+ *
+ * @return true if successful, false on I2C error
+ */
+static bool _read_rtc(uint32_t *timestamp)
+{
+    struct tm time;
+
+    if (DS3231_Get_Time(&g_ds3231, &time) != HAL_OK)
+    {
+        return false;
+    }
+
+    *timestamp = (uint32_t)mktime(&time);
+    return true;
+}
+
+/**
+ * @brief Take a consistent snapshot of the edge state
+ *
+ * @param seconds Pointer to store the second started at the last edge
+ * @param tick Pointer to store the HAL tick of the last edge
+ */
+static void _snapshot(uint32_t *seconds, uint32_t *tick)
+{
+    uint32_t count;
+
+    do
+    {
+        count = edge_count;
+        *seconds = clock_seconds;
+        *tick = edge_tick;
+    } while (count != edge_count);
+}
+
+/**
+ * @brief Load a new second count, aligned to now
+ *
+ * @param timestamp Unix second that is currently running
+ */
+static void _load(uint32_t timestamp)
+{
+    __disable_irq();
+    clock_seconds = timestamp;
+    edge_tick = HAL_GetTick();
+    edge_count++;
+    __enable_irq();
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize the clock
+ */
+void RTCClock_Init(void)
+{
+    GPIO_InitTypeDef gpio = {0};
+    uint32_t timestamp = 0;
+
+    if (!_read_rtc(&timestamp))
+    {
+        PRINT_CLI("[RTC] Read FAILED - clock starts at 0\r\n");
+    }
+    _load(timestamp);
+    last_resync_s = timestamp;
+
+    // 1 Hz square wave on INT/SQW (INTCN = 0)
+    DS3231_Set_Squarewave_Freq(&g_ds3231, DS3231_SQWAVE_1HZ);
+    DS3231_Enable_Squarewave(&g_ds3231);
+
+    // Seconds register increments on the falling edge
+    gpio.Pin = RTC_CLOCK_SQW_PIN;
+    gpio.Mode = GPIO_MODE_IT_FALLING;
+    gpio.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(RTC_CLOCK_SQW_PORT, &gpio);
+
+    HAL_NVIC_SetPriority(RTC_CLOCK_SQW_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(RTC_CLOCK_SQW_IRQn);
+
+    // Phase of the first read is unknown, align on the first edge
+    resync_pending = true;
+}
+
+/**
+ * @brief Get current Unix time
+ */
+uint32_t RTCClock_Now(void)
+{
+    return RTCClock_NowMs(NULL);
+}
+
+/**
+ * @brief Get current Unix time with milliseconds
+ */
+uint32_t RTCClock_NowMs(uint16_t *ms)
+{
+    uint32_t seconds;
+    uint32_t tick;
+
+    _snapshot(&seconds, &tick);
+
+    // Normally < 1000; grows past it only if edges stop (free-run on SysTick)
+    uint32_t elapsed = HAL_GetTick() - tick;
+
+    if (ms)
+    {
+        *ms = (uint16_t)(elapsed % 1000);
+    }
+    return seconds + elapsed / 1000;
+}
+
+/**
+ * @brief Set the clock after the RTC was written
+ */
+void RTCClock_Set(uint32_t timestamp)
+{
+    // Writing the seconds register restarts the DS3231 countdown chain
+    _load(timestamp);
+    last_resync_s = timestamp;
+    resync_pending = true;
+}
+
+/**
+ * @brief Re-enable the square wave and resync after low power sleep
+ */
+void RTCClock_Resume(void)
+{
+    DS3231_Enable_Squarewave(&g_ds3231);
+    resync_pending = true;
+}
+
+/**
+ * @brief Periodic resync with the DS3231
+ */
+void RTCClock_Process(void)
+{
+    uint32_t seconds;
+    uint32_t tick;
+
+    _snapshot(&seconds, &tick);
+
+    if (!resync_pending && (seconds - last_resync_s) < RTC_CLOCK_RESYNC_INTERVAL_S)
+    {
+        return;
+    }
+
+    // Read only right after an edge so the next edge cannot fall inside the read.
+    // Without edges (SQW not wired) read any time, the count free-runs anyway.
+    uint32_t age = HAL_GetTick() - tick;
+    if (RTCClock_IsDisciplined() && age >= RTC_CLOCK_RESYNC_WINDOW_MS)
+    {
+        return;
+    }
+
+    uint32_t rtc_now;
+    if (!_read_rtc(&rtc_now))
+    {
+        return;
+    }
+
+    uint32_t local_now = RTCClock_Now();
+    if (rtc_now != local_now)
+    {
+        _load(rtc_now);
+        corrections++;
+        PRINT_CLI("[RTC] Resync: %ld s\r\n", (long)(rtc_now - local_now));
+    }
+
+    last_resync_s = rtc_now;
+    resync_pending = false;
+}
+
+/**
+ * @brief Square wave edge handler
+ */
+void RTCClock_HandleEdge(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    // Normally exactly one second; after a gap (sleep, SQW off) keep the
+    // free-running count instead of losing the missed seconds
+    uint32_t steps = (now - edge_tick + 500) / 1000;
+    if (steps == 0)
+    {
+        steps = 1;
+    }
+
+    clock_seconds += steps;
+    edge_tick = now;
+    edge_count++;
+}
+
+/**
+ * @brief Check if square wave edges are arriving
+ */
+bool RTCClock_IsDisciplined(void)
+{
+    return (HAL_GetTick() - edge_tick) < 1500;
+}
+
+/**
+ * @brief Get number of corrections applied by resync
+ */
+uint32_t RTCClock_GetCorrections(void)
+{
+    return corrections;
+}
@@ -0,0 +1,424 @@
+/**
+ * @file sd_archive.c
+ *
+ * @brief SD Archive - Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <string.h>
+#include "sd_archive.h"
+#include "print_cli.h"
+
+/* PRIVATE VARIABLES --------------------------------------------------------*/
+
+/* Archive state */
+static bool archive_ready = false;
+static sd_archive_metadata_t g_archive_meta = {0};
+static volatile uint32_t archive_unsaved = 0; // Appends since last metadata save
+
+/* Sparse index: first timestamp of each SD_ARCHIVE_INDEX_STRIDE chunk */
+static uint32_t g_archive_index[SD_ARCHIVE_INDEX_ENTRIES] = {0};
+
+/* Query cursor */
+static bool query_active = false;
+static uint32_t query_cursor = 0; // Next logical record to read
+static uint32_t query_from = 0;
+static uint32_t query_to = 0;
+static uint32_t query_sent = 0;
+
+/* PRIVATE FUNCTIONS --------------------------------------------------------*/
+
+/**
+ * @brief Get SD card block address for given logical record
+ *
+ * @param logical Logical record number
+ *
+ * @return SD card block address
+ */
+static uint32_t _get_archive_block_addr(uint32_t logical)
+{
+    return SDCardManager_GetBaseBlock() + SD_ARCHIVE_DATA_START_BLOCK + (logical % SD_ARCHIVE_SIZE);
+}
+
+/**
+ * @brief Get oldest logical record that is still readable
+ *
+ * @details After wrap-around the chunk being overwritten has lost its index
+ *          entry, so the oldest readable record is the next chunk start.
+ *
+ * @return Oldest logical record number
+ */
+static uint32_t _get_oldest(void)
+{
+    if (g_archive_meta.total <= SD_ARCHIVE_SIZE)
+    {
+        return 0;
+    }
+
+    uint32_t oldest = g_archive_meta.total - SD_ARCHIVE_SIZE;
+    return ((oldest + SD_ARCHIVE_INDEX_STRIDE - 1) / SD_ARCHIVE_INDEX_STRIDE) * SD_ARCHIVE_INDEX_STRIDE;
+}
+
+/**
+ * @brief Check if the readable records are in time order
+ *
+ * @details An out-of-order record only breaks the order while its
+ *          predecessor is still readable.
+ *
+ * @return true if records can be seeked with the index
+ */
+static bool _is_ordered(void)
+{
+    return g_archive_meta.unordered <= _get_oldest();
+}
+
+/**
+ * @brief Track time order of a record appended at the given logical number
+ *
+ * @param logical Logical record number
+ * @param timestamp Record timestamp
+ */
+static void _track_order(uint32_t logical, uint32_t timestamp)
+{
+    if (logical > 0 && timestamp < g_archive_meta.last_timestamp)
+    {
+        if (_is_ordered())
+        {
+            PRINT_CLI("[SD] Archive time went back, queries scan the whole archive\r\n");
+        }
+        g_archive_meta.unordered = logical;
+    }
+    g_archive_meta.last_timestamp = timestamp;
+}
+
+/**
+ * @brief Write archive metadata to SD card
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _write_archive_metadata(void)
+{
+    uint8_t buffer[512] = {0};
+    memcpy(buffer, &g_archive_meta, sizeof(sd_archive_metadata_t));
+
+    if (SD_WriteBlock(SDCardManager_GetBaseBlock() + SD_ARCHIVE_META_BLOCK, buffer) != 0)
+    {
+        return false;
+    }
+
+    archive_unsaved = 0;
+    return true;
+}
+
+/**
+ * @brief Write the index block holding the given entry to SD card
+ *
+ * @param slot Index entry slot (0 to SD_ARCHIVE_INDEX_ENTRIES - 1)
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _write_index_block(uint32_t slot)
+{
+    const uint32_t entries_per_block = 512 / sizeof(uint32_t);
+    uint32_t block = slot / entries_per_block;
+
+    return SD_WriteBlock(SDCardManager_GetBaseBlock() + SD_ARCHIVE_INDEX_START_BLOCK + block,
+                         (uint8_t *)&g_archive_index[block * entries_per_block]) == 0;
+}
+
+/**
+ * @brief Recover records appended after the last metadata save
+ *
+ * @details Records carry their logical number in sequence_num, so the tail
+ *          is found by probing forward until the number or check word does
+ *          not match.
+ */
+static void _recover_tail(void)
+{
+    sd_data_record_t record;
+
+    for (uint32_t i = 0; i < SD_ARCHIVE_META_INTERVAL; i++)
+    {
+        uint32_t logical = g_archive_meta.total;
+        if (SD_ReadBlock(_get_archive_block_addr(logical), (uint8_t *)&record) != 0 ||
+            record.sequence_num != logical ||
+            record.check != SD_RECORD_CHECK(record.sequence_num, record.timestamp))
+        {
+            break;
+        }
+        _track_order(logical, record.timestamp);
+        g_archive_meta.total++;
+    }
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Initialize SD Archive
+ */
+bool SDArchive_Init(void)
+{
+    uint8_t buffer[512] = {0};
+
+    archive_ready = false;
+
+    if (!SDCardManager_IsReady() || SD_ReadBlock(SDCardManager_GetBaseBlock() + SD_ARCHIVE_META_BLOCK, buffer) != 0)
+    {
+        PRINT_CLI("[SD] Archive init FAILED\r\n");
+        return false;
+    }
+
+    memcpy(&g_archive_meta, buffer, sizeof(sd_archive_metadata_t));
+
+    if (g_archive_meta.magic != SD_ARCHIVE_MAGIC)
+    {
+        // Format archive region: empty metadata and zeroed index
+        memset(&g_archive_meta, 0, sizeof(sd_archive_metadata_t));
+        memset(g_archive_index, 0, sizeof(g_archive_index));
+        g_archive_meta.magic = SD_ARCHIVE_MAGIC;
+
+        for (uint32_t slot = 0; slot < SD_ARCHIVE_INDEX_ENTRIES; slot += 512 / sizeof(uint32_t))
+        {
+            if (!_write_index_block(slot))
+            {
+                PRINT_CLI("[SD] Archive index write FAILED\r\n");
+                return false;
+            }
+        }
+
+        if (!_write_archive_metadata())
+        {
+            PRINT_CLI("[SD] Archive metadata write FAILED\r\n");
+            return false;
+        }
+        PRINT_CLI("[SD] New archive created\r\n");
+    }
+    else
+    {
+        // Load sparse index into RAM
+        for (uint32_t block = 0; block < SD_ARCHIVE_INDEX_BLOCKS; block++)
+        {
+            uint32_t offset = block * (512 / sizeof(uint32_t));
+            if (SD_ReadBlock(SDCardManager_GetBaseBlock() + SD_ARCHIVE_INDEX_START_BLOCK + block,
+                             (uint8_t *)&g_archive_index[offset]) != 0)
+            {
+                PRINT_CLI("[SD] Archive index read FAILED\r\n");
+                return false;
+            }
+        }
+
+        _recover_tail();
+    }
+
+    archive_ready = true;
+    PRINT_CLI("[SD] Archive ready | Records: %lu/%lu\r\n",
+              (unsigned long)SDArchive_GetCount(), (unsigned long)SD_ARCHIVE_SIZE);
+    return true;
+}
+
+/**
+ * @brief Append a sensor record to the archive
+ */
+bool SDArchive_Append(uint32_t timestamp, float temperature, float humidity, const char *mode_str,
+                      uint32_t suppressed)
+{
+    if (!archive_ready)
+    {
+        return false;
+    }
+
+    uint32_t logical = g_archive_meta.total;
+
+    // Create record (sequence_num holds the logical number for recovery)
+    sd_data_record_t record = {0};
+    record.timestamp = timestamp;
+    record.temperature = temperature;
+    record.humidity = humidity;
+    record.sequence_num = logical;
+    record.suppressed = suppressed;
+    record.check = SD_RECORD_CHECK(logical, timestamp);
+    strncpy(record.mode, mode_str, sizeof(record.mode) - 1);
+
+    if (SD_WriteBlock(_get_archive_block_addr(logical), (uint8_t *)&record) != 0)
+    {
+        PRINT_CLI("[SD] Archive write FAILED\r\n");
+        return false;
+    }
+
+    // First record of a chunk: update and persist its index entry
+    if (logical % SD_ARCHIVE_INDEX_STRIDE == 0)
+    {
+        uint32_t slot = (logical / SD_ARCHIVE_INDEX_STRIDE) % SD_ARCHIVE_INDEX_ENTRIES;
+        g_archive_index[slot] = timestamp;
+        if (!_write_index_block(slot))
+        {
+            PRINT_CLI("[SD] Archive index write FAILED\r\n");
+        }
+    }
+
+    _track_order(logical, timestamp);
+    g_archive_meta.total++;
+
+    // Metadata is saved in batches, the tail is recovered on boot
+    if (++archive_unsaved >= SD_ARCHIVE_META_INTERVAL)
+    {
+        _write_archive_metadata();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Save archive metadata if it has unsaved appends
+ */
+bool SDArchive_Flush(void)
+{
+    if (!archive_ready || archive_unsaved == 0)
+    {
+        return true;
+    }
+
+    return _write_archive_metadata();
+}
+
+/**
+ * @brief Start a time range query
+ */
+bool SDArchive_StartQuery(uint32_t from, uint32_t to)
+{
+    if (!archive_ready || from > to)
+    {
+        return false;
+    }
+
+    uint32_t oldest = _get_oldest();
+
+    query_from = from;
+    query_to = to;
+    query_sent = 0;
+    query_cursor = oldest;
+    query_active = (g_archive_meta.total > oldest);
+
+    // Out of order: scan everything from the oldest record
+    if (!query_active || !_is_ordered())
+    {
+        return true;
+    }
+
+    // Binary search for the last chunk starting at or before 'from'
+    uint32_t lo = oldest / SD_ARCHIVE_INDEX_STRIDE;
+    uint32_t hi = (g_archive_meta.total - 1) / SD_ARCHIVE_INDEX_STRIDE;
+    uint32_t start = lo;
+
+    while (lo <= hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (g_archive_index[mid % SD_ARCHIVE_INDEX_ENTRIES] <= from)
+        {
+            start = mid;
+            lo = mid + 1;
+        }
+        else
+        {
+            if (mid == 0)
+            {
+                break;
+            }
+            hi = mid - 1;
+        }
+    }
+
+    if (start * SD_ARCHIVE_INDEX_STRIDE > oldest)
+    {
+        query_cursor = start * SD_ARCHIVE_INDEX_STRIDE;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Fetch next record of the active query
+ */
+bool SDArchive_QueryNext(sd_data_record_t *record)
+{
+    if (!query_active || !record)
+    {
+        return false;
+    }
+
+    for (uint32_t scanned = 0; scanned < SD_ARCHIVE_QUERY_SCAN_MAX; scanned++)
+    {
+        // Skip records overwritten since the query started
+        uint32_t oldest = _get_oldest();
+        if (query_cursor < oldest)
+        {
+            query_cursor = oldest;
+        }
+
+        if (query_cursor >= g_archive_meta.total)
+        {
+            break;
+        }
+
+        if (SD_ReadBlock(_get_archive_block_addr(query_cursor), (uint8_t *)record) != 0)
+        {
+            PRINT_CLI("[SD] Archive read FAILED\r\n");
+            break;
+        }
+        query_cursor++;
+
+        // In time order nothing newer than 'to' can follow
+        if (_is_ordered() && record->timestamp > query_to)
+        {
+            break;
+        }
+
+        if (record->timestamp >= query_from && record->timestamp <= query_to)
+        {
+            query_sent++;
+            return true;
+        }
+
+        if (scanned == SD_ARCHIVE_QUERY_SCAN_MAX - 1)
+        {
+            return false; // Keep scanning on next call
+        }
+    }
+
+    query_active = false;
+    PRINT_CLI("[SD] Query done: %lu records\r\n", (unsigned long)query_sent);
+    return false;
+}
+
+/**
+ * @brief Abort the active query
+ */
+void SDArchive_StopQuery(void)
+{
+    query_active = false;
+}
+
+/**
+ * @brief Check if a query is in progress
+ */
+bool SDArchive_IsQueryActive(void)
+{
+    return query_active;
+}
+
+/**
+ * @brief Get number of records currently held in the archive
+ */
+uint32_t SDArchive_GetCount(void)
+{
+    return g_archive_meta.total - _get_oldest();
+}
+
+/**
+ * @brief Check if SD Archive is initialized
+ */
+bool SDArchive_IsReady(void)
+{
+    return archive_ready;
+}
@@ -13,6 +13,7 @@
 
 static uint8_t SD_Type = SD_TYPE_UNKNOWN;
 static SPI_HandleTypeDef *g_hspi = NULL; /* Global SPI handle */
+static volatile uint8_t SD_Busy = 0;      /* CS asserted - transaction in progress */
 
 /* PRIVATE VARIABLES --------------------------------------------------------*/
 
@@ -60,6 +61,7 @@ static uint8_t SD_SendCommandRaw(uint8_t cmd, uint32_t arg, uint8_t crc)
 void SD_GPIO_Init(void)
 {
     HAL_GPIO_WritePin(SD_CS_PORT, SD_CS_PIN, GPIO_PIN_SET);
+    SD_Busy = 0;
 }
 
 /**
@@ -112,6 +114,7 @@ void SD_SetSpeedHigh(void)
 void SD_CS_High(void)
 {
     HAL_GPIO_WritePin(SD_CS_PORT, SD_CS_PIN, GPIO_PIN_SET);
+    SD_Busy = 0;
 }
 
 /**
@@ -119,6 +122,7 @@ void SD_CS_High(void)
  */
 void SD_CS_Low(void)
 {
+    SD_Busy = 1;
     HAL_GPIO_WritePin(SD_CS_PORT, SD_CS_PIN, GPIO_PIN_RESET);
 }
 
@@ -472,6 +476,117 @@ uint8_t SD_WriteBlock(uint32_t block_addr, uint8_t *buffer)
     return 0;
 }
 
+/**
+ * @brief Write consecutive blocks to SD card
+ */
+uint8_t SD_WriteMultiBlock(uint32_t block_addr, uint8_t *buffer, uint32_t count)
+{
+    uint16_t i, retry;
+    uint8_t r1, response;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    if (count == 1)
+    {
+        return SD_WriteBlock(block_addr, buffer);
+    }
+
+    if (SD_Type != SD_TYPE_SDHC)
+    {
+        block_addr <<= 9;
+    }
+
+    /* Send CMD25 (WRITE_MULTIPLE_BLOCK) and keep CS LOW for entire operation */
+    SD_CS_Low();
+    SD_SPI_ReadWrite(0xFF); // Dummy byte before command
+
+    r1 = SD_SendCommandRaw(CMD25, block_addr, 0);
+    if (r1 != R1_READY)
+    {
+        SD_SPI_ReadWrite(0xFF);
+        SD_CS_High();
+        return 1; /* Command failed */
+    }
+
+    SD_SPI_ReadWrite(0xFF);
+
+    while (count--)
+    {
+        /* Send multi-block data token (CS still LOW) */
+        SD_SPI_ReadWrite(0xFC);
+
+        for (i = 0; i < SD_BLOCK_SIZE; i++)
+        {
+            SD_SPI_ReadWrite(buffer[i]);
+        }
+        buffer += SD_BLOCK_SIZE;
+
+        /* Send dummy CRC (2 bytes) */
+        SD_SPI_ReadWrite(0xFF);
+        SD_SPI_ReadWrite(0xFF);
+
+        /* Read data response token (should be 0x05 = accepted) */
+        retry = 0;
+        response = SD_SPI_ReadWrite(0xFF);
+        while (response == 0xFF && retry++ < 100)
+        {
+            response = SD_SPI_ReadWrite(0xFF);
+        }
+
+        if ((response & 0x1F) != 0x05)
+        {
+            /* Terminate the transfer before reporting the error */
+            SD_SPI_ReadWrite(0xFD);
+            SD_SPI_ReadWrite(0xFF);
+            SD_CS_High();
+            return 2; /* Write rejected - data response token error */
+        }
+
+        /* Wait for the card to program this block */
+        retry = 0;
+        while (SD_SPI_ReadWrite(0xFF) == 0x00)
+        {
+            if (retry++ > 50000)
+            {
+                SD_CS_High();
+                return 3; /* Timeout waiting for write to complete */
+            }
+        }
+    }
+
+    /* Send stop transmission token and wait until the card is idle */
+    SD_SPI_ReadWrite(0xFD);
+    SD_SPI_ReadWrite(0xFF);
+
+    retry = 0;
+    while (SD_SPI_ReadWrite(0xFF) == 0x00)
+    {
+        if (retry++ > 50000)
+        {
+            SD_CS_High();
+            return 3; /* Timeout waiting for stop to complete */
+        }
+    }
+
+    /* Deselect card after write complete */
+    SD_SPI_ReadWrite(0xFF);
+    SD_CS_High();
+    SD_SPI_ReadWrite(0xFF);
+
+    return 0;
+}
+
+/**
+ * @brief Check if an SD transaction is in progress
+ */
+uint8_t SD_IsBusy(void)
+{
+    return SD_Busy;
+}
+
 /**
  * @brief Get SD card type
  */
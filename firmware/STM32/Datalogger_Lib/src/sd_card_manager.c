@@ -8,6 +8,8 @@
 
 #include <string.h>
 #include "sd_card_manager.h"
+#include "sd_archive.h"
+#include "sd_fat32.h"
 #include "print_cli.h"
 
 /* EXTERNAL VARIABLES -------------------------------------------------------*/
@@ -21,6 +23,8 @@ extern SPI_HandleTypeDef hspi1;
 static bool sd_initialized = false;
 static sd_buffer_metadata_t g_metadata = {0};
 static uint8_t sd_last_error = 0;
+static uint32_t sd_base_block = 0; // First block of the raw region (0 = whole card)
+static volatile uint32_t meta_unsaved = 0; // Buffer operations since last metadata save
 
 /* PRIVATE FUNCTIONS --------------------------------------------------------*/
 
@@ -32,7 +36,7 @@ static uint8_t sd_last_error = 0;
 static bool _read_metadata(void)
 {
     uint8_t buffer[512] = {0};
-    uint8_t ret = SD_ReadBlock(SD_DATA_BLOCK, buffer);
+    uint8_t ret = SD_ReadBlock(sd_base_block + SD_DATA_BLOCK, buffer);
     if (ret != 0)
     {
         sd_last_error = ret;
@@ -53,13 +57,28 @@ static bool _write_metadata(void)
     uint8_t buffer[512] = {0};
     memcpy(buffer, &g_metadata, sizeof(sd_buffer_metadata_t));
 
-    uint8_t ret = SD_WriteBlock(SD_DATA_BLOCK, buffer);
+    uint8_t ret = SD_WriteBlock(sd_base_block + SD_DATA_BLOCK, buffer);
     if (ret != 0)
     {
         sd_last_error = ret;
         return false;
     }
 
+    meta_unsaved = 0;
+    return true;
+}
+
+/**
+ * @brief Count a buffer operation and save metadata when the batch is full
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _mark_metadata_dirty(void)
+{
+    if (++meta_unsaved >= SD_META_SAVE_INTERVAL || g_metadata.count == 0)
+    {
+        return _write_metadata();
+    }
     return true;
 }
 
@@ -72,7 +91,47 @@ static bool _write_metadata(void)
  */
 static uint32_t _get_data_block_addr(uint32_t index)
 {
-    return SD_DATA_START_BLOCK + (index % SD_BUFFER_SIZE);
+    return sd_base_block + SD_DATA_START_BLOCK + (index % SD_BUFFER_SIZE);
+}
+
+/**
+ * @brief Recover records written after the last metadata save
+ *
+ * @details Metadata is saved in batches, so up to SD_META_SAVE_INTERVAL
+ *          records may be on the card but missing from the metadata. They
+ *          are found by probing forward from write_index for the expected
+ *          sequence number and a valid check word.
+ *
+ * @return Number of recovered records
+ */
+static uint32_t _recover_tail(void)
+{
+    sd_data_record_t record;
+    uint32_t recovered = 0;
+
+    for (uint32_t i = 0; i < SD_META_SAVE_INTERVAL; i++)
+    {
+        if (SD_ReadBlock(_get_data_block_addr(g_metadata.write_index), (uint8_t *)&record) != 0 ||
+            record.sequence_num != g_metadata.sequence_num ||
+            record.check != SD_RECORD_CHECK(record.sequence_num, record.timestamp))
+        {
+            break;
+        }
+
+        if (g_metadata.count >= SD_BUFFER_SIZE)
+        {
+            g_metadata.read_index = (g_metadata.read_index + 1) % SD_BUFFER_SIZE;
+        }
+        else
+        {
+            g_metadata.count++;
+        }
+        g_metadata.write_index = (g_metadata.write_index + 1) % SD_BUFFER_SIZE;
+        g_metadata.sequence_num++;
+        recovered++;
+    }
+
+    return recovered;
 }
 
 /* PUBLIC API ----------------------------------------------------------------*/
@@ -94,6 +153,17 @@ bool SDCardManager_Init(void)
         return false;
     }
 
+#if SD_FAT32_ENABLE
+    // Keep the card readable on a PC: raw blocks live inside a contiguous file
+    if (!SDFat32_Mount() ||
+        !SDFat32_OpenRegion(SD_FAT32_REGION_NAME, SD_RAW_REGION_BLOCKS, &sd_base_block))
+    {
+        sd_initialized = false;
+        PRINT_CLI("[SD] FAT32 region FAILED - format the card as FAT32\r\n");
+        return false;
+    }
+#endif
+
     // Try to load existing metadata from SD card
     if (!_read_metadata())
     {
@@ -115,6 +185,13 @@ bool SDCardManager_Init(void)
     }
     else
     {
+        uint32_t recovered = _recover_tail();
+        if (recovered > 0)
+        {
+            PRINT_CLI("[SD] Recovered %lu unsaved records\r\n", (unsigned long)recovered);
+            _write_metadata();
+        }
+
         // Warn if buffer is full
         if (g_metadata.count >= SD_BUFFER_SIZE)
         {
@@ -132,7 +209,8 @@ bool SDCardManager_Init(void)
 /**
  * @brief Write sensor data to SD card buffer
  */
-bool SDCardManager_WriteData(uint32_t timestamp, float temperature, float humidity, const char *mode_str)
+bool SDCardManager_WriteData(uint32_t timestamp, float temperature, float humidity, const char *mode_str,
+                             uint32_t suppressed)
 {
     if (!sd_initialized)
     {
@@ -145,8 +223,11 @@ bool SDCardManager_WriteData(uint32_t timestamp, float temperature, float humidi
     {
         PRINT_CLI("[SD] Buffer FULL - overwriting oldest\r\n");
         // Move read pointer forward to discard oldest record
+        // (IRQs off: the PVD flush must never see half-updated metadata)
+        __disable_irq();
         g_metadata.read_index = (g_metadata.read_index + 1) % SD_BUFFER_SIZE;
         g_metadata.count--; // Decrease count to make room for new record
+        __enable_irq();
     }
 
     // Create record
@@ -154,7 +235,9 @@ bool SDCardManager_WriteData(uint32_t timestamp, float temperature, float humidi
     record.timestamp = timestamp;
     record.temperature = temperature;
     record.humidity = humidity;
-    record.sequence_num = g_metadata.sequence_num++;
+    record.sequence_num = g_metadata.sequence_num;
+    record.suppressed = suppressed;
+    record.check = SD_RECORD_CHECK(record.sequence_num, timestamp);
     strncpy(record.mode, mode_str, sizeof(record.mode) - 1);
 
     // Get block address for this record
@@ -170,11 +253,14 @@ bool SDCardManager_WriteData(uint32_t timestamp, float temperature, float humidi
     }
 
     // Update metadata
+    __disable_irq();
     g_metadata.write_index = (g_metadata.write_index + 1) % SD_BUFFER_SIZE;
     g_metadata.count++;
+    g_metadata.sequence_num++;
+    __enable_irq();
 
-    // Save metadata
-    if (!_write_metadata())
+    // Save metadata in batches, the tail is recovered on boot
+    if (!_mark_metadata_dirty())
     {
         PRINT_CLI("[SD] Metadata save FAILED (err=%d)\r\n", sd_last_error);
         return false;
@@ -237,13 +323,14 @@ bool SDCardManager_RemoveRecord(void)
         return false;
 
     // Update metadata IN RAM ONLY (defer SD write for performance)
+    __disable_irq();
     g_metadata.read_index = (g_metadata.read_index + 1) % SD_BUFFER_SIZE;
     g_metadata.count--;
+    __enable_irq();
 
-    // Save metadata to SD card
-    // NOTE: This writes metadata after EVERY record removal
-    // For better performance, could batch updates, but trades off crash recovery
-    return _write_metadata();
+    // Save metadata in batches (and as soon as the buffer is empty)
+    // Removals lost on power failure only cause records to be sent twice
+    return _mark_metadata_dirty();
 }
 
 /**
@@ -254,16 +341,30 @@ bool SDCardManager_ClearBuffer(void)
     if (!sd_initialized)
         return false;
 
-    // Reset metadata
+    // Reset metadata (sequence_num keeps counting so old records are never recovered)
+    __disable_irq();
     g_metadata.write_index = 0;
     g_metadata.read_index = 0;
     g_metadata.count = 0;
-    g_metadata.sequence_num = 0;
+    __enable_irq();
 
     // Save metadata
     return _write_metadata();
 }
 
+/**
+ * @brief Save buffer metadata if it has unsaved changes
+ */
+bool SDCardManager_Flush(void)
+{
+    if (!sd_initialized || meta_unsaved == 0)
+    {
+        return true;
+    }
+
+    return _write_metadata();
+}
+
 /**
  * @brief Check if SD Card Manager is initialized
  */
@@ -272,6 +373,14 @@ bool SDCardManager_IsReady(void)
     return sd_initialized;
 }
 
+/**
+ * @brief Get first block of the raw region
+ */
+uint32_t SDCardManager_GetBaseBlock(void)
+{
+    return sd_base_block;
+}
+
 /**
  * @brief Get last SD card error code
  */
@@ -0,0 +1,975 @@
+/**
+ * @file sd_fat32.c
+ *
+ * @brief SD FAT32 - Implementation
+ */
+
+/* INCLUDES ------------------------------------------------------------------*/
+
+#include <string.h>
+#include <time.h>
+#include "sd_fat32.h"
+#include "sd_card.h"
+#include "fixed_fmt.h"
+#include "print_cli.h"
+
+/* DEFINES -------------------------------------------------------------------*/
+
+#define FAT32_EOC 0x0FFFFFFF      // End of cluster chain marker
+#define FAT32_EOC_MIN 0x0FFFFFF8  // Any value >= this ends a chain
+#define FAT32_ENTRY_MASK 0x0FFFFFFF
+#define FAT32_ENTRIES_PER_BLOCK (SD_BLOCK_SIZE / 4)
+#define FAT32_DIR_ENTRY_SIZE 32
+#define FAT32_ATTR_ARCHIVE 0x20
+#define FAT32_FSINFO_LEAD_SIG 0x41615252
+#define FAT32_FSINFO_STRUC_SIG 0x61417272
+#define FAT32_LOG_BUFFER_SIZE (SD_FAT32_LOG_BUFFER_BLOCKS * SD_BLOCK_SIZE)
+
+/* TYPEDEFS ------------------------------------------------------------------*/
+
+/**
+ * @brief Mounted volume geometry
+ */
+typedef struct
+{
+    uint32_t fat_lba;        // First block of FAT #1
+    uint32_t data_lba;       // First block of cluster 2
+    uint32_t fsinfo_lba;     // FSInfo block
+    uint32_t fat_size;       // Blocks per FAT
+    uint32_t root_cluster;   // First cluster of root directory
+    uint32_t total_clusters; // Data clusters on the volume
+    uint32_t free_count;     // FSInfo free cluster count (0xFFFFFFFF = unknown)
+    uint32_t next_free;      // FSInfo next free cluster hint
+    uint8_t num_fats;        // Number of FAT copies
+    uint8_t sec_per_clus;    // Blocks per cluster
+} fat32_volume_t;
+
+/**
+ * @brief Open per-day log file
+ */
+typedef struct
+{
+    bool open;              // File is open
+    char name[11];          // 8.3 name without dot
+    uint32_t first_cluster; // First cluster (0 = no data yet)
+    uint32_t size;          // Logical file size in bytes
+    uint32_t dir_lba;       // Block holding the directory entry
+    uint16_t dir_offset;    // Offset of the entry inside that block
+    uint32_t run_first;     // First cluster of the current contiguous run
+    uint32_t run_clusters;  // Clusters in the current run
+    uint32_t run_offset;    // File offset of the current run start
+    uint32_t run_link;      // Cluster linking to run_first (0 = none)
+    uint32_t unsynced;      // Records since last sync
+    uint32_t last_write;    // Timestamp of the last record (directory write time)
+} fat32_log_t;
+
+/* PRIVATE VARIABLES ---------------------------------------------------------*/
+
+static bool fat_mounted = false;
+static fat32_volume_t g_vol = {0};
+static fat32_log_t g_log = {0};
+
+/* One-block FAT cache, written back lazily to batch FAT updates */
+static uint8_t g_fat_cache[SD_BLOCK_SIZE];
+static uint32_t fat_cache_lba = 0xFFFFFFFF;
+static bool fat_cache_dirty = false;
+static bool fsinfo_dirty = false;
+
+/* Staging buffer for the log file, starts at a block-aligned file offset */
+static uint8_t g_log_buffer[FAT32_LOG_BUFFER_SIZE];
+static uint32_t log_buffer_offset = 0; // File offset of g_log_buffer[0]
+static uint32_t log_buffer_fill = 0;   // Bytes staged
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+/**
+ * @brief Read little-endian 16-bit value
+ */
+static uint16_t _rd16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief Read little-endian 32-bit value
+ */
+static uint32_t _rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Write little-endian 16-bit value
+ */
+static void _wr16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+/**
+ * @brief Write little-endian 32-bit value
+ */
+static void _wr32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief Get first block of a cluster
+ */
+static uint32_t _cluster_to_lba(uint32_t cluster)
+{
+    return g_vol.data_lba + (cluster - 2) * g_vol.sec_per_clus;
+}
+
+/**
+ * @brief Write cached FAT block to every FAT copy
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _fat_flush(void)
+{
+    if (!fat_cache_dirty)
+    {
+        return true;
+    }
+
+    for (uint8_t i = 0; i < g_vol.num_fats; i++)
+    {
+        if (SD_WriteBlock(fat_cache_lba + i * g_vol.fat_size, g_fat_cache) != 0)
+        {
+            return false;
+        }
+    }
+
+    fat_cache_dirty = false;
+    return true;
+}
+
+/**
+ * @brief Load the FAT block holding a cluster entry into the cache
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _fat_load(uint32_t cluster)
+{
+    uint32_t lba = g_vol.fat_lba + cluster / FAT32_ENTRIES_PER_BLOCK;
+
+    if (lba == fat_cache_lba)
+    {
+        return true;
+    }
+
+    if (!_fat_flush() || SD_ReadBlock(lba, g_fat_cache) != 0)
+    {
+        fat_cache_lba = 0xFFFFFFFF;
+        return false;
+    }
+
+    fat_cache_lba = lba;
+    return true;
+}
+
+/**
+ * @brief Get FAT entry of a cluster
+ *
+ * @return Next cluster, FAT32_EOC on end of chain or read error
+ */
+static uint32_t _fat_get(uint32_t cluster)
+{
+    if (!_fat_load(cluster))
+    {
+        return FAT32_EOC;
+    }
+
+    return _rd32(&g_fat_cache[(cluster % FAT32_ENTRIES_PER_BLOCK) * 4]) & FAT32_ENTRY_MASK;
+}
+
+/**
+ * @brief Set FAT entry of a cluster (upper 4 reserved bits preserved)
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _fat_set(uint32_t cluster, uint32_t value)
+{
+    if (!_fat_load(cluster))
+    {
+        return false;
+    }
+
+    uint8_t *entry = &g_fat_cache[(cluster % FAT32_ENTRIES_PER_BLOCK) * 4];
+    _wr32(entry, (_rd32(entry) & ~FAT32_ENTRY_MASK) | (value & FAT32_ENTRY_MASK));
+    fat_cache_dirty = true;
+    return true;
+}
+
+/**
+ * @brief Write FSInfo free count and next free hint
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _fsinfo_write(void)
+{
+    uint8_t buffer[SD_BLOCK_SIZE];
+
+    if (!fsinfo_dirty)
+    {
+        return true;
+    }
+
+    if (SD_ReadBlock(g_vol.fsinfo_lba, buffer) != 0)
+    {
+        return false;
+    }
+
+    _wr32(&buffer[488], g_vol.free_count);
+    _wr32(&buffer[492], g_vol.next_free);
+
+    if (SD_WriteBlock(g_vol.fsinfo_lba, buffer) != 0)
+    {
+        return false;
+    }
+
+    fsinfo_dirty = false;
+    return true;
+}
+
+/**
+ * @brief Allocate a contiguous run of free clusters and chain it
+ *
+ * @param count Number of clusters
+ * @param first Pointer to store the first allocated cluster
+ *
+ * @return true if successful, false if no contiguous run is free
+ */
+static bool _alloc_run(uint32_t count, uint32_t *first)
+{
+    uint32_t last_cluster = g_vol.total_clusters + 1;
+    uint32_t start = (g_vol.next_free >= 2 && g_vol.next_free <= last_cluster) ? g_vol.next_free : 2;
+    uint32_t run_start = 0;
+    uint32_t run_len = 0;
+    uint32_t cluster = start;
+
+    // Scan from the hint, wrap once to the beginning of the FAT
+    for (uint32_t scanned = 0; scanned < g_vol.total_clusters; scanned++)
+    {
+        if (cluster > last_cluster)
+        {
+            cluster = 2;
+            run_len = 0; // A run cannot wrap around the end of the volume
+        }
+
+        if (_fat_get(cluster) == 0)
+        {
+            if (run_len == 0)
+            {
+                run_start = cluster;
+            }
+            if (++run_len == count)
+            {
+                break;
+            }
+        }
+        else
+        {
+            run_len = 0;
+        }
+        cluster++;
+    }
+
+    if (run_len < count)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t next = (i + 1 < count) ? run_start + i + 1 : FAT32_EOC;
+        if (!_fat_set(run_start + i, next))
+        {
+            return false;
+        }
+    }
+
+    if (g_vol.free_count != 0xFFFFFFFF)
+    {
+        g_vol.free_count -= count;
+    }
+    g_vol.next_free = run_start + count;
+    fsinfo_dirty = true;
+
+    *first = run_start;
+    return true;
+}
+
+/**
+ * @brief Convert Unix timestamp to FAT date and time
+ */
+static void _fat_datetime(uint32_t timestamp, uint16_t *date, uint16_t *time_of_day)
+{
+    time_t t = (time_t)timestamp;
+    struct tm *tm = localtime(&t);
+
+    if (tm == NULL || tm->tm_year < 80)
+    {
+        *date = (1 << 5) | 1; // 1980-01-01
+        *time_of_day = 0;
+        return;
+    }
+
+    *date = (uint16_t)(((tm->tm_year - 80) << 9) | ((tm->tm_mon + 1) << 5) | tm->tm_mday);
+    *time_of_day = (uint16_t)((tm->tm_hour << 11) | (tm->tm_min << 5) | (tm->tm_sec / 2));
+}
+
+/**
+ * @brief Find a root directory entry, optionally reserving a free slot
+ *
+ * @param name83 11-character 8.3 name
+ * @param create Reserve a free slot if the name is not found
+ * @param dir_lba Pointer to store the entry block
+ * @param dir_offset Pointer to store the entry offset
+ * @param entry Buffer for the 32-byte entry (filled if found)
+ *
+ * @return 1 if found, 0 if a free slot was reserved, -1 on error
+ */
+static int _dir_find(const char *name83, bool create, uint32_t *dir_lba, uint16_t *dir_offset, uint8_t *entry)
+{
+    uint8_t buffer[SD_BLOCK_SIZE];
+    uint32_t cluster = g_vol.root_cluster;
+    uint32_t prev_cluster = 0;
+    bool have_free = false;
+
+    while (cluster >= 2 && cluster < FAT32_EOC_MIN)
+    {
+        for (uint8_t s = 0; s < g_vol.sec_per_clus; s++)
+        {
+            uint32_t lba = _cluster_to_lba(cluster) + s;
+            if (SD_ReadBlock(lba, buffer) != 0)
+            {
+                return -1;
+            }
+
+            for (uint16_t off = 0; off < SD_BLOCK_SIZE; off += FAT32_DIR_ENTRY_SIZE)
+            {
+                uint8_t first = buffer[off];
+
+                if (first == 0x00 || first == 0xE5)
+                {
+                    if (!have_free)
+                    {
+                        have_free = true;
+                        *dir_lba = lba;
+                        *dir_offset = off;
+                    }
+                    if (first == 0x00)
+                    {
+                        return create ? 0 : -1; // End of directory
+                    }
+                    continue;
+                }
+
+                if (memcmp(&buffer[off], name83, 11) == 0)
+                {
+                    *dir_lba = lba;
+                    *dir_offset = off;
+                    memcpy(entry, &buffer[off], FAT32_DIR_ENTRY_SIZE);
+                    return 1;
+                }
+            }
+        }
+
+        prev_cluster = cluster;
+        cluster = _fat_get(cluster);
+    }
+
+    if (!create)
+    {
+        return -1;
+    }
+
+    if (have_free)
+    {
+        return 0;
+    }
+
+    // Root directory is full: extend it by one zeroed cluster
+    uint32_t new_cluster;
+    if (!_alloc_run(1, &new_cluster) || !_fat_set(prev_cluster, new_cluster))
+    {
+        return -1;
+    }
+
+    memset(buffer, 0, sizeof(buffer));
+    for (uint8_t s = 0; s < g_vol.sec_per_clus; s++)
+    {
+        if (SD_WriteBlock(_cluster_to_lba(new_cluster) + s, buffer) != 0)
+        {
+            return -1;
+        }
+    }
+
+    *dir_lba = _cluster_to_lba(new_cluster);
+    *dir_offset = 0;
+    return 0;
+}
+
+/**
+ * @brief Write a directory entry
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _dir_write(uint32_t dir_lba, uint16_t dir_offset, const char *name83,
+                       uint32_t first_cluster, uint32_t size, uint32_t timestamp, bool create)
+{
+    uint8_t buffer[SD_BLOCK_SIZE];
+    uint16_t date, time_of_day;
+
+    if (SD_ReadBlock(dir_lba, buffer) != 0)
+    {
+        return false;
+    }
+
+    uint8_t *entry = &buffer[dir_offset];
+    _fat_datetime(timestamp, &date, &time_of_day);
+
+    if (create)
+    {
+        memset(entry, 0, FAT32_DIR_ENTRY_SIZE);
+        memcpy(entry, name83, 11);
+        entry[11] = FAT32_ATTR_ARCHIVE;
+        _wr16(&entry[14], time_of_day); // Creation time
+        _wr16(&entry[16], date);        // Creation date
+    }
+
+    _wr16(&entry[18], date);                           // Last access date
+    _wr16(&entry[20], (uint16_t)(first_cluster >> 16)); // First cluster high
+    _wr16(&entry[22], time_of_day);                    // Write time
+    _wr16(&entry[24], date);                           // Write date
+    _wr16(&entry[26], (uint16_t)first_cluster);        // First cluster low
+    _wr32(&entry[28], size);
+
+    return SD_WriteBlock(dir_lba, buffer) == 0;
+}
+
+/**
+ * @brief Allocate the next preallocated run for the log file
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _log_extend(void)
+{
+    uint32_t first;
+
+    if (!_alloc_run(SD_FAT32_PREALLOC_CLUSTERS, &first))
+    {
+        PRINT_CLI("[FAT] No contiguous space left\r\n");
+        return false;
+    }
+
+    if (g_log.run_clusters == 0)
+    {
+        g_log.first_cluster = first; // First data of the file
+        g_log.run_link = 0;
+    }
+    else
+    {
+        uint32_t last = g_log.run_first + g_log.run_clusters - 1;
+        if (!_fat_set(last, first))
+        {
+            return false;
+        }
+        g_log.run_link = last;
+        g_log.run_offset += g_log.run_clusters * g_vol.sec_per_clus * SD_BLOCK_SIZE;
+    }
+
+    g_log.run_first = first;
+    g_log.run_clusters = SD_FAT32_PREALLOC_CLUSTERS;
+    return true;
+}
+
+/**
+ * @brief Write staged log blocks to the card
+ *
+ * @param partial Also write the incomplete last block
+ *
+ * @return true if successful, false otherwise
+ *
+ * @details Complete blocks are dropped from the buffer afterwards, so the
+ *          buffer always starts at the block holding the end of file.
+ */
+static bool _log_flush(bool partial)
+{
+    uint32_t full_blocks = log_buffer_fill / SD_BLOCK_SIZE;
+    uint32_t blocks = full_blocks + ((partial && (log_buffer_fill % SD_BLOCK_SIZE)) ? 1 : 0);
+    uint32_t done = 0;
+
+    while (done < blocks)
+    {
+        uint32_t offset = log_buffer_offset + done * SD_BLOCK_SIZE;
+        uint32_t run_bytes = g_log.run_clusters * g_vol.sec_per_clus * SD_BLOCK_SIZE;
+
+        if (g_log.run_clusters == 0 || offset >= g_log.run_offset + run_bytes)
+        {
+            if (!_log_extend())
+            {
+                return false;
+            }
+            continue;
+        }
+
+        // Write as many blocks as fit in the current contiguous run
+        uint32_t in_run = (g_log.run_offset + run_bytes - offset) / SD_BLOCK_SIZE;
+        uint32_t count = (blocks - done < in_run) ? (blocks - done) : in_run;
+        uint32_t lba = _cluster_to_lba(g_log.run_first) + (offset - g_log.run_offset) / SD_BLOCK_SIZE;
+
+        if (SD_WriteMultiBlock(lba, &g_log_buffer[done * SD_BLOCK_SIZE], count) != 0)
+        {
+            return false;
+        }
+        done += count;
+    }
+
+    uint32_t remainder = log_buffer_fill % SD_BLOCK_SIZE;
+    if (full_blocks > 0)
+    {
+        memmove(g_log_buffer, &g_log_buffer[full_blocks * SD_BLOCK_SIZE], remainder);
+        log_buffer_offset += full_blocks * SD_BLOCK_SIZE;
+        log_buffer_fill = remainder;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Append bytes to the log file
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _log_append(const char *data, uint32_t len)
+{
+    while (len > 0)
+    {
+        uint32_t space = FAT32_LOG_BUFFER_SIZE - log_buffer_fill;
+        uint32_t chunk = (len < space) ? len : space;
+
+        memcpy(&g_log_buffer[log_buffer_fill], data, chunk);
+        log_buffer_fill += chunk;
+        g_log.size += chunk;
+        data += chunk;
+        len -= chunk;
+
+        if (log_buffer_fill == FAT32_LOG_BUFFER_SIZE && !_log_flush(false))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Flush log data, directory entry, FAT and FSInfo
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _log_sync(uint32_t timestamp)
+{
+    if (!_log_flush(true))
+    {
+        return false;
+    }
+
+    if (!_dir_write(g_log.dir_lba, g_log.dir_offset, g_log.name,
+                    g_log.first_cluster, g_log.size, timestamp, false))
+    {
+        return false;
+    }
+
+    g_log.unsynced = 0;
+    return _fat_flush() && _fsinfo_write();
+}
+
+/**
+ * @brief Close the log file and release unused preallocated clusters
+ */
+static void _log_close(uint32_t timestamp)
+{
+    if (!g_log.open)
+    {
+        return;
+    }
+
+    if (g_log.run_clusters > 0)
+    {
+        uint32_t cluster_bytes = g_vol.sec_per_clus * SD_BLOCK_SIZE;
+        uint32_t used = (g_log.size > g_log.run_offset)
+                            ? (g_log.size - g_log.run_offset + cluster_bytes - 1) / cluster_bytes
+                            : 0;
+
+        if (used < g_log.run_clusters)
+        {
+            // Terminate the chain at the last used cluster, free the rest
+            if (used > 0)
+            {
+                _fat_set(g_log.run_first + used - 1, FAT32_EOC);
+            }
+            else if (g_log.run_link != 0)
+            {
+                _fat_set(g_log.run_link, FAT32_EOC);
+            }
+            else
+            {
+                g_log.first_cluster = 0; // Empty file owns no clusters
+            }
+
+            for (uint32_t c = used; c < g_log.run_clusters; c++)
+            {
+                _fat_set(g_log.run_first + c, 0);
+            }
+
+            if (g_vol.free_count != 0xFFFFFFFF)
+            {
+                g_vol.free_count += g_log.run_clusters - used;
+            }
+            if (g_log.run_first + used < g_vol.next_free)
+            {
+                g_vol.next_free = g_log.run_first + used;
+            }
+            g_log.run_clusters = used;
+            fsinfo_dirty = true;
+        }
+    }
+
+    _log_sync(timestamp);
+    g_log.open = false;
+}
+
+/**
+ * @brief Open (or create) the log file of the day containing timestamp
+ *
+ * @return true if successful, false otherwise
+ */
+static bool _log_open(uint32_t timestamp)
+{
+    char name[12];
+    time_t t = (time_t)timestamp;
+    struct tm *tm = localtime(&t);
+
+    if (tm == NULL)
+    {
+        return false;
+    }
+
+    fixed_fmt_t out;
+    FixedFmt_Init(&out, name, sizeof(name));
+    FixedFmt_U32(&out, (uint32_t)(tm->tm_year + 1900), 4);
+    FixedFmt_U32(&out, (uint32_t)(tm->tm_mon + 1), 2);
+    FixedFmt_U32(&out, (uint32_t)tm->tm_mday, 2);
+    FixedFmt_Str(&out, "CSV");
+    FixedFmt_End(&out);
+
+    if (g_log.open && memcmp(g_log.name, name, 11) == 0)
+    {
+        return true;
+    }
+
+    _log_close(timestamp);
+
+    memset(&g_log, 0, sizeof(g_log));
+    memcpy(g_log.name, name, 11);
+
+    uint8_t entry[FAT32_DIR_ENTRY_SIZE];
+    int found = _dir_find(name, true, &g_log.dir_lba, &g_log.dir_offset, entry);
+    if (found < 0)
+    {
+        return false;
+    }
+
+    if (found == 0)
+    {
+        // New day: empty entry, clusters are preallocated on first write
+        if (!_dir_write(g_log.dir_lba, g_log.dir_offset, name, 0, 0, timestamp, true))
+        {
+            return false;
+        }
+        log_buffer_offset = 0;
+        log_buffer_fill = 0;
+        g_log.open = true;
+
+        static const char header[] = "timestamp,mode,temperature,humidity,suppressed\r\n";
+        return _log_append(header, sizeof(header) - 1);
+    }
+
+    // Existing file (reboot during the day): seek to its end
+    uint32_t cluster_bytes = g_vol.sec_per_clus * SD_BLOCK_SIZE;
+    g_log.first_cluster = ((uint32_t)_rd16(&entry[20]) << 16) | _rd16(&entry[26]);
+    g_log.size = _rd32(&entry[28]);
+
+    if (g_log.first_cluster >= 2)
+    {
+        uint32_t index = g_log.size / cluster_bytes;
+        uint32_t cluster = g_log.first_cluster;
+        uint32_t prev = 0;
+
+        for (uint32_t i = 0; i < index && cluster < FAT32_EOC_MIN; i++)
+        {
+            prev = cluster;
+            cluster = _fat_get(cluster);
+        }
+
+        if (cluster < FAT32_EOC_MIN)
+        {
+            // Current run = contiguous clusters from the end-of-file cluster
+            uint32_t count = 1;
+            uint32_t next = _fat_get(cluster);
+            while (next == cluster + count)
+            {
+                count++;
+                next = _fat_get(next);
+            }
+            g_log.run_first = cluster;
+            g_log.run_clusters = count;
+            g_log.run_offset = index * cluster_bytes;
+            g_log.run_link = prev;
+        }
+        else
+        {
+            // File ends exactly on a cluster boundary: next write extends from prev
+            g_log.run_first = prev;
+            g_log.run_clusters = 1;
+            g_log.run_offset = (index - 1) * cluster_bytes;
+        }
+    }
+    else
+    {
+        g_log.size = 0; // No clusters: treat as empty
+    }
+
+    // Reload the partial end-of-file block into the staging buffer
+    log_buffer_offset = g_log.size - (g_log.size % SD_BLOCK_SIZE);
+    log_buffer_fill = g_log.size % SD_BLOCK_SIZE;
+    if (log_buffer_fill > 0)
+    {
+        uint32_t lba = _cluster_to_lba(g_log.run_first) + (log_buffer_offset - g_log.run_offset) / SD_BLOCK_SIZE;
+        if (SD_ReadBlock(lba, g_log_buffer) != 0)
+        {
+            return false;
+        }
+    }
+
+    g_log.open = true;
+    return true;
+}
+
+/* PUBLIC API ----------------------------------------------------------------*/
+
+/**
+ * @brief Mount the FAT32 volume
+ */
+bool SDFat32_Mount(void)
+{
+    uint8_t buffer[SD_BLOCK_SIZE];
+    uint32_t part_lba = 0;
+
+    fat_mounted = false;
+    fat_cache_lba = 0xFFFFFFFF;
+    fat_cache_dirty = false;
+    memset(&g_log, 0, sizeof(g_log));
+
+    if (SD_ReadBlock(0, buffer) != 0 || buffer[510] != 0x55 || buffer[511] != 0xAA)
+    {
+        PRINT_CLI("[FAT] No boot signature\r\n");
+        return false;
+    }
+
+    // Block 0 is either an MBR or the boot sector of a partitionless volume
+    if (memcmp(&buffer[82], "FAT32   ", 8) != 0)
+    {
+        uint8_t type = buffer[446 + 4];
+        if (type != 0x0B && type != 0x0C)
+        {
+            PRINT_CLI("[FAT] No FAT32 partition (type=0x%02X)\r\n", type);
+            return false;
+        }
+
+        part_lba = _rd32(&buffer[446 + 8]);
+        if (SD_ReadBlock(part_lba, buffer) != 0 || buffer[510] != 0x55 || buffer[511] != 0xAA)
+        {
+            PRINT_CLI("[FAT] Boot sector read FAILED\r\n");
+            return false;
+        }
+    }
+
+    if (_rd16(&buffer[11]) != SD_BLOCK_SIZE || buffer[13] == 0 || _rd32(&buffer[36]) == 0)
+    {
+        PRINT_CLI("[FAT] Unsupported volume\r\n");
+        return false;
+    }
+
+    uint16_t reserved = _rd16(&buffer[14]);
+    uint32_t total_blocks = _rd32(&buffer[32]);
+
+    g_vol.sec_per_clus = buffer[13];
+    g_vol.num_fats = buffer[16];
+    g_vol.fat_size = _rd32(&buffer[36]);
+    g_vol.root_cluster = _rd32(&buffer[44]);
+    g_vol.fsinfo_lba = part_lba + _rd16(&buffer[48]);
+    g_vol.fat_lba = part_lba + reserved;
+    g_vol.data_lba = g_vol.fat_lba + g_vol.num_fats * g_vol.fat_size;
+    g_vol.total_clusters = (total_blocks - reserved - g_vol.num_fats * g_vol.fat_size) / g_vol.sec_per_clus;
+
+    // FSInfo gives the free count and a hint where to start allocating
+    g_vol.free_count = 0xFFFFFFFF;
+    g_vol.next_free = 2;
+    if (SD_ReadBlock(g_vol.fsinfo_lba, buffer) == 0 &&
+        _rd32(&buffer[0]) == FAT32_FSINFO_LEAD_SIG &&
+        _rd32(&buffer[484]) == FAT32_FSINFO_STRUC_SIG)
+    {
+        g_vol.free_count = _rd32(&buffer[488]);
+        g_vol.next_free = _rd32(&buffer[492]);
+    }
+    fsinfo_dirty = false;
+
+    fat_mounted = true;
+    PRINT_CLI("[FAT] Mounted | Cluster: %u B | Clusters: %lu\r\n",
+              (unsigned)(g_vol.sec_per_clus * SD_BLOCK_SIZE), (unsigned long)g_vol.total_clusters);
+    return true;
+}
+
+/**
+ * @brief Open or create a contiguous region file
+ */
+bool SDFat32_OpenRegion(const char *name83, uint32_t blocks, uint32_t *first_block)
+{
+    uint8_t entry[FAT32_DIR_ENTRY_SIZE];
+    uint32_t dir_lba;
+    uint16_t dir_offset;
+    uint32_t clusters = (blocks + g_vol.sec_per_clus - 1) / g_vol.sec_per_clus;
+
+    if (!fat_mounted || !first_block)
+    {
+        return false;
+    }
+
+    int found = _dir_find(name83, true, &dir_lba, &dir_offset, entry);
+    if (found < 0)
+    {
+        return false;
+    }
+
+    if (found == 1)
+    {
+        uint32_t first = ((uint32_t)_rd16(&entry[20]) << 16) | _rd16(&entry[26]);
+
+        // Raw block I/O is only safe if the whole file is one contiguous run
+        uint32_t cluster = first;
+        for (uint32_t i = 1; i < clusters; i++)
+        {
+            uint32_t next = _fat_get(cluster);
+            if (next != cluster + 1)
+            {
+                PRINT_CLI("[FAT] %.11s is fragmented\r\n", name83);
+                return false;
+            }
+            cluster = next;
+        }
+
+        *first_block = _cluster_to_lba(first);
+        return true;
+    }
+
+    uint32_t first;
+    if (!_alloc_run(clusters, &first))
+    {
+        PRINT_CLI("[FAT] No contiguous space for %.11s\r\n", name83);
+        return false;
+    }
+
+    if (!_fat_flush() || !_fsinfo_write() ||
+        !_dir_write(dir_lba, dir_offset, name83, first, blocks * SD_BLOCK_SIZE, 0, true))
+    {
+        return false;
+    }
+
+    PRINT_CLI("[FAT] Created %.11s (%lu blocks)\r\n", name83, (unsigned long)blocks);
+    *first_block = _cluster_to_lba(first);
+    return true;
+}
+
+/**
+ * @brief Append a sensor record to the per-day CSV file
+ */
+bool SDFat32_LogRecord(uint32_t timestamp, float temperature, float humidity, const char *mode_str,
+                       uint32_t suppressed)
+{
+    char line[64];
+
+    if (!fat_mounted || !_log_open(timestamp))
+    {
+        return false;
+    }
+
+    fixed_fmt_t out;
+    FixedFmt_Init(&out, line, sizeof(line));
+    FixedFmt_U32(&out, timestamp, 0);
+    FixedFmt_Char(&out, ',');
+    FixedFmt_Str(&out, mode_str);
+    FixedFmt_Char(&out, ',');
+    FixedFmt_Float(&out, temperature, 2);
+    FixedFmt_Char(&out, ',');
+    FixedFmt_Float(&out, humidity, 2);
+    FixedFmt_Char(&out, ',');
+    FixedFmt_U32(&out, suppressed, 0);
+    FixedFmt_Str(&out, "\r\n");
+
+    int len = FixedFmt_End(&out);
+    if (len < 0)
+    {
+        return false;
+    }
+
+    g_log.last_write = timestamp;
+    if (!_log_append(line, (uint32_t)len))
+    {
+        PRINT_CLI("[FAT] Log write FAILED\r\n");
+        return false;
+    }
+
+    // Directory size, FAT and FSInfo are only written every few records
+    if (++g_log.unsynced >= SD_FAT32_SYNC_INTERVAL)
+    {
+        return _log_sync(timestamp);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Write staged data, directory entry, FAT and FSInfo to the card
+ */
+bool SDFat32_Sync(void)
+{
+    if (!fat_mounted)
+    {
+        return false;
+    }
+
+    if (!g_log.open)
+    {
+        return _fat_flush() && _fsinfo_write();
+    }
+
+    return _log_sync(g_log.last_write);
+}
+
+/**
+ * @brief Check if the FAT32 volume is mounted
+ */
+bool SDFat32_IsMounted(void)
+{
+    return fat_mounted;
+}
@@ -6,40 +6,72 @@
 
 /* INCLUDES ------------------------------------------------------------------*/
 
+#include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <string.h>
-#include <time.h>
 #include "sensor_json_output.h"
+#include "fixed_fmt.h"
 #include "print_cli.h"
-#include "ds3231.h"
+#include "rtc_clock.h"
 
 /* DEFINES -------------------------------------------------------------------*/
 
 #define JSON_BUFFER_SIZE 128
 #define ERROR_JSON "{\"error\":\"buffer_overflow\"}\r\n"
 
-/* PRIVATE FUNCTION PROTOTYPES -----------------------------------------------*/
-
-static time_t get_unix_timestamp(void);
-
 /* PRIVATE FUNCTIONS ---------------------------------------------------------*/
 
 /**
- * @brief Retrieves the current Unix timestamp from the DS3231 RTC
- *
- * @return time_t The current Unix timestamp, or 0 on error
+ * @brief Formats one report, optionally tagged with its SD buffer sequence number
  */
-static time_t get_unix_timestamp(void)
+static int _format(char *buffer, size_t buffer_size,
+                   const char *mode, float temperature, float humidity,
+                   uint32_t timestamp, uint32_t suppressed,
+                   bool has_seq, uint32_t sequence_num)
 {
-    struct tm time;
+    if (buffer == NULL || buffer_size == 0)
+    {
+        return -1;
+    }
 
-    if (DS3231_Get_Time(&g_ds3231, &time) == HAL_OK)
+    // If timestamp is 0, get it from RTC
+    if (timestamp == 0)
     {
-        return mktime(&time);
+        timestamp = RTCClock_Now();
     }
 
-    return 0; // Return 0 on error
+    // Format JSON string with strict format (no spaces, single line, \r\n at end)
+    // Values are appended as centi-units, no printf or float formatting
+    fixed_fmt_t out;
+    FixedFmt_Init(&out, buffer, buffer_size);
+
+    FixedFmt_Str(&out, "{\"mode\":\"");
+    FixedFmt_Str(&out, mode);
+    FixedFmt_Str(&out, "\",\"timestamp\":");
+    FixedFmt_U32(&out, timestamp, 0);
+    FixedFmt_Str(&out, ",\"temperature\":");
+    FixedFmt_Float(&out, temperature, 2);
+    FixedFmt_Str(&out, ",\"humidity\":");
+    FixedFmt_Float(&out, humidity, 2);
+
+    if (suppressed != 0)
+    {
+        // Deadband reporting: tell the receiver how many samples were skipped
+        FixedFmt_Str(&out, ",\"suppressed\":");
+        FixedFmt_U32(&out, suppressed, 0);
+    }
+
+    if (has_seq)
+    {
+        // Backlog replay: the gateway routes on this field, the ingest side keys on it
+        FixedFmt_Str(&out, ",\"seq\":");
+        FixedFmt_U32(&out, sequence_num, 0);
+    }
+
+    FixedFmt_Str(&out, "}\r\n");
+
+    // -1 on buffer overflow
+    return FixedFmt_End(&out);
 }
 
 /* PUBLIC API ----------------------------------------------------------------*/
@@ -49,46 +81,35 @@ static time_t get_unix_timestamp(void)
  */
 int sensor_json_format(char *buffer, size_t buffer_size,
                        const char *mode, float temperature, float humidity,
-                       uint32_t timestamp)
+                       uint32_t timestamp, uint32_t suppressed)
 {
-    if (buffer == NULL || buffer_size == 0)
-    {
-        return -1;
-    }
-
-    // If timestamp is 0, get it from RTC
-    if (timestamp == 0)
-    {
-        timestamp = (uint32_t)get_unix_timestamp();
-    }
-
-    // Format JSON string with strict format (no spaces, single line, \r\n at end)
-    int written = snprintf(buffer, buffer_size,
-                           "{\"mode\":\"%s\",\"timestamp\":%lu,\"temperature\":%.2f,\"humidity\":%.2f}\r\n",
-                           mode,
-                           (unsigned long)timestamp,
-                           temperature,
-                           humidity);
-
-    // Check for buffer overflow
-    if (written < 0 || written >= (int)buffer_size)
-    {
-        return -1; // Buffer overflow
-    }
+    return _format(buffer, buffer_size, mode, temperature, humidity,
+                   timestamp, suppressed, false, 0);
+}
 
-    return written;
+/**
+ * @brief Formats a record replayed from the SD buffer into a JSON string
+ */
+int sensor_json_format_backlog(char *buffer, size_t buffer_size,
+                               const char *mode, float temperature, float humidity,
+                               uint32_t timestamp, uint32_t suppressed,
+                               uint32_t sequence_num)
+{
+    return _format(buffer, buffer_size, mode, temperature, humidity,
+                   timestamp, suppressed, true, sequence_num);
 }
 
 /**
  * @brief Formats sensor data into a JSON string and prints it via UART
  */
-void sensor_json_output_send(const char *mode, float temperature, float humidity)
+void sensor_json_output_send(const char *mode, float temperature, float humidity,
+                             uint32_t suppressed)
 {
     static char json_buffer[JSON_BUFFER_SIZE];
 
     // Use the new format function
     int written = sensor_json_format(json_buffer, JSON_BUFFER_SIZE,
-                                     mode, temperature, humidity, 0);
+                                     mode, temperature, humidity, 0, suppressed);
 
     // Check for errors
     if (written < 0)
@@ -8,6 +8,7 @@
 
 #include <assert.h>
 #include "sht3x.h"
+#include "i2c_bus.h"
 #include "print_cli.h"
 
 /* DEFINES -------------------------------------------------------------------*/
@@ -149,10 +150,11 @@ static HAL_StatusTypeDef SHT3X_Send_Command(const sht3x_t *dev, uint16_t command
 
 	uint8_t command_buffer[2] = {(uint8_t)((command >> 8) & 0xFF), (uint8_t)(command & 0xFF)};
 
-	if (HAL_I2C_Master_Transmit(dev->hi2c,
-								(uint16_t)(dev->device_address),		// 7-bit addr
-								command_buffer, sizeof(command_buffer), // 2 bytes
-								SHT3X_I2C_TIMEOUT) != HAL_OK)
+	i2c_bus_xfer_t xfer = {.address = (uint16_t)(dev->device_address), // 7-bit addr
+						   .op = I2C_BUS_WRITE,
+						   .data = command_buffer, .len = sizeof(command_buffer)}; // 2 bytes
+
+	if (I2CBus_Transfer(&xfer) != HAL_OK)
 	{
 		return HAL_ERROR;
 	}
@@ -211,12 +213,13 @@ static SHT3X_StatusTypeDef SHT3X_ReadStatus(sht3x_t *dev, uint16_t *state_word)
 
 	uint8_t read_buffer[3]; // [0]=MSB, [1]=LSB, [2]=CRC
 
-	if (HAL_I2C_Mem_Read(dev->hi2c,
-						 (uint16_t)(dev->device_address), // 7-bit addr
-						 SHT3X_COMMAND_READ_STATUS,		  // 0xF32D
-						 I2C_MEMADD_SIZE_16BIT,			  // send [MSB:LSB]
-						 read_buffer, sizeof(read_buffer),
-						 SHT3X_I2C_TIMEOUT) != HAL_OK)
+	i2c_bus_xfer_t xfer = {.address = (uint16_t)(dev->device_address), // 7-bit addr
+						   .op = I2C_BUS_MEM_READ,
+						   .mem_addr = SHT3X_COMMAND_READ_STATUS, // 0xF32D
+						   .mem_size = I2C_MEMADD_SIZE_16BIT,	  // send [MSB:LSB]
+						   .data = read_buffer, .len = sizeof(read_buffer)};
+
+	if (I2CBus_Transfer(&xfer) != HAL_OK)
 	{
 		return SHT3X_ERROR;
 	}
@@ -231,6 +234,20 @@ static SHT3X_StatusTypeDef SHT3X_ReadStatus(sht3x_t *dev, uint16_t *state_word)
 	return SHT3X_OK;
 }
 
+/**
+ * @brief I2C bus completion of an asynchronous fetch
+ *
+ * @param status Bus result
+ * @param ctx Pointer to the SHT3x device structure
+ */
+static void SHT3X_FetchDone(HAL_StatusTypeDef status, void *ctx)
+{
+	sht3x_t *dev = (sht3x_t *)ctx;
+
+	dev->fetchResult = status;
+	dev->fetchState = SHT3X_FETCH_DONE;
+}
+
 /* PUBLIC API ----------------------------------------------------------------*/
 
 /**
@@ -266,9 +283,12 @@ void SHT3X_Init(sht3x_t *dev, I2C_HandleTypeDef *hi2c, uint8_t addr7bit)
 	dev->humidity = 0.0f;
 	dev->currentState = SHT3X_IDLE;
 	dev->modeRepeat = SHT3X_HIGH;
+	dev->fetchState = SHT3X_FETCH_IDLE;
+
+	// Sampling is time-critical, served before DS3231 transfers
+	I2CBus_RegisterDevice((uint16_t)(addr7bit), I2C_BUS_PRIO_HIGH, SHT3X_I2C_TIMEOUT);
 
-	if (HAL_I2C_IsDeviceReady(hi2c, (uint16_t)(addr7bit),
-							  3, SHT3X_I2C_TIMEOUT) != HAL_OK)
+	if (!I2CBus_IsDeviceReady((uint16_t)(addr7bit), 3))
 	{
 
 		return;
@@ -297,8 +317,7 @@ void SHT3X_DeInit(sht3x_t *dev)
 		return;
 	}
 
-	if (HAL_I2C_IsDeviceReady(dev->hi2c, (uint16_t)(dev->device_address),
-							  3, SHT3X_I2C_TIMEOUT) != HAL_OK)
+	if (!I2CBus_IsDeviceReady((uint16_t)(dev->device_address), 3))
 	{
 		return;
 	}
@@ -426,8 +445,10 @@ SHT3X_StatusTypeDef SHT3X_Single(sht3x_t *dev, sht3x_repeat_t *modeRepeat, float
 	HAL_Delay(SHT3X_MEAS_DURATION_MS[*modeRepeat]);
 
 	uint8_t frame[SHT3X_RAW_DATA_SIZE] = {0};
-	if (HAL_I2C_Master_Receive(dev->hi2c, (uint16_t)(dev->device_address),
-							   frame, sizeof(frame), SHT3X_I2C_TIMEOUT) != HAL_OK)
+	i2c_bus_xfer_t xfer = {.address = (uint16_t)(dev->device_address),
+						   .op = I2C_BUS_READ,
+						   .data = frame, .len = sizeof(frame)};
+	if (I2CBus_Transfer(&xfer) != HAL_OK)
 	{
 		// I2C error, output remains 0.0
 		return SHT3X_ERROR;
@@ -658,10 +679,11 @@ void SHT3X_FetchData(sht3x_t *dev, float *outT, float *outRH)
 	}
 
 	uint8_t frame[SHT3X_RAW_DATA_SIZE] = {0};
-	if (HAL_I2C_Mem_Read(dev->hi2c,
-						 (uint16_t)(dev->device_address),
-						 SHT3X_COMMAND_FETCH_DATA, I2C_MEMADD_SIZE_16BIT,
-						 frame, sizeof(frame), SHT3X_I2C_TIMEOUT) != HAL_OK)
+	i2c_bus_xfer_t xfer = {.address = (uint16_t)(dev->device_address),
+						   .op = I2C_BUS_MEM_READ,
+						   .mem_addr = SHT3X_COMMAND_FETCH_DATA, .mem_size = I2C_MEMADD_SIZE_16BIT,
+						   .data = frame, .len = sizeof(frame)};
+	if (I2CBus_Transfer(&xfer) != HAL_OK)
 	{
 		// I2C error, output remains 0.0
 		return;
@@ -687,3 +709,80 @@ void SHT3X_FetchData(sht3x_t *dev, float *outT, float *outRH)
 		*outRH = rh;
 	}
 }
+
+/**
+ * @brief Queue a periodic fetch on the I2C bus
+ */
+SHT3X_StatusTypeDef SHT3X_FetchStart(sht3x_t *dev)
+{
+	if (!dev || !dev->hi2c || !SHT3X_IS_PERIODIC_STATE(dev->currentState))
+	{
+		return SHT3X_ERROR;
+	}
+
+	if (dev->fetchState == SHT3X_FETCH_BUSY)
+	{
+		return SHT3X_OK; // previous fetch still on the bus
+	}
+
+	i2c_bus_xfer_t xfer = {.address = (uint16_t)(dev->device_address),
+						   .op = I2C_BUS_MEM_READ,
+						   .mem_addr = SHT3X_COMMAND_FETCH_DATA, .mem_size = I2C_MEMADD_SIZE_16BIT,
+						   .data = dev->rxFrame, .len = sizeof(dev->rxFrame),
+						   .done = SHT3X_FetchDone, .ctx = dev};
+
+	dev->fetchState = SHT3X_FETCH_BUSY;
+	if (!I2CBus_Submit(&xfer))
+	{
+		// Report the failure through FetchPoll so the sample slot is not lost
+		SHT3X_FetchDone(HAL_ERROR, dev);
+		return SHT3X_ERROR;
+	}
+
+	return SHT3X_OK;
+}
+
+/**
+ * @brief Collect the result of SHT3X_FetchStart()
+ */
+bool SHT3X_FetchPoll(sht3x_t *dev, float *outT, float *outRH)
+{
+	if (!dev || dev->fetchState != SHT3X_FETCH_DONE)
+	{
+		return false;
+	}
+
+	dev->fetchState = SHT3X_FETCH_IDLE;
+
+	if (!SHT3X_IS_PERIODIC_STATE(dev->currentState))
+	{
+		return false;
+	}
+
+	// Initialize output to 0.0 (default for sensor failure)
+	if (outT)
+		*outT = 0.0f;
+	if (outRH)
+		*outRH = 0.0f;
+
+	float tC = 0.0f, rh = 0.0f;
+	if (dev->fetchResult != HAL_OK || SHT3X_ParseFrame(dev->rxFrame, &tC, &rh) != SHT3X_OK)
+	{
+		// I2C or CRC error, output remains 0.0
+		return true;
+	}
+
+	dev->temperature = tC;
+	dev->humidity = rh;
+
+	if (outT)
+	{
+		*outT = tC;
+	}
+	if (outRH)
+	{
+		*outRH = rh;
+	}
+
+	return true;
+}
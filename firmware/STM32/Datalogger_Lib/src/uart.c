@@ -19,6 +19,43 @@ uint8_t buff[BUFFER_UART];
 uint8_t index_uart = 0;
 uint8_t Flag_UART = 0;
 ring_buffer_t uart_rx_rb; // Ring buffer for UART reception
+volatile uint32_t uart_last_rx_tick = 0; // HAL tick of the last received byte
+
+// Baud rate negotiation
+static const uint32_t uart_supported_baud[] = {115200, 230400, 460800, 921600, 2000000};
+static uint32_t uart_committed_baud = UART_BAUD_DEFAULT; // Rate a trial reverts to
+static bool uart_trial_pending = false;
+static uint32_t uart_trial_tick = 0;
+static uart_link_stats_t uart_link_stats;
+
+/* PRIVATE FUNCTIONS ---------------------------------------------------------*/
+
+/**
+ * @brief Reprogram USART1 with a new baud rate
+ *
+ * @param baud Baud rate
+ */
+static void uart_apply_baud(uint32_t baud)
+{
+	// Let the last reply leave at the old rate (about 1 ms at 115200)
+	uint32_t start = HAL_GetTick();
+	while (__HAL_UART_GET_FLAG(&huart1, UART_FLAG_TC) == RESET && (HAL_GetTick() - start) < 10)
+	{
+	}
+
+	HAL_UART_AbortReceive(&huart1);
+
+	// Peripheral is already set up, HAL_UART_Init() only rewrites BRR/CR registers
+	huart1.Init.BaudRate = baud;
+	HAL_UART_Init(&huart1);
+
+	// Bytes received at the old rate are meaningless now
+	RingBuffer_Clear(&uart_rx_rb);
+	memset(buff, 0, sizeof(buff));
+	index_uart = 0;
+
+	HAL_UART_Receive_IT(&huart1, &data_rx, sizeof(data_rx));
+}
 
 /* PUBLIC API ----------------------------------------------------------------*/
 
@@ -33,6 +70,10 @@ void UART_Init(UART_HandleTypeDef *huart)
 
 	RingBuffer_Init(&uart_rx_rb);
 
+	uart_committed_baud = huart->Init.BaudRate;
+	uart_trial_pending = false;
+	memset(&uart_link_stats, 0, sizeof(uart_link_stats));
+
 	HAL_UART_Receive_IT(huart, &data_rx, sizeof(data_rx));
 }
 
@@ -44,6 +85,7 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 	if (huart->Instance == huart1.Instance)
 	{
 		RingBuffer_Put(&uart_rx_rb, data_rx);
+		uart_last_rx_tick = HAL_GetTick();
 
 		HAL_UART_Receive_IT(&huart1, &data_rx, sizeof(data_rx));
 	}
@@ -56,6 +98,14 @@ void UART_Handle(void)
 {
 	uint8_t received_byte;
 
+	// Trial rate not confirmed: the ESP32 gave up, go back to the last good rate
+	if (uart_trial_pending && (HAL_GetTick() - uart_trial_tick) >= UART_BAUD_TRIAL_TIMEOUT_MS)
+	{
+		uart_trial_pending = false;
+		uart_link_stats.trial_reverts++;
+		uart_apply_baud(uart_committed_baud);
+	}
+
 	while (RingBuffer_Get(&uart_rx_rb, &received_byte))
 	{
 		if (index_uart < (BUFFER_UART - 1))
@@ -79,3 +129,167 @@ void UART_Handle(void)
 		Flag_UART = 0;
 	}
 }
+
+/**
+ * @brief Check if UART has been quiet for a given time
+ */
+bool UART_IsIdle(uint32_t quiet_ms)
+{
+	return !uart_trial_pending && RingBuffer_Available(&uart_rx_rb) == 0 && index_uart == 0 &&
+		   (HAL_GetTick() - uart_last_rx_tick) >= quiet_ms;
+}
+
+/**
+ * @brief Check if a baud rate can be negotiated
+ */
+bool UART_IsSupportedBaud(uint32_t baud)
+{
+	for (uint8_t i = 0; i < sizeof(uart_supported_baud) / sizeof(uart_supported_baud[0]); i++)
+	{
+		if (uart_supported_baud[i] == baud)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Switch to a baud rate immediately and keep it
+ */
+void UART_SetBaudRate(uint32_t baud)
+{
+	uart_trial_pending = false;
+	uart_committed_baud = baud;
+
+	if (huart1.Init.BaudRate != baud)
+	{
+		uart_apply_baud(baud);
+	}
+}
+
+/**
+ * @brief Switch to a baud rate on trial
+ */
+bool UART_TryBaudRate(uint32_t baud)
+{
+	if (!UART_IsSupportedBaud(baud))
+	{
+		return false;
+	}
+
+	uart_apply_baud(baud);
+	uart_trial_pending = true;
+	uart_trial_tick = HAL_GetTick();
+	return true;
+}
+
+/**
+ * @brief Keep the trial baud rate
+ */
+bool UART_CommitBaudRate(void)
+{
+	if (!uart_trial_pending)
+	{
+		return false;
+	}
+
+	uart_trial_pending = false;
+	uart_committed_baud = huart1.Init.BaudRate;
+	return true;
+}
+
+/**
+ * @brief Get the current baud rate
+ */
+uint32_t UART_GetBaudRate(void)
+{
+	return huart1.Init.BaudRate;
+}
+
+/**
+ * @brief Verify a test pattern received from the ESP32
+ */
+bool UART_CheckTestPattern(const char *pattern, uint16_t crc)
+{
+	size_t len = strlen(pattern);
+
+	if (len == 0 || len > UART_TEST_PATTERN_MAX || UART_Crc16((const uint8_t *)pattern, len) != crc)
+	{
+		uart_link_stats.test_failures++;
+		return false;
+	}
+
+	// Link works at this rate so far, give the ESP32 time for the next round
+	uart_trial_tick = HAL_GetTick();
+	return true;
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE
+ */
+uint16_t UART_Crc16(const uint8_t *data, uint16_t len)
+{
+	uint16_t crc = 0xFFFF;
+
+	while (len--)
+	{
+		crc ^= (uint16_t)(*data++) << 8;
+		for (uint8_t bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Get link error counters
+ */
+void UART_GetLinkStats(uart_link_stats_t *stats)
+{
+	if (stats == NULL)
+	{
+		return;
+	}
+
+	*stats = uart_link_stats;
+	stats->baud = huart1.Init.BaudRate;
+}
+
+/**
+ * @brief UART error callback (called from HAL)
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	if (huart->Instance != huart1.Instance)
+	{
+		return;
+	}
+
+	uint32_t error = huart->ErrorCode;
+
+	if (error & HAL_UART_ERROR_ORE)
+	{
+		uart_link_stats.overruns++;
+	}
+	if (error & HAL_UART_ERROR_FE)
+	{
+		uart_link_stats.frame_errors++;
+	}
+	if (error & HAL_UART_ERROR_NE)
+	{
+		uart_link_stats.noise_errors++;
+	}
+	if (error & HAL_UART_ERROR_PE)
+	{
+		uart_link_stats.parity_errors++;
+	}
+
+	// The HAL ends reception after an overrun, restart it
+	if (huart->RxState == HAL_UART_STATE_READY)
+	{
+		HAL_UART_Receive_IT(&huart1, &data_rx, sizeof(data_rx));
+	}
+}
@@ -4,15 +4,14 @@ feather.replace();
 // ====================================================================
 // GLOBAL VARIABLES (from script.js)
 // ====================================================================
+// Measurement state of the selected device (deviceStates holds every device)
 let isPeriodic = false;
 let isDeviceOn = false;
 let isMqttConnected = false;
 let isFirebaseConnected = false;
-let temperatureData = [];
-let humidityData = [];
-let logBuffer = [];
 let maxDataPoints = 50;
-let maxLogsInMemory = 100;
+let chartUpdateIntervalMs = 1000;
+const maxLogsInMemory = 2000;
 let mqttClient = null;
 let firebaseDb = null;
 let currentTemp = null;
@@ -20,14 +19,19 @@ let currentHumi = null;
 // Last reading timestamp (ms since epoch) sourced from device payload
 let lastReadingTimestamp = null;
 
+// Gateways seen on the broker (MQTT client id -> state) and the one shown
+const deviceStates = new Map();
+let selectedDevice = localStorage.getItem("selectedDevice") || null;
+
 let logFilterType = "ALL";
 
 // Data Management cache (MUST be declared BEFORE any functions that use it)
 let filteredDataCache = [];
+// Last History API query (for Load More and export); null when Firebase was used
+let historyQuery = null;
 
 // Live Data table
-let liveDataBuffer = [];
-const maxLiveDataEntries = 100;
+const maxLiveDataEntries = 5000;
 
 // Device button cooldown
 let deviceButtonLocked = false;
@@ -101,17 +105,56 @@ const MQTT_CONFIG = {
   username: "DataLogger",
   password: "datalogger",
   clientId: "web_client_1",
+  // Every gateway publishes under <root>/<client id>/ (see deviceTopic)
+  root: "datalogger",
   topics: {
-    stm32Command: "datalogger/stm32/command",
-    relayControl: "datalogger/esp32/relay/control",
-    systemState: "datalogger/esp32/system/state",
-    singleData: "datalogger/stm32/single/data",
-    periodicData: "datalogger/stm32/periodic/data",
+    stm32Command: "stm32/command",
+    relayControl: "esp32/relay/control",
+    systemState: "esp32/system/state",
+    singleData: "stm32/single/data",
+    periodicData: "stm32/periodic/data",
+    backlogData: "stm32/backlog/data",
+    // Retained by the ingest service (broker/ingest)
+    latestReading: "history/latest",
+    recentHistory: "history/recent",
   },
 };
 
+/**
+ * Full topic of one device
+ * @param {string} name - Key of MQTT_CONFIG.topics
+ * @param {string} device - Client id, "+" for every device
+ */
+function deviceTopic(name, device = selectedDevice) {
+  return `${MQTT_CONFIG.root}/${device}/${MQTT_CONFIG.topics[name]}`;
+}
+
+// SD backlog replay: records are written to Firebase in multi-path batches,
+// keyed by device and SD sequence number so a record sent twice is stored once
+const BACKLOG_CONFIG = {
+  batchSize: 500,
+  flushDelayMs: 1000,
+  retryDelayMs: 5000,
+};
+
+// History Query API (broker/ingest datalogger_query). Filtering, sorting and
+// paging run on the server; Firebase is used when the URL is empty or unreachable.
+const HISTORY_API_CONFIG = {
+  url: "http://127.0.0.1:8090",
+  device: selectedDevice || "ESP32_01", // Follows the device selector
+  pageSize: 500,
+  exportLimit: 100000,
+};
+
+// Backlog batching state
+let backlogPending = new Map(); // Firebase path -> record
+let backlogFlushTimer = null;
+let backlogFlushInFlight = false;
+let backlogSavedCount = 0;
+
 // Charts
 let tempChart, humiChart;
+let chartStats = { temp: null, humi: null }; // Last snapshot from the MQTT decoder
 let chartInitRetryCount = 0;
 const maxChartInitRetries = 10;
 
@@ -222,9 +265,297 @@ document.querySelectorAll(".menu-item").forEach((item) => {
   });
 });
 
+// ====================================================================
+// VIRTUAL LISTS (Live Data table, Logs console)
+// ====================================================================
+
+// Rows rendered above and below the visible window
+const VIRTUAL_LIST_OVERSCAN = 8;
+
+/**
+ * Append-only record list shown newest first in a scrolling window.
+ * Only the rows in view (plus VIRTUAL_LIST_OVERSCAN) are in the DOM, between
+ * two spacers. A render inserts the rows entering the window and removes the
+ * rows leaving it, at most once per animation frame, and nothing is rendered
+ * while the list is hidden. Rows are keyed by record number, so existing rows
+ * are never rewritten.
+ */
+class VirtualList {
+  /**
+   * @param {Object} options
+   * @param {number} options.capacity - Records kept (oldest dropped first)
+   * @param {string} options.scrollId - Scrolling element id
+   * @param {string} options.bodyId - Row container id
+   * @param {number} options.rowHeight - Row height in px until measured
+   * @param {Function} options.renderRow - (record, number) => HTML of one row
+   * @param {Function} options.createSpacer - () => empty element for the row container
+   * @param {string} options.emptyHtml - Shown when no record matches
+   * @param {Function} [options.onCount] - Called with the matching count on render
+   */
+  constructor(options) {
+    this.options = options;
+    this.rowHeight = options.rowHeight;
+    this.rowMeasured = false;
+    // Trimmed in chunks so a push stays O(1) amortized
+    this.slack = Math.max(1, Math.ceil(options.capacity / 8));
+    this.items = []; // Oldest first
+    this.dropped = 0; // Number of the oldest record kept
+    this.view = []; // Numbers of the matching records, ascending
+    this.filterKey = "";
+    this.filter = null;
+    this.rendered = new Map(); // Record number -> row element
+    this.added = 0; // Matching records since the last render (scroll anchoring)
+    this.topSpacer = null;
+    this.bottomSpacer = null;
+    this.stale = true;
+    this.frame = null;
+    this.scroller = null;
+  }
+
+  get length() {
+    return this.items.length;
+  }
+
+  push(record) {
+    const number = this.dropped + this.items.length;
+    this.items.push(record);
+    if (!this.filter || this.filter(record)) {
+      this.view.push(number);
+      this.added++;
+    }
+    if (this.items.length > this.options.capacity + this.slack) {
+      this.trim();
+    }
+    this.schedule();
+  }
+
+  trim() {
+    const excess = this.items.length - this.options.capacity;
+    this.items.splice(0, excess);
+    this.dropped += excess;
+
+    let k = 0;
+    while (k < this.view.length && this.view[k] < this.dropped) k++;
+    this.view.splice(0, k);
+  }
+
+  clear() {
+    this.items = [];
+    this.dropped = 0;
+    this.view = [];
+    this.refresh();
+  }
+
+  /**
+   * Change the filter; the view is rebuilt only when the key changes
+   * @param {string} key - Identifies the filter
+   * @param {Function|null} filter - record => boolean, null for all
+   */
+  setFilter(key, filter) {
+    if (key === this.filterKey) return;
+    this.filterKey = key;
+    this.filter = filter;
+    this.view = [];
+    this.items.forEach((record, i) => {
+      if (!filter || filter(record)) this.view.push(this.dropped + i);
+    });
+    if (this.scroller) this.scroller.scrollTop = 0;
+    this.refresh();
+  }
+
+  /** Newest-first copy of the records (exports) */
+  toArray() {
+    return this.items.slice().reverse();
+  }
+
+  /** Rebuild the window on the next frame (shown again, formatting changed) */
+  refresh() {
+    this.stale = true;
+    this.schedule();
+  }
+
+  schedule() {
+    if (this.frame !== null) return;
+    this.frame = requestAnimationFrame(() => {
+      this.frame = null;
+      this.render();
+    });
+  }
+
+  /** Position of a record number in display order (newest = 0) */
+  displayIndex(number) {
+    let lo = 0;
+    let hi = this.view.length - 1;
+    while (lo < hi) {
+      const mid = (lo + hi) >> 1;
+      if (this.view[mid] < number) lo = mid + 1;
+      else hi = mid;
+    }
+    return this.view.length - 1 - lo;
+  }
+
+  /**
+   * Build rows for display positions [from, to)
+   * @returns {DocumentFragment}
+   */
+  buildRows(from, to) {
+    const count = this.view.length;
+    let html = "";
+    for (let d = from; d < to; d++) {
+      const number = this.view[count - 1 - d];
+      html += this.options.renderRow(this.items[number - this.dropped], number + 1);
+    }
+    const template = document.createElement("template");
+    template.innerHTML = html;
+    const rows = template.content.children;
+    for (let k = 0; k < rows.length; k++) {
+      this.rendered.set(this.view[count - 1 - (from + k)], rows[k]);
+    }
+    return template.content;
+  }
+
+  render() {
+    const scroller = document.getElementById(this.options.scrollId);
+    const body = document.getElementById(this.options.bodyId);
+    if (!scroller || !body) return;
+
+    // Hidden page: render once it is shown again
+    if (scroller.offsetParent === null) {
+      this.stale = true;
+      return;
+    }
+
+    if (this.scroller !== scroller) {
+      this.scroller = scroller;
+      scroller.addEventListener("scroll", () => this.schedule(), {
+        passive: true,
+      });
+    }
+
+    const count = this.view.length;
+    if (this.options.onCount) this.options.onCount(count);
+
+    if (count === 0) {
+      body.innerHTML = this.options.emptyHtml;
+      this.rendered.clear();
+      this.topSpacer = null;
+      this.added = 0;
+      return;
+    }
+
+    if (this.stale || !this.topSpacer || this.topSpacer.parentNode !== body) {
+      body.textContent = "";
+      this.rendered.clear();
+      this.topSpacer = this.options.createSpacer();
+      this.bottomSpacer = this.options.createSpacer();
+      body.append(this.topSpacer, this.bottomSpacer);
+      this.stale = false;
+      this.added = 0;
+    }
+
+    // Keep the rows being read in place when new ones arrive above them
+    let scrollTop = scroller.scrollTop;
+    if (this.added > 0 && scrollTop > 0) {
+      scrollTop += this.added * this.rowHeight;
+    }
+    this.added = 0;
+    scrollTop = Math.min(
+      scrollTop,
+      Math.max(0, count * this.rowHeight - scroller.clientHeight)
+    );
+
+    const first = Math.max(
+      0,
+      Math.floor(scrollTop / this.rowHeight) - VIRTUAL_LIST_OVERSCAN
+    );
+    const last = Math.min(
+      count,
+      Math.ceil((scrollTop + scroller.clientHeight) / this.rowHeight) +
+        VIRTUAL_LIST_OVERSCAN
+    );
+    const newest = this.view[count - 1 - first];
+    const oldest = this.view[count - last];
+
+    // Drop rows that left the window (or the kept records)
+    let renderedNewest = -1;
+    let renderedOldest = Infinity;
+    for (const [number, row] of this.rendered) {
+      if (number > newest || number < oldest) {
+        row.remove();
+        this.rendered.delete(number);
+      } else {
+        renderedNewest = Math.max(renderedNewest, number);
+        renderedOldest = Math.min(renderedOldest, number);
+      }
+    }
+
+    if (this.rendered.size === 0) {
+      this.bottomSpacer.before(this.buildRows(first, last));
+    } else {
+      const top = this.displayIndex(renderedNewest);
+      const bottom = this.displayIndex(renderedOldest);
+      if (top > first) this.topSpacer.after(this.buildRows(first, top));
+      if (bottom + 1 < last) {
+        this.bottomSpacer.before(this.buildRows(bottom + 1, last));
+      }
+    }
+
+    this.topSpacer.style.height = `${first * this.rowHeight}px`;
+    this.bottomSpacer.style.height = `${(count - last) * this.rowHeight}px`;
+    if (scroller.scrollTop !== scrollTop) scroller.scrollTop = scrollTop;
+
+    // Spacer heights assume the real row height
+    if (!this.rowMeasured) {
+      const height = this.topSpacer.nextElementSibling?.offsetHeight || 0;
+      if (height > 0) {
+        this.rowMeasured = true;
+        if (height !== this.rowHeight) {
+          this.rowHeight = height;
+          this.refresh();
+        }
+      }
+    }
+  }
+}
+
 // ====================================================================
 // LOGGING SYSTEM
 // ====================================================================
+
+// Log line colors (full console)
+const LOG_COLORS = {
+  INFO: "#3B82F6",
+  WARNING: "#F59E0B",
+  ERROR: "#EF4444",
+  MQTT: "#8B5CF6",
+  FIREBASE: "#F97316",
+  SYNC: "#06B6D4",
+  SETTING: "#14B8A6",
+};
+
+const logList = new VirtualList({
+  capacity: maxLogsInMemory,
+  scrollId: "consoleFull",
+  bodyId: "consoleFull",
+  rowHeight: 24,
+  renderRow: (log) => {
+    const time = new Date(log.timestamp).toLocaleTimeString("en-US", {
+      hour12: false,
+    });
+    const color = LOG_COLORS[log.type] || "#10B981";
+    return `<div class="log-line log-${log.type.toLowerCase()}" style="color: ${color};"><strong>[${time}]</strong> <strong style="display: inline-block; min-width: 80px;">[${log.type}]</strong> ${log.message}</div>`;
+  },
+  createSpacer: () => document.createElement("div"),
+  emptyHtml:
+    '<div style="color: var(--text-muted); text-align: center; padding: 2rem;">No logs found</div>',
+  onCount: (count) => {
+    const countEl = document.getElementById("logCount");
+    if (countEl) countEl.textContent = count;
+  },
+});
+
+let consolePreviewFrame = null;
+
 function addStatus(message, type = "INFO") {
   const timestamp = Date.now();
   const logEntry = {
@@ -234,40 +565,34 @@ function addStatus(message, type = "INFO") {
     date_iso: new Date(timestamp).toISOString(),
   };
 
-  // Add to buffer (FIFO)
-  logBuffer.unshift(logEntry);
-  if (logBuffer.length > maxLogsInMemory) {
-    logBuffer.pop();
-  }
+  // Full console renders itself on the next frame (only while shown)
+  logList.push(logEntry);
 
   // Update console displays
-  updateConsoleDisplay(logEntry);
+  updateConsoleDisplay();
 
   console.log(`[${type}] ${message}`);
 }
 
-function updateConsoleDisplay(logEntry) {
-  const time = new Date(logEntry.timestamp).toLocaleTimeString("en-US", {
-    hour12: false,
+// Dashboard preview (last 5), redrawn at most once per frame
+function updateConsoleDisplay() {
+  if (consolePreviewFrame !== null) return;
+  consolePreviewFrame = requestAnimationFrame(() => {
+    consolePreviewFrame = null;
+    const preview = document.getElementById("consolePreview");
+    if (!preview) return;
+
+    preview.innerHTML = logList.items
+      .slice(-5)
+      .reverse()
+      .map((log) => {
+        const time = new Date(log.timestamp).toLocaleTimeString("en-US", {
+          hour12: false,
+        });
+        return `<div class="log-line log-${log.type.toLowerCase()}">[${log.type}] ${time}: ${log.message}</div>`;
+      })
+      .join("");
   });
-  const line = `<div class="log-line log-${logEntry.type.toLowerCase()}">[${logEntry.type
-    }] ${time}: ${logEntry.message}</div>`;
-
-  // Update preview (last 5)
-  const preview = document.getElementById("consolePreview");
-  if (preview) {
-    preview.innerHTML = line + preview.innerHTML;
-    const lines = preview.querySelectorAll(".log-line");
-    if (lines.length > 5) {
-      lines[lines.length - 1].remove();
-    }
-  }
-
-  // Update full logs if on logs page
-  const logsSection = document.getElementById("page-logs");
-  if (logsSection && logsSection.classList.contains("active")) {
-    renderFullConsole();
-  }
 }
 
 // ====================================================================
@@ -389,49 +714,269 @@ function initializeMQTT() {
   addStatus(`   Full URL: ${url}`, "INFO");
 
   try {
-    mqttClient = mqtt.connect(url, {
-      clientId: MQTT_CONFIG.clientId,
-      username: MQTT_CONFIG.username,
-      password: MQTT_CONFIG.password,
-      clean: true,
-      connectTimeout: 4000,
-      reconnectPeriod: 2000,
+    mqttClient = createMqttClient(
+      url,
+      {
+        clientId: MQTT_CONFIG.clientId,
+        username: MQTT_CONFIG.username,
+        password: MQTT_CONFIG.password,
+        clean: true,
+        connectTimeout: 4000,
+        reconnectPeriod: 2000,
+      },
+      [
+        // Retained snapshots first, so live readings follow them. The
+        // history snapshot is only needed for the charted device.
+        ...(selectedDevice ? [deviceTopic("recentHistory")] : []),
+        deviceTopic("latestReading", "+"),
+        deviceTopic("systemState", "+"),
+        deviceTopic("singleData", "+"),
+        deviceTopic("periodicData", "+"),
+        deviceTopic("backlogData", "+"),
+      ]
+    );
+    postStreamState();
+    postChartSeed();
+  } catch (error) {
+    addStatus(` MQTT init exception: ${error.message}`, "ERROR");
+    addStatus(`   Stack: ${error.stack}`, "ERROR");
+    updateMQTTStatus(false);
+  }
+}
+
+/**
+ * Connection in a Web Worker (mqtt_worker.js), or on the main thread when
+ * workers are unavailable (file:// pages, old browsers)
+ */
+function createMqttClient(url, options, subscribe) {
+  if (typeof Worker !== "undefined") {
+    try {
+      return new WorkerMqttClient(url, options, subscribe);
+    } catch (error) {
+      addStatus(
+        `MQTT worker unavailable (${error.message}), decoding on the main thread`,
+        "WARNING"
+      );
+    }
+  }
+  return new LocalMqttClient(url, options, subscribe);
+}
+
+/**
+ * MQTT client running in mqtt_worker.js. Decoding, filtering and chart
+ * statistics happen in the worker, which posts batches (handleStreamBatch).
+ * publish()/end()/connected match the mqtt.js client.
+ */
+class WorkerMqttClient {
+  constructor(url, options, subscribe) {
+    this.connected = false;
+    this.ended = false;
+    this.args = [url, options, subscribe];
+    this.subscriptions = []; // Added after connect (kept for fallBack)
+    this.worker = new Worker("mqtt_worker.js");
+    this.worker.onmessage = (event) => this.onMessage(event.data);
+    this.worker.onerror = (event) => {
+      event.preventDefault();
+      this.fallBack(event.message || "worker error");
+    };
+    this.worker.postMessage({
+      type: "connect",
+      url,
+      options,
+      root: MQTT_CONFIG.root,
+      topics: MQTT_CONFIG.topics,
+      subscribe,
     });
+  }
 
-    mqttClient.on("connect", function () {
-      updateMQTTStatus(true);
-      addStatus(" MQTT broker connected successfully!", "MQTT");
+  onMessage(msg) {
+    switch (msg.type) {
+      case "batch":
+        handleStreamBatch(msg);
+        break;
+      case "status":
+        this.connected = msg.event === "connect";
+        handleMqttStatus(msg.event, msg.message);
+        if (this.ended && msg.event === "close") this.worker.terminate();
+        break;
+      case "subscribed":
+        handleMqttSubscribed(msg.topic, msg.error);
+        break;
+      case "fatal":
+        this.fallBack(msg.message);
+        break;
+    }
+  }
 
-      // Subscribe to topics
-      const topics = [
-        MQTT_CONFIG.topics.systemState,
-        MQTT_CONFIG.topics.singleData,
-        MQTT_CONFIG.topics.periodicData,
-      ];
+  // The worker could not start: run the same client on the main thread
+  fallBack(reason) {
+    if (mqttClient !== this) return;
+    this.worker.terminate();
+    addStatus(
+      `MQTT worker unavailable (${reason}), decoding on the main thread`,
+      "WARNING"
+    );
+    mqttClient = new LocalMqttClient(...this.args);
+    this.subscriptions.forEach((topic) => mqttClient.subscribe(topic));
+    postStreamState();
+    postChartSeed();
+  }
 
-      topics.forEach((topic) => {
-        mqttClient.subscribe(topic, { qos: 1 }, (err) => {
-          if (err) {
-            addStatus(
-              ` Failed to subscribe to ${topic}: ${err.message}`,
-              "ERROR"
-            );
-          } else {
-            addStatus(` Subscribed to ${topic}`, "MQTT");
-          }
-        });
-      });
+  publish(topic, payload, options = {}) {
+    this.worker.postMessage({
+      type: "publish",
+      topic,
+      payload: String(payload),
+      qos: options.qos || 0,
+      retain: !!options.retain,
+    });
+  }
+
+  end(force) {
+    this.ended = true;
+    this.worker.postMessage({ type: "end", force });
+  }
+
+  subscribe(topic) {
+    this.subscriptions.push(topic);
+    this.worker.postMessage({ type: "subscribe", topic });
+  }
+
+  unsubscribe(topic) {
+    this.args[2] = this.args[2].filter((t) => t !== topic);
+    this.subscriptions = this.subscriptions.filter((t) => t !== topic);
+    this.worker.postMessage({ type: "unsubscribe", topic });
+  }
+
+  configure(state) {
+    this.worker.postMessage({ type: "configure", state });
+  }
+
+  seedChart(temps, humis) {
+    this.worker.postMessage({ type: "seed", temps, humis }, [
+      temps.buffer,
+      humis.buffer,
+    ]);
+  }
+}
+
+/**
+ * Main-thread fallback with the same interface and the same decoding
+ * (mqtt_stream.js); batches are handed over on a timer like the worker's
+ */
+class LocalMqttClient {
+  constructor(url, options, subscribe) {
+    this.stream = new MqttStream(MQTT_CONFIG.root, MQTT_CONFIG.topics);
+    this.flushTimer = null;
+    this.subscriptions = subscribe.slice();
+    this.client = mqtt.connect(url, options);
+
+    this.client.on("connect", () => {
+      handleMqttStatus("connect");
+      this.subscriptions.forEach((topic) => this.subscribeNow(topic));
+    });
+    this.client.on("message", (topic, payload) => {
+      this.stream.handle(topic, payload);
+      this.scheduleFlush();
+    });
+    this.client.on("error", (error) => handleMqttStatus("error", error.message));
+    this.client.on("offline", () => handleMqttStatus("offline"));
+    this.client.on("reconnect", () => handleMqttStatus("reconnect"));
+    this.client.on("close", () => handleMqttStatus("close"));
+  }
+
+  get connected() {
+    return this.client.connected;
+  }
+
+  scheduleFlush() {
+    if (this.flushTimer !== null || !this.stream.pending) return;
+    this.flushTimer = setTimeout(() => {
+      this.flushTimer = null;
+      const batch = this.stream.takeBatch();
+      if (batch) handleStreamBatch(batch);
+    }, 50);
+  }
+
+  publish(topic, payload, options) {
+    this.client.publish(topic, payload, options);
+  }
+
+  end(force) {
+    this.client.end(force);
+  }
+
+  subscribeNow(topic) {
+    this.client.subscribe(topic, { qos: 1 }, (err) => {
+      handleMqttSubscribed(topic, err ? err.message : null);
+    });
+  }
+
+  subscribe(topic) {
+    if (!this.subscriptions.includes(topic)) this.subscriptions.push(topic);
+    if (this.client.connected) this.subscribeNow(topic);
+  }
+
+  unsubscribe(topic) {
+    this.subscriptions = this.subscriptions.filter((t) => t !== topic);
+    if (this.client.connected) this.client.unsubscribe(topic);
+  }
+
+  configure(state) {
+    this.stream.configure(state);
+    this.scheduleFlush();
+  }
+
+  seedChart(temps, humis) {
+    this.stream.seedChart(temps, humis);
+    this.scheduleFlush();
+  }
+}
+
+/**
+ * Tell the decoder which device is shown and which readings the dashboard
+ * keeps (call after state changes; also updates the device's entry)
+ */
+function postStreamState() {
+  const selected = deviceStates.get(selectedDevice);
+  if (selected) {
+    selected.deviceOn = isDeviceOn;
+    selected.periodic = isPeriodic;
+  }
+  if (!mqttClient) return;
+  mqttClient.configure({
+    device: selectedDevice,
+    deviceOn: isDeviceOn,
+    periodic: isPeriodic,
+    skipErrors: localStorage.getItem("chartSkipErrors") === "true",
+    window: maxDataPoints,
+  });
+}
+
+/** Send the chart window to the decoder's statistics (history load, clear) */
+function postChartSeed() {
+  if (!mqttClient) return;
+  const values = (ring) => {
+    const out = new Float32Array(ring.length);
+    for (let k = 0; k < ring.length; k++) out[k] = ring.valueAt(k);
+    return out;
+  };
+  mqttClient.seedChart(values(temperatureData), values(humidityData));
+}
+
+function handleMqttStatus(event, message) {
+  switch (event) {
+    case "connect":
+      updateMQTTStatus(true);
+      addStatus(" MQTT broker connected successfully!", "MQTT");
 
       // Request state sync
       setTimeout(() => {
         requestStateSync();
       }, 500);
-    });
-
-    mqttClient.on("message", handleMQTTMessage);
-
-    mqttClient.on("error", function (error) {
-      addStatus(` MQTT error: ${error.message}`, "ERROR");
+      break;
+    case "error":
+      addStatus(` MQTT error: ${message}`, "ERROR");
       addStatus(
         `   Check if broker is running at ${MQTT_CONFIG.host}:${MQTT_CONFIG.port}`,
         "ERROR"
@@ -441,25 +986,26 @@ function initializeMQTT() {
         "ERROR"
       );
       updateMQTTStatus(false);
-    });
-
-    mqttClient.on("offline", function () {
+      break;
+    case "offline":
       addStatus(" MQTT client offline - attempting reconnect...", "WARNING");
       updateMQTTStatus(false);
-    });
-
-    mqttClient.on("reconnect", function () {
+      break;
+    case "reconnect":
       addStatus(" MQTT reconnecting...", "MQTT");
-    });
-
-    mqttClient.on("close", function () {
+      break;
+    case "close":
       updateMQTTStatus(false);
       addStatus(" MQTT connection closed", "MQTT");
-    });
-  } catch (error) {
-    addStatus(` MQTT init exception: ${error.message}`, "ERROR");
-    addStatus(`   Stack: ${error.stack}`, "ERROR");
-    updateMQTTStatus(false);
+      break;
+  }
+}
+
+function handleMqttSubscribed(topic, error) {
+  if (error) {
+    addStatus(` Failed to subscribe to ${topic}: ${error}`, "ERROR");
+  } else {
+    addStatus(` Subscribed to ${topic}`, "MQTT");
   }
 }
 
@@ -480,166 +1026,159 @@ function updateMQTTStatus(connected) {
   }
 }
 
-function handleMQTTMessage(topic, payload) {
-  const text = payload.toString();
-  console.log(
-    `[MQTT] Message received - Topic: ${topic}, Payload: ${text.substring(
-      0,
-      100
-    )}`
-  );
+/**
+ * Apply a batch from the MQTT decoder: recent-history snapshot, readings,
+ * pass-through messages, decode errors and (when changed) chart statistics
+ */
+function handleStreamBatch(batch) {
+  batch.errors.forEach((message) => addStatus(message, "ERROR"));
 
-  // System state sync
-  if (topic === MQTT_CONFIG.topics.systemState) {
-    const parsedState = parseStateMessage(text);
-    if (parsedState) {
-      syncUIWithHardwareState(parsedState);
-    }
-    return;
+  // A snapshot posted before a device switch belongs to the old device
+  if (batch.recent && batch.recentDevice === selectedDevice) {
+    applyRecentSnapshot(batch.recent);
   }
 
-  // Data topics
-  if (
-    topic === MQTT_CONFIG.topics.singleData ||
-    topic === MQTT_CONFIG.topics.periodicData
-  ) {
-    try {
-      const jsonData = JSON.parse(text);
-      const timestamp =
-        jsonData.timestamp * 1000 - 7 * 3600 * 1000 || Date.now();
-      // Derive mode from topic to avoid unreliable payloads
-      const isPeriodicTopic = topic === MQTT_CONFIG.topics.periodicData;
-      const isSingleTopic = topic === MQTT_CONFIG.topics.singleData;
-      const mode = isPeriodicTopic ? "periodic" : "single";
-
-      // Only treat periodic messages when user actually enabled PERIODIC and device is ON
-      const isActiveMeasurement =
-        isSingleTopic || (isPeriodicTopic && isDeviceOn && isPeriodic);
-
-      if (isPeriodicTopic && !isActiveMeasurement) {
-        console.log(
-          `[DATA] Ignored periodic message (deviceOn=${isDeviceOn}, isPeriodic=${isPeriodic})`
-        );
-        return; // ignore completely: no warnings, no firebase, no charts
+  batch.messages.forEach(({ device, kind, state }) => {
+    // System state sync (decoded per device by MqttStream)
+    if (kind === "state" && state) {
+      updateDeviceState(device, { deviceOn: state.deviceOn, periodic: state.periodic });
+      if (device === selectedDevice) {
+        syncUIWithHardwareState({ device: state.deviceOn, periodic: state.periodic });
       }
+    }
+  });
 
-      // Check for sensor/RTC failures
-      const sensorFailed =
-        jsonData.temperature === 0.0 && jsonData.humidity === 0.0;
-      const rtcFailed = jsonData.timestamp === 0;
-
-      // Only surface warnings when measurement is active
-      if (isActiveMeasurement) {
-        if (sensorFailed) {
-          addStatus(
-            "SHT31 sensor hardware failed (disconnected or wiring issue)",
-            "ERROR"
-          );
-          addStatus("Sensor hardware failed (disconnected)", "WARNING");
-        }
-        if (rtcFailed) {
-          addStatus(
-            "DS3231 RTC module failed (time sync error or I2C communication failure)",
-            "ERROR"
-          );
-          addStatus("RTC failed (using local time)", "WARNING");
-        }
-      }
+  // The current value display shows the newest reading of the selected device only
+  let latest = null;
+  batch.readings.forEach((reading) => {
+    updateDeviceState(reading.device, { lastSeen: reading.timestamp });
+    if (reading.kind === "backlog") {
+      // SD backlog replay: stored whatever the measurement state
+      queueBacklogReading(reading);
+    } else if (reading.device !== selectedDevice) {
+      // Other loggers: stored, not displayed
+      if (reading.kind !== "latest") saveReading(reading);
+    } else if (reading.kind === "latest") {
+      // Retained last value: display only, and only if it is newer
+      const shown = latest ? latest.timestamp : lastReadingTimestamp || 0;
+      if (reading.timestamp > shown) latest = reading;
+    } else {
+      handleReading(reading);
+      latest = reading;
+    }
+  });
 
-      // Update current values only when active
-      if (isActiveMeasurement) {
-        currentTemp = jsonData.temperature;
-        currentHumi = jsonData.humidity;
-        lastReadingTimestamp = timestamp;
-        updateCurrentDisplay();
-      }
+  if (latest) {
+    currentTemp = latest.temp;
+    currentHumi = latest.humi;
+    lastReadingTimestamp = latest.timestamp;
+    updateCurrentDisplay();
+  }
 
-      // Save to Firebase only when active
-      if (isActiveMeasurement) {
-        saveToFirebaseSimple({
-          temp: jsonData.temperature,
-          humi: jsonData.humidity,
-          mode: mode,
-          sensor: "SHT31",
-          time: jsonData.timestamp || 0,
-          device: "ESP32_01",
-        });
-      }
+  if (batch.stats) {
+    chartStats = batch.stats;
+    updateChartStats("temp");
+    updateChartStats("humi");
+  }
+}
 
-      // Update charts only when active and valid values
-      if (isPeriodicTopic && isActiveMeasurement) {
-        // Check "Skip error readings" setting
-        const skipErrors = localStorage.getItem("chartSkipErrors") === "true";
+/**
+ * Recent-history snapshot (retained by the ingest service). An empty chart
+ * is filled at once; after a reconnect only the points newer than the chart
+ * are added, which fills the gap without Firebase.
+ * @param {Object} recent - {times, temps, humis, sensorFailed} typed arrays
+ */
+function applyRecentSnapshot(recent) {
+  const skipErrors = localStorage.getItem("chartSkipErrors") === "true";
+  const newest = temperatureData.length
+    ? temperatureData.timeAt(temperatureData.length - 1)
+    : -Infinity;
+  let added = 0;
+
+  // Older points would be pushed out of the window again
+  const first = Math.max(0, recent.times.length - temperatureData.capacity);
+  for (let i = first; i < recent.times.length; i++) {
+    if (recent.times[i] <= newest) continue;
+    if (skipErrors && recent.sensorFailed[i]) continue;
+    pushTemperature(recent.temps[i], false, recent.times[i]);
+    pushHumidity(recent.humis[i], false, recent.times[i]);
+    added++;
+  }
 
-        if (!(skipErrors && sensorFailed)) {
-          pushTemperature(jsonData.temperature, true, timestamp);
-          pushHumidity(jsonData.humidity, true, timestamp);
-        }
-      }
+  if (added === 0) return;
+  scheduleChartRender();
+  postChartSeed();
+  addStatus(`Chart restored from broker: ${added} recent points`, "INFO");
+}
 
-      // Update component health
-      if (isActiveMeasurement) {
-        updateComponentHealth("SHT31", !sensorFailed);
-        updateComponentHealth("DS3231", !rtcFailed);
-      }
+/** Store one live reading under the device it came from */
+function saveReading(reading) {
+  saveToFirebaseSimple({
+    temp: reading.temp,
+    humi: reading.humi,
+    mode: reading.kind,
+    sensor: "SHT31",
+    time: reading.time,
+    device: reading.device,
+  });
+}
 
-      // Add to Live Data table only when active
-      if (isActiveMeasurement) {
-        addToLiveDataTable({
-          time: timestamp,
-          temp: jsonData.temperature,
-          humi: jsonData.humidity,
-          mode: mode,
-          status: sensorFailed || rtcFailed ? "error" : "success",
-        });
-      }
-    } catch (e) {
-      addStatus(`JSON parse error: ${e.message}`, "ERROR");
-    }
+/**
+ * One live reading of the selected device. Periodic readings only arrive
+ * while PERIODIC is enabled and the device is ON (MqttStream drops the rest).
+ */
+function handleReading(reading) {
+  const { sensorFailed, rtcFailed } = reading;
+
+  if (sensorFailed) {
+    addStatus(
+      "SHT31 sensor hardware failed (disconnected or wiring issue)",
+      "ERROR"
+    );
+    addStatus("Sensor hardware failed (disconnected)", "WARNING");
+  }
+  if (rtcFailed) {
+    addStatus(
+      "DS3231 RTC module failed (time sync error or I2C communication failure)",
+      "ERROR"
+    );
+    addStatus("RTC failed (using local time)", "WARNING");
   }
+
+  saveReading(reading);
+
+  // "Skip error readings" is applied by the decoder
+  if (reading.chart) {
+    pushTemperature(reading.temp, true, reading.timestamp);
+    pushHumidity(reading.humi, true, reading.timestamp);
+  }
+
+  updateComponentHealth("SHT31", !sensorFailed);
+  updateComponentHealth("DS3231", !rtcFailed);
+
+  addToLiveDataTable({
+    time: reading.timestamp,
+    temp: reading.temp,
+    humi: reading.humi,
+    mode: reading.kind,
+    status: sensorFailed || rtcFailed ? "error" : "success",
+  });
 }
 
 // ====================================================================
 // STATE SYNCHRONIZATION (Keep original logic)
 // ====================================================================
 function requestStateSync() {
-  if (!isMqttConnected || !mqttClient) return;
-
-  addStatus("Requesting state sync...", "SYNC");
-  mqttClient.publish(MQTT_CONFIG.topics.systemState, "REQUEST", { qos: 1 });
-}
-
-function parseStateMessage(message) {
-  try {
-    // Try JSON format first (from ESP32)
-    const state = JSON.parse(message);
-    return {
-      device: state.device === "ON",
-      periodic: state.periodic === "ON",
-    };
-  } catch (e) {
-    // Fallback to text format
-    const deviceMatch = message.match(/device[:\s]+(ON|OFF)/i);
-    const periodicMatch = message.match(/periodic[:\s]+(ON|OFF)/i);
-
-    if (deviceMatch || periodicMatch) {
-      return {
-        device: deviceMatch
-          ? deviceMatch[1].toUpperCase() === "ON"
-          : isDeviceOn,
-        periodic: periodicMatch
-          ? periodicMatch[1].toUpperCase() === "ON"
-          : isPeriodic,
-      };
-    }
-  }
+  if (!isMqttConnected || !mqttClient || !selectedDevice) return;
 
-  return null;
+  addStatus(`Requesting state sync from ${selectedDevice}...`, "SYNC");
+  mqttClient.publish(deviceTopic("systemState"), "REQUEST", { qos: 1 });
 }
 
 function syncUIWithHardwareState(state) {
   isDeviceOn = state.device;
   isPeriodic = state.periodic;
+  postStreamState();
 
   // USE HELPER FUNCTIONS
   updateDeviceButtonUI();
@@ -652,6 +1191,85 @@ function syncUIWithHardwareState(state) {
   );
 }
 
+// ====================================================================
+// DEVICES
+// ====================================================================
+
+/**
+ * Per-device state machine. An entry is created on a device's first
+ * message (discovery) and updated from its state topic and readings, and
+ * for the selected device also from the buttons. isDeviceOn/isPeriodic
+ * mirror the selected entry. The first device seen is selected when none
+ * was saved.
+ * @param {string} device - Gateway client id
+ * @param {Object} changes - {deviceOn?, periodic?, lastSeen?}
+ */
+function updateDeviceState(device, changes) {
+  if (!device) return;
+
+  let state = deviceStates.get(device);
+  if (!state) {
+    state = { deviceOn: false, periodic: false, lastSeen: null };
+    deviceStates.set(device, state);
+    addDeviceOption(device);
+    addStatus(`Device discovered: ${device}`, "INFO");
+    if (!selectedDevice) selectDevice(device);
+  }
+  Object.assign(state, changes);
+}
+
+function addDeviceOption(device) {
+  const select = document.getElementById("deviceSelect");
+  if ([...select.options].some((option) => option.value === device)) return;
+
+  select.querySelector('option[value=""]')?.remove();
+  const option = document.createElement("option");
+  option.value = device;
+  option.textContent = device;
+  select.appendChild(option);
+  select.value = selectedDevice || device;
+}
+
+/**
+ * Show another gateway: its state drives the buttons, commands go to its
+ * topics, and the chart restarts from its retained recent history
+ * @param {string} device - Gateway client id
+ */
+function selectDevice(device) {
+  if (device === selectedDevice && deviceStates.has(device)) return;
+
+  if (mqttClient && selectedDevice) {
+    mqttClient.unsubscribe(deviceTopic("recentHistory"));
+  }
+  selectedDevice = device;
+  localStorage.setItem("selectedDevice", device);
+  HISTORY_API_CONFIG.device = device;
+  addDeviceOption(device);
+
+  const state = deviceStates.get(device) || { deviceOn: false, periodic: false };
+  isDeviceOn = state.deviceOn;
+  isPeriodic = state.periodic;
+  updateDeviceButtonUI();
+  updatePeriodicButtonUI();
+
+  currentTemp = null;
+  currentHumi = null;
+  lastReadingTimestamp = null;
+  updateCurrentDisplay();
+
+  postStreamState();
+  clearChartData();
+  if (mqttClient) {
+    mqttClient.subscribe(deviceTopic("recentHistory"));
+  }
+
+  addStatus(`Selected device ${device}`, "INFO");
+}
+
+document.getElementById("deviceSelect").addEventListener("change", function () {
+  if (this.value) selectDevice(this.value);
+});
+
 // ====================================================================
 // CURRENT DISPLAY
 // ====================================================================
@@ -674,15 +1292,12 @@ function updateCurrentDisplay() {
 // ====================================================================
 // FIREBASE SAVE (New structure)
 // ====================================================================
-function saveToFirebaseSimple(data) {
-  if (!isFirebaseConnected || !firebaseDb) return;
-
+function buildFirebaseRecord(data) {
   // Use device timestamp to create date key, not browser time
   const deviceTimestamp = data.time
     ? (data.time - 7 * 3600) * 1000
     : Date.now();
   const dateStr = new Date(deviceTimestamp).toISOString().split("T")[0];
-  const id = Date.now().toString();
 
   const record = {
     temp: data.temp ?? null,
@@ -701,6 +1316,15 @@ function saveToFirebaseSimple(data) {
     created_at: Date.now(),
   };
 
+  return { dateStr, record };
+}
+
+function saveToFirebaseSimple(data) {
+  if (!isFirebaseConnected || !firebaseDb) return;
+
+  const { dateStr, record } = buildFirebaseRecord(data);
+  const id = Date.now().toString();
+
   firebaseDb
     .ref(`readings/${dateStr}/${id}`)
     .set(record)
@@ -715,6 +1339,92 @@ function saveToFirebaseSimple(data) {
     });
 }
 
+// ====================================================================
+// FIREBASE BACKLOG (batched multi-path writes)
+// ====================================================================
+function queueBacklogReading(reading) {
+  // Without Firebase there is nowhere to put the records
+  if (!firebaseDb) return;
+
+  const { dateStr, record } = buildFirebaseRecord({
+    temp: reading.temp,
+    humi: reading.humi,
+    mode: reading.mode,
+    sensor: "SHT31",
+    time: reading.time,
+    device: reading.device,
+  });
+  record.seq = reading.seq;
+
+  // Zero-padded so the keys of one device sort in replay order
+  const key = `${record.device}_${String(reading.seq).padStart(10, "0")}`;
+  backlogPending.set(`readings/${dateStr}/${key}`, record);
+
+  if (backlogPending.size >= BACKLOG_CONFIG.batchSize) {
+    flushBacklog();
+  } else {
+    scheduleBacklogFlush(BACKLOG_CONFIG.flushDelayMs);
+  }
+}
+
+function scheduleBacklogFlush(delayMs) {
+  if (backlogFlushTimer !== null) return;
+  backlogFlushTimer = setTimeout(() => {
+    backlogFlushTimer = null;
+    flushBacklog();
+  }, delayMs);
+}
+
+// One update() per batch: all paths are written in a single round-trip
+function flushBacklog() {
+  if (backlogFlushInFlight || backlogPending.size === 0) return;
+  if (!isFirebaseConnected || !firebaseDb) {
+    scheduleBacklogFlush(BACKLOG_CONFIG.retryDelayMs);
+    return;
+  }
+
+  const batch = new Map();
+  for (const [path, record] of backlogPending) {
+    batch.set(path, record);
+    if (batch.size >= BACKLOG_CONFIG.batchSize) break;
+  }
+  const updates = {};
+  for (const [path, record] of batch) {
+    updates[path] = record;
+    backlogPending.delete(path);
+  }
+
+  backlogFlushInFlight = true;
+  firebaseDb
+    .ref()
+    .update(updates)
+    .then(() => {
+      backlogFlushInFlight = false;
+      backlogSavedCount += batch.size;
+      addStatus(
+        `Firebase backlog saved: ${batch.size} records (${backlogSavedCount} total)`,
+        "FIREBASE"
+      );
+      if (backlogPending.size >= BACKLOG_CONFIG.batchSize) {
+        flushBacklog();
+      } else if (backlogPending.size > 0) {
+        scheduleBacklogFlush(BACKLOG_CONFIG.flushDelayMs);
+      }
+    })
+    .catch((err) => {
+      backlogFlushInFlight = false;
+      // Put the batch back unless a newer copy arrived meanwhile (same key, same record)
+      for (const [path, record] of batch) {
+        if (!backlogPending.has(path)) backlogPending.set(path, record);
+      }
+      addStatus(
+        `Firebase backlog error: ${err.message} (${backlogPending.size} pending, retrying)`,
+        "ERROR"
+      );
+      scheduleBacklogFlush(BACKLOG_CONFIG.retryDelayMs);
+    });
+}
+
 // ====================================================================
 // CHARTS
 // ====================================================================
@@ -937,20 +1647,11 @@ function initializeCharts() {
     });
 
     // If there's existing data, render it now
-    if (temperatureData.length > 0) {
-      console.log("[CHART] Rendering existing temperature data...");
-      tempChart.data.labels = temperatureData.map((d) => d.time);
-      tempChart.data.datasets[0].data = temperatureData.map((d) => d.value);
-      tempChart.update("none");
-      updateChartStats("temp");
-    }
-
-    if (humidityData.length > 0) {
-      console.log("[CHART] Rendering existing humidity data...");
-      humiChart.data.labels = humidityData.map((d) => d.time);
-      humiChart.data.datasets[0].data = humidityData.map((d) => d.value);
-      humiChart.update("none");
-      updateChartStats("humi");
+    if (temperatureData.length > 0 || humidityData.length > 0) {
+      console.log("[CHART] Rendering existing data...");
+      temperatureData.invalidate();
+      humidityData.invalidate();
+      scheduleChartRender();
     }
 
     addStatus("Charts initialized successfully", "INFO");
@@ -960,81 +1661,246 @@ function initializeCharts() {
   }
 }
 
-function pushTemperature(value, update = true, timestamp = null) {
-  // Lazy init in case initial boot missed DOM timing
-  if (!tempChart || !humiChart) ensureChartsInitialized();
-  const time = timestamp
-    ? new Date(timestamp).toLocaleTimeString("en-US", { hour12: false })
-    : new Date().toLocaleTimeString("en-US", { hour12: false });
+// Points drawn per chart; longer windows are decimated with LTTB
+const CHART_RENDER_POINTS = 200;
+
+/**
+ * Fixed-capacity chart series in typed arrays.
+ * push() never allocates: the oldest point is overwritten when full.
+ */
+class SeriesRing {
+  constructor(capacity) {
+    this.length = 0;
+    this.start = 0;
+    this.capacity = 0;
+    this.resize(capacity);
+  }
+
+  /**
+   * Change the capacity, keeping the newest points
+   * @param {number} capacity - Max points
+   */
+  resize(capacity) {
+    const times = new Float64Array(capacity);
+    const values = new Float32Array(capacity);
+    const keep = Math.min(this.length, capacity);
+
+    for (let k = 0; k < keep; k++) {
+      times[k] = this.timeAt(this.length - keep + k);
+      values[k] = this.valueAt(this.length - keep + k);
+    }
+
+    this.times = times;
+    this.values = values;
+    this.capacity = capacity;
+    this.start = 0;
+    this.length = keep;
+    this.invalidate();
+  }
 
-  temperatureData.push({ value, time });
+  clear() {
+    this.start = 0;
+    this.length = 0;
+    this.invalidate();
+  }
 
-  if (temperatureData.length > maxDataPoints) {
-    temperatureData.shift();
+  /** Force a full chart rebuild on the next render */
+  invalidate() {
+    this.added = 0;
+    this.rebuild = true;
   }
 
-  if (update) {
-    if (tempChart) {
-      tempChart.data.labels = temperatureData.map((d) => d.time);
-      tempChart.data.datasets[0].data = temperatureData.map((d) => d.value);
-      tempChart.update("active");
-      updateChartStats("temp");
+  push(time, value) {
+    const i = (this.start + this.length) % this.capacity;
+    if (this.length === this.capacity) {
+      this.start = (this.start + 1) % this.capacity;
+    } else {
+      this.length++;
     }
+    this.times[i] = time;
+    this.values[i] = value;
+    this.added++;
+  }
+
+  /** @param {number} k - Index from the oldest point */
+  timeAt(k) {
+    return this.times[(this.start + k) % this.capacity];
+  }
+
+  /** @param {number} k - Index from the oldest point */
+  valueAt(k) {
+    return this.values[(this.start + k) % this.capacity];
   }
 }
 
-function pushHumidity(value, update = true, timestamp = null) {
-  // Lazy init in case initial boot missed DOM timing
-  if (!tempChart || !humiChart) ensureChartsInitialized();
-  const time = timestamp
-    ? new Date(timestamp).toLocaleTimeString("en-US", { hour12: false })
-    : new Date().toLocaleTimeString("en-US", { hour12: false });
+let temperatureData = new SeriesRing(maxDataPoints);
+let humidityData = new SeriesRing(maxDataPoints);
 
-  humidityData.push({ value, time });
+// Redraw scheduling: all readings of a burst are drawn in one frame
+let chartRenderFrame = null;
+let chartRenderTimer = null;
+let lastChartRenderMs = -Infinity;
+const lttbIndices = new Uint32Array(CHART_RENDER_POINTS);
 
-  if (humidityData.length > maxDataPoints) {
-    humidityData.shift();
-  }
+function formatChartTime(ms) {
+  return new Date(ms).toLocaleTimeString("en-US", { hour12: false });
+}
 
-  if (update) {
-    if (humiChart) {
-      humiChart.data.labels = humidityData.map((d) => d.time);
-      humiChart.data.datasets[0].data = humidityData.map((d) => d.value);
-      humiChart.update("active");
-      updateChartStats("humi");
+/**
+ * Largest-Triangle-Three-Buckets: pick the points that keep the visual shape
+ * @param {SeriesRing} ring - Series
+ * @param {number} threshold - Points to keep (>= 3, < ring.length)
+ * @param {Uint32Array} out - Output indices (from the oldest point)
+ * @returns {number} Number of indices written
+ */
+function lttbDecimate(ring, threshold, out) {
+  const n = ring.length;
+  const every = (n - 2) / (threshold - 2);
+  let a = 0;
+  let o = 0;
+
+  out[o++] = 0;
+  for (let i = 0; i < threshold - 2; i++) {
+    // Average of the next bucket is the third triangle corner
+    const avgStart = Math.floor((i + 1) * every) + 1;
+    const avgEnd = Math.min(Math.floor((i + 2) * every) + 1, n);
+    let avgX = 0;
+    let avgY = 0;
+    for (let j = avgStart; j < avgEnd; j++) {
+      avgX += ring.timeAt(j);
+      avgY += ring.valueAt(j);
     }
+    avgX /= avgEnd - avgStart;
+    avgY /= avgEnd - avgStart;
+
+    const ax = ring.timeAt(a);
+    const ay = ring.valueAt(a);
+    const rangeEnd = Math.floor((i + 1) * every) + 1;
+    let maxArea = -1;
+    let next = a + 1;
+    for (let j = Math.floor(i * every) + 1; j < rangeEnd; j++) {
+      const area = Math.abs(
+        (ax - avgX) * (ring.valueAt(j) - ay) - (ax - ring.timeAt(j)) * (avgY - ay)
+      );
+      if (area > maxArea) {
+        maxArea = area;
+        next = j;
+      }
+    }
+    out[o++] = next;
+    a = next;
   }
+  out[o++] = n - 1;
+  return o;
 }
 
-function updateChartStats(type) {
-  const data = type === "temp" ? temperatureData : humidityData;
-  if (data.length === 0) return;
+/**
+ * Bring a chart in line with its series.
+ * New points are pushed onto the dataset arrays and the oldest spliced off
+ * in place; a full rebuild only follows clear/resize/history load, and
+ * windows longer than CHART_RENDER_POINTS are redrawn decimated.
+ */
+function syncChart(chart, ring) {
+  if (!chart || (ring.added === 0 && !ring.rebuild)) return;
+
+  const labels = chart.data.labels;
+  const data = chart.data.datasets[0].data;
+  const added = ring.added;
+  const decimate = ring.length > CHART_RENDER_POINTS;
+
+  if (decimate) {
+    const count = lttbDecimate(ring, CHART_RENDER_POINTS, lttbIndices);
+    labels.length = 0;
+    data.length = 0;
+    for (let i = 0; i < count; i++) {
+      labels.push(formatChartTime(ring.timeAt(lttbIndices[i])));
+      data.push(ring.valueAt(lttbIndices[i]));
+    }
+  } else if (ring.rebuild || added >= ring.length) {
+    labels.length = 0;
+    data.length = 0;
+    for (let k = 0; k < ring.length; k++) {
+      labels.push(formatChartTime(ring.timeAt(k)));
+      data.push(ring.valueAt(k));
+    }
+  } else {
+    for (let k = ring.length - added; k < ring.length; k++) {
+      labels.push(formatChartTime(ring.timeAt(k)));
+      data.push(ring.valueAt(k));
+    }
+    const excess = data.length - ring.length;
+    if (excess > 0) {
+      labels.splice(0, excess);
+      data.splice(0, excess);
+    }
+  }
 
-  const values = data.map((d) => d.value);
-  const min = Math.min(...values);
-  const max = Math.max(...values);
-  const avg = values.reduce((a, b) => a + b, 0) / values.length;
+  // Decimated output changes everywhere, so the next render rebuilds too
+  ring.rebuild = decimate;
+  ring.added = 0;
 
-  document.getElementById(`${type}Min`).textContent = min.toFixed(1);
-  document.getElementById(`${type}Max`).textContent = max.toFixed(1);
-  document.getElementById(`${type}Avg`).textContent = avg.toFixed(1);
+  // Animate a single live reading; bursts and rebuilds draw immediately
+  chart.update(added === 1 && !decimate ? "active" : "none");
 }
 
-function clearChartData() {
-  temperatureData = [];
-  humidityData = [];
+function renderCharts() {
+  chartRenderFrame = null;
+  lastChartRenderMs = performance.now();
+  syncChart(tempChart, temperatureData);
+  syncChart(humiChart, humidityData);
+}
 
-  if (tempChart) {
-    tempChart.data.labels = [];
-    tempChart.data.datasets[0].data = [];
-    tempChart.update();
-  }
+/**
+ * Request a redraw: at most one per animation frame and per chart update
+ * interval (setting), the first one after a quiet period without delay
+ */
+function scheduleChartRender() {
+  if (chartRenderFrame !== null || chartRenderTimer !== null) return;
+
+  const requestFrame = () => {
+    chartRenderTimer = null;
+    chartRenderFrame = requestAnimationFrame(renderCharts);
+  };
+  const wait = lastChartRenderMs + chartUpdateIntervalMs - performance.now();
 
-  if (humiChart) {
-    humiChart.data.labels = [];
-    humiChart.data.datasets[0].data = [];
-    humiChart.update();
+  if (wait > 0) {
+    chartRenderTimer = setTimeout(requestFrame, wait);
+  } else {
+    requestFrame();
   }
+}
+
+function pushTemperature(value, update = true, timestamp = null) {
+  // Lazy init in case initial boot missed DOM timing
+  if (!tempChart || !humiChart) ensureChartsInitialized();
+
+  temperatureData.push(timestamp || Date.now(), value);
+  if (update) scheduleChartRender();
+}
+
+function pushHumidity(value, update = true, timestamp = null) {
+  // Lazy init in case initial boot missed DOM timing
+  if (!tempChart || !humiChart) ensureChartsInitialized();
+
+  humidityData.push(timestamp || Date.now(), value);
+  if (update) scheduleChartRender();
+}
+
+// Min/max/avg are kept by the MQTT decoder (RollingStats) over the chart window
+function updateChartStats(type) {
+  const stats = chartStats[type];
+  if (!stats) return;
+
+  document.getElementById(`${type}Min`).textContent = stats.min.toFixed(1);
+  document.getElementById(`${type}Max`).textContent = stats.max.toFixed(1);
+  document.getElementById(`${type}Avg`).textContent = stats.avg.toFixed(1);
+}
+
+function clearChartData() {
+  temperatureData.clear();
+  humidityData.clear();
+  scheduleChartRender();
+  postChartSeed();
 
   document.getElementById("tempMin").textContent = "--";
   document.getElementById("tempMax").textContent = "--";
@@ -1050,33 +1916,11 @@ function clearChartData() {
 // APPLY CHART SETTINGS DYNAMICALLY
 // ====================================================================
 function applyChartSettings() {
-  // Trim temperature data if exceeds new limit
-  if (temperatureData.length > maxDataPoints) {
-    const removeCount = temperatureData.length - maxDataPoints;
-    temperatureData.splice(0, removeCount);
-  }
-
-  // Trim humidity data if exceeds new limit
-  if (humidityData.length > maxDataPoints) {
-    const removeCount = humidityData.length - maxDataPoints;
-    humidityData.splice(0, removeCount);
-  }
-
-  // Update temperature chart
-  if (tempChart) {
-    tempChart.data.labels = temperatureData.map((d) => d.time);
-    tempChart.data.datasets[0].data = temperatureData.map((d) => d.value);
-    tempChart.update("none"); // 'none' = no animation for instant update
-    updateChartStats("temp");
-  }
-
-  // Update humidity chart
-  if (humiChart) {
-    humiChart.data.labels = humidityData.map((d) => d.time);
-    humiChart.data.datasets[0].data = humidityData.map((d) => d.value);
-    humiChart.update("none");
-    updateChartStats("humi");
-  }
+  // Keeps the newest points if the window shrinks
+  temperatureData.resize(maxDataPoints);
+  humidityData.resize(maxDataPoints);
+  scheduleChartRender();
+  postStreamState();
 
   addStatus(`Charts refreshed with ${maxDataPoints} max points`, "INFO");
 }
@@ -1099,6 +1943,11 @@ document.getElementById("deviceBtn").addEventListener("click", function () {
     return;
   }
 
+  if (!selectedDevice) {
+    addStatus("No device selected", "WARNING");
+    return;
+  }
+
   // Toggle device state
   const command = isDeviceOn ? "RELAY OFF" : "RELAY ON";
   const willBeDeviceOn = !isDeviceOn;
@@ -1107,7 +1956,7 @@ document.getElementById("deviceBtn").addEventListener("click", function () {
   lockDeviceButton();
 
   // Publish MQTT command
-  mqttClient.publish(MQTT_CONFIG.topics.relayControl, command, { qos: 1 });
+  mqttClient.publish(deviceTopic("relayControl"), command, { qos: 1 });
 
   // Update state immediately
   isDeviceOn = willBeDeviceOn;
@@ -1120,11 +1969,12 @@ document.getElementById("deviceBtn").addEventListener("click", function () {
     isPeriodic = false;
     updatePeriodicButtonUI();
 
-    mqttClient.publish(MQTT_CONFIG.topics.stm32Command, "PERIODIC OFF", {
+    mqttClient.publish(deviceTopic("stm32Command"), "PERIODIC OFF", {
       qos: 1,
     });
     addStatus("Periodic mode stopped (device OFF)", "SYNC");
   }
+  postStreamState();
 
   // Reset current values when device OFF
   if (!isDeviceOn) {
@@ -1284,6 +2134,11 @@ document.getElementById("periodicBtn").addEventListener("click", function () {
     return;
   }
 
+  if (!selectedDevice) {
+    addStatus("No device selected", "WARNING");
+    return;
+  }
+
   if (!isDeviceOn) {
     addStatus("Device must be ON first", "WARNING");
     return;
@@ -1294,10 +2149,11 @@ document.getElementById("periodicBtn").addEventListener("click", function () {
   const command = willBePeriodic ? "PERIODIC ON" : "PERIODIC OFF";
 
   // Publish MQTT command
-  mqttClient.publish(MQTT_CONFIG.topics.stm32Command, command, { qos: 1 });
+  mqttClient.publish(deviceTopic("stm32Command"), command, { qos: 1 });
 
   // Update state immediately
   isPeriodic = willBePeriodic;
+  postStreamState();
 
   // Update UI - show CURRENT state
   const periodicBtn = document.getElementById("periodicBtn");
@@ -1319,12 +2175,17 @@ document.getElementById("singleBtn").addEventListener("click", function () {
     return;
   }
 
+  if (!selectedDevice) {
+    addStatus("No device selected", "WARNING");
+    return;
+  }
+
   if (!isDeviceOn) {
     addStatus("Device must be ON first", "WARNING");
     return;
   }
 
-  mqttClient.publish(MQTT_CONFIG.topics.stm32Command, "SINGLE", { qos: 1 });
+  mqttClient.publish(deviceTopic("stm32Command"), "SINGLE", { qos: 1 });
   addStatus("Single read command sent", "MQTT");
 });
 
@@ -1389,7 +2250,11 @@ function loadHistoryFromFirebase() {
 
   Promise.all(promises)
     .then((results) => {
-      const allData = results.flat();
+      // The chart shows the selected device (records older than the device
+      // field belong to the single logger of that time)
+      const allData = results
+        .flat()
+        .filter((record) => !selectedDevice || (record.device || "ESP32_01") === selectedDevice);
       totalRecords = allData.length;
 
       if (totalRecords === 0) {
@@ -1411,8 +2276,8 @@ function loadHistoryFromFirebase() {
       addStatus(`Loading ${pointsToLoad} most recent points (out of ${totalRecords} total)`, "INFO");
 
       // Clear existing chart data
-      temperatureData = [];
-      humidityData = [];
+      temperatureData.clear();
+      humidityData.clear();
 
       // Populate charts
       recentData.forEach((record) => {
@@ -1432,20 +2297,9 @@ function loadHistoryFromFirebase() {
         }
       });
 
-      // Update charts
-      if (tempChart) {
-        tempChart.data.labels = temperatureData.map((d) => d.time);
-        tempChart.data.datasets[0].data = temperatureData.map((d) => d.value);
-        tempChart.update("active");
-        updateChartStats("temp");
-      }
-
-      if (humiChart) {
-        humiChart.data.labels = humidityData.map((d) => d.time);
-        humiChart.data.datasets[0].data = humidityData.map((d) => d.value);
-        humiChart.update("active");
-        updateChartStats("humi");
-      }
+      // Update charts (one rebuild for the whole batch)
+      scheduleChartRender();
+      postChartSeed();
 
       addStatus(
         `Loaded ${totalRecords} records (last 24h), showing ${pointsToLoad} on charts (max: ${maxDataPoints})`,
@@ -1466,66 +2320,56 @@ document
 // ====================================================================
 // LIVE DATA TABLE
 // ====================================================================
-function addToLiveDataTable(data) {
-  liveDataBuffer.unshift(data);
-
-  if (liveDataBuffer.length > maxLiveDataEntries) {
-    liveDataBuffer.pop();
-  }
-
-  renderLiveDataTable();
-}
-
-function renderLiveDataTable() {
-  const tbody = document.getElementById("liveDataTable");
-  const filter = document.getElementById("liveDataFilter")?.value || "all";
-
-  let filtered = liveDataBuffer;
-  if (filter === "success") {
-    filtered = liveDataBuffer.filter((d) => d.status === "success");
-  } else if (filter === "error") {
-    filtered = liveDataBuffer.filter((d) => d.status === "error");
-  }
-
-  if (filtered.length === 0) {
-    tbody.innerHTML =
-      '<tr><td colspan="6" style="padding: 2rem; text-align: center; color: var(--text-muted);">No data available</td></tr>';
-    document.getElementById("liveDataCount").textContent = "0";
-    return;
-  }
-
-  tbody.innerHTML = filtered
-    .map((data, idx) => {
-      const dateTime = formatDateTime(new Date(data.time));
-      const tempDisplay = formatTemperature(data.temp);
-      const statusClass =
-        data.status === "success" ? "connected" : "disconnected";
-      const statusText = data.status === "success" ? " Success" : " Error";
-
-      return `
-                    <tr style="border-bottom: 1px solid var(--border-color);">
-                        <td style="padding: 0.75rem;">${idx + 1}</td>
+// Rows are numbered in arrival order, so a new reading never renumbers the rows in view
+const liveDataList = new VirtualList({
+  capacity: maxLiveDataEntries,
+  scrollId: "liveDataScroll",
+  bodyId: "liveDataTable",
+  rowHeight: 49,
+  renderRow: (data, number) => {
+    const dateTime = formatDateTime(new Date(data.time));
+    const tempDisplay = formatTemperature(data.temp);
+    const statusClass =
+      data.status === "success" ? "connected" : "disconnected";
+    const statusText = data.status === "success" ? " Success" : " Error";
+
+    return `<tr style="border-bottom: 1px solid var(--border-color);">
+                        <td style="padding: 0.75rem;">${number}</td>
                         <td style="padding: 0.75rem;">${dateTime}</td>
                         <td style="padding: 0.75rem;">${tempDisplay}</td>
-                        <td style="padding: 0.75rem;">${data.humi.toFixed(
-        1
-      )}%</td>
-                        <td style="padding: 0.75rem; text-transform: capitalize;">${data.mode
-        }</td>
+                        <td style="padding: 0.75rem;">${data.humi.toFixed(1)}%</td>
+                        <td style="padding: 0.75rem; text-transform: capitalize;">${data.mode}</td>
                         <td style="padding: 0.75rem;">
                             <span class="status-badge ${statusClass}" style="font-size: 0.75rem; padding: 0.25rem 0.5rem;">
                                 ${statusText}
                             </span>
                         </td>
-                    </tr>
-                `;
-    })
-    .join("");
+                    </tr>`;
+  },
+  createSpacer: () => {
+    const row = document.createElement("tr");
+    row.setAttribute("aria-hidden", "true");
+    return row;
+  },
+  emptyHtml:
+    '<tr><td colspan="6" style="padding: 2rem; text-align: center; color: var(--text-muted);">No data available</td></tr>',
+  onCount: (count) => {
+    document.getElementById("liveDataCount").textContent = count;
+  },
+});
 
-  document.getElementById("liveDataCount").textContent = filtered.length;
+function addToLiveDataTable(data) {
+  liveDataList.push(data);
+}
 
-  // Re-initialize feather icons
-  if (typeof feather !== "undefined") feather.replace();
+function renderLiveDataTable() {
+  const filter = document.getElementById("liveDataFilter")?.value || "all";
+
+  liveDataList.setFilter(
+    filter,
+    filter === "all" ? null : (d) => d.status === filter
+  );
+  liveDataList.refresh();
 }
 
 document
@@ -1544,8 +2388,7 @@ function bindLiveDataButtons() {
 
     newClearBtn.addEventListener("click", function () {
       if (confirm("Clear all live data?")) {
-        liveDataBuffer = [];
-        renderLiveDataTable();
+        liveDataList.clear();
         addStatus("Live data cleared", "INFO");
       }
     });
@@ -1557,7 +2400,7 @@ function bindLiveDataButtons() {
     exportBtn.parentNode.replaceChild(newExportBtn, exportBtn);
 
     newExportBtn.addEventListener("click", function () {
-      if (liveDataBuffer.length === 0) {
+      if (liveDataList.length === 0) {
         addStatus("No data to export", "WARNING");
         return;
       }
@@ -1566,7 +2409,7 @@ function bindLiveDataButtons() {
         ["#", "DateTime", "Temperature", "Humidity (%)", "Mode", "Status"].join(
           ","
         ),
-        ...liveDataBuffer.map((d, idx) => {
+        ...liveDataList.toArray().map((d, idx) => {
           const dateTime = formatDateTime(new Date(d.time));
           const tempDisplay = formatTemperature(d.temp);
           return [idx + 1, dateTime, tempDisplay, d.humi.toFixed(2), d.mode, d.status].join(",");
@@ -1903,8 +2746,8 @@ function onSyncTimeClick() {
   // Send to device (add 7 hours offset for Vietnam timezone UTC+7)
   const timestampWithOffset = timestamp + 7 * 3600; // Add 7 hours in seconds
   const command = `SET TIME ${timestampWithOffset}`;
-  if (isMqttConnected && mqttClient) {
-    mqttClient.publish(MQTT_CONFIG.topics.stm32Command, command, { qos: 1 });
+  if (isMqttConnected && mqttClient && selectedDevice) {
+    mqttClient.publish(deviceTopic("stm32Command"), command, { qos: 1 });
     addStatus(
       `Time synced from internet: ${now.toLocaleString()} (UTC+7 sent to device)`,
       "SYNC"
@@ -1951,8 +2794,8 @@ function onManualTimeClick() {
   // Send to device (add 7 hours offset for Vietnam timezone UTC+7)
   const timestampWithOffset = timestamp + 7 * 3600; // Add 7 hours in seconds
   const command = `SET TIME ${timestampWithOffset}`;
-  if (isMqttConnected && mqttClient) {
-    mqttClient.publish(MQTT_CONFIG.topics.stm32Command, command, { qos: 1 });
+  if (isMqttConnected && mqttClient && selectedDevice) {
+    mqttClient.publish(deviceTopic("stm32Command"), command, { qos: 1 });
     addStatus(
       `Manual time set: ${date.toLocaleString()} (UTC+7 sent to device)`,
       "SETTING"
@@ -2005,11 +2848,6 @@ function getDateRange(startDate, endDate) {
 }
 
 function applyDataFilters() {
-  if (!isFirebaseConnected || !firebaseDb) {
-    addStatus("Firebase not connected", "ERROR");
-    return;
-  }
-
   const filters = {
     dateFrom: document.getElementById("filterDateFrom").value || "2024-01-01",
     dateTo:
@@ -2030,6 +2868,28 @@ function applyDataFilters() {
     sortBy: document.getElementById("filterSort").value,
   };
 
+  if (HISTORY_API_CONFIG.url) {
+    loadFromHistoryApi(filters).catch((err) => {
+      addStatus(
+        `History API unavailable (${err.message}), using Firebase`,
+        "WARNING"
+      );
+      loadFromFirebase(filters);
+    });
+    return;
+  }
+
+  loadFromFirebase(filters);
+}
+
+function loadFromFirebase(filters) {
+  if (!isFirebaseConnected || !firebaseDb) {
+    addStatus("Firebase not connected", "ERROR");
+    return;
+  }
+
+  historyQuery = null;
+  updateLoadMoreButton();
   addStatus("Loading filtered data from Firebase...", "INFO");
 
   const dateRange = getDateRange(filters.dateFrom, filters.dateTo);
@@ -2086,6 +2946,124 @@ function applyDataFilters() {
     });
 }
 
+/**
+ * Build History API parameters from the filter form
+ * @param {Object} filters - Filters from applyDataFilters()
+ * @returns {URLSearchParams} Query parameters (dates are UTC days, like readings/<date>)
+ */
+function buildHistoryParams(filters) {
+  const params = new URLSearchParams({
+    device: HISTORY_API_CONFIG.device,
+    from: Date.parse(`${filters.dateFrom}T00:00:00Z`) / 1000,
+    to: Date.parse(`${filters.dateTo}T00:00:00Z`) / 1000 + 86399,
+    sort: filters.sortBy,
+  });
+
+  if (filters.mode) params.set("mode", filters.mode);
+  if (filters.status) params.set("status", filters.status);
+  if (isFinite(filters.tempMin)) params.set("temp_min", filters.tempMin);
+  if (isFinite(filters.tempMax)) params.set("temp_max", filters.tempMax);
+  if (isFinite(filters.humiMin)) params.set("humi_min", filters.humiMin);
+  if (isFinite(filters.humiMax)) params.set("humi_max", filters.humiMax);
+  return params;
+}
+
+/**
+ * Fetch one page of readings from the History API
+ * @param {URLSearchParams} params - Filter parameters
+ * @param {number} offset - Rows to skip
+ * @param {number} limit - Rows to return
+ * @returns {Promise<Object>} Response with rows in the Firebase record shape
+ */
+async function fetchHistoryPage(params, offset, limit) {
+  const page = new URLSearchParams(params);
+  page.set("offset", offset);
+  page.set("limit", limit);
+
+  const response = await fetch(`${HISTORY_API_CONFIG.url}/api/readings?${page}`);
+  const result = await response.json();
+  if (!response.ok) {
+    throw new Error(result.error || `HTTP ${response.status}`);
+  }
+
+  result.rows = result.rows.map((row) => ({
+    ...row,
+    sensor: "SHT31",
+    device: result.device,
+    created_at: row.time * 1000,
+  }));
+  return result;
+}
+
+async function loadFromHistoryApi(filters) {
+  const params = buildHistoryParams(filters);
+
+  addStatus("Loading filtered data from History API...", "INFO");
+  const result = await fetchHistoryPage(params, 0, HISTORY_API_CONFIG.pageSize);
+
+  historyQuery = { params, result };
+  filteredDataCache = result.rows;
+  renderDataManagementTable(filteredDataCache);
+  updateHistoryStatistics(result);
+  updateLoadMoreButton();
+
+  addStatus(
+    `Loaded ${result.rows.length} of ${result.total} records ` +
+      `(${(result.scan.elapsed_us / 1000).toFixed(1)} ms, ` +
+      `${result.scan.decoded}/${result.scan.blocks} blocks decoded)`,
+    "INFO"
+  );
+}
+
+async function loadMoreHistory() {
+  if (!historyQuery) return;
+
+  try {
+    const result = await fetchHistoryPage(
+      historyQuery.params,
+      filteredDataCache.length,
+      HISTORY_API_CONFIG.pageSize
+    );
+    historyQuery.result = result;
+    filteredDataCache = filteredDataCache.concat(result.rows);
+    renderDataManagementTable(filteredDataCache);
+    updateHistoryStatistics(result);
+    updateLoadMoreButton();
+  } catch (err) {
+    addStatus(`Load error: ${err.message}`, "ERROR");
+  }
+}
+
+function updateLoadMoreButton() {
+  const btn = document.getElementById("loadMoreBtn");
+  if (!btn) return;
+
+  const more =
+    historyQuery && filteredDataCache.length < historyQuery.result.total;
+  btn.style.display = more ? "" : "none";
+}
+
+/**
+ * Show server-side statistics (they cover every match, not just the loaded pages)
+ * @param {Object} result - History API response
+ */
+function updateHistoryStatistics(result) {
+  const avgTemp = result.temp_avg;
+  const avgHumi = result.humi_avg;
+
+  document.getElementById("statsTotal").textContent = result.total;
+  document.getElementById("statsSuccess").textContent =
+    result.total > 0
+      ? ((result.valid / result.total) * 100).toFixed(1) + "%"
+      : "--";
+  document.getElementById("statsAvgTemp").textContent =
+    avgTemp !== null ? avgTemp.toFixed(1) + "°C" : "--";
+  document.getElementById("statsAvgHumi").textContent =
+    avgHumi !== null ? avgHumi.toFixed(1) + "%" : "--";
+  document.getElementById("dataManagementCount").textContent =
+    `${filteredDataCache.length} of ${result.total}`;
+}
+
 function applySorting(data, sortBy) {
   const [field, order] = sortBy.split("-");
 
@@ -2162,24 +3140,27 @@ function updateDataStatistics(data) {
     return;
   }
 
-  const successCount = data.filter((d) => d.status === "success").length;
+  // One pass over the loaded records (0 = sensor failure, excluded from averages)
+  let successCount = 0;
+  let tempSum = 0;
+  let tempCount = 0;
+  let humiSum = 0;
+  let humiCount = 0;
+  for (const d of data) {
+    if (d.status === "success") successCount++;
+    if (d.temp !== null && d.temp !== undefined && d.temp !== 0) {
+      tempSum += d.temp;
+      tempCount++;
+    }
+    if (d.humi !== null && d.humi !== undefined && d.humi !== 0) {
+      humiSum += d.humi;
+      humiCount++;
+    }
+  }
   const successRate = ((successCount / data.length) * 100).toFixed(1);
 
-  const temps = data
-    .filter((d) => d.temp !== null && d.temp !== 0)
-    .map((d) => d.temp);
-  const humis = data
-    .filter((d) => d.humi !== null && d.humi !== 0)
-    .map((d) => d.humi);
-
-  const avgTemp =
-    temps.length > 0
-      ? (temps.reduce((a, b) => a + b, 0) / temps.length).toFixed(1)
-      : "--";
-  const avgHumi =
-    humis.length > 0
-      ? (humis.reduce((a, b) => a + b, 0) / humis.length).toFixed(1)
-      : "--";
+  const avgTemp = tempCount > 0 ? (tempSum / tempCount).toFixed(1) : "--";
+  const avgHumi = humiCount > 0 ? (humiSum / humiCount).toFixed(1) : "--";
 
   document.getElementById("statsTotal").textContent = data.length;
   document.getElementById("statsSuccess").textContent = successRate + "%";
@@ -2195,12 +3176,33 @@ function updateDataStatistics(data) {
     avgHumi + (avgHumi !== "--" ? "%" : "");
 }
 
-function exportFilteredData() {
+async function exportFilteredData() {
   if (!filteredDataCache || filteredDataCache.length === 0) {
     addStatus("No data to export. Apply filters first.", "WARNING");
     return;
   }
 
+  // Only a page is loaded: fetch all matches (up to exportLimit) in one request
+  let records = filteredDataCache;
+  if (historyQuery && records.length < historyQuery.result.total) {
+    try {
+      const limit = Math.min(
+        historyQuery.result.total,
+        HISTORY_API_CONFIG.exportLimit
+      );
+      records = (await fetchHistoryPage(historyQuery.params, 0, limit)).rows;
+      if (limit < historyQuery.result.total) {
+        addStatus(
+          `Export limited to the first ${limit} of ${historyQuery.result.total} records`,
+          "WARNING"
+        );
+      }
+    } catch (err) {
+      addStatus(`Export error: ${err.message}`, "ERROR");
+      return;
+    }
+  }
+
   const headers = [
     "#",
     "Date",
@@ -2212,7 +3214,7 @@ function exportFilteredData() {
     "Sensor",
     "Device",
   ];
-  const rows = filteredDataCache.map((record, idx) => {
+  const rows = records.map((record, idx) => {
     const date = new Date(record.created_at);
     const tempDisplay = formatTemperature(record.temp);
     return [
@@ -2239,7 +3241,7 @@ function exportFilteredData() {
   a.download = `datalogger_export_${Date.now()}.csv`;
   a.click();
 
-  addStatus(`Exported ${filteredDataCache.length} records to CSV`, "INFO");
+  addStatus(`Exported ${records.length} records to CSV`, "INFO");
 }
 
 function resetDataFilters() {
@@ -2254,6 +3256,8 @@ function resetDataFilters() {
   document.getElementById("filterSort").value = "time-desc";
 
   filteredDataCache = [];
+  historyQuery = null;
+  updateLoadMoreButton();
 
   document.getElementById("dataManagementTable").innerHTML =
     '<tr><td colspan="6" style="padding: 2rem; text-align: center; color: var(--text-muted);">No data loaded. Click "Apply Filters" to load data from Firebase.</td></tr>';
@@ -2369,6 +3373,7 @@ function bindDataManagementButtons() {
   const applyBtn = document.getElementById("applyFiltersBtn");
   const resetBtn = document.getElementById("resetFiltersBtn");
   const exportBtn = document.getElementById("exportDataBtn");
+  const loadMoreBtn = document.getElementById("loadMoreBtn");
 
   console.log("[DATA] Action buttons found:", {
     apply: !!applyBtn,
@@ -2409,6 +3414,15 @@ function bindDataManagementButtons() {
     console.warn("[DATA] Export button not found!");
   }
 
+  if (loadMoreBtn) {
+    const newBtn = loadMoreBtn.cloneNode(true);
+    loadMoreBtn.parentNode.replaceChild(newBtn, loadMoreBtn);
+    newBtn.addEventListener("click", () => {
+      console.log("[DATA] Load more clicked");
+      loadMoreHistory();
+    });
+  }
+
   console.log("[DATA] All buttons bound successfully");
 }
 
@@ -2420,68 +3434,18 @@ function bindDataManagementButtons() {
  * Render full console with filtering
  */
 function renderFullConsole() {
-  const consoleEl = document.getElementById("consoleFull");
-  if (!consoleEl) {
-    console.warn("[LOGS] consoleFull element not found");
-    return;
-  }
-
   const searchTerm =
     document.getElementById("logSearchInput")?.value.toLowerCase() || "";
 
-  // Apply filters
-  let filteredLogs = logBuffer.filter((log) => {
-    // Type filter
-    if (logFilterType !== "ALL" && log.type !== logFilterType) return false;
-
-    // Search filter
-    if (searchTerm && !log.message.toLowerCase().includes(searchTerm))
-      return false;
-
-    return true;
-  });
-
-  // Update count
-  const countEl = document.getElementById("logCount");
-  if (countEl) {
-    countEl.textContent = filteredLogs.length;
-  }
-
-  // Empty state
-  if (filteredLogs.length === 0) {
-    consoleEl.innerHTML =
-      '<div style="color: var(--text-muted); text-align: center; padding: 2rem;">No logs found</div>';
-    return;
-  }
-
-  // Color mapping for log types
-  const colors = {
-    INFO: "#3B82F6",
-    WARNING: "#F59E0B",
-    ERROR: "#EF4444",
-    MQTT: "#8B5CF6",
-    FIREBASE: "#F97316",
-    SYNC: "#06B6D4",
-    SETTING: "#14B8A6",
-  };
-
-  // Render logs (newest first)
-  consoleEl.innerHTML = filteredLogs
-    .map((log) => {
-      const time = new Date(log.timestamp).toLocaleTimeString("en-US", {
-        hour12: false,
-      });
-      const color = colors[log.type] || "#10B981";
-
-      return `<div class="log-line log-${log.type.toLowerCase()}" style="color: ${color};">
-                    <strong>[${time}]</strong> <strong style="display: inline-block; min-width: 80px;">[${log.type
-        }]</strong> ${log.message}
-                </div>`;
-    })
-    .join("");
-
-  // Auto-scroll to bottom for new logs
-  consoleEl.scrollTop = consoleEl.scrollHeight;
+  logList.setFilter(
+    `${logFilterType}\n${searchTerm}`,
+    logFilterType === "ALL" && !searchTerm
+      ? null
+      : (log) =>
+        (logFilterType === "ALL" || log.type === logFilterType) &&
+        (!searchTerm || log.message.toLowerCase().includes(searchTerm))
+  );
+  logList.refresh();
 }
 
 /**
@@ -2515,7 +3479,7 @@ function clearLogs() {
   }
 
   // Clear main buffer
-  logBuffer = [];
+  logList.clear();
 
   // Clear preview console on dashboard
   const preview = document.getElementById("consolePreview");
@@ -2524,9 +3488,6 @@ function clearLogs() {
       '<div style="color: var(--text-muted); text-align: center; padding: 1rem;">No logs yet</div>';
   }
 
-  // Re-render full console
-  renderFullConsole();
-
   // Add confirmation log
   addStatus("All logs cleared by user", "INFO");
 }
@@ -2535,19 +3496,19 @@ function clearLogs() {
  * Export logs to CSV
  */
 function exportLogs() {
-  if (logBuffer.length === 0) {
+  if (logList.length === 0) {
     addStatus("No logs to export", "WARNING");
     alert("[WARNING] No logs available to export!");
     return;
   }
 
-  console.log("[LOGS] Exporting", logBuffer.length, "logs...");
+  console.log("[LOGS] Exporting", logList.length, "logs...");
 
   // CSV headers
   const headers = ["Timestamp", "Date/Time", "Type", "Message"];
 
   // CSV rows
-  const rows = logBuffer.map((log) => {
+  const rows = logList.toArray().map((log) => {
     const date = new Date(log.timestamp);
     const dateStr = date.toLocaleDateString();
     const timeStr = date.toLocaleTimeString("en-US", { hour12: false });
@@ -2572,7 +3533,7 @@ function exportLogs() {
   link.click();
   URL.revokeObjectURL(url);
 
-  addStatus(`Exported ${logBuffer.length} logs to CSV`, "INFO");
+  addStatus(`Exported ${logList.length} logs to CSV`, "INFO");
 }
 
 /**
@@ -2707,8 +3668,8 @@ function saveSettings() {
     document.getElementById("chartUpdateInterval").value
   );
 
-  if (maxPoints < 10 || maxPoints > 200) {
-    alert("Error: Max Data Points must be between 10-200!");
+  if (maxPoints < 10 || maxPoints > 10000) {
+    alert("Error: Max Data Points must be between 10-10000!");
     addStatus("Settings validation failed: Invalid max points", "ERROR");
     return;
   }
@@ -2773,6 +3734,7 @@ function saveSettings() {
   // === SAVE CHART SETTINGS (NO RECONNECT NEEDED) ===
   const oldMaxPoints = maxDataPoints;
   maxDataPoints = maxPoints;
+  chartUpdateIntervalMs = updateInterval * 1000;
 
   localStorage.setItem("chartMaxPoints", maxPoints);
   localStorage.setItem("chartUpdateInterval", updateInterval);
@@ -2780,6 +3742,7 @@ function saveSettings() {
     "chartSkipErrors",
     document.getElementById("chartSkipErrors").checked
   );
+  postStreamState();
 
   addStatus(
     `Chart settings: ${maxPoints} points, ${updateInterval}s interval`,
@@ -3095,14 +4058,19 @@ function setPeriodicInterval() {
     return;
   }
 
+  if (!selectedDevice) {
+    addStatus("No device selected", "WARNING");
+    return;
+  }
+
   const command = `SET PERIODIC INTERVAL ${totalSeconds}`;
   console.log(
     "[INTERVAL] Publishing command:",
     command,
     "to",
-    MQTT_CONFIG.topics.stm32Command
+    deviceTopic("stm32Command")
   );
-  mqttClient.publish(MQTT_CONFIG.topics.stm32Command, command, { qos: 1 });
+  mqttClient.publish(deviceTopic("stm32Command"), command, { qos: 1 });
 
   addStatus(
     `Interval set to ${selectedMinute}m ${selectedSecond}s (${totalSeconds}s)`,
@@ -3223,6 +4191,9 @@ function startDeviceClockTicker() {
 function runInitialization() {
   addStatus("DataLogger Monitor starting...", "INFO");
 
+  // Last selected gateway, until the broker reports the others
+  if (selectedDevice) addDeviceOption(selectedDevice);
+
   // Load saved config from localStorage
   const savedMQTT = localStorage.getItem("datalogger_mqtt_config");
   const savedFirebase = localStorage.getItem("datalogger_firebase_config");
@@ -3234,10 +4205,13 @@ function runInitialization() {
 
   if (savedMaxPoints) {
     maxDataPoints = parseInt(savedMaxPoints);
+    temperatureData.resize(maxDataPoints);
+    humidityData.resize(maxDataPoints);
     addStatus(`Loaded chart settings: ${maxDataPoints} max points`, "INFO");
   }
   if (savedUpdateInterval) {
     const interval = parseInt(savedUpdateInterval);
+    chartUpdateIntervalMs = interval * 1000;
     addStatus(`Chart update interval: ${interval}s`, "INFO");
   }
   if (savedSkipErrors !== null) {
@@ -0,0 +1,408 @@
+// ====================================================================
+// MQTT STREAM - payload decoding and rolling statistics
+// ====================================================================
+// Shared by mqtt_worker.js (importScripts) and the dashboard (<script>, used
+// on the main thread when the worker cannot start). No DOM access here.
+
+// Device RTC runs on local time (UTC+7), payload timestamps are shifted back
+const STREAM_DEVICE_UTC_OFFSET_S = 7 * 3600;
+
+// Recent-history snapshot published by the ingest service (ts_recent.h)
+const RECENT_MAGIC = 0x31524c44; // "DLR1"
+const RECENT_HEADER_SIZE = 16;
+const RECENT_POINT_SIZE = 8;
+const RECENT_HUMI_MASK = 0x3fff;
+const RECENT_HUMI_SENSOR_FAIL = 0x8000;
+
+/**
+ * Min/max/avg over the last `capacity` values in O(1) amortized per push.
+ * Min and max come from monotonic index queues, the sum is kept running and
+ * recomputed once per window to stop floating-point drift.
+ */
+class RollingStats {
+  constructor(capacity) {
+    this.capacity = 0;
+    this.resize(capacity);
+  }
+
+  /**
+   * Change the window, keeping the newest values
+   * @param {number} capacity - Values in the window
+   */
+  resize(capacity) {
+    const keep = this.capacity ? this.toArray().slice(-capacity) : [];
+    this.capacity = capacity;
+    this.clear();
+    keep.forEach((v) => this.push(v));
+  }
+
+  clear() {
+    this.values = new Float64Array(this.capacity);
+    this.next = 0; // Values pushed since clear (absolute index of the next one)
+    this.sum = 0;
+    this.minQueue = [];
+    this.minHead = 0;
+    this.maxQueue = [];
+    this.maxHead = 0;
+  }
+
+  get count() {
+    return Math.min(this.next, this.capacity);
+  }
+
+  push(value) {
+    const i = this.next++;
+    const slot = i % this.capacity;
+
+    if (i >= this.capacity) {
+      const evicted = i - this.capacity;
+      this.sum -= this.values[slot];
+      if (this.minQueue[this.minHead] === evicted) this.minHead++;
+      if (this.maxQueue[this.maxHead] === evicted) this.maxHead++;
+    }
+    this.values[slot] = value;
+    this.sum += value;
+
+    while (
+      this.minQueue.length > this.minHead &&
+      this.valueAt(this.minQueue[this.minQueue.length - 1]) >= value
+    ) {
+      this.minQueue.pop();
+    }
+    this.minQueue.push(i);
+
+    while (
+      this.maxQueue.length > this.maxHead &&
+      this.valueAt(this.maxQueue[this.maxQueue.length - 1]) <= value
+    ) {
+      this.maxQueue.pop();
+    }
+    this.maxQueue.push(i);
+
+    // Drop consumed queue heads now and then instead of shifting every push
+    if (this.minHead > 1024) {
+      this.minQueue = this.minQueue.slice(this.minHead);
+      this.minHead = 0;
+    }
+    if (this.maxHead > 1024) {
+      this.maxQueue = this.maxQueue.slice(this.maxHead);
+      this.maxHead = 0;
+    }
+
+    if (slot === this.capacity - 1) {
+      this.sum = this.values.reduce((a, b) => a + b, 0);
+    }
+  }
+
+  valueAt(index) {
+    return this.values[index % this.capacity];
+  }
+
+  /** Window values, oldest first */
+  toArray() {
+    const out = [];
+    for (let i = this.next - this.count; i < this.next; i++) {
+      out.push(this.valueAt(i));
+    }
+    return out;
+  }
+
+  /** @returns {{count: number, min: number, max: number, avg: number}|null} */
+  snapshot() {
+    const count = this.count;
+    if (count === 0) return null;
+    return {
+      count,
+      min: this.valueAt(this.minQueue[this.minHead]),
+      max: this.valueAt(this.maxQueue[this.maxHead]),
+      avg: this.sum / count,
+    };
+  }
+}
+
+/**
+ * Device state from a system state message: JSON from the gateway
+ * ({"device":"ON","periodic":"OFF"}) or "device: ON" style text. Fields
+ * missing from text keep their previous value.
+ * @param {string} text
+ * @param {{deviceOn: boolean, periodic: boolean}} previous
+ * @returns {{deviceOn: boolean, periodic: boolean}|null}
+ */
+function parseDeviceState(text, previous) {
+  try {
+    const state = JSON.parse(text);
+    return { deviceOn: state.device === "ON", periodic: state.periodic === "ON" };
+  } catch (e) {
+    const deviceMatch = text.match(/device[:\s]+(ON|OFF)/i);
+    const periodicMatch = text.match(/periodic[:\s]+(ON|OFF)/i);
+    if (!deviceMatch && !periodicMatch) return null;
+    return {
+      deviceOn: deviceMatch ? deviceMatch[1].toUpperCase() === "ON" : previous.deviceOn,
+      periodic: periodicMatch ? periodicMatch[1].toUpperCase() === "ON" : previous.periodic,
+    };
+  }
+}
+
+/**
+ * Decodes data topics into readings and keeps the chart statistics.
+ *
+ * Topics are <root>/<device>/<suffix>: the device comes from the second
+ * level and the kind from one Map lookup on the suffix, so the cost per
+ * message does not grow with the number of loggers on the broker.
+ * A payload is one JSON reading or an array of them (batched publishers).
+ * The retained latest reading of the ingest service is decoded like a data
+ * topic, its binary recent-history snapshot into typed arrays.
+ * Each device has its own measurement state, taken from its system state
+ * messages and, for the selected device, from the dashboard (configure()).
+ * Periodic readings the dashboard would ignore are dropped here. Only the
+ * selected device is charted, and its charted readings feed the rolling
+ * statistics. takeBatch() hands over everything since the previous call;
+ * stats are included only when changed.
+ */
+class MqttStream {
+  /**
+   * @param {string} root - MQTT_CONFIG.root
+   * @param {Object} topics - MQTT_CONFIG.topics (suffixes after the device level)
+   */
+  constructor(root, topics) {
+    this.prefix = `${root}/`;
+    this.kinds = new Map([
+      [topics.singleData, "single"],
+      [topics.periodicData, "periodic"],
+      [topics.backlogData, "backlog"],
+      [topics.latestReading, "latest"],
+      [topics.recentHistory, "recent"],
+      [topics.systemState, "state"],
+    ]);
+    this.decoder = new TextDecoder();
+    this.devices = new Map(); // device -> {deviceOn, periodic}
+    this.state = { device: null, skipErrors: false, window: 50 };
+    this.temp = new RollingStats(this.state.window);
+    this.humi = new RollingStats(this.state.window);
+    this.readings = [];
+    this.messages = []; // Non-data topics, passed through as text
+    this.errors = [];
+    this.recent = null; // Newest snapshot since the previous batch
+    this.recentDevice = null;
+    this.statsChanged = false;
+    this.counters = { messages: 0, readings: 0, ignored: 0, errors: 0 };
+  }
+
+  /** @returns {{deviceOn: boolean, periodic: boolean}} */
+  deviceState(device) {
+    let state = this.devices.get(device);
+    if (!state) {
+      state = { deviceOn: false, periodic: false };
+      this.devices.set(device, state);
+    }
+    return state;
+  }
+
+  /**
+   * Update the selected device, its measurement state and the chart settings
+   * @param {Object} state - {device, deviceOn, periodic, skipErrors, window}
+   */
+  configure({ deviceOn, periodic, ...state }) {
+    Object.assign(this.state, state);
+    if (this.state.device !== null) {
+      const selected = this.deviceState(this.state.device);
+      if (deviceOn !== undefined) selected.deviceOn = deviceOn;
+      if (periodic !== undefined) selected.periodic = periodic;
+    }
+    if (this.state.window !== this.temp.capacity) {
+      this.temp.resize(this.state.window);
+      this.humi.resize(this.state.window);
+      this.statsChanged = true;
+    }
+  }
+
+  /**
+   * Replace the chart window (history load, clear)
+   * @param {ArrayLike<number>} temps - Oldest first
+   * @param {ArrayLike<number>} humis - Oldest first
+   */
+  seedChart(temps, humis) {
+    this.temp.clear();
+    this.humi.clear();
+    for (let i = 0; i < temps.length; i++) this.temp.push(temps[i]);
+    for (let i = 0; i < humis.length; i++) this.humi.push(humis[i]);
+    this.statsChanged = true;
+  }
+
+  /**
+   * Decode one MQTT message
+   * @param {string} topic
+   * @param {Uint8Array} payload
+   */
+  handle(topic, payload) {
+    this.counters.messages++;
+
+    const slash = topic.startsWith(this.prefix) ? topic.indexOf("/", this.prefix.length) : -1;
+    const device = slash > 0 ? topic.slice(this.prefix.length, slash) : null;
+    const kind = device ? this.kinds.get(topic.slice(slash + 1)) : undefined;
+
+    if (kind === "recent") {
+      // Only the selected device is charted (a retained snapshot of the
+      // previous selection can still arrive after a switch)
+      if (device === this.state.device) this.decodeRecent(device, payload);
+      return;
+    }
+
+    const text = this.decoder.decode(payload);
+    if (kind === "state") {
+      const state = parseDeviceState(text, this.deviceState(device));
+      if (state) Object.assign(this.deviceState(device), state);
+      this.messages.push({ topic, text, device, kind, state });
+      return;
+    }
+    if (!kind) {
+      this.messages.push({ topic, text, device });
+      return;
+    }
+
+    let parsed;
+    try {
+      parsed = JSON.parse(text);
+    } catch (e) {
+      this.counters.errors++;
+      this.errors.push(`JSON parse error: ${e.message}`);
+      return;
+    }
+
+    if (Array.isArray(parsed)) {
+      parsed.forEach((record) => this.decode(device, kind, record));
+    } else {
+      this.decode(device, kind, parsed);
+    }
+  }
+
+  decode(device, kind, record) {
+    if (!record || typeof record !== "object") {
+      this.counters.errors++;
+      this.errors.push(`Invalid ${kind} reading`);
+      return;
+    }
+
+    const time = Number(record.timestamp) || 0;
+    const reading = {
+      device,
+      kind,
+      time,
+      // RTC failure (timestamp 0): receive time instead
+      timestamp: time ? (time - STREAM_DEVICE_UTC_OFFSET_S) * 1000 : Date.now(),
+      temp: record.temperature,
+      humi: record.humidity,
+      sensorFailed: record.temperature === 0 && record.humidity === 0,
+      rtcFailed: time === 0,
+      chart: false,
+    };
+
+    if (kind === "backlog") {
+      if (!Number.isInteger(record.seq)) {
+        this.counters.errors++;
+        return;
+      }
+      reading.seq = record.seq;
+      reading.mode = String(record.mode || "periodic").toLowerCase();
+    } else if (kind === "periodic") {
+      // Only while PERIODIC is enabled and the device is ON
+      const state = this.deviceState(device);
+      if (!state.deviceOn || !state.periodic) {
+        this.counters.ignored++;
+        return;
+      }
+      reading.chart =
+        device === this.state.device && !(this.state.skipErrors && reading.sensorFailed);
+    }
+
+    if (reading.chart) {
+      this.temp.push(reading.temp);
+      this.humi.push(reading.humi);
+      this.statsChanged = true;
+    }
+
+    this.counters.readings++;
+    this.readings.push(reading);
+  }
+
+  /**
+   * Unpack a recent-history snapshot (header: magic u32, count u16,
+   * reserved u16, base time i64; point: offset u32, temperature i16,
+   * humidity u16 with failure flags, all little-endian)
+   * @param {string} device
+   * @param {Uint8Array} bytes
+   */
+  decodeRecent(device, bytes) {
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    const count = bytes.byteLength >= RECENT_HEADER_SIZE ? view.getUint16(4, true) : 0;
+
+    if (
+      bytes.byteLength < RECENT_HEADER_SIZE ||
+      view.getUint32(0, true) !== RECENT_MAGIC ||
+      bytes.byteLength < RECENT_HEADER_SIZE + count * RECENT_POINT_SIZE
+    ) {
+      this.counters.errors++;
+      this.errors.push("Invalid recent-history snapshot");
+      return;
+    }
+
+    const base = Number(view.getBigInt64(8, true));
+    const recent = {
+      times: new Float64Array(count), // ms, UTC
+      temps: new Float32Array(count),
+      humis: new Float32Array(count),
+      sensorFailed: new Uint8Array(count),
+    };
+
+    for (let i = 0; i < count; i++) {
+      const at = RECENT_HEADER_SIZE + i * RECENT_POINT_SIZE;
+      const humi = view.getUint16(at + 6, true);
+      recent.times[i] = (base + view.getUint32(at, true)) * 1000;
+      recent.temps[i] = view.getInt16(at + 4, true) / 100;
+      recent.humis[i] = (humi & RECENT_HUMI_MASK) / 100;
+      recent.sensorFailed[i] = humi & RECENT_HUMI_SENSOR_FAIL ? 1 : 0;
+    }
+
+    this.recent = recent;
+    this.recentDevice = device;
+  }
+
+  get pending() {
+    return (
+      this.recent !== null ||
+      this.readings.length > 0 ||
+      this.messages.length > 0 ||
+      this.errors.length > 0 ||
+      this.statsChanged
+    );
+  }
+
+  /**
+   * Everything decoded since the previous call
+   * @returns {Object|null} {readings, messages, errors, counters, stats?, recent?, recentDevice?}
+   */
+  takeBatch() {
+    if (!this.pending) return null;
+
+    const batch = {
+      readings: this.readings,
+      messages: this.messages,
+      errors: this.errors,
+      counters: { ...this.counters },
+    };
+    if (this.recent) {
+      batch.recent = this.recent;
+      batch.recentDevice = this.recentDevice;
+      this.recent = null;
+    }
+    if (this.statsChanged) {
+      batch.stats = { temp: this.temp.snapshot(), humi: this.humi.snapshot() };
+      this.statsChanged = false;
+    }
+
+    this.readings = [];
+    this.messages = [];
+    this.errors = [];
+    return batch;
+  }
+}
@@ -0,0 +1,119 @@
+// ====================================================================
+// MQTT WORKER - owns the broker connection off the UI thread
+// ====================================================================
+// Messages from the page:
+//   {type: "connect", url, options, root, topics, subscribe}
+//   {type: "publish", topic, payload, qos, retain}
+//   {type: "subscribe", topic}          added to the set restored on reconnect
+//   {type: "unsubscribe", topic}
+//   {type: "end", force}
+//   {type: "configure", state}          measurement state, chart settings
+//   {type: "seed", temps, humis}        chart window replaced (history, clear)
+// Messages to the page:
+//   {type: "status", event, message}    connect/offline/reconnect/close/error
+//   {type: "subscribed", topic, error}
+//   {type: "batch", ...}                MqttStream.takeBatch(), at most every STREAM_FLUSH_MS
+//   {type: "fatal", message}            could not start (the page falls back)
+
+// Longest a decoded reading waits before it is posted to the page
+const STREAM_FLUSH_MS = 50;
+
+try {
+  importScripts("https://unpkg.com/mqtt/dist/mqtt.min.js", "mqtt_stream.js");
+} catch (e) {
+  self.postMessage({ type: "fatal", message: e.message });
+  self.close();
+}
+
+let client = null;
+let stream = null;
+let flushTimer = null;
+let subscriptions = [];
+
+function flush() {
+  flushTimer = null;
+  const batch = stream.takeBatch();
+  if (!batch) return;
+
+  const transfer = batch.recent
+    ? Object.values(batch.recent).map((array) => array.buffer)
+    : [];
+  self.postMessage({ type: "batch", ...batch }, transfer);
+}
+
+function scheduleFlush() {
+  if (flushTimer === null && stream.pending) {
+    flushTimer = setTimeout(flush, STREAM_FLUSH_MS);
+  }
+}
+
+function subscribe(topic) {
+  client.subscribe(topic, { qos: 1 }, (err) => {
+    self.postMessage({
+      type: "subscribed",
+      topic,
+      error: err ? err.message : null,
+    });
+  });
+}
+
+function connect(msg) {
+  stream = new MqttStream(msg.root, msg.topics);
+  subscriptions = msg.subscribe.slice();
+  client = mqtt.connect(msg.url, msg.options);
+
+  client.on("connect", () => {
+    self.postMessage({ type: "status", event: "connect" });
+    subscriptions.forEach(subscribe);
+  });
+
+  client.on("message", (topic, payload) => {
+    stream.handle(topic, payload);
+    scheduleFlush();
+  });
+
+  client.on("error", (error) => {
+    self.postMessage({ type: "status", event: "error", message: error.message });
+  });
+  client.on("offline", () => self.postMessage({ type: "status", event: "offline" }));
+  client.on("reconnect", () => self.postMessage({ type: "status", event: "reconnect" }));
+  client.on("close", () => self.postMessage({ type: "status", event: "close" }));
+}
+
+self.onmessage = (event) => {
+  const msg = event.data;
+
+  switch (msg.type) {
+    case "connect":
+      try {
+        connect(msg);
+      } catch (e) {
+        self.postMessage({ type: "fatal", message: e.message });
+      }
+      break;
+    case "publish":
+      if (client) {
+        client.publish(msg.topic, msg.payload, { qos: msg.qos, retain: msg.retain });
+      }
+      break;
+    case "subscribe":
+      if (!subscriptions.includes(msg.topic)) subscriptions.push(msg.topic);
+      if (client && client.connected) subscribe(msg.topic);
+      break;
+    case "unsubscribe":
+      subscriptions = subscriptions.filter((topic) => topic !== msg.topic);
+      if (client && client.connected) client.unsubscribe(msg.topic);
+      break;
+    case "end":
+      if (client) client.end(msg.force);
+      break;
+    case "configure":
+      if (stream) stream.configure(msg.state);
+      scheduleFlush();
+      break;
+    case "seed":
+      if (stream) stream.seedChart(msg.temps, msg.humis);
+      scheduleFlush();
+      break;
+  }
+};